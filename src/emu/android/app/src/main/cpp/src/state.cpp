@@ -115,6 +115,8 @@ namespace eka2l1::android {
             log::filterings->parse_filter_string(conf.log_filter);
         }
 
+        log::set_async_logging(conf.async_logging);
+
         LOG_INFO(FRONTEND_CMDLINE, "EKA2L1 v0.0.1 ({}-{})", GIT_BRANCH, GIT_COMMIT_HASH);
 
         app_settings = std::make_unique<config::app_settings>(&conf);
@@ -20,6 +20,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cstdint>
 #include <string>
 #include <type_traits>
@@ -92,6 +93,26 @@ namespace eka2l1::common {
             return buf >= end;
         }
 
+        /**
+         * \brief Check if a count read from the buffer can fit in the data left.
+         *
+         * Each element takes at least the given number of bytes, so a bigger count can only come
+         * from corrupted data. Check it before resizing a container, so that a corrupted count
+         * does not allocate a huge amount of memory.
+         *
+         * \param count            The count of elements.
+         * \param min_element_size Minimum number of bytes an element takes in the buffer.
+         *
+         * \returns False if the elements can't fit. Always true when not reading.
+         */
+        bool count_fits(const std::uint64_t count, const std::size_t min_element_size = 1) {
+            if (mode != SERI_MODE_READ) {
+                return true;
+            }
+
+            return count <= left() / std::max<std::size_t>(min_element_size, 1);
+        }
+
         std::uint8_t *current() const {
             return buf;
         }
@@ -138,6 +159,10 @@ namespace eka2l1::common {
             absorb(s);
 
             if (mode == SERI_MODE_READ) {
+                if (!count_fits(s)) {
+                    s = 0;
+                }
+
                 c.resize(s);
             }
 
@@ -152,6 +177,10 @@ namespace eka2l1::common {
             absorb(s);
 
             if (mode == SERI_MODE_READ) {
+                if (!count_fits(s)) {
+                    s = 0;
+                }
+
                 c.resize(s);
             }
 
@@ -166,6 +195,10 @@ namespace eka2l1::common {
             absorb(s);
 
             if (mode == SERI_MODE_READ) {
+                if (!count_fits(s)) {
+                    s = 0;
+                }
+
                 c.resize(s);
             }
 
@@ -24,8 +24,18 @@
 
 #include <common/configure.h>
 
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <new>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 
 namespace eka2l1 {
     extern bool already_setup;
@@ -73,6 +83,191 @@ namespace eka2l1 {
         void setup_log(std::shared_ptr<base_logger> extra_logger);
         void toggle_console();
         bool is_console_enabled();
+
+        /**
+         * \brief Enable or disable asynchronous logging.
+         *
+         * In asynchronous mode, log macros only copy their arguments into a ring owned by the calling thread.
+         * Formatting and writing to the sinks is done later by a background thread. Disabling it writes out
+         * every pending message first.
+         */
+        void set_async_logging(const bool enable);
+
+        extern std::atomic_bool async_logging_enabled;
+
+        // Number of threads currently queuing a record. The writer is kept running until it drops to zero
+        extern std::atomic_int async_log_pushers;
+
+        inline bool is_async_logging() {
+            return async_logging_enabled.load(std::memory_order_relaxed);
+        }
+
+        enum {
+            ASYNC_LOG_ARGS_SIZE = 192,
+            ASYNC_LOG_RING_SIZE = 512
+        };
+
+        struct async_log_record {
+            // Format the arguments stored in the record, then destroy them
+            using format_func = void (*)(void *args, const char *format, std::string &dest);
+
+            format_func format_;
+            const char *format_string_;
+            spdlog::level::level_enum level_;
+
+            alignas(std::max_align_t) std::uint8_t args_[ASYNC_LOG_ARGS_SIZE];
+        };
+
+        /**
+         * \brief Records waiting to be formatted, with the calling thread as the only producer.
+         */
+        class async_log_ring {
+            std::array<async_log_record, ASYNC_LOG_RING_SIZE> records_;
+
+            alignas(128) std::atomic_size_t read_index_{ 0 };
+            alignas(128) std::atomic_size_t write_index_{ 0 };
+
+        public:
+            async_log_record *begin_write() {
+                const std::size_t write_index = write_index_.load(std::memory_order_relaxed);
+                if (write_index - read_index_.load(std::memory_order_acquire) >= ASYNC_LOG_RING_SIZE) {
+                    return nullptr;
+                }
+
+                return &records_[write_index % ASYNC_LOG_RING_SIZE];
+            }
+
+            void end_write() {
+                write_index_.store(write_index_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+            }
+
+            async_log_record *begin_read() {
+                const std::size_t read_index = read_index_.load(std::memory_order_relaxed);
+                if (read_index == write_index_.load(std::memory_order_acquire)) {
+                    return nullptr;
+                }
+
+                return &records_[read_index % ASYNC_LOG_RING_SIZE];
+            }
+
+            void end_read() {
+                read_index_.store(read_index_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+            }
+
+            bool empty() const {
+                return read_index_.load(std::memory_order_acquire) == write_index_.load(std::memory_order_acquire);
+            }
+        };
+
+        async_log_ring *get_thread_async_log_ring();
+        void wake_async_log_writer();
+
+        // Strings are copied, since the pointed data may be gone by the time the record is formatted
+        template <typename T>
+        using async_log_arg_t = std::conditional_t<std::is_same_v<std::decay_t<T>, const char *> || std::is_same_v<std::decay_t<T>, char *>
+                || std::is_same_v<std::decay_t<T>, std::string_view>,
+            std::string, std::decay_t<T>>;
+
+        template <typename Tuple, std::size_t... I>
+        void format_async_log_args(Tuple &args, const char *format, std::string &dest, std::index_sequence<I...>) {
+            dest = fmt::vformat(format, fmt::make_format_args(std::get<I>(args)...));
+        }
+
+        // Only types that own their data are stored. Others, like fmt::join results, may refer to data
+        // that is gone by the time the record is formatted, so the message is formatted right away
+        template <typename T>
+        inline constexpr bool is_async_log_arg_storable_v = std::is_arithmetic_v<std::decay_t<T>> || std::is_enum_v<std::decay_t<T>>
+            || std::is_same_v<std::decay_t<T>, const void *> || std::is_same_v<std::decay_t<T>, void *>
+            || std::is_same_v<async_log_arg_t<T>, std::string>;
+
+        template <typename Tuple>
+        void format_and_destroy_async_log_args(void *args, const char *format, std::string &dest) {
+            Tuple *args_casted = reinterpret_cast<Tuple *>(args);
+
+            try {
+                format_async_log_args(*args_casted, format, dest, std::make_index_sequence<std::tuple_size_v<Tuple>>{});
+            } catch (...) {
+                args_casted->~Tuple();
+                throw;
+            }
+
+            args_casted->~Tuple();
+        }
+
+        template <typename Tuple, typename... Args>
+        void push_async_log_record(const spdlog::level::level_enum level, const char *format, Args &&...args) {
+            // Counted before checking, so that set_async_logging(false) either waits for this record
+            // to be queued, or this sees asynchronous logging is off and writes the message itself
+            async_log_pushers.fetch_add(1);
+
+            if (!async_logging_enabled.load()) {
+                async_log_pushers.fetch_sub(1);
+
+                std::string message;
+
+                try {
+                    message = fmt::vformat(format, fmt::make_format_args(args...));
+                } catch (std::exception &e) {
+                    message = std::string("Failed to format log message: ") + e.what();
+                }
+
+                if (spd_logger) {
+                    spd_logger->log(level, spdlog::string_view_t(message.data(), message.size()));
+                }
+
+                return;
+            }
+
+            async_log_ring *ring = get_thread_async_log_ring();
+            async_log_record *record = nullptr;
+
+            while ((record = ring->begin_write()) == nullptr) {
+                // The writer is behind. Wait for it rather than dropping the message
+                wake_async_log_writer();
+                std::this_thread::yield();
+            }
+
+            record->format_ = format_and_destroy_async_log_args<Tuple>;
+            record->format_string_ = format;
+            record->level_ = level;
+
+            try {
+                new (record->args_) Tuple(std::forward<Args>(args)...);
+            } catch (...) {
+                async_log_pushers.fetch_sub(1);
+                throw;
+            }
+
+            ring->end_write();
+            async_log_pushers.fetch_sub(1);
+        }
+
+        /**
+         * \brief Queue a message to be formatted by the background log writer.
+         *
+         * The file name and class name must have static storage, as they are not copied.
+         */
+        template <typename... Args>
+        void push_async_log(const spdlog::level::level_enum level, const char *format, const char *file, const int line,
+            const char *class_name, Args &&...args) {
+            using args_tuple = std::tuple<const char *, int, const char *, async_log_arg_t<Args>...>;
+
+            if constexpr ((sizeof(args_tuple) <= ASYNC_LOG_ARGS_SIZE) && (alignof(args_tuple) <= alignof(std::max_align_t))
+                && (is_async_log_arg_storable_v<Args> && ...)) {
+                push_async_log_record<args_tuple>(level, format, file, line, class_name, std::forward<Args>(args)...);
+            } else {
+                // Too big to be stored in a record, or refers to data it doesn't own. Format it right away
+                std::string message;
+
+                try {
+                    message = fmt::vformat(format, fmt::make_format_args(file, line, class_name, args...));
+                } catch (std::exception &e) {
+                    message = std::string("Failed to format log message: ") + e.what();
+                }
+
+                push_async_log_record<std::tuple<std::string>>(level, "{}", std::move(message));
+            }
+        }
     }
 }
 
@@ -98,35 +293,39 @@ namespace eka2l1 {
 #define COND_CHECK_AND(class, serv) &&eka2l1::log::filterings->is_passed(class, spdlog::level::serv)
 #endif
 
+#define LOG_WRITE(class, lvl, method, fmt, ...)                                                                                                                               \
+    (eka2l1::log::is_async_logging() ? eka2l1::log::push_async_log(spdlog::level::lvl, "{:s}:{} [{:s}]: " fmt, __FILE__, __LINE__, log_class_to_string(class), ##__VA_ARGS__) \
+                                     : eka2l1::log::spd_logger->method("{:s}:{} [{:s}]: " fmt, __FILE__, __LINE__, log_class_to_string(class), ##__VA_ARGS__))
+
 #define LOG_TRACE(class, fmt, ...) COND_CHECK(class, trace) \
-                                   eka2l1::log::spd_logger->trace("{:s}:{} [{:s}]: " fmt, __FILE__, __LINE__, log_class_to_string(class), ##__VA_ARGS__)
+                                   LOG_WRITE(class, trace, trace, fmt, ##__VA_ARGS__)
 #define LOG_DEBUG(class, fmt, ...) COND_CHECK(class, debug) \
-                                   eka2l1::log::spd_logger->debug("{:s}:{} [{:s}]: " fmt, __FILE__, __LINE__, log_class_to_string(class), ##__VA_ARGS__)
+                                   LOG_WRITE(class, debug, debug, fmt, ##__VA_ARGS__)
 #define LOG_INFO(class, fmt, ...) COND_CHECK(class, info) \
-                                  eka2l1::log::spd_logger->info("{:s}:{} [{:s}]: " fmt, __FILE__, __LINE__, log_class_to_string(class), ##__VA_ARGS__)
+                                  LOG_WRITE(class, info, info, fmt, ##__VA_ARGS__)
 #define LOG_WARN(class, fmt, ...) COND_CHECK(class, warn) \
-                                  eka2l1::log::spd_logger->warn("{:s}:{} [{:s}]: " fmt, __FILE__, __LINE__, log_class_to_string(class), ##__VA_ARGS__)
+                                  LOG_WRITE(class, warn, warn, fmt, ##__VA_ARGS__)
 #define LOG_ERROR(class, fmt, ...) COND_CHECK(class, err) \
-                                   eka2l1::log::spd_logger->error("{:s}:{} [{:s}]: " fmt, __FILE__, __LINE__, log_class_to_string(class), ##__VA_ARGS__)
+                                   LOG_WRITE(class, err, error, fmt, ##__VA_ARGS__)
 #define LOG_CRITICAL(class, fmt, ...) COND_CHECK(class, critical) \
-                                      eka2l1::log::spd_logger->critical("{:s}:{} [{:s}]: " fmt, __FILE__, __LINE__, log_class_to_string(class), ##__VA_ARGS__)
+                                      LOG_WRITE(class, critical, critical, fmt, ##__VA_ARGS__)
 
 #define LOG_TRACE_IF(class, flag, fmt, ...) \
     if (flag COND_CHECK_AND(class, trace))  \
-    eka2l1::log::spd_logger->trace("{:s}:{} [{:s}]: " fmt, __FILE__, __LINE__, log_class_to_string(class), ##__VA_ARGS__)
+    LOG_WRITE(class, trace, trace, fmt, ##__VA_ARGS__)
 #define LOG_DEBUG_IF(class, flag, fmt, ...) \
     if (flag COND_CHECK_AND(class, debug))  \
-    eka2l1::log::spd_logger->debug("{:s}:{} [{:s}]: " fmt, __FILE__, __LINE__, log_class_to_string(class), ##__VA_ARGS__)
+    LOG_WRITE(class, debug, debug, fmt, ##__VA_ARGS__)
 #define LOG_INFO_IF(class, flag, fmt, ...) \
     if (flag COND_CHECK_AND(class, info))  \
-    eka2l1::log::spd_logger->info("{:s}:{} [{:s}]: " fmt, __FILE__, __LINE__, log_class_to_string(class), ##__VA_ARGS__)
+    LOG_WRITE(class, info, info, fmt, ##__VA_ARGS__)
 #define LOG_WARN_IF(class, flag, fmt, ...) \
     if (flag COND_CHECK_AND(class, warn))  \
-    eka2l1::log::spd_logger->warn("{:s}:{} [{:s}]: " fmt, __FILE__, __LINE__, log_class_to_string(class), ##__VA_ARGS__)
+    LOG_WRITE(class, warn, warn, fmt, ##__VA_ARGS__)
 #define LOG_ERROR_IF(class, flag, fmt, ...) \
     if (flag COND_CHECK_AND(class, err))    \
-    eka2l1::log::spd_logger->error("{:s}:{} [{:s}]: " fmt, __FILE__, __LINE__, log_class_to_string(class), ##__VA_ARGS__)
+    LOG_WRITE(class, err, error, fmt, ##__VA_ARGS__)
 #define LOG_CRITICAL_IF(class, flag, fmt, ...) \
     if (flag COND_CHECK_AND(class, critical))  \
-    eka2l1::log::spd_logger->critical("{:s}:{} [{:s}]: " fmt, __FILE__, __LINE__, log_class_to_string(class), ##__VA_ARGS__)
+    LOG_WRITE(class, critical, critical, fmt, ##__VA_ARGS__)
 #endif
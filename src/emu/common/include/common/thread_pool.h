@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2022 EKA2L1 Team.
+ * 
+ * This file is part of EKA2L1 project.
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace eka2l1::common {
+    /**
+     * @brief A fixed group of host threads consuming tasks from a shared FIFO queue.
+     */
+    class thread_pool {
+    public:
+        using task_func = std::function<void()>;
+
+    private:
+        std::vector<std::thread> workers_;
+        std::queue<task_func> tasks_;
+
+        std::mutex lock_;
+        std::condition_variable cond_;
+
+        std::string name_;
+        bool should_stop_;
+
+        void worker_loop(const std::size_t index);
+
+    public:
+        /**
+         * @brief Construct a new thread pool.
+         * 
+         * @param name          Prefix of the name given to each worker thread.
+         * @param worker_count  Number of worker threads. Use 0 to pick from the host's hardware concurrency.
+         */
+        explicit thread_pool(const std::string &name, const std::size_t worker_count = 0);
+        ~thread_pool();
+
+        /**
+         * @brief Queue a task to be run on one of the worker threads.
+         * 
+         * @param task The task to run.
+         */
+        void enqueue(task_func task);
+
+        /**
+         * @brief Queue a task and get a future to its result.
+         * 
+         * @param func The function to run.
+         * @returns A future, which will hold the function's result once the function has been run.
+         */
+        template <typename F>
+        auto submit(F &&func) -> std::future<decltype(func())> {
+            using result_type = decltype(func());
+
+            auto task = std::make_shared<std::packaged_task<result_type()>>(std::forward<F>(func));
+            std::future<result_type> result = task->get_future();
+
+            enqueue([task]() { (*task)(); });
+            return result;
+        }
+
+        std::size_t worker_count() const {
+            return workers_.size();
+        }
+    };
+}
@@ -57,6 +57,8 @@ namespace eka2l1::common {
     /**
      * \brief Decommit memory region.
      *
+     * The backing pages are returned to the host, and read as zero once committed again.
+     *
      * \param ptr Pointer to the target region.
      * \param size Size of the memory to be decommitted.
      * 
@@ -64,6 +66,23 @@ namespace eka2l1::common {
     */
     bool decommit(void *ptr, const std::size_t size);
 
+    /**
+     * \brief Get the number of bytes in a region that are backed by physical host memory.
+     *
+     * \param ptr Pointer to the target region.
+     * \param size Size of the region.
+     *
+     * \returns Resident size in bytes, rounded to host pages. 0 on failure.
+    */
+    std::size_t get_resident_size(void *ptr, const std::size_t size);
+
+    /**
+     * \brief Get the resident set size of the whole emulator process.
+     *
+     * \returns Resident size in bytes. 0 if it can't be queried.
+    */
+    std::size_t get_host_resident_size();
+
     /**
      * \brief Change protection of committed region
      *
@@ -87,6 +87,10 @@ namespace eka2l1::common {
         absorb_impl(reinterpret_cast<std::uint8_t *>(&s), sizeof(std::uint32_t));
 
         if (mode == SERI_MODE_READ) {
+            if (!count_fits(s, 1)) {
+                s = 0;
+            }
+
             dat.resize(s);
         }
 
@@ -98,6 +102,10 @@ namespace eka2l1::common {
         absorb_impl(reinterpret_cast<std::uint8_t *>(&s), sizeof(std::uint32_t));
 
         if (mode == SERI_MODE_READ) {
+            if (!count_fits(s, 2)) {
+                s = 0;
+            }
+
             dat.resize(s);
         }
 
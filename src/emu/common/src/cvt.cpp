@@ -21,6 +21,8 @@
 #include <common/platform.h>
 
 #include <codecvt>
+#include <cstdint>
+#include <cstring>
 #include <locale>
 
 #if EKA2L1_PLATFORM(WIN32)
@@ -29,34 +31,197 @@
 
 namespace eka2l1 {
     namespace common {
-#ifdef _MSC_VER
-        using char_ucs2 = uint16_t;
-#else
-        using char_ucs2 = char16_t;
-#endif
+        static constexpr char16_t REPLACEMENT_CHARACTER = 0xFFFD;
+
+        // Mask out everything but the bits that are set in non-ASCII code units, eight bytes at a time
+        static constexpr std::uint64_t NON_ASCII_BYTE_MASK = 0x8080808080808080ULL;
+        static constexpr std::uint64_t NON_ASCII_UCS2_MASK = 0xFF80FF80FF80FF80ULL;
+
+        static std::size_t count_ascii_prefix(const char *str, const std::size_t size) {
+            std::size_t i = 0;
+
+            for (; i + sizeof(std::uint64_t) <= size; i += sizeof(std::uint64_t)) {
+                std::uint64_t chunk = 0;
+                std::memcpy(&chunk, str + i, sizeof(std::uint64_t));
+
+                if (chunk & NON_ASCII_BYTE_MASK) {
+                    break;
+                }
+            }
+
+            while ((i < size) && !(static_cast<std::uint8_t>(str[i]) & 0x80)) {
+                i++;
+            }
+
+            return i;
+        }
+
+        static std::size_t count_ascii_prefix(const char16_t *str, const std::size_t size) {
+            static constexpr std::size_t UNITS_PER_CHUNK = sizeof(std::uint64_t) / sizeof(char16_t);
+            std::size_t i = 0;
+
+            for (; i + UNITS_PER_CHUNK <= size; i += UNITS_PER_CHUNK) {
+                std::uint64_t chunk = 0;
+                std::memcpy(&chunk, str + i, sizeof(std::uint64_t));
 
-        // VS2017 bug: https://stackoverflow.com/questions/32055357/visual-studio-c-2015-stdcodecvt-with-char16-t-or-char32-t
+                if (chunk & NON_ASCII_UCS2_MASK) {
+                    break;
+                }
+            }
+
+            while ((i < size) && (str[i] < 0x80)) {
+                i++;
+            }
+
+            return i;
+        }
+
+        static inline bool is_high_surrogate(const char16_t c) {
+            return (c >= 0xD800) && (c <= 0xDBFF);
+        }
+
+        static inline bool is_low_surrogate(const char16_t c) {
+            return (c >= 0xDC00) && (c <= 0xDFFF);
+        }
+
+        // Lone surrogates are encoded as three-byte sequences rather than rejected, so that any UCS-2 string
+        // coming from the guest survives a round trip.
         std::string ucs2_to_utf8(const std::u16string &str) {
-            if (str.empty()) {
-                return "";
+            const char16_t *source = str.data();
+            const std::size_t source_size = str.size();
+            const std::size_t ascii_count = count_ascii_prefix(source, source_size);
+
+            std::size_t dest_size = ascii_count;
+
+            for (std::size_t i = ascii_count; i < source_size; i++) {
+                const char16_t c = source[i];
+
+                if (c < 0x80) {
+                    dest_size += 1;
+                } else if (c < 0x800) {
+                    dest_size += 2;
+                } else if (is_high_surrogate(c) && (i + 1 < source_size) && is_low_surrogate(source[i + 1])) {
+                    dest_size += 4;
+                    i++;
+                } else {
+                    dest_size += 3;
+                }
             }
 
-            std::wstring_convert<std::codecvt_utf8_utf16<char_ucs2>, char_ucs2> convert;
-            auto p = reinterpret_cast<const char_ucs2 *>(str.data());
+            std::string result(dest_size, '\0');
+            char *dest = result.data();
 
-            return convert.to_bytes(p, p + str.size());
+            for (std::size_t i = 0; i < ascii_count; i++) {
+                dest[i] = static_cast<char>(source[i]);
+            }
+
+            std::size_t written = ascii_count;
+
+            for (std::size_t i = ascii_count; i < source_size; i++) {
+                const char16_t c = source[i];
+
+                if (c < 0x80) {
+                    dest[written++] = static_cast<char>(c);
+                } else if (c < 0x800) {
+                    dest[written++] = static_cast<char>(0xC0 | (c >> 6));
+                    dest[written++] = static_cast<char>(0x80 | (c & 0x3F));
+                } else if (is_high_surrogate(c) && (i + 1 < source_size) && is_low_surrogate(source[i + 1])) {
+                    const char32_t code_point = 0x10000 + ((static_cast<char32_t>(c - 0xD800) << 10) | (source[i + 1] - 0xDC00));
+
+                    dest[written++] = static_cast<char>(0xF0 | (code_point >> 18));
+                    dest[written++] = static_cast<char>(0x80 | ((code_point >> 12) & 0x3F));
+                    dest[written++] = static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+                    dest[written++] = static_cast<char>(0x80 | (code_point & 0x3F));
+
+                    i++;
+                } else {
+                    dest[written++] = static_cast<char>(0xE0 | (c >> 12));
+                    dest[written++] = static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+                    dest[written++] = static_cast<char>(0x80 | (c & 0x3F));
+                }
+            }
+
+            return result;
         }
 
+        // Malformed sequences are replaced with U+FFFD, one per invalid byte.
         std::u16string utf8_to_ucs2(const std::string &str) {
-            if (str.empty()) {
-                return u"";
+            const char *source = str.data();
+            const std::size_t source_size = str.size();
+            const std::size_t ascii_count = count_ascii_prefix(source, source_size);
+
+            // Every byte produces at most one code unit
+            std::u16string result(source_size, u'\0');
+            char16_t *dest = result.data();
+
+            for (std::size_t i = 0; i < ascii_count; i++) {
+                dest[i] = static_cast<char16_t>(source[i]);
             }
 
-            std::wstring_convert<std::codecvt_utf8_utf16<char_ucs2>, char_ucs2> converter;
-            auto wstr = converter.from_bytes(str);
+            std::size_t written = ascii_count;
+            std::size_t i = ascii_count;
+
+            while (i < source_size) {
+                const std::uint8_t lead = static_cast<std::uint8_t>(source[i]);
+
+                if (lead < 0x80) {
+                    dest[written++] = static_cast<char16_t>(lead);
+                    i++;
 
-            std::u16string new_string(wstr.begin(), wstr.end());
-            return new_string;
+                    continue;
+                }
+
+                std::size_t sequence_size = 0;
+                char32_t code_point = 0;
+                char32_t min_code_point = 0;
+
+                if ((lead & 0xE0) == 0xC0) {
+                    sequence_size = 2;
+                    code_point = lead & 0x1F;
+                    min_code_point = 0x80;
+                } else if ((lead & 0xF0) == 0xE0) {
+                    sequence_size = 3;
+                    code_point = lead & 0x0F;
+                    min_code_point = 0x800;
+                } else if ((lead & 0xF8) == 0xF0) {
+                    sequence_size = 4;
+                    code_point = lead & 0x07;
+                    min_code_point = 0x10000;
+                }
+
+                bool valid = (sequence_size != 0) && (i + sequence_size <= source_size);
+
+                for (std::size_t j = 1; valid && (j < sequence_size); j++) {
+                    const std::uint8_t trail = static_cast<std::uint8_t>(source[i + j]);
+
+                    if ((trail & 0xC0) != 0x80) {
+                        valid = false;
+                    } else {
+                        code_point = (code_point << 6) | (trail & 0x3F);
+                    }
+                }
+
+                if (!valid || (code_point < min_code_point) || (code_point > 0x10FFFF)) {
+                    dest[written++] = REPLACEMENT_CHARACTER;
+                    i++;
+
+                    continue;
+                }
+
+                if (code_point >= 0x10000) {
+                    code_point -= 0x10000;
+
+                    dest[written++] = static_cast<char16_t>(0xD800 + (code_point >> 10));
+                    dest[written++] = static_cast<char16_t>(0xDC00 + (code_point & 0x3FF));
+                } else {
+                    dest[written++] = static_cast<char16_t>(code_point);
+                }
+
+                i += sequence_size;
+            }
+
+            result.resize(written);
+            return result;
         }
 
         std::wstring ucs2_to_wstr(const std::u16string &str) {
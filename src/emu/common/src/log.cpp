@@ -25,8 +25,12 @@
 #define SPDLOG_FMT_EXTERNAL
 #include <spdlog/spdlog.h>
 
+#include <condition_variable>
 #include <iostream>
 #include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 #ifdef _MSC_VER
 #include <spdlog/sinks/msvc_sink.h>
@@ -286,5 +290,159 @@ namespace eka2l1 {
         bool is_console_enabled() {
             return console_shown;
         }
+
+        std::atomic_bool async_logging_enabled(false);
+        std::atomic_int async_log_pushers(0);
+
+        /**
+         * \brief Drains the rings of every logging thread, formats the records and writes them to the sinks.
+         */
+        class async_log_writer {
+            std::vector<std::shared_ptr<async_log_ring>> rings_;
+            std::mutex rings_lock_;
+
+            std::unique_ptr<std::thread> thread_;
+            std::mutex wake_lock_;
+            std::condition_variable wake_cond_;
+            bool should_stop_ = false;
+
+            bool drain() {
+                std::vector<std::shared_ptr<async_log_ring>> rings;
+
+                {
+                    const std::lock_guard<std::mutex> guard(rings_lock_);
+
+                    // Rings of exited threads are only referenced here. Drop them once they are empty
+                    rings_.erase(std::remove_if(rings_.begin(), rings_.end(), [](const std::shared_ptr<async_log_ring> &ring) {
+                        return (ring.use_count() == 1) && ring->empty();
+                    }), rings_.end());
+
+                    rings = rings_;
+                }
+
+                bool has_written = false;
+                std::string message;
+
+                for (auto &ring: rings) {
+                    while (async_log_record *record = ring->begin_read()) {
+                        try {
+                            record->format_(record->args_, record->format_string_, message);
+                        } catch (std::exception &e) {
+                            message = std::string("Failed to format log message: ") + e.what();
+                        }
+
+                        if (spd_logger) {
+                            spd_logger->log(record->level_, spdlog::string_view_t(message.data(), message.size()));
+                        }
+
+                        ring->end_read();
+
+                        has_written = true;
+                    }
+                }
+
+                return has_written;
+            }
+
+            void run() {
+                while (true) {
+                    if (drain()) {
+                        continue;
+                    }
+
+                    std::unique_lock<std::mutex> guard(wake_lock_);
+                    if (should_stop_) {
+                        break;
+                    }
+
+                    // Producers never notify on the normal path, so poll at a short interval
+                    wake_cond_.wait_for(guard, std::chrono::milliseconds(5));
+                }
+
+                drain();
+            }
+
+        public:
+            ~async_log_writer() {
+                stop();
+            }
+
+            void start() {
+                if (thread_) {
+                    return;
+                }
+
+                should_stop_ = false;
+                thread_ = std::make_unique<std::thread>([this]() {
+                    run();
+                });
+            }
+
+            void stop() {
+                if (!thread_) {
+                    return;
+                }
+
+                // New records are written synchronously from now on. Let the ones being queued land
+                // in their rings while the thread can still make room for them
+                async_logging_enabled = false;
+
+                while (async_log_pushers.load() != 0) {
+                    std::this_thread::yield();
+                }
+
+                {
+                    const std::lock_guard<std::mutex> guard(wake_lock_);
+                    should_stop_ = true;
+                }
+
+                wake_cond_.notify_one();
+
+                thread_->join();
+                thread_.reset();
+
+                // Catch anything queued after the thread's last pass
+                drain();
+            }
+
+            void wake() {
+                wake_cond_.notify_one();
+            }
+
+            std::shared_ptr<async_log_ring> new_ring() {
+                auto ring = std::make_shared<async_log_ring>();
+
+                const std::lock_guard<std::mutex> guard(rings_lock_);
+                rings_.push_back(ring);
+
+                return ring;
+            }
+        };
+
+        // Declared after the logger, so that it is destroyed (and drained) first
+        static async_log_writer async_writer;
+
+        async_log_ring *get_thread_async_log_ring() {
+            thread_local std::shared_ptr<async_log_ring> ring = async_writer.new_ring();
+            return ring.get();
+        }
+
+        void wake_async_log_writer() {
+            async_writer.wake();
+        }
+
+        void set_async_logging(const bool enable) {
+            if (enable == async_logging_enabled) {
+                return;
+            }
+
+            if (enable) {
+                async_writer.start();
+                async_logging_enabled = true;
+            } else {
+                // Messages already queued are still written out before this returns
+                async_writer.stop();
+            }
+        }
     }
 }
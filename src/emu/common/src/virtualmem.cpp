@@ -24,12 +24,20 @@
 
 #if EKA2L1_PLATFORM(WIN32)
 #include <Windows.h>
+#include <Psapi.h>
 #elif EKA2L1_PLATFORM(UNIX) || EKA2L1_PLATFORM(DARWIN)
 #include <sys/mman.h>
 #include <sys/stat.h>
 
 #include <fcntl.h>
 #include <unistd.h>
+
+#include <cstdio>
+#include <vector>
+
+#if EKA2L1_PLATFORM(DARWIN)
+#include <mach/mach.h>
+#endif
 #endif
 
 namespace eka2l1::common {
@@ -91,9 +99,115 @@ namespace eka2l1::common {
             return false;
         }
 
+#if !EKA2L1_PLATFORM(WIN32)
+        // Protection alone keeps the pages resident. Drop them so the host can reclaim the memory,
+        // only touching host pages that are fully inside the region.
+        const std::size_t host_page_size = static_cast<std::size_t>(get_host_page_size());
+        const std::uintptr_t release_start = (reinterpret_cast<std::uintptr_t>(ptr) + host_page_size - 1) & ~(host_page_size - 1);
+        const std::uintptr_t release_end = (reinterpret_cast<std::uintptr_t>(ptr) + size) & ~(host_page_size - 1);
+
+        if (release_end > release_start) {
+            madvise(reinterpret_cast<void *>(release_start), release_end - release_start, MADV_DONTNEED);
+        }
+#endif
+
         return true;
     }
 
+    std::size_t get_resident_size(void *ptr, const std::size_t size) {
+#if EKA2L1_PLATFORM(WIN32)
+        // Decommit already releases memory on Windows, so committed pages are what is being held
+        std::size_t resident = 0;
+        std::uint8_t *current = reinterpret_cast<std::uint8_t *>(ptr);
+        std::uint8_t *end = current + size;
+
+        while (current < end) {
+            MEMORY_BASIC_INFORMATION info;
+
+            if (VirtualQuery(current, &info, sizeof(info)) == 0) {
+                break;
+            }
+
+            std::uint8_t *region_end = reinterpret_cast<std::uint8_t *>(info.BaseAddress) + info.RegionSize;
+
+            if (region_end > end) {
+                region_end = end;
+            }
+
+            if (info.State == MEM_COMMIT) {
+                resident += region_end - current;
+            }
+
+            current = region_end;
+        }
+
+        return resident;
+#else
+        const std::size_t host_page_size = static_cast<std::size_t>(get_host_page_size());
+        const std::uintptr_t start = reinterpret_cast<std::uintptr_t>(ptr) & ~(host_page_size - 1);
+        const std::size_t page_count = (reinterpret_cast<std::uintptr_t>(ptr) + size - start + host_page_size - 1) / host_page_size;
+
+#if EKA2L1_PLATFORM(DARWIN)
+        std::vector<char> residency(page_count);
+#else
+        std::vector<unsigned char> residency(page_count);
+#endif
+
+        if (mincore(reinterpret_cast<void *>(start), page_count * host_page_size, residency.data()) != 0) {
+            return 0;
+        }
+
+        std::size_t resident_pages = 0;
+
+        for (const auto state : residency) {
+            if (state & 1) {
+                resident_pages++;
+            }
+        }
+
+        return resident_pages * host_page_size;
+#endif
+    }
+
+    std::size_t get_host_resident_size() {
+#if EKA2L1_PLATFORM(WIN32)
+        PROCESS_MEMORY_COUNTERS counters{};
+
+        if (!K32GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+            return 0;
+        }
+
+        return counters.WorkingSetSize;
+#elif EKA2L1_PLATFORM(DARWIN)
+        mach_task_basic_info info;
+        mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+
+        if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, reinterpret_cast<task_info_t>(&info), &count) != KERN_SUCCESS) {
+            return 0;
+        }
+
+        return info.resident_size;
+#else
+        FILE *statm = std::fopen("/proc/self/statm", "r");
+
+        if (!statm) {
+            return 0;
+        }
+
+        unsigned long total_pages = 0;
+        unsigned long resident_pages = 0;
+
+        const int matched = std::fscanf(statm, "%lu %lu", &total_pages, &resident_pages);
+        std::fclose(statm);
+
+        if (matched != 2) {
+            return 0;
+        }
+
+        return static_cast<std::size_t>(resident_pages) * get_host_page_size();
+#endif
+    }
+
     bool change_protection(void *ptr, const std::size_t size,
         const prot new_prot) {
 #if EKA2L1_PLATFORM(WIN32)
@@ -115,6 +115,7 @@ namespace eka2l1::config {
 
         bool stop_warn_touch_disabled{ false };
         bool dump_imb_range_code{ false };
+        bool record_ws_commands{ false };
         bool hide_mouse_in_screen_space{ false };
         bool nearest_neighbor_filtering{ true };
         bool integer_scaling{ true };
@@ -155,6 +156,8 @@ namespace eka2l1::config {
 		std::string btnet_password;
 		std::uint32_t btnet_discovery_mode{ 0 };
         bool extensive_logging{ false };
+        bool async_logging{ false };
+        std::uint32_t goom_host_memory_budget_mb{ 0 };     ///< Free memory requests fail past this host resident size. 0 means no budget.
 
         void serialize(const bool with_bindings = true);
         void deserialize(const bool with_bindings = true);
@@ -52,6 +52,7 @@ OPTION(fbs-enable-compression-queue, fbs_enable_compression_queue, false)
 OPTION(enable-btrace, enable_btrace, false)
 OPTION(stop-warn-touchscreen-disabled, stop_warn_touch_disabled, false)
 OPTION(dump-imb-range-code, dump_imb_range_code, false)
+OPTION(record-ws-commands, record_ws_commands, false)
 OPTION(hide-mouse-in-screen-space, hide_mouse_in_screen_space, false)
 OPTION(enable-nearest-neighbor-filter, nearest_neighbor_filtering, true)
 OPTION(integer-scaling, integer_scaling, true)
@@ -80,6 +81,8 @@ OPTION(btnet-password, btnet_password, "")
 OPTION(btnet-discovery-mode, btnet_discovery_mode, 0)
 OPTION(enable-upnp, enable_upnp, true)
 OPTION(extensive-logging, extensive_logging, false)
+OPTION(async-logging, async_logging, false)
+OPTION(goom-host-memory-budget-mb, goom_host_memory_budget_mb, 0)
 
 #ifdef OPTION
 #undef OPTION
@@ -0,0 +1,186 @@
+/*
+ * Copyright (c) 2022 EKA2L1 Team.
+ *
+ * This file is part of EKA2L1 project.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cpu/arm_factory.h>
+#include <cpu/arm_interface.h>
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace eka2l1::arm {
+    /**
+     * \brief Flat guest memory used by the lockstep harness.
+     *
+     * Every access goes through the core's memory callbacks (the TLB is never filled), so that
+     * each write can be tracked with page granularity. Only dirtied pages are compared at a block boundary.
+     */
+    class lockstep_memory {
+    public:
+        enum {
+            PAGE_BITS = 12,
+            PAGE_SIZE = 1 << PAGE_BITS
+        };
+
+    private:
+        std::vector<std::uint8_t> data_;
+        std::vector<bool> dirty_;
+
+    public:
+        explicit lockstep_memory(const std::uint32_t size);
+
+        std::uint8_t *pointer(const address addr, const std::uint32_t access_size);
+        std::uint32_t size() const {
+            return static_cast<std::uint32_t>(data_.size());
+        }
+
+        void mark_dirty(const address addr, const std::uint32_t access_size);
+        bool is_dirty(const std::uint32_t page_index) const {
+            return dirty_[page_index];
+        }
+
+        void clear_dirty();
+
+        /**
+         * \brief Bind all memory callbacks of a core to this memory.
+         */
+        void attach(core *target);
+
+        /**
+         * \brief Bind the memory callbacks of an exclusive monitor to this memory.
+         *
+         * LDREX/STREX go through the monitor instead of the core callbacks.
+         */
+        void attach(exclusive_monitor *monitor);
+    };
+
+    enum lockstep_divergence_kind {
+        lockstep_divergence_none = 0,
+        lockstep_divergence_gpr = 1,
+        lockstep_divergence_cpsr = 2,
+        lockstep_divergence_fpr = 3,
+        lockstep_divergence_fpscr = 4,
+        lockstep_divergence_memory = 5,
+        lockstep_divergence_instruction_count = 6,
+        lockstep_divergence_system_call = 7,
+        lockstep_divergence_exception = 8
+    };
+
+    struct lockstep_divergence {
+        lockstep_divergence_kind kind_ = lockstep_divergence_none;
+
+        std::uint64_t block_index_ = 0;         ///< Index of the block after which the states differ.
+        address block_start_ = 0;               ///< PC at the start of that block.
+        std::uint32_t location_ = 0;            ///< Register index or guest address, depending on the kind.
+
+        std::uint64_t reference_value_ = 0;
+        std::uint64_t subject_value_ = 0;
+
+        std::string to_string() const;
+    };
+
+    /**
+     * \brief Runs the same guest code on two CPU backends, comparing their state at every block boundary.
+     *
+     * The subject core (usually a JIT) is run first, and decides where the block ends. The reference core
+     * (usually the Dyncom interpreter) then executes exactly the same amount of instructions. Registers, VFP state,
+     * dirtied memory, system calls and exceptions are compared afterwards, and the first mismatch is reported.
+     *
+     * Each core has its own copy of the memory, so the two never observe each other's writes.
+     */
+    class lockstep_runner {
+        struct side {
+            exclusive_monitor_instance monitor_;
+            core_instance core_;
+            lockstep_memory memory_;
+
+            std::vector<std::uint32_t> system_calls_;
+            std::vector<std::pair<exception_type, std::uint32_t>> exceptions_;
+
+            explicit side(const arm_emulator_type type, const std::uint32_t memory_size);
+        };
+
+        side reference_;
+        side subject_;
+
+        std::uint64_t block_count_;
+        std::optional<lockstep_divergence> divergence_;
+
+        void setup_side(side &target);
+        void compare_after_block(const address block_start);
+
+    public:
+        explicit lockstep_runner(const arm_emulator_type reference_type, const arm_emulator_type subject_type,
+            const std::uint32_t memory_size);
+
+        /**
+         * \brief Check if both cores were successfully created.
+         *
+         * The requested backend may not be available on the current host (for example, Dynarmic on ARM32).
+         */
+        bool is_valid() const;
+
+        /**
+         * \brief Copy data to the same location of both memories.
+         */
+        bool write_memory(const address addr, const void *data, const std::uint32_t size);
+
+        /**
+         * \brief Load the same context into both cores.
+         */
+        void load_context(const core::thread_context &ctx);
+
+        /**
+         * \brief Execute one block on both cores and compare.
+         *
+         * \param max_instructions      The maximum number of instructions the subject may run in this block.
+         * \returns False if a divergence has been detected, or no instruction was executed.
+         */
+        bool step_block(const std::uint32_t max_instructions);
+
+        /**
+         * \brief Run blocks until a divergence happens, or the instruction budget is used up.
+         *
+         * \param total_instructions    Total amount of instructions to run.
+         * \param block_limit           The maximum number of instructions in a block.
+         *
+         * \returns The first divergence, if there is one.
+         */
+        std::optional<lockstep_divergence> run(const std::uint64_t total_instructions, const std::uint32_t block_limit = 64);
+
+        std::optional<lockstep_divergence> first_divergence() const {
+            return divergence_;
+        }
+
+        std::uint64_t block_count() const {
+            return block_count_;
+        }
+
+        core *reference_core() {
+            return reference_.core_.get();
+        }
+
+        core *subject_core() {
+            return subject_.core_.get();
+        }
+    };
+}
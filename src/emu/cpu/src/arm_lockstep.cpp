@@ -0,0 +1,412 @@
+/*
+ * Copyright (c) 2022 EKA2L1 Team.
+ *
+ * This file is part of EKA2L1 project.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <common/algorithm.h>
+#include <common/atomic.h>
+#include <common/log.h>
+
+#include <cpu/arm_lockstep.h>
+
+#include <fmt/format.h>
+#include <cstring>
+
+namespace eka2l1::arm {
+    lockstep_memory::lockstep_memory(const std::uint32_t size)
+        : data_(((size + PAGE_SIZE - 1) >> PAGE_BITS) << PAGE_BITS, 0)
+        , dirty_((size + PAGE_SIZE - 1) >> PAGE_BITS, false) {
+    }
+
+    std::uint8_t *lockstep_memory::pointer(const address addr, const std::uint32_t access_size) {
+        if ((static_cast<std::uint64_t>(addr) + access_size) > data_.size()) {
+            return nullptr;
+        }
+
+        return data_.data() + addr;
+    }
+
+    void lockstep_memory::mark_dirty(const address addr, const std::uint32_t access_size) {
+        const std::uint32_t page_start = addr >> PAGE_BITS;
+        const std::uint32_t page_end = (addr + access_size - 1) >> PAGE_BITS;
+
+        for (std::uint32_t i = page_start; (i <= page_end) && (i < dirty_.size()); i++) {
+            dirty_[i] = true;
+        }
+    }
+
+    void lockstep_memory::clear_dirty() {
+        std::fill(dirty_.begin(), dirty_.end(), false);
+    }
+
+    template <typename T>
+    static bool lockstep_read(lockstep_memory *mem, const address addr, T *result) {
+        std::uint8_t *ptr = mem->pointer(addr, sizeof(T));
+        if (!ptr) {
+            return false;
+        }
+
+        std::memcpy(result, ptr, sizeof(T));
+        return true;
+    }
+
+    template <typename T>
+    static bool lockstep_write(lockstep_memory *mem, const address addr, T *value) {
+        std::uint8_t *ptr = mem->pointer(addr, sizeof(T));
+        if (!ptr) {
+            return false;
+        }
+
+        std::memcpy(ptr, value, sizeof(T));
+        mem->mark_dirty(addr, sizeof(T));
+
+        return true;
+    }
+
+    template <typename T>
+    static std::int32_t lockstep_write_exclusive(lockstep_memory *mem, const address addr, T value, T expected) {
+        std::uint8_t *ptr = mem->pointer(addr, sizeof(T));
+        if (!ptr) {
+            return -1;
+        }
+
+        const bool stored = common::atomic_compare_and_swap<T>(reinterpret_cast<volatile T *>(ptr), value, expected);
+        if (stored) {
+            mem->mark_dirty(addr, sizeof(T));
+        }
+
+        return static_cast<std::int32_t>(stored);
+    }
+
+    void lockstep_memory::attach(core *target) {
+        target->read_code = [this](const address addr, std::uint32_t *data) { return lockstep_read(this, addr, data); };
+        target->read_8bit = [this](const address addr, std::uint8_t *data) { return lockstep_read(this, addr, data); };
+        target->read_16bit = [this](const address addr, std::uint16_t *data) { return lockstep_read(this, addr, data); };
+        target->read_32bit = [this](const address addr, std::uint32_t *data) { return lockstep_read(this, addr, data); };
+        target->read_64bit = [this](const address addr, std::uint64_t *data) { return lockstep_read(this, addr, data); };
+
+        target->write_8bit = [this](const address addr, std::uint8_t *data) { return lockstep_write(this, addr, data); };
+        target->write_16bit = [this](const address addr, std::uint16_t *data) { return lockstep_write(this, addr, data); };
+        target->write_32bit = [this](const address addr, std::uint32_t *data) { return lockstep_write(this, addr, data); };
+        target->write_64bit = [this](const address addr, std::uint64_t *data) { return lockstep_write(this, addr, data); };
+
+        target->exclusive_write_8bit = [this](const address addr, std::uint8_t value, std::uint8_t expected) {
+            return lockstep_write_exclusive<std::uint8_t>(this, addr, value, expected);
+        };
+
+        target->exclusive_write_16bit = [this](const address addr, std::uint16_t value, std::uint16_t expected) {
+            return lockstep_write_exclusive<std::uint16_t>(this, addr, value, expected);
+        };
+
+        target->exclusive_write_32bit = [this](const address addr, std::uint32_t value, std::uint32_t expected) {
+            return lockstep_write_exclusive<std::uint32_t>(this, addr, value, expected);
+        };
+
+        target->exclusive_write_64bit = [this](const address addr, std::uint64_t value, std::uint64_t expected) {
+            return lockstep_write_exclusive<std::uint64_t>(this, addr, value, expected);
+        };
+    }
+
+    void lockstep_memory::attach(exclusive_monitor *monitor) {
+        // Each side has its own monitor and a single core, so the requesting core does not matter
+        monitor->read_8bit = [this](core *, const address addr, std::uint8_t *data) { return lockstep_read(this, addr, data); };
+        monitor->read_16bit = [this](core *, const address addr, std::uint16_t *data) { return lockstep_read(this, addr, data); };
+        monitor->read_32bit = [this](core *, const address addr, std::uint32_t *data) { return lockstep_read(this, addr, data); };
+        monitor->read_64bit = [this](core *, const address addr, std::uint64_t *data) { return lockstep_read(this, addr, data); };
+
+        monitor->write_8bit = [this](core *, const address addr, std::uint8_t value, std::uint8_t expected) {
+            return lockstep_write_exclusive<std::uint8_t>(this, addr, value, expected);
+        };
+
+        monitor->write_16bit = [this](core *, const address addr, std::uint16_t value, std::uint16_t expected) {
+            return lockstep_write_exclusive<std::uint16_t>(this, addr, value, expected);
+        };
+
+        monitor->write_32bit = [this](core *, const address addr, std::uint32_t value, std::uint32_t expected) {
+            return lockstep_write_exclusive<std::uint32_t>(this, addr, value, expected);
+        };
+
+        monitor->write_64bit = [this](core *, const address addr, std::uint64_t value, std::uint64_t expected) {
+            return lockstep_write_exclusive<std::uint64_t>(this, addr, value, expected);
+        };
+    }
+
+    static const char *lockstep_divergence_kind_to_string(const lockstep_divergence_kind kind) {
+        switch (kind) {
+        case lockstep_divergence_none:
+            return "none";
+        case lockstep_divergence_gpr:
+            return "general register";
+        case lockstep_divergence_cpsr:
+            return "CPSR";
+        case lockstep_divergence_fpr:
+            return "VFP register";
+        case lockstep_divergence_fpscr:
+            return "FPSCR";
+        case lockstep_divergence_memory:
+            return "memory";
+        case lockstep_divergence_instruction_count:
+            return "instruction count";
+        case lockstep_divergence_system_call:
+            return "system call";
+        case lockstep_divergence_exception:
+            return "exception";
+        default:
+            break;
+        }
+
+        return "unknown";
+    }
+
+    std::string lockstep_divergence::to_string() const {
+        return fmt::format("Divergence in {} (location 0x{:X}) after block {} starting at 0x{:X}: reference=0x{:X}, subject=0x{:X}",
+            lockstep_divergence_kind_to_string(kind_), location_, block_index_, block_start_, reference_value_,
+            subject_value_);
+    }
+
+    lockstep_runner::side::side(const arm_emulator_type type, const std::uint32_t memory_size)
+        : monitor_(create_exclusive_monitor(type, 1))
+        , core_(nullptr)
+        , memory_(memory_size) {
+        if (monitor_) {
+            core_ = create_core(monitor_.get(), type);
+        }
+    }
+
+    lockstep_runner::lockstep_runner(const arm_emulator_type reference_type, const arm_emulator_type subject_type,
+        const std::uint32_t memory_size)
+        : reference_(reference_type, memory_size)
+        , subject_(subject_type, memory_size)
+        , block_count_(0) {
+        if (is_valid()) {
+            setup_side(reference_);
+            setup_side(subject_);
+        }
+    }
+
+    bool lockstep_runner::is_valid() const {
+        return reference_.core_ && subject_.core_;
+    }
+
+    void lockstep_runner::setup_side(side &target) {
+        side *target_ptr = &target;
+        core *core_ptr = target.core_.get();
+
+        target.memory_.attach(core_ptr);
+        target.memory_.attach(target.monitor_.get());
+
+        // There is no kernel behind the harness. Record what is requested, so that both sides can be compared.
+        core_ptr->system_call_handler = [target_ptr](const std::uint32_t svc) {
+            target_ptr->system_calls_.push_back(svc);
+        };
+
+        core_ptr->exception_handler = [target_ptr, core_ptr](exception_type type, const std::uint32_t data) {
+            target_ptr->exceptions_.emplace_back(type, data);
+            core_ptr->stop();
+
+            return false;
+        };
+    }
+
+    bool lockstep_runner::write_memory(const address addr, const void *data, const std::uint32_t size) {
+        std::uint8_t *ref_ptr = reference_.memory_.pointer(addr, size);
+        std::uint8_t *sub_ptr = subject_.memory_.pointer(addr, size);
+
+        if (!ref_ptr || !sub_ptr) {
+            return false;
+        }
+
+        std::memcpy(ref_ptr, data, size);
+        std::memcpy(sub_ptr, data, size);
+
+        // Code may have changed
+        reference_.core_->imb_range(addr, size);
+        subject_.core_->imb_range(addr, size);
+
+        return true;
+    }
+
+    void lockstep_runner::load_context(const core::thread_context &ctx) {
+        reference_.core_->load_context(ctx);
+        subject_.core_->load_context(ctx);
+    }
+
+    void lockstep_runner::compare_after_block(const address block_start) {
+        lockstep_divergence result;
+        result.block_index_ = block_count_;
+        result.block_start_ = block_start;
+
+        auto report = [&](const lockstep_divergence_kind kind, const std::uint32_t location, const std::uint64_t ref_value,
+                          const std::uint64_t sub_value) {
+            result.kind_ = kind;
+            result.location_ = location;
+            result.reference_value_ = ref_value;
+            result.subject_value_ = sub_value;
+
+            divergence_ = result;
+        };
+
+        core::thread_context ref_ctx;
+        core::thread_context sub_ctx;
+
+        reference_.core_->save_context(ref_ctx);
+        subject_.core_->save_context(sub_ctx);
+
+        for (std::uint32_t i = 0; i < 16; i++) {
+            if (ref_ctx.cpu_registers[i] != sub_ctx.cpu_registers[i]) {
+                report(lockstep_divergence_gpr, i, ref_ctx.cpu_registers[i], sub_ctx.cpu_registers[i]);
+                return;
+            }
+        }
+
+        if (ref_ctx.cpsr != sub_ctx.cpsr) {
+            report(lockstep_divergence_cpsr, 0, ref_ctx.cpsr, sub_ctx.cpsr);
+            return;
+        }
+
+        for (std::uint32_t i = 0; i < 64; i++) {
+            if (ref_ctx.fpu_registers[i] != sub_ctx.fpu_registers[i]) {
+                report(lockstep_divergence_fpr, i, ref_ctx.fpu_registers[i], sub_ctx.fpu_registers[i]);
+                return;
+            }
+        }
+
+        if (ref_ctx.fpscr != sub_ctx.fpscr) {
+            report(lockstep_divergence_fpscr, 0, ref_ctx.fpscr, sub_ctx.fpscr);
+            return;
+        }
+
+        const std::size_t svc_common = common::min(reference_.system_calls_.size(), subject_.system_calls_.size());
+
+        for (std::size_t i = 0; i < svc_common; i++) {
+            if (reference_.system_calls_[i] != subject_.system_calls_[i]) {
+                report(lockstep_divergence_system_call, static_cast<std::uint32_t>(i), reference_.system_calls_[i],
+                    subject_.system_calls_[i]);
+                return;
+            }
+        }
+
+        if (reference_.system_calls_.size() != subject_.system_calls_.size()) {
+            report(lockstep_divergence_system_call, static_cast<std::uint32_t>(svc_common), reference_.system_calls_.size(),
+                subject_.system_calls_.size());
+            return;
+        }
+
+        const std::size_t exception_common = common::min(reference_.exceptions_.size(), subject_.exceptions_.size());
+
+        for (std::size_t i = 0; i < exception_common; i++) {
+            if (reference_.exceptions_[i] != subject_.exceptions_[i]) {
+                report(lockstep_divergence_exception, reference_.exceptions_[i].second, reference_.exceptions_[i].first,
+                    subject_.exceptions_[i].first);
+                return;
+            }
+        }
+
+        if (reference_.exceptions_.size() != subject_.exceptions_.size()) {
+            report(lockstep_divergence_exception, static_cast<std::uint32_t>(exception_common), reference_.exceptions_.size(),
+                subject_.exceptions_.size());
+            return;
+        }
+
+        const std::uint32_t page_count = reference_.memory_.size() >> lockstep_memory::PAGE_BITS;
+
+        for (std::uint32_t page = 0; page < page_count; page++) {
+            if (!reference_.memory_.is_dirty(page) && !subject_.memory_.is_dirty(page)) {
+                continue;
+            }
+
+            const address page_addr = page << lockstep_memory::PAGE_BITS;
+            const std::uint8_t *ref_page = reference_.memory_.pointer(page_addr, lockstep_memory::PAGE_SIZE);
+            const std::uint8_t *sub_page = subject_.memory_.pointer(page_addr, lockstep_memory::PAGE_SIZE);
+
+            if (std::memcmp(ref_page, sub_page, lockstep_memory::PAGE_SIZE) == 0) {
+                continue;
+            }
+
+            for (std::uint32_t off = 0; off < lockstep_memory::PAGE_SIZE; off++) {
+                if (ref_page[off] != sub_page[off]) {
+                    report(lockstep_divergence_memory, page_addr + off, ref_page[off], sub_page[off]);
+                    return;
+                }
+            }
+        }
+    }
+
+    bool lockstep_runner::step_block(const std::uint32_t max_instructions) {
+        if (!is_valid() || divergence_.has_value()) {
+            return false;
+        }
+
+        // Only what this block did is compared, so that an earlier mismatch is not reported again
+        for (side *target : { &reference_, &subject_ }) {
+            target->memory_.clear_dirty();
+            target->system_calls_.clear();
+            target->exceptions_.clear();
+        }
+
+        const address block_start = subject_.core_->get_pc();
+
+        // The subject decides where the block ends. The reference then runs the exact same amount.
+        subject_.core_->run(max_instructions);
+        const std::uint32_t executed = subject_.core_->get_num_instruction_executed();
+
+        std::uint32_t ref_executed = 0;
+
+        if (executed != 0) {
+            reference_.core_->run(executed);
+            ref_executed = reference_.core_->get_num_instruction_executed();
+        }
+
+        if (ref_executed != executed) {
+            lockstep_divergence result;
+            result.kind_ = lockstep_divergence_instruction_count;
+            result.block_index_ = block_count_;
+            result.block_start_ = block_start;
+            result.reference_value_ = ref_executed;
+            result.subject_value_ = executed;
+
+            divergence_ = result;
+        } else {
+            compare_after_block(block_start);
+        }
+
+        if (divergence_.has_value()) {
+            LOG_ERROR(CPU, "{}", divergence_->to_string());
+            return false;
+        }
+
+        block_count_++;
+        return (executed != 0);
+    }
+
+    std::optional<lockstep_divergence> lockstep_runner::run(const std::uint64_t total_instructions, const std::uint32_t block_limit) {
+        std::uint64_t executed = 0;
+
+        while (executed < total_instructions) {
+            const std::uint32_t max_this_block = static_cast<std::uint32_t>(common::min<std::uint64_t>(block_limit,
+                total_instructions - executed));
+
+            if (!step_block(max_this_block)) {
+                break;
+            }
+
+            executed += subject_.core_->get_num_instruction_executed();
+        }
+
+        return divergence_;
+    }
+}
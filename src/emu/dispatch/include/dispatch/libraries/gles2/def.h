@@ -22,6 +22,7 @@
 #include <dispatch/libraries/gles_shared/def.h>
 #include <dispatch/libraries/gles2/consts.h>
 #include <drivers/graphics/graphics.h>
+#include <drivers/graphics/uniform_arena.h>
 #include <common/vecx.h>
 
 #include <array>
@@ -51,8 +52,14 @@ namespace eka2l1::dispatch {
         bool delete_pending_;
         bool source_changed_;
 
+        // The compilation is queued to the driver, and only waited on when its result is needed
+        drivers::graphics_driver *compile_driver_;
+        int compile_status_;
+        bool compile_pending_;
+
         std::vector<gles_program_object*> attached_programs_;
         void cleanup_current_driver_module();
+        void wait_for_compile();
 
     public:
         explicit gles_shader_object(egl_context_es_shared &ctx, const drivers::shader_module_type module_type);
@@ -68,7 +75,8 @@ namespace eka2l1::dispatch {
             return source_;
         }
 
-        const std::string get_compile_info() const {
+        const std::string get_compile_info() {
+            wait_for_compile();
             return compile_info_;
         }
 
@@ -76,7 +84,8 @@ namespace eka2l1::dispatch {
             return static_cast<std::uint32_t>(source_.length());
         }
 
-        const std::uint32_t get_compile_info_length() const {
+        const std::uint32_t get_compile_info_length() {
+            wait_for_compile();
             return static_cast<std::uint32_t>(compile_info_.length());
         }
 
@@ -84,7 +93,8 @@ namespace eka2l1::dispatch {
             return module_type_;
         }
 
-        const bool is_last_compile_ok() const {
+        const bool is_last_compile_ok() {
+            wait_for_compile();
             return compile_ok_;
         }
 
@@ -97,21 +107,6 @@ namespace eka2l1::dispatch {
         }
     };
 
-    struct gles_uniform_variable_data_info {
-        enum {
-            EXTRA_FLAG_MATRIX_NEED_TRANSPOSE = 1 << 0
-        };
-
-        std::vector<std::uint8_t> data_;
-        drivers::shader_var_type cached_var_type_;
-        std::uint32_t extra_flags_;
-
-        explicit gles_uniform_variable_data_info()
-            : cached_var_type_(drivers::shader_var_type::none)
-            , extra_flags_(0) {
-        }
-    };
-
     struct gles_program_object: public gles_driver_object {
     private:
         gles_shader_object *attached_vertex_shader_;
@@ -126,14 +121,23 @@ namespace eka2l1::dispatch {
 
         drivers::shader_program_metadata metadata_;
 
-        std::map<int, gles_uniform_variable_data_info> uniform_datas_;
-        std::set<int> dirty_uniform_locations_;
+        // Same as shader compilation, the link is resolved on first use of its result
+        drivers::graphics_driver *link_driver_;
+        int link_status_;
+        bool link_pending_;
+
+        drivers::uniform_arena uniform_arena_;
+        std::vector<std::uint8_t> uniform_upload_staging_;
         std::map<int, int> attrib_bind_routes_;
         std::map<int, int> attrib_bind_routes_reverse_;
         std::map<std::string, int> pending_attrib_binds_;
+        std::map<std::string, int> linking_attrib_binds_;
  
         void cleanup_current_driver_program();
         void delete_from_object_store();
+        void build_uniform_arena();
+        void apply_attribute_routes(std::map<std::string, int> &binds);
+        void wait_for_link();
 
     public:
         explicit gles_program_object(egl_context_es_shared &ctx);
@@ -147,22 +151,25 @@ namespace eka2l1::dispatch {
         void delete_object();
 
         std::uint32_t set_uniform_data(const int binding, const std::uint8_t *data, const std::int32_t data_size,
-            const std::int32_t actual_count, drivers::shader_var_type var_type, const std::uint32_t extra_flags);
+            const std::int32_t actual_count, drivers::shader_var_type var_type, const std::uint16_t flags);
 
         void bind_attribute_to_index(const std::string &attrib_name, const int new_index);
         std::optional<int> get_routed_attribute_num(const int original_index, const bool reverse = false);
 
         bool prepare_for_draw();
 
-        const std::string &get_link_log() const {
+        const std::string &get_link_log() {
+            wait_for_link();
             return link_log_;
         }
 
-        const std::int32_t get_link_log_length() const {
+        const std::int32_t get_link_log_length() {
+            wait_for_link();
             return static_cast<std::int32_t>(link_log_.length());
         }
 
-        const bool is_linked() const {
+        const bool is_linked() {
+            wait_for_link();
             return linked_;
         }
 
@@ -178,23 +185,28 @@ namespace eka2l1::dispatch {
             return (attached_vertex_shader_ ? (attached_fragment_shader_ ? 2 : 1) : 0);
         }
 
-        const std::int32_t active_attributes_count() const {
+        const std::int32_t active_attributes_count() {
+            wait_for_link();
             return linked_ ? metadata_.get_attribute_count() : 0;
         }
 
-        const std::int32_t active_uniforms_count() const {
+        const std::int32_t active_uniforms_count() {
+            wait_for_link();
             return linked_ ? metadata_.get_uniform_count() : 0;
         }
 
-        const std::int32_t active_attribute_max_name_length() const {
+        const std::int32_t active_attribute_max_name_length() {
+            wait_for_link();
             return linked_ ? metadata_.get_attribute_max_name_length() : 0;
         }
         
-        const std::int32_t active_uniform_max_name_length() const {
+        const std::int32_t active_uniform_max_name_length() {
+            wait_for_link();
             return linked_ ? metadata_.get_uniform_max_name_length() : 0;
         }
 
-        const drivers::shader_program_metadata *get_readonly_metadata() const {
+        const drivers::shader_program_metadata *get_readonly_metadata() {
+            wait_for_link();
             return linked_ ? &metadata_ : nullptr;
         }
 
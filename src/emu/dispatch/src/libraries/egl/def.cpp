@@ -57,12 +57,21 @@ namespace eka2l1::dispatch {
 
         if (backed_window_) {
             backed_window_->add_canvas_observer(this);
+
+            if (backed_window_->win_type == epoc::window_type::backed_up) {
+                // Swaps happen every frame, do not stall on reading the content back to the window's bitmap
+                static_cast<epoc::bitmap_backed_canvas *>(backed_window_)->set_async_readback(true);
+            }
         }
     }
     
     egl_surface::~egl_surface() {
         if (backed_window_) {
             backed_window_->remove_canvas_observer(this);
+
+            if (backed_window_->win_type == epoc::window_type::backed_up) {
+                static_cast<epoc::bitmap_backed_canvas *>(backed_window_)->set_async_readback(false);
+            }
         }
     }
     
@@ -23,6 +23,7 @@
 
 #include <dispatch/dispatcher.h>
 #include <drivers/graphics/graphics.h>
+#include <drivers/graphics/shader.h>
 #include <system/epoc.h>
 #include <services/window/screen.h>
 #include <kernel/kernel.h>
@@ -73,7 +74,10 @@ namespace eka2l1::dispatch {
         , module_type_(module_type)
         , compile_ok_(false)
         , delete_pending_(false)
-        , source_changed_(false) {
+        , source_changed_(false)
+        , compile_driver_(nullptr)
+        , compile_status_(0)
+        , compile_pending_(false) {
     }
 
     void gles_shader_object::compile(drivers::graphics_driver *drv) {
@@ -82,10 +86,13 @@ namespace eka2l1::dispatch {
             return;
         }
 
-        std::string changed_source = source_;
+        // The previous compilation still writes to the info log and the status
+        wait_for_compile();
 
-        if (changed_source.substr(0, 8) == "#version") {
-            std::size_t pos = changed_source.find_first_of('\n');
+        std::size_t body_start = 0;
+
+        if (source_.compare(0, 8, "#version") == 0) {
+            std::size_t pos = source_.find_first_of('\n');
             if (pos == std::string::npos) {
                 compile_ok_ = false;
                 compile_info_ = "ERROR: Shader has empty content!";
@@ -93,55 +100,66 @@ namespace eka2l1::dispatch {
 
                 return;
             }
-            changed_source.erase(changed_source.begin(), changed_source.begin() + pos + 1);
+
+            body_start = pos + 1;
         }
 
-        // Add version and qualifiers for shader that is missing it
+        // Add version and qualifiers for shader that is missing it. The new source is built in one go
+        std::string changed_source;
+        changed_source.reserve(source_.size() - body_start + 64);
+
         if (drv->is_stricted()) {
-            changed_source.insert(0, "#version 100\n");
+            changed_source += "#version 100\n";
 
-            std::string str_precision;
-            if (module_type_ == drivers::shader_module_type::fragment) {
-                str_precision += "precision mediump float;\n";
-            } else {
-                str_precision += "precision highp float;\n";
-            }
+            const char *str_precision = (module_type_ == drivers::shader_module_type::fragment) ? "precision mediump float;\n" :
+                "precision highp float;\n";
 
-            std::size_t pos_to_insert = changed_source.rfind("extension");
-            if (pos_to_insert != std::string::npos) {
-                std::size_t pos_to_end_insert = changed_source.find("\n", pos_to_insert);
+            std::size_t pos_to_insert = source_.rfind("extension");
+            if ((pos_to_insert != std::string::npos) && (pos_to_insert >= body_start)) {
+                std::size_t pos_to_end_insert = source_.find("\n", pos_to_insert);
                 if (pos_to_end_insert != std::string::npos) {
-                    changed_source.insert(pos_to_end_insert + 1, str_precision);
+                    changed_source.append(source_, body_start, pos_to_end_insert + 1 - body_start);
+                    changed_source += str_precision;
+                    changed_source.append(source_, pos_to_end_insert + 1, std::string::npos);
+                } else {
+                    changed_source.append(source_, body_start, std::string::npos);
                 }
             } else {
-                // 13 = strlen(#version 100\n)
-                changed_source.insert(13, str_precision);
+                changed_source += str_precision;
+                changed_source.append(source_, body_start, std::string::npos);
             }
         } else {
-            changed_source.insert(0, "#version 120\n");
+            changed_source += "#version 120\n";
 
             if (!drv->support_extension(drivers::graphics_driver_extension_float_precision_qualifier)) {
-                changed_source = common::replace_all(changed_source, "precision mediump float", "");
-                changed_source = common::replace_all(changed_source, "precision highp float", "");
-                changed_source = common::replace_all(changed_source, "precision lowp float", "");
-                changed_source = common::replace_all(changed_source, "highp", "");
-                changed_source = common::replace_all(changed_source, "lowp", "");
-                changed_source = common::replace_all(changed_source, "mediump", "");
+                drivers::append_glsl_without_precision_qualifiers(changed_source, source_, body_start);
+            } else {
+                changed_source.append(source_, body_start, std::string::npos);
             }
         }
 
         cleanup_current_driver_module();
-        driver_handle_ = drivers::create_shader_module(drv, changed_source.data(), changed_source.length(), module_type_, &compile_info_);
 
-        if (!driver_handle_) {
-            compile_ok_ = false;
-        } else {
-            compile_ok_ = true;
-        }
+        driver_handle_ = drivers::create_shader_module_async(drv, changed_source.data(), changed_source.length(), module_type_,
+            &compile_info_, &compile_status_);
 
+        compile_driver_ = drv;
+        compile_pending_ = true;
+        compile_ok_ = false;
         source_changed_ = false;
     }
 
+    void gles_shader_object::wait_for_compile() {
+        if (!compile_pending_) {
+            return;
+        }
+
+        compile_driver_->wait_for(&compile_status_);
+
+        compile_ok_ = (compile_status_ == 0);
+        compile_pending_ = false;
+    }
+
     void gles_shader_object::cleanup_current_driver_module() {
         if (driver_handle_) {
             egl_context_es2 &es2_ctx = static_cast<egl_context_es2&>(context_);
@@ -182,8 +200,7 @@ namespace eka2l1::dispatch {
             es2_ctx.linked_program_cleanup_.push(driver_handle_);
         }
 
-        dirty_uniform_locations_.clear();
-        uniform_datas_.clear();
+        uniform_arena_.clear();
     }
     
     void gles_shader_object::delete_object() {
@@ -201,10 +218,17 @@ namespace eka2l1::dispatch {
         , attached_fragment_shader_(nullptr)
         , linked_(false)
         , one_module_changed_(false)
-        , delete_pending_(false) {
+        , delete_pending_(false)
+        , link_driver_(nullptr)
+        , link_status_(0)
+        , link_pending_(false) {
     }
 
     gles_program_object::~gles_program_object() {
+        if (link_pending_) {
+            link_driver_->wait_for(&link_status_);
+        }
+
         cleanup_current_driver_program();
 
         if (attached_vertex_shader_) {
@@ -289,9 +313,12 @@ namespace eka2l1::dispatch {
     }
 
     void gles_program_object::link(drivers::graphics_driver *drv) {
+        // The previous link still writes to the log, the metadata and the status
+        wait_for_link();
+
         if (!one_module_changed_) {
             if (linked_) {
-                goto APPLY_PENDING_ROUTES;
+                apply_attribute_routes(pending_attrib_binds_);
             }
 
             return;
@@ -304,17 +331,42 @@ namespace eka2l1::dispatch {
             return;
         }
 
-        driver_handle_ = drivers::create_shader_program(drv, attached_vertex_shader_->handle_value(), attached_fragment_shader_->handle_value(),
-            &metadata_, &link_log_);
+        metadata_.metadata_ = nullptr;
+
+        // Attribute binds made from now on only apply to the next link
+        linking_attrib_binds_ = std::move(pending_attrib_binds_);
+        pending_attrib_binds_.clear();
 
-        linked_ = (driver_handle_ != 0);
+        driver_handle_ = drivers::create_shader_program_async(drv, attached_vertex_shader_->handle_value(), attached_fragment_shader_->handle_value(),
+            &metadata_, &link_log_, &link_status_);
+
+        link_driver_ = drv;
+        link_pending_ = true;
         one_module_changed_ = false;
+    }
+
+    void gles_program_object::wait_for_link() {
+        if (!link_pending_) {
+            return;
+        }
+
+        link_driver_->wait_for(&link_status_);
 
-APPLY_PENDING_ROUTES:
+        linked_ = (link_status_ == 0);
+        link_pending_ = false;
+
+        if (linked_) {
+            build_uniform_arena();
+        }
+
+        apply_attribute_routes(linking_attrib_binds_);
+    }
+
+    void gles_program_object::apply_attribute_routes(std::map<std::string, int> &binds) {
         attrib_bind_routes_.clear();
         attrib_bind_routes_reverse_.clear();
 
-        for (const auto &route_request: pending_attrib_binds_) {
+        for (const auto &route_request: binds) {
             const std::int32_t res = metadata_.get_attribute_binding(route_request.first.c_str());
             if (res >= 0) {
                 attrib_bind_routes_.emplace(route_request.second, res);
@@ -322,7 +374,7 @@ APPLY_PENDING_ROUTES:
             }
         }
 
-        pending_attrib_binds_.clear();
+        binds.clear();
     }
     
     void gles_program_object::bind_attribute_to_index(const std::string &attrib_name, const int new_index) {
@@ -330,6 +382,8 @@ APPLY_PENDING_ROUTES:
     }
 
     std::optional<int> gles_program_object::get_routed_attribute_num(const int original_index, const bool reverse) {
+        wait_for_link();
+
         std::map<int, int> *map_to_search = &attrib_bind_routes_;
         if (reverse) {
             map_to_search = &attrib_bind_routes_reverse_;
@@ -343,8 +397,23 @@ APPLY_PENDING_ROUTES:
         return std::nullopt;
     }
 
+    void gles_program_object::build_uniform_arena() {
+        std::string name;
+        std::int32_t binding = 0;
+        std::int32_t array_size = 0;
+        drivers::shader_var_type var_type = drivers::shader_var_type::none;
+
+        for (std::int32_t i = 0; i < metadata_.get_uniform_count(); i++) {
+            if (metadata_.get_uniform_info(i, name, binding, var_type, array_size)) {
+                uniform_arena_.add_variable(binding, var_type, array_size);
+            }
+        }
+    }
+
     std::uint32_t gles_program_object::set_uniform_data(const int binding, const std::uint8_t *data, const std::int32_t data_size,
-        const std::int32_t actual_count, drivers::shader_var_type var_type, const std::uint32_t extra_flags) {
+        const std::int32_t actual_count, drivers::shader_var_type var_type, const std::uint16_t flags) {
+        wait_for_link();
+
         if (!linked_) {
             return GL_INVALID_OPERATION;
         }
@@ -353,62 +422,33 @@ APPLY_PENDING_ROUTES:
             return GL_INVALID_VALUE;
         }
 
-        auto cached_ite = uniform_datas_.find(binding);
-        if (cached_ite != uniform_datas_.end()) {
-            gles_uniform_variable_data_info &cached_data = cached_ite->second;
-            if (cached_data.cached_var_type_ != var_type) {
-                return GL_INVALID_OPERATION;
-            }
-
-            cached_data.data_.resize(data_size);
-            cached_data.extra_flags_ = extra_flags;
-            std::memcpy(cached_data.data_.data(), data, data_size);
-            dirty_uniform_locations_.insert(binding);
-
-            return GL_NO_ERROR;
+        const drivers::uniform_arena_variable *variable = uniform_arena_.get_variable(binding);
+        if (!variable) {
+            return GL_INVALID_OPERATION;
         }
 
-        std::string name;
-        std::int32_t current_iterate_binding = 0;
-        std::int32_t current_iterate_array_size = 0;
-        drivers::shader_var_type current_iterate_var_type = drivers::shader_var_type::none;
-
-        bool found = false;
-
-        for (std::int32_t i = 0; i < metadata_.get_uniform_count(); i++) {
-            metadata_.get_uniform_info(i, name, current_iterate_binding, current_iterate_var_type, current_iterate_array_size);
-            if (binding == current_iterate_binding) {
-                if ((current_iterate_array_size == 1) && (actual_count > 1)) {
-                    return GL_INVALID_OPERATION;
-                }
-                if ((current_iterate_var_type == drivers::shader_var_type::sampler2d) || (current_iterate_var_type == drivers::shader_var_type::sampler_cube)) {
-                    if (var_type != drivers::shader_var_type::integer) {
-                        return GL_INVALID_OPERATION;
-                    }
-                }
-                found = true;
-                break;
-            }
+        if ((variable->cached_var_type_ != drivers::shader_var_type::none) && (variable->cached_var_type_ != var_type)) {
+            return GL_INVALID_OPERATION;
         }
 
-        if (!found) {
+        if ((variable->array_size_ == 1) && (actual_count > 1)) {
             return GL_INVALID_OPERATION;
         }
-        
-        gles_uniform_variable_data_info info_push;
 
-        info_push.data_.resize(data_size);
-        info_push.extra_flags_ = extra_flags;
-        info_push.cached_var_type_ = var_type;
-
-        std::memcpy(info_push.data_.data(), data, data_size);
-        uniform_datas_.emplace(binding, std::move(info_push));
-        dirty_uniform_locations_.insert(binding);
+        if ((variable->declared_var_type_ == drivers::shader_var_type::sampler2d) || (variable->declared_var_type_ == drivers::shader_var_type::sampler_cube)) {
+            if (var_type != drivers::shader_var_type::integer) {
+                return GL_INVALID_OPERATION;
+            }
+        }
 
+        // Values past the end of the array are ignored
+        uniform_arena_.write(binding, data, static_cast<std::uint32_t>(data_size), var_type, flags);
         return GL_NO_ERROR;
     }
 
     bool gles_program_object::prepare_for_draw() {
+        wait_for_link();
+
         if (!linked_) {
             return false;
         }
@@ -417,40 +457,16 @@ APPLY_PENDING_ROUTES:
             context_.cmd_builder_.use_program(driver_handle_);
         }
 
-        for (int dirty_location: dirty_uniform_locations_) {
-            const gles_uniform_variable_data_info &info = uniform_datas_[dirty_location];
-            if (info.extra_flags_ & gles_uniform_variable_data_info::EXTRA_FLAG_MATRIX_NEED_TRANSPOSE) {
-                // Manual transpose
-                std::uint32_t width = 2;
-
-                if (info.cached_var_type_ == drivers::shader_var_type::mat2) {
-                    width = 2;
-                } else if (info.cached_var_type_ == drivers::shader_var_type::mat3) {
-                    width = 3;
-                } else {
-                    width = 4;
-                }
-
-                float data_temp[16]; 
-                std::memcpy(data_temp, info.data_.data(), info.data_.size());
-
-                for (std::uint32_t i = 0; i < width; i++) {
-                    for (std::uint32_t j = i + 1; j < width; j++) {
-                        std::swap(data_temp[i * width + j], data_temp[j * width + i]);
-                    }
-                }
-
-                context_.cmd_builder_.set_dynamic_uniform(dirty_location, info.cached_var_type_, data_temp, info.data_.size());
-            } else {
-                context_.cmd_builder_.set_dynamic_uniform(dirty_location, info.cached_var_type_, info.data_.data(), info.data_.size());
-            }
+        // Pack every changed uniform into one upload. The staging buffer keeps its capacity between draws.
+        if (uniform_arena_.pack_dirty(uniform_upload_staging_)) {
+            context_.cmd_builder_.set_dynamic_uniforms(uniform_upload_staging_.data(), uniform_upload_staging_.size());
         }
 
-        dirty_uniform_locations_.clear();
         return true;
     }
 
     gles_shader_object::~gles_shader_object() {
+        wait_for_compile();
         cleanup_current_driver_module();
     }
     
@@ -2384,7 +2400,7 @@ APPLY_PENDING_ROUTES:
     }
 
     static void set_uniform_value_gles2(system *sys, int binding, void *data, std::int32_t total_size,
-        std::int32_t count, drivers::shader_var_type var_type, std::uint32_t extra_flags) {
+        std::int32_t count, drivers::shader_var_type var_type, std::uint16_t flags) {
         egl_context_es2 *ctx = get_es2_active_context(sys);
         if (!ctx) {
             return;
@@ -2399,7 +2415,7 @@ APPLY_PENDING_ROUTES:
         }
 
         std::uint32_t res = ctx->using_program_->set_uniform_data(binding, reinterpret_cast<const std::uint8_t*>(data), total_size,
-            count, var_type, extra_flags);
+            count, var_type, flags);
 
         if (res != GL_NO_ERROR) {
             controller.push_error(ctx, res);
@@ -2477,15 +2493,15 @@ APPLY_PENDING_ROUTES:
     }
     
     BRIDGE_FUNC_LIBRARY(void, gl_uniform_matrix_2fv_emu, int location, std::int32_t count, bool transpose, float *value) {
-        set_uniform_value_gles2(sys, location, value, 16 * count, count, drivers::shader_var_type::mat2, transpose ? gles_uniform_variable_data_info::EXTRA_FLAG_MATRIX_NEED_TRANSPOSE : 0);
+        set_uniform_value_gles2(sys, location, value, 16 * count, count, drivers::shader_var_type::mat2, transpose ? drivers::uniform_batch_entry_flag_transpose : 0);
     }
 
     BRIDGE_FUNC_LIBRARY(void, gl_uniform_matrix_3fv_emu, int location, std::int32_t count, bool transpose, float *value) {
-        set_uniform_value_gles2(sys, location, value, 36 * count, count, drivers::shader_var_type::mat3, transpose ? gles_uniform_variable_data_info::EXTRA_FLAG_MATRIX_NEED_TRANSPOSE : 0);
+        set_uniform_value_gles2(sys, location, value, 36 * count, count, drivers::shader_var_type::mat3, transpose ? drivers::uniform_batch_entry_flag_transpose : 0);
     }
 
     BRIDGE_FUNC_LIBRARY(void, gl_uniform_matrix_4fv_emu, int location, std::int32_t count, bool transpose, float *value) {
-        set_uniform_value_gles2(sys, location, value, 64 * count, count, drivers::shader_var_type::mat4, transpose ? gles_uniform_variable_data_info::EXTRA_FLAG_MATRIX_NEED_TRANSPOSE : 0);
+        set_uniform_value_gles2(sys, location, value, 64 * count, count, drivers::shader_var_type::mat4, transpose ? drivers::uniform_batch_entry_flag_transpose : 0);
     }
     
     BRIDGE_FUNC_LIBRARY(void, gl_enable_vertex_attrib_array_emu, int index) {
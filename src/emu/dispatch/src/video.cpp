@@ -190,10 +190,10 @@ namespace eka2l1::dispatch {
             const std::lock_guard<std::mutex> guard(posting.target_window_->scr->screen_mutex);
 
             if (!image_handle_) {
-                image_handle_ = drivers::create_texture(driver_, 2, 0, drivers::texture_format::rgba, drivers::texture_format::rgba,
+                image_handle_ = drivers::create_texture(driver_, 2, 0, drivers::texture_format::yuv420p, drivers::texture_format::yuv420p,
                     drivers::texture_data_type::ubyte, buffer_data, buffer_size, vid_size_v3);
             } else {
-                posting.target_window_->driver_builder_.update_texture(image_handle_, reinterpret_cast<const char*>(buffer_data), buffer_size, 0, drivers::texture_format::rgba,
+                posting.target_window_->driver_builder_.update_texture(image_handle_, reinterpret_cast<const char*>(buffer_data), buffer_size, 0, drivers::texture_format::yuv420p,
                     drivers::texture_data_type::ubyte, eka2l1::vec3(0, 0, 0), vid_size_v3);
             }
 
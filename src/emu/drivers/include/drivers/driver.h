@@ -119,6 +119,14 @@ namespace eka2l1::drivers {
             cond_.wait(ulock, [&]() { return (*status != -100) || aborted(); });
         }
 
+        /**
+         * \brief Check if a command submitted with the given status has been processed, without waiting.
+         */
+        bool is_finished(int *status) {
+            std::unique_lock<std::mutex> ulock(mut_);
+            return (*status != -100);
+        }
+
         void finish(int *status, const int code) {
             if (status) {
                 std::unique_lock<std::mutex> ulock(mut_);
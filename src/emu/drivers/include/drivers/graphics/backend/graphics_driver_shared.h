@@ -33,8 +33,6 @@
 #include <common/vecx.h>
 
 namespace eka2l1::drivers {
-    #define HANDLE_BITMAP (1ULL << 32)
-
     /**
      * \brief Bitmap is basically a texture. It can be drawn into and can be taken to draw.
      */
@@ -71,7 +69,7 @@ namespace eka2l1::drivers {
         glm::mat4 projection_matrix;
         eka2l1::vecx<float, 4> brush_color;
 
-        drivers::handle append_graphics_object(graphics_object_instance &instance);
+        drivers::handle append_graphics_object(graphics_object_instance &instance, const drivers::handle reserved = 0);
         bool delete_graphics_object(const drivers::handle handle);
         graphics_object *get_graphics_object(const drivers::handle num);
 
@@ -60,6 +60,7 @@ namespace eka2l1::drivers {
         OGL_FEATURE_SUPPORT_PVRTC = 1 << 1,
         OGL_FEATURE_SUPPORT_ANISOTROPHY = 1 << 2,
         OGL_FEATURE_COMPABILITY_ES31 = 1 << 3,
+        OGL_FEATURE_SUPPORT_PROGRAM_BINARY = 1 << 4,
         OGL_MAX_FEATURE = 2
     };
 
@@ -71,6 +72,7 @@ namespace eka2l1::drivers {
         std::unique_ptr<ogl_shader_program> mask_program;
         std::unique_ptr<ogl_shader_program> pen_program;
         std::unique_ptr<ogl_shader_program> upscale_program;
+        std::unique_ptr<ogl_shader_program> yuv_program;
 
         GLuint sprite_vao;
         GLuint sprite_vbo;
@@ -116,6 +118,15 @@ namespace eka2l1::drivers {
         GLint in_position_loc_upscale;
         GLint in_texcoord_loc_upscale;
 
+        GLint color_loc_yuv;
+        GLint proj_loc_yuv;
+        GLint model_loc_yuv;
+        GLint y_plane_loc_yuv;
+        GLint u_plane_loc_yuv;
+        GLint v_plane_loc_yuv;
+        GLint in_position_loc_yuv;
+        GLint in_texcoord_loc_yuv;
+
         GLint color_loc_pen;
         GLint proj_loc_pen;
         GLint model_loc_pen;
@@ -135,11 +146,13 @@ namespace eka2l1::drivers {
         void *new_surface;
         bool is_gles;
         bool support_line_width_;
+        bool yuv_program_tried_;
 
         float point_size;
         pen_style line_style;
 
         std::uint32_t feature_flags_;
+        std::uint64_t program_binary_salt_;
         std::unique_ptr<graphics::gl_context> context_;
         std::string pending_upscale_shader_;
         std::string active_upscale_shader_;
@@ -174,7 +187,11 @@ namespace eka2l1::drivers {
         void set_front_face_rule(command &cmd);
         void set_color_mask(command &cmd);
         void set_depth_func(command &cmd);
+        bool upload_uniform(const int binding, const shader_var_type var_type, const void *data, const std::size_t size,
+            const bool transpose);
+
         void set_uniform(command &cmd);
+        void set_uniforms(command &cmd);
         void set_texture_for_shader(command &cmd);
         void bind_vertex_buffers(command &cmd);
         void bind_index_buffer(command &cmd);
@@ -219,6 +236,22 @@ namespace eka2l1::drivers {
             return feature_flags_ & feature_mask;
         }
 
+        /**
+         * @brief Get the hash of the GL vendor, renderer and version strings.
+         *
+         * Program binaries are only valid for the driver that produced them, so this is mixed into their cache key.
+         */
+        std::uint64_t program_binary_salt() const {
+            return program_binary_salt_;
+        }
+
+        /**
+         * @brief Compile the program that converts YUV420 planes to RGB while drawing, if not done yet.
+         *
+         * @returns False if the program is unavailable. YUV textures must then be converted on the CPU.
+         */
+        bool prepare_yuv_program();
+
         bool aborted() const override {
             return should_stop.load();
         }
@@ -9,6 +9,7 @@ namespace eka2l1::drivers {
     class ogl_shader_module : public shader_module {
     private:
         std::uint32_t shader;
+        std::uint64_t source_hash_;
 
     public:
         ~ogl_shader_module() override;
@@ -23,6 +24,15 @@ namespace eka2l1::drivers {
         std::uint32_t shader_handle() const {
             return shader;
         }
+
+        /**
+         * @brief Get the hash of the source code this module was compiled from.
+         *
+         * Used as part of the key for the on-disk program binary cache.
+         */
+        std::uint64_t source_hash() const {
+            return source_hash_;
+        }
     };
 
     class ogl_shader_program: public shader_program {
@@ -30,6 +40,9 @@ namespace eka2l1::drivers {
         std::uint32_t program;
         std::uint8_t *metadata;
 
+        bool load_cached_binary(const std::string &path);
+        void save_cached_binary(const std::string &path);
+
     public:
         explicit ogl_shader_program();
         ~ogl_shader_program() override;
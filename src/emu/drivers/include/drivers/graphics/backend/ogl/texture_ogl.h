@@ -15,9 +15,13 @@ namespace eka2l1::drivers {
         std::size_t pixels_per_line;
 
         std::uint32_t texture{ 0 };
+        std::uint32_t chroma_textures[2]{ 0, 0 };
+
         int last_tex{ 0 };
         int last_active{ 0 };
 
+        void upload_yuv420p_planes(const void *data, const bool allocate);
+
     public:
         ogl_texture() {}
         ~ogl_texture() override;
@@ -57,6 +61,15 @@ namespace eka2l1::drivers {
         std::uint64_t driver_handle() override {
             return texture;
         }
+
+        /**
+         * @brief Get the GL texture of a chroma plane. Only valid for YUV420 textures.
+         *
+         * @param index     0 for U plane, 1 for V plane.
+         */
+        std::uint32_t chroma_plane_handle(const int index) const {
+            return chroma_textures[index];
+        }
     };
     
     class ogl_renderbuffer: public renderbuffer {
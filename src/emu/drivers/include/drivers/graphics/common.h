@@ -128,7 +128,8 @@ namespace eka2l1::drivers {
         pvrtc_4bppv1_rgb,
         pvrtc_2bppv1_rgb,
         pvrtc_4bppv1_rgba,
-        pvrtc_2bppv1_rgba
+        pvrtc_2bppv1_rgba,
+        yuv420p                 // Y plane, then quarter-sized U and V planes, tightly packed
     };
 
     enum class texture_data_type : std::uint16_t {
@@ -28,6 +28,8 @@
 
 #include <functional>
 #include <memory>
+#include <mutex>
+#include <vector>
 
 namespace eka2l1::drivers {
     enum graphics_driver_opcode : std::uint16_t {
@@ -82,6 +84,7 @@ namespace eka2l1::drivers {
         graphics_driver_set_texture_anisotrophy,
         graphics_driver_use_program,
         graphics_driver_set_uniform,
+        graphics_driver_set_uniforms,
         graphics_driver_bind_texture,
         graphics_driver_bind_vertex_buffers,
         graphics_driver_bind_index_buffer,
@@ -119,12 +122,40 @@ namespace eka2l1::drivers {
 
     using display_hook = std::function<void()>;
 
+    #define HANDLE_BITMAP (1ULL << 32)
+
+    /**
+     * \brief Thread-safe pool of handle numbers.
+     *
+     * Clients may reserve a number before the object exists, so that its creation can be queued like
+     * any other command. The driver gives the number back once the object is destroyed.
+     */
+    class graphics_handle_pool {
+        std::mutex lock_;
+        std::vector<drivers::handle> free_;
+        std::vector<bool> in_use_;
+
+    public:
+        /**
+         * \brief Reserve a handle number. Numbers start from 1.
+         */
+        drivers::handle reserve();
+
+        /**
+         * \brief Give a handle number back. Numbers that are not reserved are ignored.
+         */
+        void release(const drivers::handle h);
+    };
+
     class graphics_driver : public driver {
         graphic_api api_;
 
     protected:
         display_hook disp_hook_;
 
+        graphics_handle_pool bitmap_handles_;
+        graphics_handle_pool object_handles_;
+
     public:
         explicit graphics_driver(graphic_api api)
             : api_(api) {}
@@ -136,6 +167,20 @@ namespace eka2l1::drivers {
             return api_;
         }
 
+        /**
+         * \brief Reserve a handle for a bitmap that is yet to be created.
+         */
+        drivers::handle reserve_bitmap_handle() {
+            return bitmap_handles_.reserve() | HANDLE_BITMAP;
+        }
+
+        /**
+         * \brief Reserve a handle for a graphics object that is yet to be created.
+         */
+        drivers::handle reserve_object_handle() {
+            return object_handles_.reserve();
+        }
+
         virtual bool is_stricted() const {
             return false;
         }
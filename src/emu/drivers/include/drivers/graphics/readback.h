@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2022 EKA2L1 Team.
+ *
+ * This file is part of EKA2L1 project.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <common/vecx.h>
+#include <drivers/graphics/common.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace eka2l1::drivers {
+    class graphics_driver;
+
+    /**
+     * \brief Pipelines bitmap readbacks through two staging buffers.
+     *
+     * Each frame queues a read into the next staging buffer, and copies out the newest read that has already
+     * completed. The caller therefore never waits for the GPU, except when both staging buffers are still in
+     * flight. The destination is usually one frame behind the bitmap.
+     */
+    class bitmap_readback_pipeline {
+        struct staging {
+            std::vector<std::uint8_t> data_;
+            std::uint64_t sequence_ = 0;
+            int status_ = 0;
+            bool in_flight_ = false;
+            bool resolved_ = true;
+        };
+
+        staging stagings_[2];
+        std::size_t next_;
+        std::uint64_t sequence_;
+
+        graphics_driver *driver_;
+
+        bool is_ready(staging &target);
+
+    public:
+        explicit bitmap_readback_pipeline();
+        ~bitmap_readback_pipeline();
+
+        bitmap_readback_pipeline(const bitmap_readback_pipeline &) = delete;
+        bitmap_readback_pipeline &operator=(const bitmap_readback_pipeline &) = delete;
+
+        /**
+         * \brief Queue a read of the bitmap into the next staging buffer.
+         *
+         * \param driver        The driver that owns the bitmap.
+         * \param h             Handle to the bitmap.
+         * \param size          The size of the region to read.
+         * \param bpp           The target BPP of the read data.
+         * \param buffer_size   Size of the destination this readback will later be resolved to.
+         */
+        void queue(graphics_driver *driver, drivers::handle h, const eka2l1::object_size &size, const std::uint32_t bpp,
+            const std::size_t buffer_size);
+
+        /**
+         * \brief Copy the newest completed readback to the destination.
+         *
+         * \param dest          The destination buffer.
+         * \param dest_size     Size of the destination. Reads queued with a different size are discarded.
+         * \param wait          If true, wait for the newest queued read instead of taking what has completed.
+         *
+         * \returns True if new data has been copied.
+         */
+        bool resolve(std::uint8_t *dest, const std::size_t dest_size, const bool wait = false);
+
+        /**
+         * \brief Wait for all pending reads to complete.
+         */
+        void wait_idle();
+    };
+}
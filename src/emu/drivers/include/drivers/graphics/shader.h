@@ -54,6 +54,30 @@ namespace eka2l1::drivers {
 
     static constexpr std::uint32_t TOTAL_BITS_PER_SHADER_VAR_TYPE = 5;
 
+    /**
+     * \brief Get the size in bytes of one element of a shader variable type.
+     *
+     * Booleans and samplers are uploaded as 32-bit integers.
+     */
+    std::uint32_t get_shader_var_type_size(const shader_var_type var_type);
+
+    enum uniform_batch_entry_flag {
+        uniform_batch_entry_flag_transpose = 1 << 0
+    };
+
+    /**
+     * \brief Header of one uniform in a batched uniform upload.
+     *
+     * The uniform's data follows right after the header. Since every variable type is a multiple of 4 bytes
+     * in size, the next header stays aligned.
+     */
+    struct uniform_batch_entry {
+        std::int32_t binding_;
+        std::uint16_t var_type_;
+        std::uint16_t flags_;
+        std::uint32_t size_;
+    };
+
     struct shader_program_metadata {
         const std::uint8_t *metadata_;
 
@@ -114,6 +138,18 @@ namespace eka2l1::drivers {
         }
     };
 
+    /**
+     * \brief Append GLSL source to a string, dropping precision statements and qualifiers.
+     *
+     * Comments and preprocessor lines are copied unchanged, except for #define bodies, which have
+     * their qualifiers dropped too.
+     *
+     * \param dest     The string to append the result to.
+     * \param source   The GLSL source.
+     * \param pos      Offset in the source to start from. It should be at the start of a line.
+     */
+    void append_glsl_without_precision_qualifiers(std::string &dest, const std::string &source, std::size_t pos = 0);
+
     std::unique_ptr<shader_module> make_shader_module(graphics_driver *driver);
     std::unique_ptr<shader_program> make_shader_program(graphics_driver *driver);
 }
@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2022 EKA2L1 Team.
+ *
+ * This file is part of EKA2L1 project.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <drivers/graphics/shader.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace eka2l1::drivers {
+    /**
+     * \brief Describe where a uniform variable lives inside a uniform arena.
+     */
+    struct uniform_arena_variable {
+        std::int32_t binding_;
+        std::uint32_t offset_;                  ///< Offset of the data in the arena.
+        std::uint32_t capacity_;                ///< Size reserved for the whole variable (including array elements).
+        std::uint32_t size_;                    ///< Size of the last data set.
+        std::int32_t array_size_;
+
+        shader_var_type declared_var_type_;
+        shader_var_type cached_var_type_;       ///< Type used by the first set, later sets must match it.
+        std::uint16_t flags_;                   ///< Flags from uniform_batch_entry_flag, of the last data set.
+
+        explicit uniform_arena_variable()
+            : binding_(-1)
+            , offset_(0)
+            , capacity_(0)
+            , size_(0)
+            , array_size_(1)
+            , declared_var_type_(shader_var_type::none)
+            , cached_var_type_(shader_var_type::none)
+            , flags_(0) {
+        }
+    };
+
+    /**
+     * \brief Keep the values of a program's uniforms in one block, and pack the changed ones for upload.
+     *
+     * Every variable gets a fixed slice of the arena when it is added. Setting a value copies it into that
+     * slice and marks the variable dirty; the dirty variables are then packed into one batch of
+     * uniform_batch_entry headers, each followed by its data.
+     */
+    class uniform_arena {
+        std::vector<uniform_arena_variable> variables_;
+        std::vector<std::int32_t> location_to_variable_;
+        std::vector<std::uint8_t> data_;
+        std::vector<std::uint64_t> dirty_bits_;
+        bool any_dirty_;
+
+    public:
+        explicit uniform_arena();
+
+        /**
+         * \brief Remove every variable and its data.
+         */
+        void clear();
+
+        /**
+         * \brief Reserve space for a variable at the end of the arena.
+         *
+         * \param binding       The location of the variable. Negative locations are ignored.
+         * \param var_type      The declared type of the variable.
+         * \param array_size    Number of array elements. Values below 1 are treated as 1.
+         */
+        void add_variable(const std::int32_t binding, const shader_var_type var_type, const std::int32_t array_size);
+
+        /**
+         * \brief Get the variable at a location.
+         *
+         * \return Nullptr if no variable lives at the location.
+         */
+        const uniform_arena_variable *get_variable(const std::int32_t binding) const;
+
+        /**
+         * \brief Copy a new value of a variable into the arena and mark it dirty.
+         *
+         * Data past the capacity of the variable is ignored.
+         *
+         * \param binding       The location of the variable.
+         * \param data          The new value.
+         * \param size          Size of the new value in bytes.
+         * \param var_type      The type the value was set as.
+         * \param flags         Flags from uniform_batch_entry_flag to upload the value with.
+         *
+         * \return False if no variable lives at the location.
+         */
+        bool write(const std::int32_t binding, const std::uint8_t *data, const std::uint32_t size, const shader_var_type var_type,
+            const std::uint16_t flags);
+
+        /**
+         * \brief Pack every dirty variable into a batch, in order of their addition, then clear the dirty marks.
+         *
+         * \param dest          The buffer to put the batch in. Its previous content is discarded, but not its capacity.
+         *
+         * \return False if nothing was dirty, in which case the destination is left untouched.
+         */
+        bool pack_dirty(std::vector<std::uint8_t> &dest);
+
+        bool any_dirty() const {
+            return any_dirty_;
+        }
+
+        std::size_t size() const {
+            return data_.size();
+        }
+    };
+}
@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2022 EKA2L1 Team.
+ *
+ * This file is part of EKA2L1 project.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <common/vecx.h>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace eka2l1::drivers {
+    /**
+     * @brief Get the size of the chroma planes of a YUV420 image.
+     */
+    inline eka2l1::vec2 get_yuv420p_chroma_size(const eka2l1::vec2 &size) {
+        return eka2l1::vec2((size.x + 1) / 2, (size.y + 1) / 2);
+    }
+
+    /**
+     * @brief Get the number of bytes a tightly packed YUV420 planar image takes.
+     */
+    std::size_t get_yuv420p_buffer_size(const eka2l1::vec2 &size);
+
+    /**
+     * @brief Convert a tightly packed YUV420 planar image to RGBA8888.
+     *
+     * BT.601 limited range coefficients are used. This is the CPU fallback for backends that can't
+     * sample the planes directly; the loops are kept branchless so the compiler can vectorise them.
+     *
+     * @param dest      Destination buffer, must hold at least width * height * 4 bytes.
+     * @param source    The planes, laid out as described by texture_format::yuv420p.
+     * @param size      Size of the image in pixels.
+     */
+    void convert_yuv420p_to_rgba(std::uint8_t *dest, const std::uint8_t *source, const eka2l1::vec2 &size);
+}
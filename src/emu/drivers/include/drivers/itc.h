@@ -71,6 +71,8 @@ namespace eka2l1::drivers {
       * \param initial_size       The initial size of the bitmap.
       * \param bpp                Bits per pixel of the bitmap
       * 
+      * The handle is reserved right away and the creation is queued, so this does not wait for the driver.
+      *
       * \returns ID of the bitmap.
       */
     drivers::handle create_bitmap(graphics_driver *driver, const eka2l1::vec2 &size, const std::uint32_t bpp);
@@ -83,6 +85,9 @@ namespace eka2l1::drivers {
       * \param type         The type of the shader module.
       * \param compile_log  Pointer to an optional string object, that hold compile log. It may be important on compile failure.
       *
+      * Without a compile log, the compilation is queued and this returns right away. A failure is then only logged
+      * by the driver, and the handle refers to nothing.
+      *
       * \returns Handle to the program.
       */
     drivers::handle create_shader_module(graphics_driver *driver, const char *data, const std::size_t size,
@@ -97,11 +102,36 @@ namespace eka2l1::drivers {
      * @param metadata          If this is not null, the metadata object is filled with this shader program's metadata.
      * @param link_log          If this is not null, on return the log is filled with linking info.
      * 
+     * Without metadata and link log, the linking is queued and this returns right away.
+     * 
      * @return A valid handle on success.
      */
     drivers::handle create_shader_program(graphics_driver *driver, drivers::handle vertex_module,
         drivers::handle fragment_module, shader_program_metadata *metadata, std::string *link_log = nullptr);
 
+    /**
+     * @brief Queue the creation of a shader module, without waiting for the compilation.
+     *
+     * The status is set to -100 while the compilation is pending, then to 0 on success or -1 on failure. Use
+     * driver::is_finished or driver::wait_for to check for completion. The compile log and the status must stay
+     * alive until then. The source is copied.
+     *
+     * @returns Handle reserved for the module. It refers to nothing if the compilation fails, but must still be destroyed.
+     */
+    drivers::handle create_shader_module_async(graphics_driver *driver, const char *data, const std::size_t size,
+        drivers::shader_module_type type, std::string *compile_log, int *status);
+
+    /**
+     * @brief Queue the creation of a shader program, without waiting for the link.
+     *
+     * The status is set to -100 while the link is pending, then to 0 on success or -1 on failure. The metadata,
+     * the link log and the status must stay alive until the command is finished.
+     *
+     * @returns Handle reserved for the program. It refers to nothing if the link fails, but must still be destroyed.
+     */
+    drivers::handle create_shader_program_async(graphics_driver *driver, drivers::handle vertex_module,
+        drivers::handle fragment_module, shader_program_metadata *metadata, std::string *link_log, int *status);
+
     /**
      * \brief Create a new texture.
      *
@@ -144,6 +174,8 @@ namespace eka2l1::drivers {
      * \param initial_size     The size of the buffer. Later resize won't keep the buffer data.
      * \param upload_hint      Upload frequency and target hint for the buffer.
      *
+     * The initial data is copied and the creation is queued, so this does not wait for the driver.
+     *
      * \returns Handle to the buffer.
      */
     drivers::handle create_buffer(graphics_driver *driver, const void *initial_data, const std::size_t initial_size, const buffer_upload_hint upload_hint);
@@ -194,6 +226,22 @@ namespace eka2l1::drivers {
     bool read_bitmap(graphics_driver *driver, drivers::handle h, const eka2l1::point &pos, const eka2l1::object_size &size,
         const std::uint32_t bpp, std::uint8_t *buffer_ptr);
 
+    /**
+     * @brief Queue a read of bitmap data into a memory buffer, without waiting for it to complete.
+     * 
+     * The status is set to -100 while the read is pending, then to non-zero on success. Use driver::is_finished
+     * or driver::wait_for to check for completion. The buffer and the status must stay alive until then.
+     * 
+     * @param h             Handle to the bitmap.
+     * @param pos           The position to start clipping bitmap data from.
+     * @param size          The size of the clipped bitmap region.
+     * @param bpp           The target BPP that will be written to the memory.
+     * @param buffer_ptr    The buffer to read the data into.
+     * @param status        Pointer to the status of the read.
+     */
+    void read_bitmap_async(graphics_driver *driver, drivers::handle h, const eka2l1::point &pos, const eka2l1::object_size &size,
+        const std::uint32_t bpp, std::uint8_t *buffer_ptr, int *status);
+
     /**
      * @brief   Read framebuffer data from a region into memory buffer.
      * 
@@ -410,6 +458,14 @@ namespace eka2l1::drivers {
         void set_dynamic_uniform(const int binding, const drivers::shader_var_type var_type,
             const void *data, const std::size_t data_size);
 
+        /**
+         * @brief Set multiple uniform variables of the current program in one command.
+         * 
+         * @param packed        Sequence of uniform_batch_entry headers, each followed by its data.
+         * @param packed_size   Total size of the sequence in bytes.
+         */
+        void set_dynamic_uniforms(const std::uint8_t *packed, const std::size_t packed_size);
+
         /**
          * \brief Bind a texture or bitmap (as texture) to a binding slot.
          *
@@ -19,11 +19,12 @@
 
 #pragma once
 
+#include <array>
 #include <atomic>
 #include <thread>
+#include <vector>
 
 #include <common/sync.h>
-#include <common/queue.h>
 #include <common/container.h>
 
 #include <drivers/video/video.h>
@@ -36,13 +37,33 @@ extern "C" {
 }
 
 namespace eka2l1::drivers {
+    /**
+     * @brief A block of resampled PCM16 audio, recycled between the decode thread and the audio callback.
+     */
+    struct video_pcm_buffer {
+        std::vector<std::int16_t> samples_;
+        std::size_t sample_count_ = 0;
+        std::size_t consumed_ = 0;
+    };
+
     class video_player_ffmpeg : public video_player {
     private:
+        enum {
+            PCM_BUFFER_POOL_SIZE = 32,
+            PCM_BUFFER_INITIAL_SAMPLES = 0x2000
+        };
+
         std::unique_ptr<audio_output_stream> stream_;
         std::unique_ptr<std::thread> decode_thread_;
-        threadsafe_cn_queue<AVPacket*> audio_packets_;
 
-        common::ring_buffer<std::uint16_t, 0x20000> pending_samples_;
+        // Buffers only move between the two queues. The decode thread is the only producer of filled buffers
+        // and the audio callback the only producer of free ones, so neither side ever locks or allocates.
+        std::array<video_pcm_buffer, PCM_BUFFER_POOL_SIZE> pcm_buffers_;
+        common::ring_buffer<video_pcm_buffer*, PCM_BUFFER_POOL_SIZE> filled_pcm_buffers_;
+        common::ring_buffer<video_pcm_buffer*, PCM_BUFFER_POOL_SIZE> free_pcm_buffers_;
+        video_pcm_buffer *playing_pcm_buffer_;
+        video_pcm_buffer *spare_pcm_buffer_;        ///< Taken from the free queue but left unfilled. Only used by the decode thread.
+
         common::event done_event_;
 
         std::atomic_bool should_stop_;
@@ -65,8 +86,12 @@ namespace eka2l1::drivers {
         std::uint64_t last_update_us_;
 
         void reset_contexts();
+        void reset_pcm_buffers();
         bool prepare_codecs();
 
+        video_pcm_buffer *acquire_free_pcm_buffer();
+        bool decode_audio_packet(AVPacket *packet);
+
     public:
         explicit video_player_ffmpeg(audio_driver *driver);
         ~video_player_ffmpeg() override;
@@ -54,11 +54,11 @@ namespace eka2l1::drivers {
         /**
          * @brief Callback that will be invoked when a new frame is available.
          * 
-         * The frame data is in RGBA format. Any backend must convert to this format before calling this
-         * function. Second parameter provided the pointer to the data buffer, and the thrid parameter provides
-         * the size of the buffer.
+         * The frame data is in planar YUV420 format, with planes tightly packed as described by texture_format::yuv420p.
+         * Any backend must convert to this format before calling this function. Second parameter provided the pointer
+         * to the data buffer, and the thrid parameter provides the size of the buffer.
          * 
-         * YUV is not preferred due to some platforms not having native support for it.
+         * The colour conversion is left to the graphics driver, which can do it while drawing.
          */
         using image_frame_available_callback = std::function<void(void*, const std::uint8_t*, const std::size_t)>;
 
@@ -0,0 +1,18 @@
+#version 140
+
+uniform sampler2D u_tex;
+uniform sampler2D u_texU;
+uniform sampler2D u_texV;
+uniform vec4 u_color;
+
+in vec2 r_texcoord;
+out vec4 o_color;
+
+void main() {
+    float y = 1.164 * (texture(u_tex, r_texcoord).r - 0.0625);
+    float u = texture(u_texU, r_texcoord).r - 0.5;
+    float v = texture(u_texV, r_texcoord).r - 0.5;
+
+    vec3 rgb = vec3(y + 1.596 * v, y - 0.392 * u - 0.813 * v, y + 2.017 * u);
+    o_color = vec4(clamp(rgb, 0.0, 1.0), 1.0) * (u_color / 255.0);
+}
\ No newline at end of file
@@ -182,24 +182,30 @@ namespace eka2l1::drivers {
         return bmp_textures[(h & ~HANDLE_BITMAP) - 1].get();
     }
 
-    drivers::handle shared_graphics_driver::append_graphics_object(graphics_object_instance &instance) {
-        auto free_slot = std::find(graphic_objects.begin(), graphic_objects.end(), nullptr);
+    drivers::handle shared_graphics_driver::append_graphics_object(graphics_object_instance &instance, const drivers::handle reserved) {
+        // The handle may have been reserved by the client before the creation command was queued
+        const drivers::handle h = (reserved != 0) ? reserved : object_handles_.reserve();
 
-        if (free_slot != graphic_objects.end()) {
-            *free_slot = std::move(instance);
-            return std::distance(graphic_objects.begin(), free_slot) + 1;
+        if (graphic_objects.size() < h) {
+            graphic_objects.resize(h);
         }
 
-        graphic_objects.push_back(std::move(instance));
-        return graphic_objects.size();
+        graphic_objects[h - 1] = std::move(instance);
+        return h;
     }
 
     bool shared_graphics_driver::delete_graphics_object(const drivers::handle handle) {
-        if (handle > graphic_objects.size() || handle == 0) {
-            return 0;
+        if (handle == 0) {
+            return false;
         }
 
-        graphic_objects[handle - 1].reset();
+        // A reserved handle whose creation failed has no slot, but must still be given back
+        if (handle <= graphic_objects.size()) {
+            graphic_objects[handle - 1].reset();
+        }
+
+        object_handles_.release(handle);
+
         return true;
     }
 
@@ -318,21 +324,21 @@ namespace eka2l1::drivers {
         eka2l1::vec2 size;
         std::uint32_t bpp = static_cast<std::uint32_t>(cmd.data_[1]);
         drivers::handle *result = reinterpret_cast<drivers::handle*>(cmd.data_[2]);
+        const drivers::handle reserved = static_cast<drivers::handle>(cmd.data_[3]);
 
         unpack_u64_to_2u32(cmd.data_[0], size.x, size.y);
 
-        // Find free slot
-        auto slot_free = std::find(bmp_textures.begin(), bmp_textures.end(), nullptr);
+        const drivers::handle index = (reserved != 0) ? (reserved & ~HANDLE_BITMAP) : bitmap_handles_.reserve();
 
-        if (slot_free != bmp_textures.end()) {
-            *slot_free = std::make_unique<bitmap>(this, size, static_cast<int>(bpp));
-            *result = std::distance(bmp_textures.begin(), slot_free) + 1;
-        } else {
-            bmp_textures.push_back(std::make_unique<bitmap>(this, size, static_cast<int>(bpp)));
-            *result = bmp_textures.size();
+        if (bmp_textures.size() < index) {
+            bmp_textures.resize(index);
         }
 
-        *result |= HANDLE_BITMAP;
+        bmp_textures[index - 1] = std::make_unique<bitmap>(this, size, static_cast<int>(bpp));
+
+        if (result) {
+            *result = index | HANDLE_BITMAP;
+        }
 
         // Notify
         finish(cmd.status_, 0);
@@ -458,14 +464,19 @@ namespace eka2l1::drivers {
     }
 
     void shared_graphics_driver::destroy_bitmap(command &cmd) {
-        drivers::handle h = cmd.data_[0];
+        const drivers::handle index = cmd.data_[0] & ~HANDLE_BITMAP;
 
-        if ((h & ~HANDLE_BITMAP) > bmp_textures.size()) {
+        if (index == 0) {
             LOG_ERROR(DRIVER_GRAPHICS, "Invalid bitmap handle to destroy");
             return;
         }
 
-        bmp_textures[(h & ~HANDLE_BITMAP) - 1].reset();
+        // Same as objects, a reserved handle may never got its bitmap created
+        if (index <= bmp_textures.size()) {
+            bmp_textures[index - 1].reset();
+        }
+
+        bitmap_handles_.release(index);
     }
 
     void shared_graphics_driver::resize_bitmap(command &cmd) {
@@ -499,20 +510,33 @@ namespace eka2l1::drivers {
         drivers::shader_module_type mod_type = static_cast<drivers::shader_module_type>(cmd.data_[2]);
         std::string *compile_log = reinterpret_cast<std::string*>(cmd.data_[4]);
         drivers::handle *store = reinterpret_cast<drivers::handle*>(cmd.data_[3]);
+        const drivers::handle reserved = static_cast<drivers::handle>(cmd.data_[5]);
 
         auto obj = make_shader_module(this);
-        if (!obj->create(this, data, data_size, mod_type, compile_log)) {
+        const bool created = obj->create(this, data, data_size, mod_type, compile_log);
+
+        if (reserved != 0) {
+            // The source is a copy made for the queued command
+            delete[] reinterpret_cast<const std::uint8_t *>(data);
+        }
+
+        if (!created) {
             LOG_ERROR(DRIVER_GRAPHICS, "Fail to create shader module!");
-            *store = 0;
+
+            if (store) {
+                *store = 0;
+            }
 
             finish(cmd.status_, -1);
             return;
         }
 
         std::unique_ptr<graphics_object> obj_casted = std::move(obj);
-        drivers::handle res = append_graphics_object(obj_casted);
+        drivers::handle res = append_graphics_object(obj_casted, reserved);
 
-        *store = res;
+        if (store) {
+            *store = res;
+        }
 
         finish(cmd.status_, 0);
     }
@@ -539,11 +563,14 @@ namespace eka2l1::drivers {
         }
 
         std::unique_ptr<graphics_object> obj_casted = std::move(obj);
-        drivers::handle res = append_graphics_object(obj_casted);
+        drivers::handle res = append_graphics_object(obj_casted, static_cast<drivers::handle>(cmd.data_[5]));
 
         drivers::handle *store = reinterpret_cast<drivers::handle*>(cmd.data_[3]);
 
-        *store = res;
+        if (store) {
+            *store = res;
+        }
+
         finish(cmd.status_, 0);
     }
 
@@ -604,6 +631,7 @@ namespace eka2l1::drivers {
         std::size_t initial_size = static_cast<std::size_t>(cmd.data_[1]);
         buffer_upload_hint upload_hint = static_cast<buffer_upload_hint>(cmd.data_[2]);
         drivers::handle existing_handle = static_cast<drivers::handle>(cmd.data_[3]);
+        const drivers::handle reserved = static_cast<drivers::handle>(cmd.data_[5]);
 
         drivers::buffer *obj = nullptr;
         std::unique_ptr<drivers::buffer> obj_inst = nullptr;
@@ -622,13 +650,19 @@ namespace eka2l1::drivers {
 
         if (obj_inst) {
             std::unique_ptr<graphics_object> obj_casted = std::move(obj_inst);
-            drivers::handle res = append_graphics_object(obj_casted);
+            drivers::handle res = append_graphics_object(obj_casted, reserved);
 
             drivers::handle *store = reinterpret_cast<drivers::handle*>(cmd.data_[4]);
-            *store = res;
+
+            if (store) {
+                *store = res;
+            }
 
             finish(cmd.status_, 0);
-        } else if ((initial_data != nullptr) && (existing_handle)) {
+        }
+
+        // The data is a copy made for the queued command, whether the buffer is new or recreated
+        if ((initial_data != nullptr) && (existing_handle || reserved)) {
             std::uint8_t *data_casted = reinterpret_cast<std::uint8_t*>(initial_data);
             delete[] data_casted;
         }
@@ -638,6 +672,7 @@ namespace eka2l1::drivers {
         drivers::input_descriptor *descs = reinterpret_cast<drivers::input_descriptor*>(cmd.data_[0]);
         std::uint32_t count = static_cast<std::uint32_t>(cmd.data_[1]);
         drivers::handle existing_handle = static_cast<drivers::handle>(cmd.data_[2]);
+        const drivers::handle reserved = static_cast<drivers::handle>(cmd.data_[4]);
 
         drivers::input_descriptors *obj = nullptr;
         std::unique_ptr<drivers::input_descriptors> obj_inst = nullptr;
@@ -656,13 +691,18 @@ namespace eka2l1::drivers {
 
         if (obj_inst) {
             std::unique_ptr<graphics_object> obj_casted = std::move(obj_inst);
-            drivers::handle res = append_graphics_object(obj_casted);
+            drivers::handle res = append_graphics_object(obj_casted, reserved);
 
             drivers::handle *store = reinterpret_cast<drivers::handle*>(cmd.data_[3]);
-            *store = res;
+
+            if (store) {
+                *store = res;
+            }
 
             finish(cmd.status_, 0);
-        } else if ((descs != nullptr) && (existing_handle)) {
+        }
+
+        if ((descs != nullptr) && (existing_handle || reserved)) {
             std::uint8_t *data_casted = reinterpret_cast<std::uint8_t*>(descs);
             delete[] data_casted;
         }
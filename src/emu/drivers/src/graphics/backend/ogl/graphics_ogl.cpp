@@ -21,6 +21,7 @@
 #include <common/log.h>
 #include <common/platform.h>
 #include <common/rgb.h>
+#include <cstring>
 #include <fstream>
 #include <sstream>
 
@@ -30,6 +31,9 @@
 #include <drivers/graphics/backend/ogl/fb_ogl.h>
 #include <glad/glad.h>
 
+#define XXH_INLINE_ALL
+#include <xxhash.h>
+
 #if EKA2L1_PLATFORM(ANDROID)
 #include <EGL/egl.h>
 #endif
@@ -78,11 +82,13 @@ namespace eka2l1::drivers {
         , new_surface(nullptr)
         , is_gles(false)
         , support_line_width_(true)
+        , yuv_program_tried_(false)
         , point_size(1.0)
         , line_style(pen_style_none)
         , active_input_descriptors_(nullptr)
         , index_buffer_current_(0)
         , feature_flags_(0)
+        , program_binary_salt_(0)
         , active_upscale_shader_("Default") {
         context_ = graphics::make_gl_context(info, false, true);
 
@@ -160,6 +166,25 @@ namespace eka2l1::drivers {
             }
         }
 
+        GLint program_binary_format_count = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &program_binary_format_count);
+
+        if ((program_binary_format_count > 0) && glGetProgramBinary && glProgramBinary) {
+            feature_flags_ |= OGL_FEATURE_SUPPORT_PROGRAM_BINARY;
+
+            std::string driver_identity;
+            for (const GLenum name : { GL_VENDOR, GL_RENDERER, GL_VERSION }) {
+                const GLubyte *value = glGetString(name);
+                if (value) {
+                    driver_identity += reinterpret_cast<const char *>(value);
+                }
+
+                driver_identity += '\n';
+            }
+
+            program_binary_salt_ = XXH64(driver_identity.data(), driver_identity.size(), 0);
+        }
+
         std::string feature = "";
 
         if (feature_flags_ & OGL_FEATURE_SUPPORT_ETC2) {
@@ -178,6 +203,10 @@ namespace eka2l1::drivers {
             feature += "ES3.1_Compability;";
         }
 
+        if (feature_flags_ & OGL_FEATURE_SUPPORT_PROGRAM_BINARY) {
+            feature += "ProgramBinary;";
+        }
+
         if (!feature.empty()) {
             feature.pop_back();
         }
@@ -193,6 +222,7 @@ namespace eka2l1::drivers {
         brush_program.reset();
         mask_program.reset();
         pen_program.reset();
+        yuv_program.reset();
 
         GLuint vao_to_del[3] = { sprite_vao, brush_vao, pen_vao };
         GLuint vbo_to_del[3] = { sprite_vbo, brush_vbo, pen_vbo };
@@ -245,6 +275,7 @@ namespace eka2l1::drivers {
     static constexpr const char *brush_f_path = "resources//brush.frag";
     static constexpr const char *pen_v_path = "resources//pen.vert";
     static constexpr const char *pen_f_path = "resources//pen.frag";
+    static constexpr const char *sprite_yuv_f_path = "resources//sprite_yuv.frag";
 
     void ogl_graphics_driver::do_init() {
         auto sprite_norm_vertex_module = std::make_unique<ogl_shader_module>(sprite_norm_v_path, shader_module_type::vertex);        
@@ -469,6 +500,37 @@ namespace eka2l1::drivers {
         draw_rectangle(brush_rect);
     }
 
+    bool ogl_graphics_driver::prepare_yuv_program() {
+        if (yuv_program_tried_) {
+            return (yuv_program != nullptr);
+        }
+
+        yuv_program_tried_ = true;
+
+        auto sprite_norm_vertex_module = std::make_unique<ogl_shader_module>(sprite_norm_v_path, shader_module_type::vertex);
+        auto sprite_yuv_fragment_module = std::make_unique<ogl_shader_module>(sprite_yuv_f_path, shader_module_type::fragment);
+
+        auto yuv_program_new = std::make_unique<ogl_shader_program>();
+
+        if (!yuv_program_new->create(this, sprite_norm_vertex_module.get(), sprite_yuv_fragment_module.get())) {
+            LOG_WARN(DRIVER_GRAPHICS, "YUV sprite shader is unavailable, video frames will be converted on the CPU");
+            return false;
+        }
+
+        yuv_program = std::move(yuv_program_new);
+
+        color_loc_yuv = yuv_program->get_uniform_location("u_color").value_or(-1);
+        proj_loc_yuv = yuv_program->get_uniform_location("u_proj").value_or(-1);
+        model_loc_yuv = yuv_program->get_uniform_location("u_model").value_or(-1);
+        y_plane_loc_yuv = yuv_program->get_uniform_location("u_tex").value_or(-1);
+        u_plane_loc_yuv = yuv_program->get_uniform_location("u_texU").value_or(-1);
+        v_plane_loc_yuv = yuv_program->get_uniform_location("u_texV").value_or(-1);
+        in_position_loc_yuv = is_stricted() ? 0 : yuv_program->get_attrib_location("in_position").value_or(-1);
+        in_texcoord_loc_yuv = is_stricted() ? 1 : yuv_program->get_attrib_location("in_texcoord").value_or(-1);
+
+        return true;
+    }
+
     void ogl_graphics_driver::draw_bitmap(command &cmd) {
         if (!sprite_program) {
             do_init();
@@ -516,12 +578,23 @@ namespace eka2l1::drivers {
         unpack_u64_to_2u32(cmd.data_[2], dest_rect.top.x, dest_rect.top.y);
         unpack_u64_to_2u32(cmd.data_[3], dest_rect.size.x, dest_rect.size.y);
 
+        // Planes of a YUV texture are combined by their own shader, which does not support masking or upscaling
+        const bool use_yuv = (draw_texture->get_format() == texture_format::yuv420p) && yuv_program;
+
+        if (use_yuv) {
+            flags &= ~bitmap_draw_flag_use_upscale_shader;
+            mask_draw_texture = nullptr;
+            mask_bmp = nullptr;
+        }
+
         if (flags & bitmap_draw_flag_use_upscale_shader) {
             commit_upscale_shader_change();
             upscale_program->use(this);
         } else {
             if (mask_bmp) {
                 mask_program->use(this);
+            } else if (use_yuv) {
+                yuv_program->use(this);
             } else {
                 sprite_program->use(this);
             }
@@ -636,6 +709,8 @@ namespace eka2l1::drivers {
 
         if (flags & bitmap_draw_flag_use_upscale_shader) {
             position_loc = in_position_loc_upscale;
+        } else if (use_yuv) {
+            position_loc = in_position_loc_yuv;
         } else {
             position_loc = mask_draw_texture ? in_position_loc_mask : in_position_loc;
         }
@@ -647,6 +722,8 @@ namespace eka2l1::drivers {
 
         if (flags & bitmap_draw_flag_use_upscale_shader) {
             texcoord_loc = in_texcoord_loc_upscale;
+        } else if (use_yuv) {
+            texcoord_loc = in_texcoord_loc_yuv;
         } else {
             texcoord_loc = mask_draw_texture ? in_texcoord_loc_mask : in_texcoord_loc;
         }
@@ -667,6 +744,19 @@ namespace eka2l1::drivers {
             glBindTexture(GL_TEXTURE_2D, static_cast<GLuint>(mask_draw_texture->driver_handle()));
         }
 
+        if (use_yuv) {
+            ogl_texture *yuv_texture = reinterpret_cast<ogl_texture*>(draw_texture);
+
+            glUniform1i(y_plane_loc_yuv, 0);
+            glUniform1i(u_plane_loc_yuv, 1);
+            glUniform1i(v_plane_loc_yuv, 2);
+
+            glActiveTexture(GL_TEXTURE1);
+            glBindTexture(GL_TEXTURE_2D, static_cast<GLuint>(yuv_texture->chroma_plane_handle(0)));
+            glActiveTexture(GL_TEXTURE2);
+            glBindTexture(GL_TEXTURE_2D, static_cast<GLuint>(yuv_texture->chroma_plane_handle(1)));
+        }
+
         if (source_rect.size.x == 0) {
             source_rect.size.x = draw_texture->get_size().x;
         }
@@ -707,6 +797,10 @@ namespace eka2l1::drivers {
 
             glUniform2fv(texel_delta_upscaled_loc_, 1, texel_delta);
             glUniform2fv(pixel_delta_upscaled_loc_, 1, pixel_delta);
+        } else if (use_yuv) {
+            glUniformMatrix4fv(model_loc_yuv, 1, false, glm::value_ptr(model_matrix));
+            glUniformMatrix4fv(proj_loc_yuv, 1, false, glm::value_ptr(projection_matrix));
+            glUniform4fv(color_loc_yuv, 1, (flags & bitmap_draw_flag_use_brush) ? brush_color.elements.data() : color);
         } else {
             glUniformMatrix4fv((mask_draw_texture ? model_loc_mask : model_loc), 1, false, glm::value_ptr(model_matrix));
             glUniformMatrix4fv((mask_draw_texture ? proj_loc_mask : proj_loc), 1, false, glm::value_ptr(projection_matrix));
@@ -1372,74 +1466,117 @@ namespace eka2l1::drivers {
         glColorMask(dat & 1, dat & 2, dat & 4, dat & 8);
     }
 
-    void ogl_graphics_driver::set_uniform(command &cmd) {
-        drivers::shader_var_type var_type;
-        std::uint8_t *data = reinterpret_cast<std::uint8_t*>(cmd.data_[1]);
-        int binding = 0;
+    bool ogl_graphics_driver::upload_uniform(const int binding, const shader_var_type var_type, const void *data,
+        const std::size_t size, const bool transpose) {
+        const std::uint32_t element_size = get_shader_var_type_size(var_type);
 
-        unpack_u64_to_2u32(cmd.data_[0], binding, var_type);
+        if (element_size == 0) {
+            return false;
+        }
+
+        const GLsizei count = static_cast<GLsizei>((size + element_size - 1) / element_size);
+        const GLint *idata = reinterpret_cast<const GLint *>(data);
+        const GLfloat *fdata = reinterpret_cast<const GLfloat *>(data);
 
         switch (var_type) {
-        case shader_var_type::integer: {
-            glUniform1iv(binding, static_cast<GLsizei>((cmd.data_[2] + 3) / 4), reinterpret_cast<const GLint *>(data));
-            delete[] data;
+        case shader_var_type::integer:
+        case shader_var_type::boolean:
+        case shader_var_type::sampler1d:
+        case shader_var_type::sampler2d:
+        case shader_var_type::sampler_cube:
+            glUniform1iv(binding, count, idata);
+            break;
 
-            return;
-        }
+        case shader_var_type::ivec2:
+        case shader_var_type::bvec2:
+            glUniform2iv(binding, count, idata);
+            break;
+
+        case shader_var_type::ivec3:
+        case shader_var_type::bvec3:
+            glUniform3iv(binding, count, idata);
+            break;
+
+        case shader_var_type::ivec4:
+        case shader_var_type::bvec4:
+            glUniform4iv(binding, count, idata);
+            break;
 
         case shader_var_type::real:
-            glUniform1fv(binding, static_cast<GLsizei>((cmd.data_[2] + 3) / 4), reinterpret_cast<const GLfloat*>(data));
-            delete[] data;
+            glUniform1fv(binding, count, fdata);
+            break;
 
-            return;
+        case shader_var_type::vec2:
+            glUniform2fv(binding, count, fdata);
+            break;
 
-        case shader_var_type::mat2: {
-            glUniformMatrix2fv(binding, static_cast<GLsizei>((cmd.data_[2] + 15) / 16), GL_FALSE, reinterpret_cast<const GLfloat *>(data));
-            delete[] data;
+        case shader_var_type::vec3:
+            glUniform3fv(binding, count, fdata);
+            break;
 
-            return;
-        }
+        case shader_var_type::vec4:
+            glUniform4fv(binding, count, fdata);
+            break;
 
-        case shader_var_type::mat3: {
-            glUniformMatrix2fv(binding, static_cast<GLsizei>((cmd.data_[2] + 35) / 36), GL_FALSE, reinterpret_cast<const GLfloat *>(data));
-            delete[] data;
+        case shader_var_type::mat2:
+            glUniformMatrix2fv(binding, count, transpose ? GL_TRUE : GL_FALSE, fdata);
+            break;
 
-            return;
-        }
+        case shader_var_type::mat3:
+            glUniformMatrix3fv(binding, count, transpose ? GL_TRUE : GL_FALSE, fdata);
+            break;
 
-        case shader_var_type::mat4: {
-            glUniformMatrix4fv(binding, static_cast<GLsizei>((cmd.data_[2] + 63) / 64), GL_FALSE, reinterpret_cast<const GLfloat *>(data));
-            delete[] data;
+        case shader_var_type::mat4:
+            glUniformMatrix4fv(binding, count, transpose ? GL_TRUE : GL_FALSE, fdata);
+            break;
 
-            return;
+        default:
+            return false;
         }
 
-        case shader_var_type::vec2: {
-            glUniform2fv(binding, static_cast<GLsizei>((cmd.data_[2] + 7) / 8), reinterpret_cast<const GLfloat *>(data));
-            delete[] data;
+        return true;
+    }
 
-            return;
-        }
+    void ogl_graphics_driver::set_uniform(command &cmd) {
+        drivers::shader_var_type var_type;
+        std::uint8_t *data = reinterpret_cast<std::uint8_t*>(cmd.data_[1]);
+        int binding = 0;
 
-        case shader_var_type::vec3: {
-            glUniform3fv(binding, static_cast<GLsizei>((cmd.data_[2] + 11) / 12), reinterpret_cast<const GLfloat *>(data));
-            delete[] data;
+        unpack_u64_to_2u32(cmd.data_[0], binding, var_type);
 
-            return;
+        if (!upload_uniform(binding, var_type, data, static_cast<std::size_t>(cmd.data_[2]), false)) {
+            LOG_ERROR(DRIVER_GRAPHICS, "Unable to set GL uniform!");
         }
 
-        case shader_var_type::vec4: {
-            glUniform4fv(binding, static_cast<GLsizei>((cmd.data_[2] + 15) / 16), reinterpret_cast<const GLfloat *>(data));
-            delete[] data;
+        delete[] data;
+    }
 
-            return;
-        }
+    void ogl_graphics_driver::set_uniforms(command &cmd) {
+        std::uint8_t *packed = reinterpret_cast<std::uint8_t *>(cmd.data_[0]);
+        const std::size_t packed_size = static_cast<std::size_t>(cmd.data_[1]);
 
-        default:
-            break;
+        std::size_t offset = 0;
+
+        while (offset + sizeof(uniform_batch_entry) <= packed_size) {
+            uniform_batch_entry entry;
+            std::memcpy(&entry, packed + offset, sizeof(uniform_batch_entry));
+
+            offset += sizeof(uniform_batch_entry);
+
+            if (offset + entry.size_ > packed_size) {
+                LOG_ERROR(DRIVER_GRAPHICS, "Batched uniform data is truncated!");
+                break;
+            }
+
+            if (!upload_uniform(entry.binding_, static_cast<shader_var_type>(entry.var_type_), packed + offset, entry.size_,
+                    entry.flags_ & uniform_batch_entry_flag_transpose)) {
+                LOG_ERROR(DRIVER_GRAPHICS, "Unable to set GL uniform at binding {}!", entry.binding_);
+            }
+
+            offset += entry.size_;
         }
 
-        LOG_ERROR(DRIVER_GRAPHICS, "Unable to set GL uniform!");
+        delete[] packed;
     }
 
     void ogl_graphics_driver::set_texture_for_shader(command &cmd) {
@@ -1833,6 +1970,10 @@ namespace eka2l1::drivers {
             set_uniform(cmd);
             break;
 
+        case graphics_driver_set_uniforms:
+            set_uniforms(cmd);
+            break;
+
         case graphics_driver_depth_set_mask:
             set_depth_mask(cmd);
             break;
@@ -18,16 +18,36 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <drivers/graphics/backend/ogl/graphics_ogl.h>
 #include <drivers/graphics/backend/ogl/shader_ogl.h>
 #include <glad/glad.h>
 
+#include <common/algorithm.h>
 #include <common/buffer.h>
+#include <common/fileutils.h>
 #include <common/log.h>
+#include <common/path.h>
+
+#include <fmt/format.h>
 
 #include <fstream>
 #include <sstream>
 
+#define XXH_INLINE_ALL
+#include <xxhash.h>
+
 namespace eka2l1::drivers {
+    static constexpr const char *PROGRAM_BINARY_CACHE_FILENAME_FORMAT = "cache/shaders/{:016X}.bin";
+    static constexpr std::uint32_t PROGRAM_BINARY_CACHE_MAGIC = 0x4E494250; // PBIN
+    static constexpr std::size_t MAXIMUM_PROGRAM_BINARY_SIZE = common::MB(16);
+
+    struct program_binary_cache_header {
+        std::uint32_t magic_;
+        std::uint32_t format_;
+        std::uint32_t size_;
+        std::uint32_t reserved_;
+    };
+
     static shader_var_type gl_enum_to_shader_var_type(const GLenum val) {
         switch (val) {
         case GL_FLOAT:
@@ -173,11 +193,13 @@ namespace eka2l1::drivers {
     }
 
     ogl_shader_module::ogl_shader_module()
-        : shader(0) {
+        : shader(0)
+        , source_hash_(0) {
     }
 
     ogl_shader_module::ogl_shader_module(const std::string &path, const shader_module_type type, const std::string &extra_header)
-        : shader(0) {
+        : shader(0)
+        , source_hash_(0) {
         common::ro_std_file_stream stream(path, std::ios_base::binary);
         if (!stream.valid()) {
             LOG_ERROR(DRIVER_GRAPHICS, "Shader file stream with path {} is invalid!", path);
@@ -193,7 +215,8 @@ namespace eka2l1::drivers {
     }
 
     ogl_shader_module::ogl_shader_module(const char *data, const std::size_t size, const shader_module_type type)
-        : shader(0) {
+        : shader(0)
+        , source_hash_(0) {
         create(nullptr, data, size, type);
     }
 
@@ -203,6 +226,8 @@ namespace eka2l1::drivers {
     }
 
     bool ogl_shader_module::create(graphics_driver *driver, const char *data, const std::size_t size, const shader_module_type type, std::string *compile_log) {
+        source_hash_ = XXH64(data, size, static_cast<XXH64_hash_t>(type));
+
         shader = glCreateShader(((type == shader_module_type::vertex) ? GL_VERTEX_SHADER :
             ((type == shader_module_type::fragment) ? GL_FRAGMENT_SHADER : GL_GEOMETRY_SHADER)));
 
@@ -269,6 +294,33 @@ namespace eka2l1::drivers {
         }
 
         program = glCreateProgram();
+
+        ogl_graphics_driver *ogl_driver = reinterpret_cast<ogl_graphics_driver *>(driver);
+        std::string cache_path;
+
+        if (ogl_driver && ogl_driver->get_supported_feature(OGL_FEATURE_SUPPORT_PROGRAM_BINARY)) {
+            const std::uint64_t key_parts[3] = { ogl_driver->program_binary_salt(), ogl_vertex_module->source_hash(),
+                ogl_fragment_module->source_hash() };
+
+            cache_path = fmt::format(PROGRAM_BINARY_CACHE_FILENAME_FORMAT, XXH64(key_parts, sizeof(key_parts), 0));
+
+            if (load_cached_binary(cache_path)) {
+                if (link_log) {
+                    link_log->clear();
+                }
+
+                return true;
+            }
+
+            // A rejected binary leaves the program in a failed state, so start from a fresh one
+            glDeleteProgram(program);
+            program = glCreateProgram();
+
+            if (glProgramParameteri) {
+                glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+            }
+        }
+
         glAttachShader(program, ogl_vertex_module->shader_handle());
         glAttachShader(program, ogl_fragment_module->shader_handle());
 
@@ -294,12 +346,87 @@ namespace eka2l1::drivers {
             }
 
             glDeleteProgram(program);
+            program = 0;
+
             return false;
         }
 
+        if (!cache_path.empty()) {
+            save_cached_binary(cache_path);
+        }
+
         return true;
     }
 
+    bool ogl_shader_program::load_cached_binary(const std::string &path) {
+        common::ro_std_file_stream stream(path, true);
+        if (!stream.valid() || (stream.size() <= sizeof(program_binary_cache_header)) || (stream.size() > MAXIMUM_PROGRAM_BINARY_SIZE)) {
+            return false;
+        }
+
+        program_binary_cache_header header;
+        if (stream.read(&header, sizeof(header)) != sizeof(header)) {
+            return false;
+        }
+
+        if ((header.magic_ != PROGRAM_BINARY_CACHE_MAGIC) || (header.size_ != stream.size() - sizeof(header))) {
+            return false;
+        }
+
+        std::vector<std::uint8_t> binary(header.size_);
+        if (stream.read(binary.data(), binary.size()) != binary.size()) {
+            return false;
+        }
+
+        glProgramBinary(program, static_cast<GLenum>(header.format_), binary.data(), static_cast<GLsizei>(binary.size()));
+
+        GLint success = 0;
+        glGetProgramiv(program, GL_LINK_STATUS, &success);
+
+        if (!success) {
+            // Usually the driver got updated and no longer accepts the old binary
+            LOG_TRACE(DRIVER_GRAPHICS, "Cached program binary {} was rejected, relinking", path);
+            return false;
+        }
+
+        return true;
+    }
+
+    void ogl_shader_program::save_cached_binary(const std::string &path) {
+        GLint binary_length = 0;
+        glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &binary_length);
+
+        if ((binary_length <= 0) || (static_cast<std::size_t>(binary_length) > MAXIMUM_PROGRAM_BINARY_SIZE)) {
+            return;
+        }
+
+        std::vector<std::uint8_t> binary(sizeof(program_binary_cache_header) + binary_length);
+
+        GLenum format = 0;
+        GLsizei written = 0;
+        glGetProgramBinary(program, binary_length, &written, &format, binary.data() + sizeof(program_binary_cache_header));
+
+        if (written <= 0) {
+            return;
+        }
+
+        program_binary_cache_header *header = reinterpret_cast<program_binary_cache_header *>(binary.data());
+        header->magic_ = PROGRAM_BINARY_CACHE_MAGIC;
+        header->format_ = static_cast<std::uint32_t>(format);
+        header->size_ = static_cast<std::uint32_t>(written);
+        header->reserved_ = 0;
+
+        common::create_directories(eka2l1::file_directory(path));
+        common::wo_std_file_stream stream(path, true);
+
+        if (!stream.valid()) {
+            LOG_WARN(DRIVER_GRAPHICS, "Unable to write program binary cache to {}", path);
+            return;
+        }
+
+        stream.write(binary.data(), sizeof(program_binary_cache_header) + written);
+    }
+
     bool ogl_shader_program::use(graphics_driver *driver) {
         glUseProgram(program);
         return true;
@@ -21,6 +21,7 @@
 #include <drivers/graphics/backend/ogl/common_ogl.h>
 #include <drivers/graphics/backend/ogl/texture_ogl.h>
 #include <drivers/graphics/backend/ogl/graphics_ogl.h>
+#include <drivers/graphics/yuv.h>
 
 #include <glad/glad.h>
 
@@ -74,6 +75,47 @@ namespace eka2l1::drivers {
         }
     }
 
+    void ogl_texture::upload_yuv420p_planes(const void *data, const bool allocate) {
+        const eka2l1::vec2 luma_size(tex_size.x, tex_size.y);
+        const eka2l1::vec2 chroma_size = get_yuv420p_chroma_size(luma_size);
+
+        const std::uint8_t *plane_data[3] = { nullptr, nullptr, nullptr };
+        const eka2l1::vec2 plane_size[3] = { luma_size, chroma_size, chroma_size };
+
+        if (data) {
+            plane_data[0] = reinterpret_cast<const std::uint8_t*>(data);
+            plane_data[1] = plane_data[0] + luma_size.x * luma_size.y;
+            plane_data[2] = plane_data[1] + chroma_size.x * chroma_size.y;
+        }
+
+        if (allocate && !chroma_textures[0]) {
+            glGenTextures(2, chroma_textures);
+        }
+
+        const std::uint32_t plane_textures[3] = { texture, chroma_textures[0], chroma_textures[1] };
+
+        // Planes are tightly packed, and the chroma width may be odd
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+        for (int i = 0; i < 3; i++) {
+            glBindTexture(GL_TEXTURE_2D, plane_textures[i]);
+
+            if (allocate) {
+                glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, plane_size[i].x, plane_size[i].y, 0, GL_RED, GL_UNSIGNED_BYTE, plane_data[i]);
+
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+            } else if (plane_data[i]) {
+                glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, plane_size[i].x, plane_size[i].y, GL_RED, GL_UNSIGNED_BYTE, plane_data[i]);
+            }
+        }
+
+        glBindTexture(GL_TEXTURE_2D, texture);
+    }
+
     bool ogl_texture::create(graphics_driver *driver, const int dim, const int miplvl, const vec3 &size, const texture_format internal_format,
         const texture_format format, const texture_data_type data_type, void *data, const std::size_t total_size, const std::size_t ppl,
         const std::uint32_t unpack_alignment) {
@@ -100,7 +142,33 @@ namespace eka2l1::drivers {
         drivers::texture_data_type converted_data_type = tex_data_type;
 
         std::vector<std::uint8_t> converted_data;
-        if (tex_data_type == drivers::texture_data_type::compressed) {
+        if (internal_format == drivers::texture_format::yuv420p) {
+            ogl_graphics_driver *ogl_driver = reinterpret_cast<ogl_graphics_driver*>(driver);
+            if ((dimensions == 2) && ogl_driver->prepare_yuv_program()) {
+                // Each plane gets its own texture, the conversion is done when drawing
+                upload_yuv420p_planes(data, true);
+                unbind(driver);
+
+                return true;
+            }
+
+            // No shader to do the conversion. Store it as a normal RGBA texture
+            converted_data_type = drivers::texture_data_type::ubyte;
+            converted_internal_format = drivers::texture_format::rgba;
+            converted_format = drivers::texture_format::rgba;
+
+            this->internal_format = converted_internal_format;
+            this->format = converted_format;
+
+            if (data) {
+                converted_data.resize(4 * size.x * size.y);
+                convert_yuv420p_to_rgba(converted_data.data(), reinterpret_cast<const std::uint8_t*>(data), eka2l1::vec2(size.x, size.y));
+
+                data = converted_data.data();
+            }
+
+            glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+        } else if (tex_data_type == drivers::texture_data_type::compressed) {
             ogl_graphics_driver *ogl_driver = reinterpret_cast<ogl_graphics_driver*>(driver);
             if (internal_format == drivers::texture_format::etc2_rgb8 && !ogl_driver->get_supported_feature(OGL_FEATURE_SUPPORT_ETC2)) {
                 converted_data_type = drivers::texture_data_type::ubyte;
@@ -205,6 +273,10 @@ namespace eka2l1::drivers {
         if (texture) {
             glDeleteTextures(1, &texture);
         }
+
+        if (chroma_textures[0]) {
+            glDeleteTextures(2, chroma_textures);
+        }
     }
 
     void ogl_texture::set_filter_minmag(const bool min, const filter_option op) {
@@ -324,7 +396,24 @@ namespace eka2l1::drivers {
         drivers::texture_data_type converted_data_type = data_type;
 
         std::vector<std::uint8_t> converted_data;
-        if (data_type == drivers::texture_data_type::compressed) {
+        if (data_format == drivers::texture_format::yuv420p) {
+            if (chroma_textures[0]) {
+                // Planes can only be replaced as a whole
+                upload_yuv420p_planes(data, false);
+                unbind(driver);
+
+                return;
+            }
+
+            converted_data_type = drivers::texture_data_type::ubyte;
+            converted_format = drivers::texture_format::rgba;
+
+            converted_data.resize(4 * size.x * size.y);
+            convert_yuv420p_to_rgba(converted_data.data(), reinterpret_cast<const std::uint8_t*>(data), eka2l1::vec2(size.x, size.y));
+
+            glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+            data = converted_data.data();
+        } else if (data_type == drivers::texture_data_type::compressed) {
             ogl_graphics_driver *ogl_driver = reinterpret_cast<ogl_graphics_driver*>(driver);
             if (!ogl_driver->get_supported_feature(OGL_FEATURE_SUPPORT_ETC2)) {
                 converted_data_type = drivers::texture_data_type::ubyte;
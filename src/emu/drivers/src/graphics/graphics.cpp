@@ -24,6 +24,32 @@
 #include <common/platform.h>
 
 namespace eka2l1::drivers {
+    drivers::handle graphics_handle_pool::reserve() {
+        const std::lock_guard<std::mutex> guard(lock_);
+
+        if (!free_.empty()) {
+            const drivers::handle h = free_.back();
+            free_.pop_back();
+
+            in_use_[h - 1] = true;
+            return h;
+        }
+
+        in_use_.push_back(true);
+        return static_cast<drivers::handle>(in_use_.size());
+    }
+
+    void graphics_handle_pool::release(const drivers::handle h) {
+        const std::lock_guard<std::mutex> guard(lock_);
+
+        if ((h == 0) || (h > in_use_.size()) || !in_use_[h - 1]) {
+            return;
+        }
+
+        in_use_[h - 1] = false;
+        free_.push_back(h);
+    }
+
     graphics_driver_ptr create_graphics_driver(const graphic_api api, const window_system_info &info) {
         switch (api) {
         case graphic_api::opengl: {
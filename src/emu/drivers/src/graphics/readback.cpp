@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2022 EKA2L1 Team.
+ *
+ * This file is part of EKA2L1 project.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <drivers/graphics/graphics.h>
+#include <drivers/graphics/readback.h>
+#include <drivers/itc.h>
+
+#include <cstring>
+
+namespace eka2l1::drivers {
+    bitmap_readback_pipeline::bitmap_readback_pipeline()
+        : next_(0)
+        , sequence_(0)
+        , driver_(nullptr) {
+    }
+
+    bitmap_readback_pipeline::~bitmap_readback_pipeline() {
+        // The driver may still write to the staging buffers
+        wait_idle();
+    }
+
+    bool bitmap_readback_pipeline::is_ready(staging &target) {
+        if (!target.in_flight_) {
+            return true;
+        }
+
+        if (!driver_->is_finished(&target.status_)) {
+            return false;
+        }
+
+        target.in_flight_ = false;
+        return true;
+    }
+
+    void bitmap_readback_pipeline::queue(graphics_driver *driver, drivers::handle h, const eka2l1::object_size &size,
+        const std::uint32_t bpp, const std::size_t buffer_size) {
+        staging &target = stagings_[next_];
+
+        if (driver_ && target.in_flight_) {
+            // Both buffers are busy, we have no choice but to wait for the oldest one
+            driver_->wait_for(&target.status_);
+            target.in_flight_ = false;
+        }
+
+        driver_ = driver;
+
+        target.data_.resize(buffer_size);
+        target.sequence_ = ++sequence_;
+        target.in_flight_ = true;
+        target.resolved_ = false;
+
+        read_bitmap_async(driver, h, eka2l1::point(0, 0), size, bpp, target.data_.data(), &target.status_);
+        next_ = (next_ + 1) % 2;
+    }
+
+    bool bitmap_readback_pipeline::resolve(std::uint8_t *dest, const std::size_t dest_size, const bool wait) {
+        if (!driver_) {
+            return false;
+        }
+
+        staging *newest = nullptr;
+
+        for (staging &target : stagings_) {
+            if (target.resolved_) {
+                continue;
+            }
+
+            if (wait && target.in_flight_) {
+                driver_->wait_for(&target.status_);
+                target.in_flight_ = false;
+            }
+
+            if (!is_ready(target)) {
+                continue;
+            }
+
+            if (!newest || (newest->sequence_ < target.sequence_)) {
+                newest = &target;
+            }
+        }
+
+        if (!newest) {
+            return false;
+        }
+
+        // Older reads are superseded by the newest one
+        for (staging &target : stagings_) {
+            if (!target.in_flight_ && (target.sequence_ <= newest->sequence_)) {
+                target.resolved_ = true;
+            }
+        }
+
+        if ((newest->status_ <= 0) || (newest->data_.size() != dest_size)) {
+            return false;
+        }
+
+        std::memcpy(dest, newest->data_.data(), dest_size);
+        return true;
+    }
+
+    void bitmap_readback_pipeline::wait_idle() {
+        if (!driver_) {
+            return;
+        }
+
+        for (staging &target : stagings_) {
+            if (target.in_flight_) {
+                driver_->wait_for(&target.status_);
+                target.in_flight_ = false;
+            }
+        }
+    }
+}
@@ -22,7 +22,10 @@
 #include <drivers/graphics/graphics.h>
 #include <drivers/graphics/shader.h>
 
+#include <algorithm>
+#include <cctype>
 #include <cstring>
+#include <string_view>
 
 namespace eka2l1::drivers {
     std::unique_ptr<shader_module> make_shader_module(graphics_driver *driver) {
@@ -51,6 +54,192 @@ namespace eka2l1::drivers {
         return nullptr;
     }
 
+    static bool is_glsl_identifier_char(const char c) {
+        return std::isalnum(static_cast<unsigned char>(c)) || (c == '_');
+    }
+
+    static bool is_glsl_precision_qualifier(const std::string_view word) {
+        return (word == "lowp") || (word == "mediump") || (word == "highp");
+    }
+
+    // Get the position after the line that contains pos, following backslash continuations.
+    static std::size_t find_glsl_line_end(const std::string &source, std::size_t pos) {
+        while (true) {
+            const std::size_t line_end = source.find('\n', pos);
+            if (line_end == std::string::npos) {
+                return source.size();
+            }
+
+            std::size_t last_char = line_end;
+            if ((last_char > pos) && (source[last_char - 1] == '\r')) {
+                last_char--;
+            }
+
+            if ((last_char == pos) || (source[last_char - 1] != '\\')) {
+                return line_end + 1;
+            }
+
+            pos = line_end + 1;
+        }
+    }
+
+    // Get where the replacement list of a #define directive starts, or npos if the directive is not a #define.
+    static std::size_t find_glsl_define_body(const std::string &source, std::size_t pos, const std::size_t end) {
+        pos = source.find_first_not_of(" \t", pos + 1);
+        if ((pos >= end) || (source.compare(pos, 6, "define") != 0)) {
+            return std::string::npos;
+        }
+
+        pos = source.find_first_not_of(" \t", pos + 6);
+        while ((pos < end) && is_glsl_identifier_char(source[pos])) {
+            pos++;
+        }
+
+        // Function-like macro, skip the parameter list
+        if ((pos < end) && (source[pos] == '(')) {
+            const std::size_t params_end = source.find(')', pos);
+            pos = ((params_end == std::string::npos) || (params_end >= end)) ? end : params_end + 1;
+        }
+
+        return std::min(pos, end);
+    }
+
+    static void append_glsl_range_without_precision_qualifiers(std::string &dest, const std::string &source, std::size_t pos,
+        const std::size_t end, const bool in_define) {
+        bool at_line_start = !in_define;
+
+        while (pos < end) {
+            const char c = source[pos];
+
+            if ((c == '#') && at_line_start) {
+                const std::size_t directive_end = std::min(find_glsl_line_end(source, pos), end);
+                const std::size_t body_start = find_glsl_define_body(source, pos, directive_end);
+
+                if (body_start == std::string::npos) {
+                    dest.append(source, pos, directive_end - pos);
+                } else {
+                    // Macros may expand to qualifiers, so their bodies are stripped as well
+                    dest.append(source, pos, body_start - pos);
+                    append_glsl_range_without_precision_qualifiers(dest, source, body_start, directive_end, true);
+                }
+
+                pos = directive_end;
+                continue;
+            }
+
+            if ((c == '/') && (pos + 1 < end)) {
+                std::size_t comment_end = std::string::npos;
+
+                if (source[pos + 1] == '/') {
+                    comment_end = std::min(find_glsl_line_end(source, pos), end);
+                    at_line_start = !in_define;
+                } else if (source[pos + 1] == '*') {
+                    comment_end = source.find("*/", pos + 2);
+                    comment_end = ((comment_end == std::string::npos) || (comment_end + 2 > end)) ? end : comment_end + 2;
+                }
+
+                if (comment_end != std::string::npos) {
+                    dest.append(source, pos, comment_end - pos);
+                    pos = comment_end;
+
+                    continue;
+                }
+            }
+
+            if (!is_glsl_identifier_char(c)) {
+                if (c == '\n') {
+                    at_line_start = !in_define;
+                } else if (!std::isspace(static_cast<unsigned char>(c))) {
+                    at_line_start = false;
+                }
+
+                dest += c;
+                pos++;
+
+                continue;
+            }
+
+            at_line_start = false;
+
+            std::size_t word_end = pos;
+            while ((word_end < end) && is_glsl_identifier_char(source[word_end])) {
+                word_end++;
+            }
+
+            const std::string_view word(source.data() + pos, word_end - pos);
+
+            if (is_glsl_precision_qualifier(word)) {
+                pos = word_end;
+                continue;
+            }
+
+            if (word == "precision") {
+                // Only treat it as a statement if a qualifier follows
+                std::size_t qualifier_start = std::min(source.find_first_not_of(" \t\r\n", word_end), end);
+                std::size_t qualifier_end = qualifier_start;
+
+                while ((qualifier_end < end) && is_glsl_identifier_char(source[qualifier_end])) {
+                    qualifier_end++;
+                }
+
+                if ((qualifier_start < end) && is_glsl_precision_qualifier(std::string_view(source.data() + qualifier_start,
+                    qualifier_end - qualifier_start))) {
+                    const std::size_t statement_end = source.find(';', qualifier_end);
+                    if ((statement_end != std::string::npos) && (statement_end < end)) {
+                        pos = statement_end + 1;
+                        continue;
+                    }
+                }
+            }
+
+            dest.append(source, pos, word_end - pos);
+            pos = word_end;
+        }
+    }
+
+    void append_glsl_without_precision_qualifiers(std::string &dest, const std::string &source, std::size_t pos) {
+        append_glsl_range_without_precision_qualifiers(dest, source, pos, source.size(), false);
+    }
+
+    std::uint32_t get_shader_var_type_size(const shader_var_type var_type) {
+        switch (var_type) {
+        case shader_var_type::integer:
+        case shader_var_type::real:
+        case shader_var_type::boolean:
+        case shader_var_type::sampler1d:
+        case shader_var_type::sampler2d:
+        case shader_var_type::sampler_cube:
+            return 4;
+
+        case shader_var_type::vec2:
+        case shader_var_type::ivec2:
+        case shader_var_type::bvec2:
+            return 8;
+
+        case shader_var_type::vec3:
+        case shader_var_type::ivec3:
+        case shader_var_type::bvec3:
+            return 12;
+
+        case shader_var_type::vec4:
+        case shader_var_type::ivec4:
+        case shader_var_type::bvec4:
+        case shader_var_type::mat2:
+            return 16;
+
+        case shader_var_type::mat3:
+            return 36;
+
+        case shader_var_type::mat4:
+            return 64;
+
+        default:
+            break;
+        }
+
+        return 0;
+    }
+
     shader_program_metadata::shader_program_metadata(const std::uint8_t *metadata)
         : metadata_(metadata) {
     }
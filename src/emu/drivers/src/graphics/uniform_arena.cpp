@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2022 EKA2L1 Team.
+ *
+ * This file is part of EKA2L1 project.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <common/algorithm.h>
+#include <drivers/graphics/uniform_arena.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace eka2l1::drivers {
+    uniform_arena::uniform_arena()
+        : any_dirty_(false) {
+    }
+
+    void uniform_arena::clear() {
+        variables_.clear();
+        location_to_variable_.clear();
+        data_.clear();
+        dirty_bits_.clear();
+        any_dirty_ = false;
+    }
+
+    void uniform_arena::add_variable(const std::int32_t binding, const shader_var_type var_type, const std::int32_t array_size) {
+        if (binding < 0) {
+            return;
+        }
+
+        uniform_arena_variable variable;
+        variable.binding_ = binding;
+        variable.offset_ = static_cast<std::uint32_t>(data_.size());
+        variable.array_size_ = std::max<std::int32_t>(array_size, 1);
+        variable.capacity_ = get_shader_var_type_size(var_type) * static_cast<std::uint32_t>(variable.array_size_);
+        variable.declared_var_type_ = var_type;
+
+        if (static_cast<std::size_t>(binding) >= location_to_variable_.size()) {
+            location_to_variable_.resize(static_cast<std::size_t>(binding) + 1, -1);
+        }
+
+        location_to_variable_[binding] = static_cast<std::int32_t>(variables_.size());
+
+        variables_.push_back(variable);
+        data_.resize(data_.size() + variable.capacity_);
+        dirty_bits_.resize((variables_.size() + 63) / 64, 0);
+    }
+
+    const uniform_arena_variable *uniform_arena::get_variable(const std::int32_t binding) const {
+        if ((binding < 0) || (static_cast<std::size_t>(binding) >= location_to_variable_.size()) || (location_to_variable_[binding] < 0)) {
+            return nullptr;
+        }
+
+        return &variables_[location_to_variable_[binding]];
+    }
+
+    bool uniform_arena::write(const std::int32_t binding, const std::uint8_t *data, const std::uint32_t size, const shader_var_type var_type,
+        const std::uint16_t flags) {
+        if (!get_variable(binding)) {
+            return false;
+        }
+
+        const std::int32_t index = location_to_variable_[binding];
+        uniform_arena_variable &variable = variables_[index];
+
+        const std::uint32_t size_to_copy = std::min<std::uint32_t>(size, variable.capacity_);
+        std::memcpy(data_.data() + variable.offset_, data, size_to_copy);
+
+        variable.size_ = size_to_copy;
+        variable.cached_var_type_ = var_type;
+        variable.flags_ = flags;
+
+        dirty_bits_[index >> 6] |= (1ULL << (index & 63));
+        any_dirty_ = true;
+
+        return true;
+    }
+
+    bool uniform_arena::pack_dirty(std::vector<std::uint8_t> &dest) {
+        if (!any_dirty_) {
+            return false;
+        }
+
+        dest.clear();
+
+        for (std::size_t word = 0; word < dirty_bits_.size(); word++) {
+            std::uint64_t bits = dirty_bits_[word];
+
+            while (bits != 0) {
+                const std::size_t index = (word << 6) + common::find_least_significant_bit_one(bits);
+                bits &= bits - 1;
+
+                const uniform_arena_variable &variable = variables_[index];
+
+                uniform_batch_entry entry;
+                entry.binding_ = variable.binding_;
+                entry.var_type_ = static_cast<std::uint16_t>(variable.cached_var_type_);
+                entry.flags_ = variable.flags_;
+                entry.size_ = variable.size_;
+
+                const std::size_t write_offset = dest.size();
+                dest.resize(write_offset + sizeof(uniform_batch_entry) + variable.size_);
+
+                std::memcpy(dest.data() + write_offset, &entry, sizeof(uniform_batch_entry));
+                std::memcpy(dest.data() + write_offset + sizeof(uniform_batch_entry), data_.data() + variable.offset_, variable.size_);
+            }
+
+            dirty_bits_[word] = 0;
+        }
+
+        any_dirty_ = false;
+        return true;
+    }
+}
@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2022 EKA2L1 Team.
+ *
+ * This file is part of EKA2L1 project.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <drivers/graphics/yuv.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace eka2l1::drivers {
+    std::size_t get_yuv420p_buffer_size(const eka2l1::vec2 &size) {
+        const eka2l1::vec2 chroma_size = get_yuv420p_chroma_size(size);
+        return static_cast<std::size_t>(size.x * size.y + 2 * chroma_size.x * chroma_size.y);
+    }
+
+    static inline std::uint8_t clamp_to_byte(const std::int32_t value) {
+        return static_cast<std::uint8_t>(std::min<std::int32_t>(std::max<std::int32_t>(value, 0), 255));
+    }
+
+    void convert_yuv420p_to_rgba(std::uint8_t *dest, const std::uint8_t *source, const eka2l1::vec2 &size) {
+        const eka2l1::vec2 chroma_size = get_yuv420p_chroma_size(size);
+
+        const std::uint8_t *y_plane = source;
+        const std::uint8_t *u_plane = y_plane + size.x * size.y;
+        const std::uint8_t *v_plane = u_plane + chroma_size.x * chroma_size.y;
+
+        // Chroma contributions, upsampled horizontally once per chroma row and shared by two luma rows
+        std::vector<std::int32_t> red_add(size.x);
+        std::vector<std::int32_t> green_add(size.x);
+        std::vector<std::int32_t> blue_add(size.x);
+
+        for (int y = 0; y < size.y; y++) {
+            if ((y & 1) == 0) {
+                const std::uint8_t *u_row = u_plane + (y >> 1) * chroma_size.x;
+                const std::uint8_t *v_row = v_plane + (y >> 1) * chroma_size.x;
+
+                for (int x = 0; x < size.x; x++) {
+                    const std::int32_t d = static_cast<std::int32_t>(u_row[x >> 1]) - 128;
+                    const std::int32_t e = static_cast<std::int32_t>(v_row[x >> 1]) - 128;
+
+                    red_add[x] = 409 * e + 128;
+                    green_add[x] = 128 - 100 * d - 208 * e;
+                    blue_add[x] = 516 * d + 128;
+                }
+            }
+
+            const std::uint8_t *y_row = y_plane + y * size.x;
+            std::uint8_t *dest_row = dest + y * size.x * 4;
+
+            for (int x = 0; x < size.x; x++) {
+                const std::int32_t c = 298 * (static_cast<std::int32_t>(y_row[x]) - 16);
+
+                dest_row[x * 4] = clamp_to_byte((c + red_add[x]) >> 8);
+                dest_row[x * 4 + 1] = clamp_to_byte((c + green_add[x]) >> 8);
+                dest_row[x * 4 + 2] = clamp_to_byte((c + blue_add[x]) >> 8);
+                dest_row[x * 4 + 3] = 255;
+            }
+        }
+    }
+}
@@ -45,6 +45,16 @@ namespace eka2l1::drivers {
         return status;
     }
 
+    static void send_async_command(graphics_driver *drv, const command &cmd) {
+        command_list cmd_list(1);
+        cmd_list.renew();
+
+        cmd_list.size_ = 1;
+        *cmd_list.base_ = cmd;
+
+        drv->submit_command_list(cmd_list);
+    }
+
     static std::uint64_t make_data_copy(const void *source, const std::size_t size) {
         if (!source) {
             return 0;
@@ -56,19 +66,21 @@ namespace eka2l1::drivers {
         return reinterpret_cast<std::uint64_t>(copy);
     }
 
+    // Creation functions below reserve the handle on the client side and queue the command, so the caller does
+    // not wait for the driver thread. Data is copied, since the caller's memory may be gone once the command runs.
+    // Creations that return something besides the handle (logs, metadata) still wait for the result.
+
     drivers::handle create_bitmap(graphics_driver *driver, const eka2l1::vec2 &size, const std::uint32_t bpp) {
-        drivers::handle handle_num = 0;
+        const drivers::handle handle_num = driver->reserve_bitmap_handle();
 
         command cmd;
         cmd.opcode_ = graphics_driver_create_bitmap;
         cmd.data_[0] = PACK_2U32_TO_U64(size.x, size.y);
         cmd.data_[1] = bpp;
-        cmd.data_[2] = reinterpret_cast<std::uint64_t>(&handle_num);
-
-        if (send_sync_command(driver, cmd) != 0) {
-            return 0;
-        }
+        cmd.data_[2] = 0;
+        cmd.data_[3] = handle_num;
 
+        send_async_command(driver, cmd);
         return handle_num;
     }
     
@@ -77,9 +89,20 @@ namespace eka2l1::drivers {
 
         command cmd;
         cmd.opcode_ = graphics_driver_create_shader_module;
-        cmd.data_[0] = reinterpret_cast<std::uint64_t>(data);
         cmd.data_[1] = size;
         cmd.data_[2] = static_cast<std::uint64_t>(mtype);
+
+        if (!compile_log) {
+            handle_num = driver->reserve_object_handle();
+
+            cmd.data_[0] = make_data_copy(data, size);
+            cmd.data_[5] = handle_num;
+
+            send_async_command(driver, cmd);
+            return handle_num;
+        }
+
+        cmd.data_[0] = reinterpret_cast<std::uint64_t>(data);
         cmd.data_[3] = reinterpret_cast<std::uint64_t>(&handle_num);
         cmd.data_[4] = reinterpret_cast<std::uint64_t>(compile_log);
 
@@ -98,6 +121,15 @@ namespace eka2l1::drivers {
         cmd.opcode_ = graphics_driver_create_shader_program;
         cmd.data_[0] = vert_mod;
         cmd.data_[1] = frag_mod;
+
+        if (!metadata && !link_log) {
+            handle_num = driver->reserve_object_handle();
+            cmd.data_[5] = handle_num;
+
+            send_async_command(driver, cmd);
+            return handle_num;
+        }
+
         cmd.data_[2] = reinterpret_cast<std::uint64_t>(&metadata_ptr);
         cmd.data_[3] = reinterpret_cast<std::uint64_t>(&handle_num);
         cmd.data_[4] = reinterpret_cast<std::uint64_t>(link_log);
@@ -112,38 +144,70 @@ namespace eka2l1::drivers {
         return handle_num;
     }
 
+    drivers::handle create_shader_module_async(graphics_driver *driver, const char *data, const std::size_t size, const shader_module_type mtype,
+        std::string *compile_log, int *status) {
+        const drivers::handle handle_num = driver->reserve_object_handle();
+        *status = -100;
+
+        command cmd;
+        cmd.opcode_ = graphics_driver_create_shader_module;
+        cmd.data_[0] = make_data_copy(data, size);
+        cmd.data_[1] = size;
+        cmd.data_[2] = static_cast<std::uint64_t>(mtype);
+        cmd.data_[4] = reinterpret_cast<std::uint64_t>(compile_log);
+        cmd.data_[5] = handle_num;
+        cmd.status_ = status;
+
+        send_async_command(driver, cmd);
+        return handle_num;
+    }
+
+    drivers::handle create_shader_program_async(graphics_driver *driver, drivers::handle vert_mod, drivers::handle frag_mod,
+        shader_program_metadata *metadata, std::string *link_log, int *status) {
+        const drivers::handle handle_num = driver->reserve_object_handle();
+        *status = -100;
+
+        command cmd;
+        cmd.opcode_ = graphics_driver_create_shader_program;
+        cmd.data_[0] = vert_mod;
+        cmd.data_[1] = frag_mod;
+        cmd.data_[2] = metadata ? reinterpret_cast<std::uint64_t>(&metadata->metadata_) : 0;
+        cmd.data_[4] = reinterpret_cast<std::uint64_t>(link_log);
+        cmd.data_[5] = handle_num;
+        cmd.status_ = status;
+
+        send_async_command(driver, cmd);
+        return handle_num;
+    }
+
     drivers::handle create_buffer(graphics_driver *driver, const void *initial_data, const std::size_t initial_size, const buffer_upload_hint upload_hint) {
-        drivers::handle handle_num = 0;
+        const drivers::handle handle_num = driver->reserve_object_handle();
 
         command cmd;
         cmd.opcode_ = graphics_driver_create_buffer;
-        cmd.data_[0] = reinterpret_cast<std::uint64_t>(initial_data);
+        cmd.data_[0] = make_data_copy(initial_data, initial_size);
         cmd.data_[1] = initial_size;
         cmd.data_[2] = static_cast<std::uint64_t>(upload_hint);
         cmd.data_[3] = 0;
-        cmd.data_[4] = reinterpret_cast<std::uint64_t>(&handle_num);
-
-        if (send_sync_command(driver, cmd) != 0) {
-            return 0;
-        }
+        cmd.data_[4] = 0;
+        cmd.data_[5] = handle_num;
 
+        send_async_command(driver, cmd);
         return handle_num;
     }
     
     drivers::handle create_input_descriptors(graphics_driver *driver, input_descriptor *descriptors, const std::uint32_t count) {
-        drivers::handle handle_num = 0;
+        const drivers::handle handle_num = driver->reserve_object_handle();
 
         command cmd;
         cmd.opcode_ = graphics_driver_create_input_descriptor;
-        cmd.data_[0] = reinterpret_cast<std::uint64_t>(descriptors);
+        cmd.data_[0] = make_data_copy(descriptors, count * sizeof(input_descriptor));
         cmd.data_[1] = count;
         cmd.data_[2] = 0;
-        cmd.data_[3] = reinterpret_cast<std::uint64_t>(&handle_num);
-
-        if (send_sync_command(driver, cmd) != 0) {
-            return 0;
-        }
+        cmd.data_[3] = 0;
+        cmd.data_[4] = handle_num;
 
+        send_async_command(driver, cmd);
         return handle_num;
     }
 
@@ -226,6 +290,25 @@ namespace eka2l1::drivers {
 
         return send_sync_command(driver, cmd);
     }
+
+    void read_bitmap_async(graphics_driver *driver, drivers::handle h, const eka2l1::point &pos, const eka2l1::object_size &size,
+        const std::uint32_t bpp, std::uint8_t *buffer_ptr, int *status) {
+        *status = -100;
+
+        command_list cmd_list(1);
+        cmd_list.renew();
+
+        command *cmd = cmd_list.retrieve_next();
+        cmd->opcode_ = graphics_driver_read_bitmap;
+        cmd->data_[0] = h;
+        cmd->data_[1] = PACK_2U32_TO_U64(pos.x, pos.y);
+        cmd->data_[2] = PACK_2U32_TO_U64(size.x, size.y);
+        cmd->data_[3] = bpp;
+        cmd->data_[4] = reinterpret_cast<std::uint64_t>(buffer_ptr);
+        cmd->status_ = status;
+
+        driver->submit_command_list(cmd_list);
+    }
     
     void read_framebuffer(graphics_driver *driver, drivers::handle h, const eka2l1::vec2 pos, const eka2l1::vec2 size, drivers::texture_format format, drivers::texture_data_type dt, void *data_ptr) {
         command cmd;
@@ -404,6 +487,18 @@ namespace eka2l1::drivers {
         cmd->data_[2] = data_size;
     }
 
+    void graphics_command_builder::set_dynamic_uniforms(const std::uint8_t *packed, const std::size_t packed_size) {
+        if (!packed_size) {
+            return;
+        }
+
+        command *cmd = list_.retrieve_next();
+        cmd->opcode_ = graphics_driver_set_uniforms;
+
+        cmd->data_[0] = make_data_copy(packed, packed_size);
+        cmd->data_[1] = packed_size;
+    }
+
     void graphics_command_builder::bind_texture(drivers::handle h, const int binding) {
         command *cmd = list_.retrieve_next();
 
@@ -41,10 +41,17 @@ namespace eka2l1::drivers {
         , image_codec_ctx_(nullptr)
         , temp_audio_frame_(nullptr)
         , resample_context_(nullptr)
+        , playing_pcm_buffer_(nullptr)
+        , spare_pcm_buffer_(nullptr)
         , audio_stream_index_(-1)
         , image_stream_index_(-1)
         , volume_(10)
         , fps_(1.0f) {
+        for (video_pcm_buffer &buffer: pcm_buffers_) {
+            buffer.samples_.resize(PCM_BUFFER_INITIAL_SAMPLES);
+        }
+
+        reset_pcm_buffers();
     }
 
     video_player_ffmpeg::~video_player_ffmpeg() {
@@ -56,9 +63,22 @@ namespace eka2l1::drivers {
         }
     }
 
+    void video_player_ffmpeg::reset_pcm_buffers() {
+        filled_pcm_buffers_.reset();
+        free_pcm_buffers_.reset();
+
+        for (video_pcm_buffer &buffer: pcm_buffers_) {
+            video_pcm_buffer *buffer_ptr = &buffer;
+            free_pcm_buffers_.push(&buffer_ptr, 1);
+        }
+
+        playing_pcm_buffer_ = nullptr;
+        spare_pcm_buffer_ = nullptr;
+    }
+
     void video_player_ffmpeg::reset_contexts() {
         stream_.reset();
-        pending_samples_.reset();
+        reset_pcm_buffers();
 
         if (format_ctx_) {
             avformat_close_input(&format_ctx_);
@@ -210,6 +230,7 @@ namespace eka2l1::drivers {
         }
 
         stop();
+        reset_pcm_buffers();
 
         should_stop_ = false;
         done_event_.reset();
@@ -238,11 +259,6 @@ namespace eka2l1::drivers {
 
             decode_thread_.reset();
         }
-
-        while (std::optional<AVPacket*> packet = audio_packets_.pop()) {
-            AVPacket *packet_unpacked = std::move(packet.value());
-            av_packet_free(&packet_unpacked);
-        }
     }
 
     std::uint32_t video_player_ffmpeg::max_volume() const {
@@ -302,44 +318,79 @@ namespace eka2l1::drivers {
         const std::uint8_t channel_count = stream_->get_channels();
         const std::size_t sample_total_count = channel_count * frames;
 
-        // Fill all zero first in case we got nothing
-        std::fill(output_buffer, output_buffer + sample_total_count, 0);
+        std::size_t sample_written = 0;
 
-        // Try to get more by decoding
-        while (pending_samples_.size() < sample_total_count) {
-            std::optional<AVPacket*> packet_op = audio_packets_.pop();
-            if (!packet_op.has_value()) {
-                break;
+        while (sample_written < sample_total_count) {
+            if (!playing_pcm_buffer_) {
+                if (filled_pcm_buffers_.pop(&playing_pcm_buffer_, 1) == 0) {
+                    break;
+                }
             }
 
-            AVPacket *packet = std::move(packet_op.value());
-            int result = avcodec_send_packet(audio_codec_ctx_, packet);
-            if (result < 0) {
-                LOG_ERROR(DRIVER_VID, "Sending video's audio packet failed with code {}", result);
-                av_packet_free(&packet);
+            const std::size_t sample_to_copy = common::min(playing_pcm_buffer_->sample_count_ - playing_pcm_buffer_->consumed_,
+                sample_total_count - sample_written);
 
-                break;
+            std::copy(playing_pcm_buffer_->samples_.data() + playing_pcm_buffer_->consumed_,
+                playing_pcm_buffer_->samples_.data() + playing_pcm_buffer_->consumed_ + sample_to_copy, output_buffer + sample_written);
+
+            playing_pcm_buffer_->consumed_ += sample_to_copy;
+            sample_written += sample_to_copy;
+
+            if (playing_pcm_buffer_->consumed_ >= playing_pcm_buffer_->sample_count_) {
+                free_pcm_buffers_.push(&playing_pcm_buffer_, 1);
+                playing_pcm_buffer_ = nullptr;
             }
+        }
+
+        // Fill the rest with silence in case we ran out
+        std::fill(output_buffer + sample_written, output_buffer + sample_total_count, 0);
+        return frames;
+    }
+
+    video_pcm_buffer *video_player_ffmpeg::acquire_free_pcm_buffer() {
+        video_pcm_buffer *buffer = spare_pcm_buffer_;
+
+        if (buffer) {
+            spare_pcm_buffer_ = nullptr;
+            return buffer;
+        }
 
-            if (!temp_audio_frame_) {
-                temp_audio_frame_ = av_frame_alloc();
+        // The callback hands buffers back as it plays them. Wait for one rather than allocating
+        while (free_pcm_buffers_.pop(&buffer, 1) == 0) {
+            if (should_stop_) {
+                return nullptr;
             }
 
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        return buffer;
+    }
+
+    bool video_player_ffmpeg::decode_audio_packet(AVPacket *packet) {
+        int result = avcodec_send_packet(audio_codec_ctx_, packet);
+        if (result < 0) {
+            LOG_ERROR(DRIVER_VID, "Sending video's audio packet failed with code {}", result);
+            return false;
+        }
+
+        const std::uint8_t channel_count = stream_->get_channels();
+
+        if (!temp_audio_frame_) {
+            temp_audio_frame_ = av_frame_alloc();
+        }
+
+        while (true) {
             result = avcodec_receive_frame(audio_codec_ctx_, temp_audio_frame_);
-            if (result == AVERROR(EAGAIN)) {
-                av_packet_free(&packet);
-                continue;
+            if ((result == AVERROR(EAGAIN)) || (result == AVERROR_EOF)) {
+                break;
             }
 
             if (result < 0) {
                 LOG_ERROR(DRIVER_VID, "Decode video's audio packet failed with code {}", result);
-                av_packet_free(&packet);
-
-                break;
+                return false;
             }
 
-            av_packet_free(&packet);
-
             if (!resample_context_) {
                 const int dest_channel_type = (channel_count == 2) ? AV_CH_LAYOUT_STEREO : AV_CH_LAYOUT_MONO;
                 AVStream *audio_stream = format_ctx_->streams[audio_stream_index_];
@@ -352,28 +403,49 @@ namespace eka2l1::drivers {
                     LOG_ERROR(DRIVER_AUD, "Error initializing audio resample context!");
                     swr_free(&resample_context_);
 
-                    break;
+                    return false;
                 }
             }
 
-            std::vector<std::uint16_t> data_temp(channel_count * temp_audio_frame_->nb_samples);
+            video_pcm_buffer *buffer = acquire_free_pcm_buffer();
+            if (!buffer) {
+                // Stopping
+                return true;
+            }
+
+            const int max_out_frames = swr_get_out_samples(resample_context_, temp_audio_frame_->nb_samples);
+            const std::size_t max_out_samples = static_cast<std::size_t>(common::max(max_out_frames, 0)) * channel_count;
+
+            if (buffer->samples_.size() < max_out_samples) {
+                // Only grows for unusually large frames, the buffer keeps its size afterwards
+                buffer->samples_.resize(max_out_samples);
+            }
 
-            std::uint8_t *data_temp_ptr = reinterpret_cast<std::uint8_t*>(data_temp.data());
+            std::uint8_t *data_temp_ptr = reinterpret_cast<std::uint8_t*>(buffer->samples_.data());
             const std::uint8_t **source = const_cast<const std::uint8_t**>(temp_audio_frame_->extended_data);
-            
-            result = swr_convert(resample_context_, &data_temp_ptr, temp_audio_frame_->nb_samples, source,
+
+            result = swr_convert(resample_context_, &data_temp_ptr, static_cast<int>(buffer->samples_.size() / channel_count), source,
                 temp_audio_frame_->nb_samples);
 
             if (result < 0) {
                 LOG_ERROR(DRIVER_VID, "Unable to resample video audio to PCM16 format!");
-                break;
+                spare_pcm_buffer_ = buffer;
+
+                return false;
             }
 
-            pending_samples_.push(data_temp);
+            buffer->sample_count_ = static_cast<std::size_t>(result) * channel_count;
+            buffer->consumed_ = 0;
+
+            if (buffer->sample_count_ == 0) {
+                // Only the audio callback may push to the free queue, keep it for the next frame instead
+                spare_pcm_buffer_ = buffer;
+            } else {
+                filled_pcm_buffers_.push(&buffer, 1);
+            }
         }
 
-        pending_samples_.pop(output_buffer, common::min(sample_total_count, pending_samples_.size()));
-        return frames;
+        return true;
     }
 
     void video_player_ffmpeg::video_audio_decode_loop() {
@@ -438,26 +510,32 @@ namespace eka2l1::drivers {
                         break;
                     }
 
-                    if (!scale_context) {
-                        // Setup frame that will store scaled result
-                        scale_context = sws_getContext(image_codec_ctx_->width, image_codec_ctx_->height,
-                            image_codec_ctx_->pix_fmt, image_codec_ctx_->width, image_codec_ctx_->height, AV_PIX_FMT_RGBA,
-                            SWS_BILINEAR, nullptr, nullptr, nullptr);
+                    if (!frame_buffer) {
+                        // Frames are handed out as tightly packed YUV420 planes, the graphics driver does the colour conversion
+                        int total_bytes_buffer = av_image_get_buffer_size(AV_PIX_FMT_YUV420P, image_codec_ctx_->width,
+                           image_codec_ctx_->height, 1);
 
-                        int total_bytes_buffer = av_image_get_buffer_size(AV_PIX_FMT_RGBA, image_codec_ctx_->width,
-                           image_codec_ctx_->height, 32);
+                        frame_buffer = reinterpret_cast<std::uint8_t*>(av_malloc(total_bytes_buffer));
+                        frame_buffer_size = static_cast<std::size_t>(total_bytes_buffer);
 
-                        // I put it extra, suspect sws_scale is heap corrupting the data a bit
-                        frame_buffer = reinterpret_cast<std::uint8_t*>(av_malloc(total_bytes_buffer + (total_bytes_buffer / 2)));
+                        av_image_fill_arrays(scaled_frame->data, scaled_frame->linesize, frame_buffer, AV_PIX_FMT_YUV420P, image_codec_ctx_->width,
+                            image_codec_ctx_->height, 1);
 
-                        av_image_fill_arrays(scaled_frame->data, scaled_frame->linesize, frame_buffer, AV_PIX_FMT_RGBA, image_codec_ctx_->width,
-                            image_codec_ctx_->height, 32);
+                        if (image_codec_ctx_->pix_fmt != AV_PIX_FMT_YUV420P) {
+                            // Only repack the planes for other layouts, no scaling involved
+                            scale_context = sws_getContext(image_codec_ctx_->width, image_codec_ctx_->height,
+                                image_codec_ctx_->pix_fmt, image_codec_ctx_->width, image_codec_ctx_->height, AV_PIX_FMT_YUV420P,
+                                SWS_POINT, nullptr, nullptr, nullptr);
+                        }
+                    }
 
-                        frame_buffer_size = static_cast<std::size_t>(total_bytes_buffer);
+                    if (scale_context) {
+                        sws_scale(scale_context, temp_frame->data, temp_frame->linesize, 0, temp_frame->height, scaled_frame->data,
+                            scaled_frame->linesize);
+                    } else {
+                        av_image_copy_to_buffer(frame_buffer, static_cast<int>(frame_buffer_size), temp_frame->data, temp_frame->linesize,
+                            AV_PIX_FMT_YUV420P, image_codec_ctx_->width, image_codec_ctx_->height, 1);
                     }
-                    
-                    int resres = sws_scale(scale_context, temp_frame->data, temp_frame->linesize, 0, temp_frame->height, scaled_frame->data,
-                        scaled_frame->linesize);
 
                     image_frame_available_callback_(image_frame_available_callback_userdata_, frame_buffer, frame_buffer_size);
                     
@@ -471,9 +549,11 @@ namespace eka2l1::drivers {
 
                     last_update_us_ = common::get_current_utc_time_in_microseconds_since_epoch();
                 }
-            } else if (temp_packet->stream_index == audio_stream_index_) {
-                audio_packets_.push(av_packet_clone(temp_packet));
+            } else if ((temp_packet->stream_index == audio_stream_index_) && audio_codec_ctx_) {
+                decode_audio_packet(temp_packet);
             }
+
+            av_packet_unref(temp_packet);
         }
 
         // Wait until a confirmation that I can exit
@@ -160,6 +160,9 @@ namespace eka2l1 {
             const std::size_t max_size() const;
             const std::size_t committed() const;
 
+            /*! \brief Get the amount of host memory really backing this chunk. */
+            std::size_t resident() const;
+
             const std::uint32_t bottom_offset() const;
             const std::uint32_t top_offset() const;
 
@@ -161,12 +161,20 @@ namespace eka2l1::kernel {
 
         std::vector<std::uint64_t> relocation_list;
         std::uint32_t hash_;
+        std::uint64_t image_hash_{ 0 };
 
         bool patched_{ false };
         bool ep_disabled_{ false };
         bool hash_inited_{ false };
+        bool image_hash_inited_{ false };
 
         void calculate_hash();
+        void relocate(std::uint8_t *code_base_ptr, std::uint8_t *data_base_ptr, const address code_run_addr, const address data_run_addr);
+
+        /**
+         * \brief Get the hash identifying the unrelocated image, used as part of the relocated image cache key.
+         */
+        std::uint64_t get_image_hash();
 
     public:
         /*! \brief Create a new codeseg
@@ -35,6 +35,7 @@
 #include <kernel/mutex.h>
 #include <kernel/object_ix.h>
 #include <kernel/process.h>
+#include <kernel/reloc_cache.h>
 #include <kernel/scheduler.h>
 #include <kernel/sema.h>
 #include <kernel/timer.h>
@@ -287,6 +288,9 @@ namespace eka2l1 {
         std::vector<kernel_obj_unq_ptr> sessions_;
         std::vector<kernel_obj_unq_ptr> props_;
         std::vector<kernel_obj_unq_ptr> prop_refs_;
+
+        // Properties indexed by category (high 32 bits) and key (low 32 bits).
+        std::unordered_map<std::uint64_t, property_ptr> prop_index_;
         std::vector<kernel_obj_unq_ptr> chunks_;
         std::vector<kernel_obj_unq_ptr> mutexes_;
         std::vector<kernel_obj_unq_ptr> semas_;
@@ -304,6 +308,8 @@ namespace eka2l1 {
         std::unique_ptr<hle::lib_manager> lib_mngr_;
         std::unique_ptr<kernel::thread_scheduler> thr_sch_;
 
+        kernel::relocated_image_cache reloc_image_cache_;
+
         ntimer *timing_;
         memory_system *mem_;
         io_system *io_;
@@ -471,8 +477,24 @@ namespace eka2l1 {
         bool subscribe_prop(prop_ident_pair ident, int *request_sts);
         bool unsubscribe_prop(prop_ident_pair ident);
 
+        /**
+         * \brief Create a new property and register it under the given category and key.
+         *
+         * Properties must be created through this function, so that they can be looked up by
+         * category and key. If several properties share a category and key, the first one created
+         * is the one returned by get_prop.
+         *
+         * \returns The new property, or nullptr on failure.
+         */
+        property_ptr create_prop(int category, int key);
+
         property_ptr get_prop(int category, int key); // Get property by category and key
-        property_ptr delete_prop(int category, int key);
+
+        /**
+         * \brief Destroy the property with given category and key.
+         * \returns True if the property existed.
+         */
+        bool delete_prop(int category, int key);
 
         void complete_undertakers(kernel::thread *literally_dies);
 
@@ -542,6 +564,10 @@ namespace eka2l1 {
             return lib_mngr_.get();
         }
 
+        kernel::relocated_image_cache &get_relocated_image_cache() {
+            return reloc_image_cache_;
+        }
+
         config::state *get_config() {
             return conf_;
         }
@@ -585,6 +611,10 @@ namespace eka2l1 {
             return codesegs_;
         }
 
+        std::vector<kernel_obj_unq_ptr> &get_chunk_list() {
+            return chunks_;
+        }
+
         /*! \brief Get kernel object by handle
         */
         template <typename T>
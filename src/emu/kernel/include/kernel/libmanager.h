@@ -29,8 +29,11 @@
 #include <functional>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace YAML {
     class Node;
@@ -136,6 +139,13 @@ namespace eka2l1 {
             std::vector<patch_pending_entry> patch_pendings_;
             std::map<address, address> trampoline_lookup_;
 
+            // Search directory (lowercased) -> lowercased file name -> mask of the drives that have the file
+            std::unordered_map<std::u16string, std::unordered_map<std::u16string, std::uint32_t>> dll_index_;
+            std::mutex dll_index_lock_;
+            std::size_t drive_change_handle_;
+
+            std::uint32_t find_in_dll_index(const std::u16string &search_path, const std::u16string &lowered_name);
+
         protected:
             const std::uint8_t *entry_points_call_routine_;
             const std::uint8_t *thread_entry_routine_;
@@ -176,6 +186,32 @@ namespace eka2l1 {
             */
             codeseg_ptr load(const std::u16string &name);
 
+            /**
+             * \brief Drop the index used to resolve library names to paths.
+             *
+             * Each search directory is listed once and the listing is reused by later loads,
+             * including for misses. Call this when files have been added to or removed from
+             * those directories outside of the emulated file server (package install, drive change...).
+             */
+            void invalidate_dll_index();
+
+            /**
+             * \brief Drop the cached listings that may have changed after an entry was modified.
+             *
+             * Only the listings of the directory containing the entry and of the directories under it
+             * are dropped, on any drive. Call this when a file is created, renamed or deleted through
+             * the emulated file server.
+             *
+             * \param changed_path Absolute path of the entry that was created, renamed or deleted.
+             */
+            void invalidate_dll_index(const std::u16string &changed_path);
+
+            /**
+             * \brief Get the paths of every existing file a library name may resolve to, in search order.
+             * \param name The library name. If it has a drive, only that drive is looked at.
+             */
+            std::vector<std::u16string> find_library_candidates(const std::u16string &name);
+
             // Search through all drives, which will parse all existing file
             std::pair<std::optional<loader::e32img>, std::optional<loader::romimg>>
             try_search_and_parse(const std::u16string &path, std::u16string *full_path = nullptr);
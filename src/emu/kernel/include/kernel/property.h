@@ -27,7 +27,9 @@
 #include <utils/reqsts.h>
 
 #include <array>
+#include <cstring>
 #include <memory>
+#include <optional>
 #include <vector>
 
 namespace eka2l1 {
@@ -55,11 +57,18 @@ namespace eka2l1 {
         public:
             typedef void (*data_change_callback_handler)(void *userdata, service::property *prop);
 
+            enum {
+                INLINE_DATA_SIZE = 32 ///< Binary values up to this size are stored without heap allocation.
+            };
+
         protected:
             int ndata;
+
+            std::array<uint8_t, INLINE_DATA_SIZE> inline_bindata;
             std::vector<uint8_t> bindata;
 
             uint32_t data_len;
+            bool data_inline;
 
             service::property_type data_type;
 
@@ -70,6 +79,12 @@ namespace eka2l1 {
 
             void fire_data_change_callbacks();
 
+            /**
+             * \brief Make sure the storage can hold the given amount of binary data.
+             * \returns Pointer to the storage.
+             */
+            uint8_t *reserve_bin(const uint32_t size);
+
         public:
             explicit property(kernel_system *kern);
 
@@ -115,16 +130,27 @@ namespace eka2l1 {
             int get_int();
             std::vector<uint8_t> get_bin();
 
+            /**
+             * \brief Get the pointer to the binary data, without copying it.
+             *
+             * The pointer is only valid until the next time the property value is changed.
+             */
+            const uint8_t *get_bin_ptr() const {
+                return data_inline ? inline_bindata.data() : bindata.data();
+            }
+
+            uint32_t get_bin_size() const {
+                return data_len;
+            }
+
             template <typename T>
             std::optional<T> get_pkg() {
-                auto bin = get_bin();
-
-                if (bin.size() != sizeof(T)) {
+                if (data_len != sizeof(T)) {
                     return std::optional<T>{};
                 }
 
                 T ret;
-                memcpy(&ret, bin.data(), bin.size());
+                memcpy(&ret, get_bin_ptr(), sizeof(T));
 
                 return ret;
             }
@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2019 EKA2L1 Team.
+ * 
+ * This file is part of EKA2L1 project.
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <common/types.h>
+
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+namespace eka2l1::kernel {
+    struct relocated_image_key {
+        std::uint64_t content_hash_;        ///< Hash of the unrelocated code, data and relocation list.
+        address code_run_addr_;
+        address data_run_addr_;
+
+        bool operator == (const relocated_image_key &rhs) const {
+            return (content_hash_ == rhs.content_hash_) && (code_run_addr_ == rhs.code_run_addr_) && (data_run_addr_ == rhs.data_run_addr_);
+        }
+    };
+
+    struct relocated_image {
+        std::vector<std::uint8_t> code_;
+        std::vector<std::uint8_t> data_;
+
+        std::size_t total_size() const {
+            return code_.size() + data_.size();
+        }
+    };
+
+    /**
+     * \brief Keeps the images of codesegs that have already been relocated to a given address.
+     *
+     * Relaunching an app, or attaching a DLL whose data lands at the same address in another process,
+     * gives the same relocated image. It is then copied from here instead of walking the relocation list again.
+     * Imports are not part of the image, since they depend on where the dependencies are in each process.
+     *
+     * The least recently used images are dropped once the total size goes over the limit.
+     */
+    class relocated_image_cache {
+        struct key_hasher {
+            std::size_t operator()(const relocated_image_key &key) const {
+                return static_cast<std::size_t>(key.content_hash_ ^ (static_cast<std::uint64_t>(key.code_run_addr_) << 32) ^ key.data_run_addr_);
+            }
+        };
+
+        using lru_list = std::list<std::pair<relocated_image_key, relocated_image>>;
+
+        lru_list images_;
+        std::unordered_map<relocated_image_key, lru_list::iterator, key_hasher> lookup_;
+
+        std::size_t total_size_;
+        std::size_t max_size_;
+
+    public:
+        explicit relocated_image_cache(const std::size_t max_size);
+
+        /**
+         * \brief Find an image, and mark it as the most recently used.
+         * \returns Nullptr if no image has been cached for the key.
+         */
+        const relocated_image *find(const relocated_image_key &key);
+
+        /**
+         * \brief Add an image, replacing the one with the same key if there is.
+         *
+         * Images bigger than the whole cache are not kept.
+         */
+        void add(const relocated_image_key &key, relocated_image &&image);
+
+        void clear();
+
+        std::size_t total_size() const {
+            return total_size_;
+        }
+
+        std::size_t count() const {
+            return images_.size();
+        }
+    };
+}
@@ -171,6 +171,10 @@ namespace eka2l1 {
             return mmc_impl_->committed();
         }
 
+        std::size_t chunk::resident() const {
+            return mmc_impl_->resident();
+        }
+
         const std::uint32_t chunk::bottom_offset() const {
             return mmc_impl_->bottom();
         }
@@ -141,6 +141,7 @@ namespace eka2l1::kernel {
 
         bool code_chunk_for_reuse = eligible_for_codeseg_reuse();
         bool need_patch_and_reloc = true;
+        bool code_needs_copy = false;
 
         unmark();
 
@@ -162,9 +163,9 @@ namespace eka2l1::kernel {
 
                 the_addr_of_code_run = code_chunk->base(new_foe).ptr_address();
 
-                // Copy data
+                // Code is copied later, possibly already relocated
                 code_base_ptr = reinterpret_cast<std::uint8_t *>(code_chunk->host_base());
-                std::copy(code_data.get(), code_data.get() + code_size, code_base_ptr); // .code
+                code_needs_copy = true;
 
                 if (code_chunk_for_reuse) {
                     code_chunk_shared = code_chunk;
@@ -208,9 +209,7 @@ namespace eka2l1::kernel {
             data_base_ptr = reinterpret_cast<std::uint8_t *>(dt_chunk->host_base()) + add_offset;
             the_addr_of_data_run = dt_chunk->base(new_foe).ptr_address() + add_offset;
 
-            // Confirmed that if data is in ROM, only BSS is reserved
-            std::copy(constant_data.get(), constant_data.get() + data_size, data_base_ptr); // .data
-
+            // Confirmed that if data is in ROM, only BSS is reserved. The .data is copied later, possibly already relocated
             const std::uint32_t bss_off = data_size;
             std::fill(data_base_ptr + bss_off, data_base_ptr + bss_off + bss_size, 0); // .bss
         } else {
@@ -226,99 +225,148 @@ namespace eka2l1::kernel {
         // Attach all of its dependencies
         for (auto &dependency : dependencies) {
             dependency.dep_->attach(new_foe);
+        }
+
+        // Relocate first, then fix up the imports, same as the real loader. Relocation only depends on where this codeseg
+        // runs, so an image relocated before for the same addresses can be copied as is.
+        const bool data_needs_copy = (data_size_align != 0);
+        const bool can_use_relocated_cache = need_patch_and_reloc && !relocation_list.empty() && code_needs_copy
+            && (data_needs_copy || (data_size == 0));
+
+        const relocated_image *cached_image = nullptr;
+        relocated_image_key cache_key;
+
+        if (can_use_relocated_cache) {
+            cache_key.content_hash_ = get_image_hash();
+            cache_key.code_run_addr_ = the_addr_of_code_run;
+            cache_key.data_run_addr_ = the_addr_of_data_run;
+
+            cached_image = kern->get_relocated_image_cache().find(cache_key);
+        }
+
+        if (cached_image) {
+            std::copy(cached_image->code_.begin(), cached_image->code_.end(), code_base_ptr);
+
+            if (data_needs_copy) {
+                std::copy(cached_image->data_.begin(), cached_image->data_.end(), data_base_ptr);
+            }
+        } else {
+            if (code_needs_copy) {
+                std::copy(code_data.get(), code_data.get() + code_size, code_base_ptr); // .code
+            }
+
+            if (data_needs_copy) {
+                std::copy(constant_data.get(), constant_data.get() + data_size, data_base_ptr); // .data
+            }
 
-            // Patch what imports we need
             if (need_patch_and_reloc) {
-                if ((code_addr && forcefully) || !code_addr) {
-                    for (const std::uint64_t import : dependency.import_info_) {
-                        const std::uint16_t ord = (import & 0xFFFF);
-                        const std::uint16_t adj = (import >> 16) & 0xFFFF;
-                        const std::uint32_t offset_to_apply = (import >> 32) & 0xFFFFFFFF;
-
-                        const address addr = dependency.dep_->lookup(new_foe, ord);
-                        if (!addr) {
-                            LOG_ERROR(KERNEL, "Invalid ordinal {}, requested from {}", ord, dependency.dep_->name());
-                        }
-
-                        *reinterpret_cast<std::uint32_t *>(&code_base_ptr[offset_to_apply]) = addr + adj;
+                relocate(code_base_ptr, data_base_ptr, the_addr_of_code_run, the_addr_of_data_run);
+            }
+
+            if (can_use_relocated_cache) {
+                relocated_image image;
+                image.code_.assign(code_base_ptr, code_base_ptr + code_size);
+
+                if (data_needs_copy) {
+                    image.data_.assign(data_base_ptr, data_base_ptr + data_size);
+                }
+
+                kern->get_relocated_image_cache().add(cache_key, std::move(image));
+            }
+        }
+
+        // Patch what imports we need
+        if (need_patch_and_reloc && ((code_addr && forcefully) || !code_addr)) {
+            for (auto &dependency : dependencies) {
+                for (const std::uint64_t import : dependency.import_info_) {
+                    const std::uint16_t ord = (import & 0xFFFF);
+                    const std::uint16_t adj = (import >> 16) & 0xFFFF;
+                    const std::uint32_t offset_to_apply = (import >> 32) & 0xFFFFFFFF;
+
+                    const address addr = dependency.dep_->lookup(new_foe, ord);
+                    if (!addr) {
+                        LOG_ERROR(KERNEL, "Invalid ordinal {}, requested from {}", ord, dependency.dep_->name());
                     }
+
+                    *reinterpret_cast<std::uint32_t *>(&code_base_ptr[offset_to_apply]) = addr + adj;
                 }
             }
         }
 
-        if (need_patch_and_reloc) {
-            if (!relocation_list.empty()) {
-                const std::uint32_t code_delta = the_addr_of_code_run - code_base;
-                const std::uint32_t data_delta = the_addr_of_data_run - data_base;
+        if (new_foe)
+            new_foe->codeseg_list.push(&attaches.back()->process_link);
 
-                // Relocate the image
-                for (const std::uint64_t relocate_info : relocation_list) {
-                    const loader::relocation_type rel_type = static_cast<loader::relocation_type>((relocate_info >> 32) & 0xFFFF);
-                    const std::uint32_t offset_to_relocate = static_cast<std::uint32_t>(relocate_info);
+        kern->run_codeseg_loaded_callback(obj_name, new_foe, this);
 
-                    loader::relocate_section sect_type = static_cast<loader::relocate_section>((relocate_info >> 48) & 0xFFFF);
-                    address the_delta = 0;
+        return true;
+    }
 
-                    std::uint8_t *base_ptr = nullptr;
+    void codeseg::relocate(std::uint8_t *code_base_ptr, std::uint8_t *data_base_ptr, const address code_run_addr, const address data_run_addr) {
+        if (relocation_list.empty()) {
+            return;
+        }
 
-                    switch (sect_type) {
-                    case loader::relocate_section_text:
-                        base_ptr = code_base_ptr;
-                        break;
+        const std::uint32_t code_delta = code_run_addr - code_base;
+        const std::uint32_t data_delta = data_run_addr - data_base;
 
-                    case loader::relocate_section_data:
-                        base_ptr = data_base_ptr;
-                        break;
+        for (const std::uint64_t relocate_info : relocation_list) {
+            const loader::relocation_type rel_type = static_cast<loader::relocation_type>((relocate_info >> 32) & 0xFFFF);
+            const std::uint32_t offset_to_relocate = static_cast<std::uint32_t>(relocate_info);
 
-                    default:
-                        break;
-                    }
+            loader::relocate_section sect_type = static_cast<loader::relocate_section>((relocate_info >> 48) & 0xFFFF);
+            address the_delta = 0;
 
-                    std::uint32_t *to_relocate_ptr = reinterpret_cast<std::uint32_t *>(&base_ptr[offset_to_relocate]);
+            std::uint8_t *base_ptr = nullptr;
 
-                    switch (rel_type) {
-                    case loader::relocation_type::data:
-                        the_delta = data_delta;
-                        break;
+            switch (sect_type) {
+            case loader::relocate_section_text:
+                base_ptr = code_base_ptr;
+                break;
 
-                    case loader::relocation_type::text:
-                        the_delta = code_delta;
-                        break;
+            case loader::relocate_section_data:
+                base_ptr = data_base_ptr;
+                break;
 
-                    case loader::relocation_type::inferred: {
-                        // This one is harder
-                        std::uint32_t val = *to_relocate_ptr;
+            default:
+                break;
+            }
 
-                        if ((code_base <= val) && (val <= code_base + code_size)) {
-                            the_delta = code_delta;
-                        } else if ((data_base <= val) && (val <= data_base + data_size + bss_size)) {
-                            the_delta = data_delta;
-                        } else {
-                            LOG_ERROR(KERNEL, "Unable to infer the relocation type of offset 0x{:X}", val);
-                        }
+            std::uint32_t *to_relocate_ptr = reinterpret_cast<std::uint32_t *>(&base_ptr[offset_to_relocate]);
 
-                        break;
-                    }
+            switch (rel_type) {
+            case loader::relocation_type::data:
+                the_delta = data_delta;
+                break;
 
-                    case loader::relocation_type::reserved:
-                        continue;
+            case loader::relocation_type::text:
+                the_delta = code_delta;
+                break;
 
-                    default:
-                        LOG_ERROR(KERNEL, "Unknown code relocation type {}", static_cast<std::uint32_t>(rel_type));
-                        break;
-                    }
+            case loader::relocation_type::inferred: {
+                // This one is harder
+                std::uint32_t val = *to_relocate_ptr;
 
-                    *to_relocate_ptr = *to_relocate_ptr + the_delta;
+                if ((code_base <= val) && (val <= code_base + code_size)) {
+                    the_delta = code_delta;
+                } else if ((data_base <= val) && (val <= data_base + data_size + bss_size)) {
+                    the_delta = data_delta;
+                } else {
+                    LOG_ERROR(KERNEL, "Unable to infer the relocation type of offset 0x{:X}", val);
                 }
+
+                break;
             }
-        }
 
-        if (new_foe)
-            new_foe->codeseg_list.push(&attaches.back()->process_link);
+            case loader::relocation_type::reserved:
+                continue;
 
-        kern->run_codeseg_loaded_callback(obj_name, new_foe, this);
+            default:
+                LOG_ERROR(KERNEL, "Unknown code relocation type {}", static_cast<std::uint32_t>(rel_type));
+                break;
+            }
 
-        return true;
+            *to_relocate_ptr = *to_relocate_ptr + the_delta;
+        }
     }
 
     bool codeseg::detach(kernel::process *de_foe) {
@@ -744,6 +792,33 @@ namespace eka2l1::kernel {
         XXH32_freeState(state);
     }
 
+    std::uint64_t codeseg::get_image_hash() {
+        if (!image_hash_inited_) {
+            XXH64_state_t *state = XXH64_createState();
+            XXH64_reset(state, 0);
+
+            const std::uint32_t layout[4] = { code_base, data_base, code_size, data_size };
+            XXH64_update(state, layout, sizeof(layout));
+
+            if (code_data) {
+                XXH64_update(state, code_data.get(), code_size);
+            }
+
+            if (constant_data) {
+                XXH64_update(state, constant_data.get(), data_size);
+            }
+
+            XXH64_update(state, relocation_list.data(), relocation_list.size() * sizeof(std::uint64_t));
+
+            image_hash_ = XXH64_digest(state);
+            image_hash_inited_ = true;
+
+            XXH64_freeState(state);
+        }
+
+        return image_hash_;
+    }
+
     std::uint32_t codeseg::get_hash() {
         if (!hash_inited_) {
             calculate_hash();
@@ -56,6 +56,12 @@
 #include <config/config.h>
 
 namespace eka2l1 {
+    static constexpr std::size_t RELOCATED_IMAGE_CACHE_MAX_SIZE = common::MB(48);
+
+    static std::uint64_t make_prop_index_key(const int category, const int key) {
+        return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(category)) << 32) | static_cast<std::uint32_t>(key);
+    }
+
     void kernel_global_data::reset() {
         // Reset all these to 0
         char_set_.char_data_set_ = 0;
@@ -67,6 +73,7 @@ namespace eka2l1 {
         : btrace_inst_(nullptr)
         , lib_mngr_(nullptr)
         , thr_sch_(nullptr)
+        , reloc_image_cache_(RELOCATED_IMAGE_CACHE_MAX_SIZE)
         , timing_(timing)
         , io_(io_sys)
         , sys_(esys)
@@ -126,6 +133,7 @@ namespace eka2l1 {
         OBJECT_CONTAINER_CLEANUP(undertakers_);
         OBJECT_CONTAINER_CLEANUP(prop_refs_);
         OBJECT_CONTAINER_CLEANUP(props_);
+        prop_index_.clear();
         OBJECT_CONTAINER_CLEANUP(chunks_);
 
         for (std::size_t i = 0; i < msgs_.size(); i++) {
@@ -752,6 +760,26 @@ namespace eka2l1 {
             return true;
         }
 
+        if (obj->get_object_type() == kernel::object_type::prop) {
+            property_ptr prop = reinterpret_cast<property_ptr>(obj);
+            auto index_ite = prop_index_.find(make_prop_index_key(prop->first, prop->second));
+
+            if ((index_ite != prop_index_.end()) && (index_ite->second == prop)) {
+                prop_index_.erase(index_ite);
+
+                // Another property may have been created with the same category and key. It takes over,
+                // in creation order, like it would be found by a scan
+                for (auto &other_obj : props_) {
+                    property_ptr other = reinterpret_cast<property_ptr>(other_obj.get());
+
+                    if ((other != prop) && (other->first == prop->first) && (other->second == prop->second)) {
+                        prop_index_.emplace(make_prop_index_key(other->first, other->second), other);
+                        break;
+                    }
+                }
+            }
+        }
+
         switch (obj->get_object_type()) {
 #define OBJECT_SEARCH(obj_type, obj_map)                                                                         \
     case kernel::object_type::obj_type: {                                                                        \
@@ -989,43 +1017,40 @@ namespace eka2l1 {
         (msgs_.begin() + msg->id - 1)->reset();
     }
 
-    property_ptr kernel_system::get_prop(int category, int key) {
-        auto prop_res = std::find_if(props_.begin(), props_.end(),
-            [=](const auto &prop_obj) {
-                property_ptr prop = reinterpret_cast<property_ptr>(prop_obj.get());
-                if (prop->first == category && prop->second == key) {
-                    return true;
-                }
+    property_ptr kernel_system::create_prop(int category, int key) {
+        property_ptr prop = create<service::property>();
 
-                return false;
-            });
-
-        if (prop_res == props_.end()) {
-            return property_ptr(nullptr);
+        if (!prop) {
+            return nullptr;
         }
 
-        return reinterpret_cast<property_ptr>(prop_res->get());
-    }
+        prop->first = category;
+        prop->second = key;
 
-    property_ptr kernel_system::delete_prop(int category, int key) {
-        auto prop_res = std::find_if(props_.begin(), props_.end(),
-            [=](const auto &prop_obj) {
-                property_ptr prop = reinterpret_cast<property_ptr>(prop_obj.get());
-                if (prop->first == category && prop->second == key) {
-                    return true;
-                }
+        // If a property with the same category and key already exists, the first one created stays the
+        // one that is looked up
+        prop_index_.emplace(make_prop_index_key(category, key), prop);
+        return prop;
+    }
 
-                return false;
-            });
+    property_ptr kernel_system::get_prop(int category, int key) {
+        auto prop_res = prop_index_.find(make_prop_index_key(category, key));
 
-        if (prop_res == props_.end()) {
+        if (prop_res == prop_index_.end()) {
             return property_ptr(nullptr);
         }
 
-        property_ptr prop_ptr = reinterpret_cast<property_ptr>(prop_res->get());
-        props_.erase(prop_res);
+        return prop_res->second;
+    }
+
+    bool kernel_system::delete_prop(int category, int key) {
+        property_ptr prop = get_prop(category, key);
+
+        if (!prop) {
+            return false;
+        }
 
-        return prop_ptr;
+        return destroy(prop);
     }
 
     kernel::handle kernel_system::mirror(kernel::thread *own_thread, kernel::handle handle, kernel::owner_type owner) {
@@ -43,6 +43,7 @@
 #include <kernel/codeseg.h>
 #include <kernel/kernel.h>
 
+#include <algorithm>
 #include <cctype>
 
 namespace eka2l1::hle {
@@ -871,41 +872,15 @@ namespace eka2l1::hle {
         };
 
         if (!eka2l1::has_root_dir(lib_path)) {
-            auto org_root_name = eka2l1::root_name(lib_path, true);
-            auto fname = eka2l1::filename(lib_path, true);
+            for (const std::u16string &candidate : find_library_candidates(lib_path)) {
+                lib_path = candidate;
 
-            // Nope ? We need to cycle through all possibilities
-            for (std::size_t i = 0; i < search_paths.size(); i++) {
-                bool only_once = eka2l1::has_root_name(search_paths[i], true);
+                auto result = open_and_get(lib_path);
+                if (result.first != std::nullopt || result.second != std::nullopt) {
+                    if (full_path)
+                        *full_path = lib_path;
 
-                if (only_once && !org_root_name.empty()) {
-                    continue;
-                }
-
-                for (drive_number drv = drive_a; drv <= drive_z; drv = static_cast<drive_number>(static_cast<int>(drv) + 1)) {
-                    const char16_t drvc = drive_to_char16(drv);
-
-                    if (!org_root_name.empty()) {
-                        lib_path = org_root_name;
-                    } else if (!only_once) {
-                        lib_path = drvc;
-                        lib_path += u':';
-                    }
-
-                    lib_path += search_paths[i];
-                    lib_path += fname;
-
-                    auto result = open_and_get(lib_path);
-                    if (result.first != std::nullopt || result.second != std::nullopt) {
-                        if (full_path)
-                            *full_path = lib_path;
-
-                        return result;
-                    }
-
-                    if (only_once) {
-                        break;
-                    }
+                    return result;
                 }
             }
 
@@ -953,42 +928,11 @@ namespace eka2l1::hle {
         // Create a new codeseg, we should try search these files
         // Absolute yet ?
         if (!eka2l1::has_root_dir(lib_path)) {
-            auto org_root_name = eka2l1::root_name(lib_path, true);
-            auto fname = eka2l1::filename(lib_path, true);
-
-            // Nope ? We need to cycle through all possibilities
-            for (std::size_t i = 0; i < search_paths.size(); i++) {
-                bool only_once = eka2l1::has_root_name(search_paths[i]);
-
-                if (only_once && !org_root_name.empty()) {
-                    continue;
-                }
-
-                for (drive_number drv = drive_a; drv <= drive_z; drv = static_cast<drive_number>(static_cast<int>(drv) + 1)) {
-                    const char16_t drvc = drive_to_char16(drv);
-
-                    if (!org_root_name.empty()) {
-                        lib_path = org_root_name;
-                    } else {
-                        if (!only_once) {
-                            lib_path = drvc;
-                            lib_path += u':';
-                        }
-                    }
-
-                    lib_path += search_paths[i];
-                    lib_path += fname;
-
-                    if (io_->exist(lib_path)) {
-                        auto result = load_depend_on_drive(lib_path);
-                        if (result != nullptr) {
-                            result->set_full_path(lib_path);
-                            return result;
-                        }
-                    }
-
-                    if (only_once || !org_root_name.empty())
-                        break;
+            for (const std::u16string &candidate : find_library_candidates(lib_path)) {
+                auto result = load_depend_on_drive(candidate);
+                if (result != nullptr) {
+                    result->set_full_path(candidate);
+                    return result;
                 }
             }
 
@@ -1012,6 +956,132 @@ namespace eka2l1::hle {
         return nullptr;
     }
 
+    std::uint32_t lib_manager::find_in_dll_index(const std::u16string &search_path, const std::u16string &lowered_name) {
+        const std::lock_guard<std::mutex> guard(dll_index_lock_);
+        const std::u16string lowered_search_path = common::lowercase_ucs2_string(search_path);
+
+        auto dir_ite = dll_index_.find(lowered_search_path);
+
+        if (dir_ite == dll_index_.end()) {
+            // First time this directory is searched, list it on every drive it may be on. Missing directories
+            // still get an (empty) entry, so they are not looked up again.
+            std::unordered_map<std::u16string, std::uint32_t> entries;
+
+            auto index_directory = [&](const drive_number drv, const std::u16string &dir_path) {
+                if (auto dir = io_->open_dir(dir_path, {}, io_attrib_include_file)) {
+                    while (auto entry = dir->get_next_entry()) {
+                        if (entry->type == io_component_type::file) {
+                            entries[common::lowercase_ucs2_string(common::utf8_to_ucs2(entry->name))] |= (1 << static_cast<int>(drv));
+                        }
+                    }
+                }
+            };
+
+            if (eka2l1::has_root_name(search_path, true)) {
+                const drive_number drv = char16_to_drive(search_path[0]);
+                if (drv != drive_invalid) {
+                    index_directory(drv, search_path);
+                }
+            } else {
+                for (drive_number drv = drive_a; drv <= drive_z; drv = static_cast<drive_number>(static_cast<int>(drv) + 1)) {
+                    std::u16string dir_path;
+                    dir_path += drive_to_char16(drv);
+                    dir_path += u':';
+                    dir_path += search_path;
+
+                    index_directory(drv, dir_path);
+                }
+            }
+
+            dir_ite = dll_index_.emplace(lowered_search_path, std::move(entries)).first;
+        }
+
+        auto name_ite = dir_ite->second.find(lowered_name);
+        return (name_ite == dir_ite->second.end()) ? 0 : name_ite->second;
+    }
+
+    std::vector<std::u16string> lib_manager::find_library_candidates(const std::u16string &name) {
+        std::vector<std::u16string> candidates;
+
+        const std::u16string org_root_name = eka2l1::root_name(name, true);
+        const std::u16string fname = eka2l1::filename(name, true);
+        const std::u16string lowered_fname = common::lowercase_ucs2_string(fname);
+
+        const drive_number org_drive = org_root_name.empty() ? drive_invalid : char16_to_drive(org_root_name[0]);
+
+        for (std::size_t i = 0; i < search_paths.size(); i++) {
+            const bool only_once = eka2l1::has_root_name(search_paths[i], true);
+
+            if (only_once && !org_root_name.empty()) {
+                continue;
+            }
+
+            std::uint32_t drive_mask = find_in_dll_index(search_paths[i], lowered_fname);
+
+            if (org_drive != drive_invalid) {
+                drive_mask &= (1 << static_cast<int>(org_drive));
+            }
+
+            if (only_once) {
+                if (drive_mask) {
+                    candidates.push_back(search_paths[i] + fname);
+                }
+
+                continue;
+            }
+
+            for (drive_number drv = drive_a; drive_mask; drv = static_cast<drive_number>(static_cast<int>(drv) + 1)) {
+                if (drive_mask & (1 << static_cast<int>(drv))) {
+                    std::u16string lib_path;
+                    lib_path += drive_to_char16(drv);
+                    lib_path += u':';
+                    lib_path += search_paths[i];
+                    lib_path += fname;
+
+                    candidates.push_back(lib_path);
+                    drive_mask &= ~(1 << static_cast<int>(drv));
+                }
+            }
+        }
+
+        return candidates;
+    }
+
+    void lib_manager::invalidate_dll_index() {
+        const std::lock_guard<std::mutex> guard(dll_index_lock_);
+        dll_index_.clear();
+    }
+
+    static std::u16string normalize_dll_index_directory(std::u16string dir) {
+        dir = common::lowercase_ucs2_string(dir);
+
+        // Listings of search paths with no drive are shared by all drives, compare without it
+        if (eka2l1::has_root_name(dir, true)) {
+            dir.erase(0, eka2l1::root_name(dir, true).length());
+        }
+
+        std::replace(dir.begin(), dir.end(), u'/', u'\\');
+
+        if (dir.empty() || (dir.back() != u'\\')) {
+            dir += u'\\';
+        }
+
+        return dir;
+    }
+
+    void lib_manager::invalidate_dll_index(const std::u16string &changed_path) {
+        const std::u16string changed_dir = normalize_dll_index_directory(eka2l1::file_directory(changed_path, true));
+        const std::lock_guard<std::mutex> guard(dll_index_lock_);
+
+        for (auto ite = dll_index_.begin(); ite != dll_index_.end();) {
+            if (normalize_dll_index_directory(ite->first).compare(0, changed_dir.length(), changed_dir) == 0) {
+                ite = dll_index_.erase(ite);
+            } else {
+                ite++;
+            }
+        }
+    }
+
     void lib_manager::jump_trampoline_through_svc() {
         kernel::thread *crr = kern_->crr_thread();
         arm::core::thread_context &context = crr->get_thread_context();
@@ -1198,7 +1268,8 @@ namespace eka2l1::hle {
         , rom_drv_(drive_invalid)
         , additional_mode_(0)
         , entry_points_call_routine_(nullptr)
-        , thread_entry_routine_(nullptr) {
+        , thread_entry_routine_(nullptr)
+        , drive_change_handle_(0) {
         hle::symbols sb;
         std::string lib_name;
 
@@ -1259,9 +1330,17 @@ namespace eka2l1::hle {
             // Circumvent ROM vs ROFS issue at the moment.
             additional_mode_ = PREFER_PHYSICAL;
         }
+
+        drive_change_handle_ = io_->register_drive_change_notify([this](void *userdata, drive_number drv, drive_action act) {
+            invalidate_dll_index();
+        }, nullptr);
     }
 
     lib_manager::~lib_manager() {
+        if (drive_change_handle_) {
+            io_->remove_drive_change_notify(drive_change_handle_);
+        }
+
         svc_funcs_.clear();
     }
 
@@ -25,14 +25,18 @@
 
 #include <common/log.h>
 
+#include <algorithm>
+#include <cstring>
+
 namespace eka2l1 {
     namespace service {
         property::property(kernel_system *kern)
             : kernel::kernel_obj(kern, "", nullptr, kernel::access_type::global_access)
+            , inline_bindata{}
             , data_len(0)
+            , data_inline(true)
             , data_type(service::property_type::unk) {
             obj_type = kernel::object_type::prop;
-            bindata.reserve(512);
 
             increase_access_count();
         }
@@ -51,6 +55,29 @@ namespace eka2l1 {
             }
         }
 
+        uint8_t *property::reserve_bin(const uint32_t size) {
+            if (size <= INLINE_DATA_SIZE) {
+                // Small values (most of them are integers or tiny structures) stay inline
+                if (!data_inline) {
+                    std::memcpy(inline_bindata.data(), bindata.data(), std::min<std::size_t>(bindata.size(), size));
+                    data_inline = true;
+                }
+
+                return inline_bindata.data();
+            }
+
+            if (data_inline) {
+                bindata.resize(size);
+                std::memcpy(bindata.data(), inline_bindata.data(), std::min<std::size_t>(data_len, INLINE_DATA_SIZE));
+
+                data_inline = false;
+            } else if (bindata.size() < size) {
+                bindata.resize(size);
+            }
+
+            return bindata.data();
+        }
+
         void property::define(service::property_type pt, uint32_t pre_allocated) {
             data_type = pt;
             data_len = pre_allocated;
@@ -60,7 +87,7 @@ namespace eka2l1 {
                 data_len = 512;
             }
 
-            bindata.resize(data_len);
+            reserve_bin(data_len);
         }
 
         bool property::set_int(int val) {
@@ -77,11 +104,7 @@ namespace eka2l1 {
         }
 
         bool property::set(uint8_t *bdata, uint32_t arr_length) {
-            if (arr_length > data_len) {
-                bindata.resize(arr_length);
-            }
-
-            memcpy(bindata.data(), bdata, arr_length);
+            std::memcpy(reserve_bin(arr_length), bdata, arr_length);
             data_len = arr_length;
 
             notify_request(epoc::error_none);
@@ -99,12 +122,8 @@ namespace eka2l1 {
         }
 
         std::vector<uint8_t> property::get_bin() {
-            std::vector<uint8_t> local;
-            local.resize(data_len);
-
-            memcpy(local.data(), bindata.data(), data_len);
-
-            return local;
+            const uint8_t *data_ptr = get_bin_ptr();
+            return std::vector<uint8_t>(data_ptr, data_ptr + data_len);
         }
 
         void property::subscribe(epoc::notify_info &info) {
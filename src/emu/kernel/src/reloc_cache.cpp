@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2019 EKA2L1 Team.
+ * 
+ * This file is part of EKA2L1 project.
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <kernel/reloc_cache.h>
+
+namespace eka2l1::kernel {
+    relocated_image_cache::relocated_image_cache(const std::size_t max_size)
+        : total_size_(0)
+        , max_size_(max_size) {
+    }
+
+    const relocated_image *relocated_image_cache::find(const relocated_image_key &key) {
+        auto ite = lookup_.find(key);
+        if (ite == lookup_.end()) {
+            return nullptr;
+        }
+
+        images_.splice(images_.begin(), images_, ite->second);
+        return &ite->second->second;
+    }
+
+    void relocated_image_cache::add(const relocated_image_key &key, relocated_image &&image) {
+        auto ite = lookup_.find(key);
+        if (ite != lookup_.end()) {
+            total_size_ -= ite->second->second.total_size();
+            images_.erase(ite->second);
+            lookup_.erase(ite);
+        }
+
+        const std::size_t image_size = image.total_size();
+        if (image_size > max_size_) {
+            return;
+        }
+
+        while (!images_.empty() && (total_size_ + image_size > max_size_)) {
+            total_size_ -= images_.back().second.total_size();
+            lookup_.erase(images_.back().first);
+            images_.pop_back();
+        }
+
+        images_.emplace_front(key, std::move(image));
+        lookup_.emplace(key, images_.begin());
+
+        total_size_ += image_size;
+    }
+
+    void relocated_image_cache::clear() {
+        images_.clear();
+        lookup_.clear();
+
+        total_size_ = 0;
+    }
+}
@@ -2493,18 +2493,19 @@ namespace eka2l1::epoc {
         }
 
         std::uint8_t *data_ptr = data.get(crr_pr);
-        auto data_vec = prop->get_bin();
+        const std::uint8_t *prop_data = prop->get_bin_ptr();
+        const std::size_t prop_data_size = prop->get_bin_size();
 
-        const std::size_t size_to_copy = std::min<std::size_t>(data_vec.size(), datlength);
+        const std::size_t size_to_copy = std::min<std::size_t>(prop_data_size, datlength);
         std::int32_t return_code = epoc::error_none;
 
-        if (data_vec.size() > datlength) {
+        if (prop_data_size > datlength) {
             // The given buffer can't hold ours.
             return_code = epoc::error_overflow;
         }
 
         // Whether the buffer is too small, we still have to either copy truncated or full data.
-        std::copy(data_vec.begin(), data_vec.begin() + size_to_copy, data.get(kern->crr_process()));
+        std::copy(prop_data, prop_data + size_to_copy, data_ptr);
 
         if (return_code != epoc::error_none) {
             return return_code;
@@ -2521,14 +2522,11 @@ namespace eka2l1::epoc {
         if (!prop) {
             LOG_WARN(KERNEL, "Property (0x{:x}, 0x{:x}) has not been defined before, undefined behavior may rise", cage, val);
 
-            prop = kern->create<service::property>();
+            prop = kern->create_prop(cage, val);
 
             if (!prop) {
                 return epoc::error_general;
             }
-
-            prop->first = cage;
-            prop->second = val;
         }
 
         auto property_ref_handle_and_obj = kern->create_and_add<service::property_reference>(
@@ -2570,14 +2568,11 @@ namespace eka2l1::epoc {
         property_ptr prop = kern->get_prop(cage, key);
 
         if (!prop) {
-            prop = kern->create<service::property>();
+            prop = kern->create_prop(cage, key);
 
             if (!prop) {
                 return epoc::error_general;
             }
-
-            prop->first = cage;
-            prop->second = key;
         }
 
         prop->define(prop_type, info->size);
@@ -2586,12 +2581,13 @@ namespace eka2l1::epoc {
     }
 
     BRIDGE_FUNC(std::int32_t, property_delete, std::int32_t cage, std::int32_t key) {
-        property_ptr prop = kern->delete_prop(cage, key);
+        property_ptr prop = kern->get_prop(cage, key);
 
         if (!prop || !prop->is_defined()) {
             return epoc::error_not_found;
         }
 
+        kern->delete_prop(cage, key);
         return epoc::error_none;
     }
 
@@ -2674,22 +2670,24 @@ namespace eka2l1::epoc {
             return epoc::error_not_found;
         }
 
-        std::vector<uint8_t> dat = prop->get_property_object()->get_bin();
+        service::property *prop_obj = prop->get_property_object();
+        const std::uint8_t *prop_data = prop_obj->get_bin_ptr();
+        const std::size_t prop_data_size = prop_obj->get_bin_size();
 
-        if (dat.size() == 0) {
+        if (prop_data_size == 0) {
             return epoc::error_argument;
         }
 
-        const std::size_t size_to_copy = std::min<std::size_t>(dat.size(), buffer_size);
+        const std::size_t size_to_copy = std::min<std::size_t>(prop_data_size, buffer_size);
         std::int32_t return_code = epoc::error_none;
 
-        if (dat.size() > buffer_size) {
+        if (prop_data_size > buffer_size) {
             // The given buffer can't hold ours.
             return_code = epoc::error_overflow;
         }
 
         // Whether the buffer is too small, we still have to either copy truncated or full data.
-        std::copy(dat.begin(), dat.begin() + size_to_copy, buffer_ptr_guest.get(kern->crr_process()));
+        std::copy(prop_data, prop_data + size_to_copy, buffer_ptr_guest.get(kern->crr_process()));
 
         if (return_code != epoc::error_none) {
             return return_code;
@@ -4521,15 +4519,12 @@ namespace eka2l1::epoc {
 
         property_ptr prop = kern->get_prop(create_info->arg0_, create_info->arg1_);
         if (!prop) {
-            prop = kern->create<service::property>();
+            prop = kern->create_prop(create_info->arg0_, create_info->arg1_);
 
             if (!prop) {
                 finish_status_request_eka1(target_thread, finish_signal, epoc::error_general);
                 return epoc::error_general;
             }
-
-            prop->first = create_info->arg0_;
-            prop->second = create_info->arg1_;
         }
 
         prop->define(static_cast<service::property_type>(create_info->arg2_), create_info->arg3_);
@@ -4548,15 +4543,12 @@ namespace eka2l1::epoc {
             LOG_WARN(KERNEL, "Property (0x{:x}, 0x{:x}) has not been defined before, undefined behavior may rise", create_info->arg1_,
                 create_info->arg2_);
 
-            prop = kern->create<service::property>();
+            prop = kern->create_prop(create_info->arg1_, create_info->arg2_);
 
             if (!prop) {
                 finish_status_request_eka1(target_thread, finish_signal, epoc::error_general);
                 return epoc::error_general;
             }
-
-            prop->first = create_info->arg1_;
-            prop->second = create_info->arg2_;
         }
 
         auto property_ref_handle_and_obj = kern->create_and_add<service::property_reference>(
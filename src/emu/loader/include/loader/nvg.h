@@ -22,6 +22,7 @@
 #include <common/buffer.h>
 #include <cstdint>
 #include <string>
+#include <vector>
 
 namespace eka2l1::loader {
     enum nvg_convert_error {
@@ -33,7 +34,8 @@ namespace eka2l1::loader {
         NVG_UNRECOGNISED_FILL_PAINT_TYPE,
         NVG_FAILED_TO_WRITE_TO_DEST_FILE,
         NVG_UNKNOWN_PATH_SEGMENT_TYPE,
-        NVG_TVL_FORMAT_UNSUPPORTED
+        NVG_TVL_FORMAT_UNSUPPORTED,
+        NVG_NON_FINITE_COORDINATES
     };
 
     enum nvg_aspect_ratio_mode {
@@ -69,4 +71,17 @@ namespace eka2l1::loader {
 
     bool convert_nvg_to_svg(common::ro_stream &in, common::wo_stream &out, std::vector<nvg_convert_error_description> &errors,
         nvg_options *options = nullptr);
+
+    /**
+     * \brief Render an NVG icon straight into pixels, without going through SVG.
+     *
+     * The destination is premultiplied 32-bit ARGB, the same as what lunasvg renders, and should be
+     * cleared beforehand.
+     *
+     * \param width    Width of the destination, in pixels. Replaces the width in the options.
+     * \param height   Height of the destination, in pixels. Replaces the height in the options.
+     * \param stride   Number of bytes between two rows of the destination.
+     */
+    bool rasterize_nvg(common::ro_stream &in, std::uint8_t *dest, const int width, const int height, const int stride,
+        std::vector<nvg_convert_error_description> &errors, nvg_options *options = nullptr);
 }
\ No newline at end of file
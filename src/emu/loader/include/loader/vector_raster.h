@@ -0,0 +1,189 @@
+/*
+ * Copyright (c) 2019 EKA2L1 Team.
+ * 
+ * This file is part of EKA2L1 project.
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace eka2l1::loader {
+    /**
+     * \brief 2D affine matrix, laid out like in SVG (a b c d e f).
+     *
+     * A point is mapped with x' = a * x + c * y + e, and y' = b * x + d * y + f.
+     */
+    struct raster_matrix {
+        float m_[6] = { 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f };
+
+        raster_matrix() = default;
+        explicit raster_matrix(const float a, const float b, const float c, const float d, const float e, const float f);
+
+        /**
+         * \brief Combine two matrices. The result applies the given matrix first, then this one.
+         */
+        raster_matrix operator*(const raster_matrix &rhs) const;
+
+        bool invert(raster_matrix &result) const;
+        void map(const float x, const float y, float &rx, float &ry) const;
+
+        /**
+         * \brief Get the average scale of the matrix. Used to convert lengths to device space.
+         */
+        float scale_factor() const;
+    };
+
+    struct raster_point {
+        float x_;
+        float y_;
+    };
+
+    enum raster_fill_rule {
+        raster_fill_rule_non_zero = 0,
+        raster_fill_rule_even_odd = 1
+    };
+
+    enum raster_paint_type {
+        raster_paint_solid = 0,
+        raster_paint_linear_gradient = 1,
+        raster_paint_radial_gradient = 2
+    };
+
+    struct raster_gradient_stop {
+        float offset_;
+        float color_[4]; ///< Non-premultiplied RGBA, from 0 to 1.
+    };
+
+    struct raster_paint {
+        raster_paint_type type_ = raster_paint_solid;
+
+        float color_[4] = { 0.0f, 0.0f, 0.0f, 1.0f }; ///< Non-premultiplied RGBA of a solid paint, from 0 to 1.
+        float opacity_ = 1.0f;
+
+        float points_[5] = {}; ///< Linear: x1, y1, x2, y2. Radial: cx, cy, fx, fy, r. All in gradient space.
+        raster_matrix gradient_transform_; ///< Map from gradient space to user space.
+
+        std::vector<raster_gradient_stop> stops_;
+    };
+
+    /**
+     * \brief A path, flattened into polygons in device space as it is built.
+     *
+     * Coordinates given to the path are in user space, and are mapped with the path's transform.
+     */
+    class raster_path {
+        raster_matrix transform_;
+
+        std::vector<std::vector<raster_point>> contours_;
+        std::vector<bool> closed_;
+
+        float start_x_;
+        float start_y_;
+        float current_x_;
+        float current_y_;
+
+        bool finite_;
+
+        void ensure_contour();
+        void add_device_point(const float x, const float y);
+
+    public:
+        explicit raster_path(const raster_matrix &transform = raster_matrix());
+
+        void move_to(const float x, const float y);
+        void line_to(const float x, const float y);
+        void quad_to(const float x1, const float y1, const float x, const float y);
+        void cubic_to(const float x1, const float y1, const float x2, const float y2, const float x, const float y);
+
+        /**
+         * \brief Add an elliptical arc, with the same parameters as the SVG arc command.
+         */
+        void arc_to(const float rx, const float ry, const float angle, const bool large_arc, const bool sweep, const float x, const float y);
+        void close();
+
+        float current_x() const {
+            return current_x_;
+        }
+
+        float current_y() const {
+            return current_y_;
+        }
+
+        const raster_matrix &transform() const {
+            return transform_;
+        }
+
+        const std::vector<std::vector<raster_point>> &contours() const {
+            return contours_;
+        }
+
+        bool is_closed(const std::size_t index) const {
+            return closed_[index];
+        }
+
+        /**
+         * \brief Check if every point of the path mapped to finite device coordinates.
+         *
+         * A path with a NaN or infinite point can't be rasterized.
+         */
+        bool is_finite() const {
+            return finite_;
+        }
+    };
+
+    /**
+     * \brief Scanline rasterizer for filling and stroking paths.
+     *
+     * Draws to premultiplied 32-bit ARGB pixels in native endian, the same layout lunasvg renders to.
+     * Edges are anti-aliased with vertical supersampling and exact horizontal coverage. Strokes
+     * use miter joins, which fall back to bevels past the miter limit, and butt caps.
+     */
+    class vector_raster {
+        std::uint8_t *pixels_;
+
+        int width_;
+        int height_;
+        int stride_;
+
+        std::vector<float> coverage_;
+
+        bool fill_polygons(const std::vector<std::vector<raster_point>> &polygons, const raster_paint &paint, const raster_matrix &user_to_device,
+            const raster_fill_rule rule);
+
+    public:
+        explicit vector_raster(std::uint8_t *pixels, const int width, const int height, const int stride);
+
+        void clear();
+
+        /**
+         * \brief Fill the path.
+         * \return False if the path has non-finite points, in which case nothing is drawn.
+         */
+        bool fill(const raster_path &path, const raster_paint &paint, const raster_fill_rule rule = raster_fill_rule_non_zero);
+
+        /**
+         * \brief Stroke the path.
+         *
+         * \param width       The stroke width, in user space.
+         * \param miter_limit Maximum ratio of the miter length to the stroke width, before a join is beveled.
+         *
+         * \return False if the path has non-finite points or the width is not finite, in which case nothing is drawn.
+         */
+        bool stroke(const raster_path &path, const raster_paint &paint, const float width, const float miter_limit = 4.0f);
+    };
+}
@@ -18,8 +18,10 @@
  */
 
 #include <loader/nvg.h>
+#include <loader/vector_raster.h>
 #include <common/log.h>
 
+#include <algorithm>
 #include <map>
 
 namespace eka2l1::loader {
@@ -116,6 +118,16 @@ namespace eka2l1::loader {
 
         float stroke_width_ = 1.0f;
         float stroke_miter_limit = 4.0f;
+
+        common::wo_stream *out_ = nullptr; ///< SVG output, when converting.
+        vector_raster *raster_ = nullptr; ///< Destination, when rasterizing directly.
+        raster_matrix view_transform_; ///< Viewport to pixels mapping, when rasterizing directly.
+    };
+
+    struct nvg_path_segment {
+        std::uint8_t type_; ///< Segment type, without the relative bit.
+        bool relative_;
+        float values_[6];
     };
 
     void uint32_to_float_rgba(const std::uint32_t rgba, std::uint32_t *rgba_sep) {
@@ -202,7 +214,7 @@ namespace eka2l1::loader {
         return true;
     }
 
-    bool nvg_direct_command_set_fill_color_ramp(nvg_state &state, std::uint32_t command, common::ro_stream &in, common::wo_stream &out, std::vector<nvg_convert_error_description> &errors) {
+    bool nvg_direct_command_set_fill_color_ramp(nvg_state &state, std::uint32_t command, common::ro_stream &in, std::vector<nvg_convert_error_description> &errors) {
         std::uint32_t command_data = 0;
         if (in.read(&command_data, 4) != 4) {
             errors.emplace_back(NVG_READ_COMMAND_DATA_FAILED, in.tell());
@@ -213,7 +225,7 @@ namespace eka2l1::loader {
             in, errors);
     }
 
-    bool nvg_direct_command_set_paint_util(nvg_brush &brush, std::uint32_t command, bool allow_color_ramp_set, common::ro_stream &in, common::wo_stream &out, std::vector<nvg_convert_error_description> &errors) {
+    bool nvg_direct_command_set_paint_util(nvg_brush &brush, std::uint32_t command, bool allow_color_ramp_set, common::ro_stream &in, std::vector<nvg_convert_error_description> &errors) {
         std::uint32_t command_data = 0;
         if (in.read(&command_data, 4) != 4) {
             errors.emplace_back(NVG_READ_COMMAND_DATA_FAILED, in.tell());
@@ -300,20 +312,95 @@ namespace eka2l1::loader {
         return true;
     }
 
-    bool nvg_direct_command_set_fill_paint(nvg_state &state, std::uint32_t command, common::ro_stream &in, common::wo_stream &out, std::vector<nvg_convert_error_description> &errors) {
-        return nvg_direct_command_set_paint_util(state.fill_brush_, command, false, in, out, errors);
+    bool nvg_direct_command_set_fill_paint(nvg_state &state, std::uint32_t command, common::ro_stream &in, std::vector<nvg_convert_error_description> &errors) {
+        return nvg_direct_command_set_paint_util(state.fill_brush_, command, false, in, errors);
+    }
+
+    bool nvg_direct_command_set_stroke_paint(nvg_state &state, std::uint32_t command, common::ro_stream &in, std::vector<nvg_convert_error_description> &errors) {
+        return nvg_direct_command_set_paint_util(state.stroke_brush_, command, true, in, errors);
+    }
+
+    static constexpr std::uint32_t NVG_INVALID_SEGMENT_VALUE_COUNT = 0xFFFFFFFF;
+
+    static std::uint32_t nvg_path_segment_value_count(const std::uint8_t type) {
+        switch (type) {
+        case VG_CLOSE_PATH:
+            return 0;
+
+        case VG_HLINE_TO:
+        case VG_VLINE_TO:
+            return 1;
+
+        case VG_MOVE_TO:
+        case VG_LINE_TO:
+        case VG_SQUAD_TO:
+            return 2;
+
+        case VG_QUAD_TO:
+        case VG_SCUBIC_TO:
+            return 4;
+
+        case VG_SCCWARC_TO:
+        case VG_SCWARC_TO:
+        case VG_LCCWARC_TO:
+        case VG_LCWARC_TO:
+            return 5;
+
+        case VG_CUBIC_TO:
+            return 6;
+
+        default:
+            break;
+        }
+
+        return NVG_INVALID_SEGMENT_VALUE_COUNT;
     }
 
-    bool nvg_direct_command_set_stroke_paint(nvg_state &state, std::uint32_t command, common::ro_stream &in, common::wo_stream &out, std::vector<nvg_convert_error_description> &errors) {
-        return nvg_direct_command_set_paint_util(state.stroke_brush_, command, true, in, out, errors);
+    static bool nvg_is_arc_segment(const std::uint8_t type) {
+        return (type == VG_SCCWARC_TO) || (type == VG_SCWARC_TO) || (type == VG_LCCWARC_TO) || (type == VG_LCWARC_TO);
     }
 
     template <typename T>
-    bool nvg_generate_direction(common::ro_stream &in, std::string &direction, std::vector<nvg_convert_error_description> &errors,
-        const std::vector<std::uint8_t> &segment_types, float scale) {
+    bool nvg_decode_path_segments(common::ro_stream &in, std::vector<nvg_convert_error_description> &errors,
+        const std::vector<std::uint8_t> &segment_types, float scale, std::vector<nvg_path_segment> &segments) {
         static constexpr std::size_t ELEM_T_SIZE = sizeof(T);
 
-        static const std::map<vg_path_segment_type, char> CORRESPOND_SVG_CMD_CHAR = {
+        T values[6];
+
+        for (std::uint8_t segment_type: segment_types) {
+            nvg_path_segment segment;
+            segment.type_ = static_cast<std::uint8_t>(segment_type & ~1);
+            segment.relative_ = (segment_type & 1);
+
+            const std::uint32_t value_count = nvg_path_segment_value_count(segment.type_);
+            if (value_count == NVG_INVALID_SEGMENT_VALUE_COUNT) {
+                errors.emplace_back(NVG_UNKNOWN_PATH_SEGMENT_TYPE, in.tell(), segment.type_);
+                continue;
+            }
+
+            if (in.read(values, ELEM_T_SIZE * value_count) != ELEM_T_SIZE * value_count) {
+                errors.emplace_back(NVG_READ_COMMAND_DATA_FAILED, in.tell());
+                return false;
+            }
+
+            for (std::uint32_t i = 0; i < value_count; i++) {
+                segment.values_[i] = values[i] * scale;
+            }
+
+            if (nvg_is_arc_segment(segment.type_)) {
+                // The rotation angle is not a coordinate
+                segment.values_[2] = static_cast<float>(values[2]);
+            }
+
+            segments.push_back(segment);
+        }
+
+        return true;
+    }
+
+    std::string nvg_generate_direction(const std::vector<nvg_path_segment> &segments) {
+        static const std::map<std::uint8_t, char> CORRESPOND_SVG_CMD_CHAR = {
+            { VG_CLOSE_PATH, 'Z' },
             { VG_LINE_TO, 'L' },
             { VG_HLINE_TO, 'H' },
             { VG_VLINE_TO, 'V' },
@@ -325,108 +412,218 @@ namespace eka2l1::loader {
             { VG_LCCWARC_TO, 'A' },
             { VG_SCCWARC_TO, 'A' },
             { VG_LCWARC_TO, 'A' },
-            { VG_SCCWARC_TO, 'A' }
+            { VG_SCWARC_TO, 'A' }
         };
 
-        T values[6];
-
-        for (std::uint8_t segment_type: segment_types) {
-            if (segment_type == VG_CLOSE_PATH) {
-                break;
-            }
-
-            auto correspond_find_res = CORRESPOND_SVG_CMD_CHAR.find(static_cast<vg_path_segment_type>(segment_type & ~1));
-            if (correspond_find_res == CORRESPOND_SVG_CMD_CHAR.end()) {
-                errors.emplace_back(NVG_UNKNOWN_PATH_SEGMENT_TYPE, in.tell(), segment_type & ~1);
-                continue;
-            }
+        std::string direction;
 
-            char result_char_res = correspond_find_res->second;
-            if (segment_type & 1) {
+        for (const nvg_path_segment &segment: segments) {
+            char result_char_res = CORRESPOND_SVG_CMD_CHAR.at(segment.type_);
+            if (segment.relative_) {
                 // Turn to relative. For SVG just lowercase
                 result_char_res = static_cast<char>(std::tolower(result_char_res));
             }
 
-            switch (segment_type) {
-            case VG_HLINE_TO:
-            case VG_VLINE_TO: {
-                T to_pos = 0;
-                        
-                if (in.read(&to_pos, ELEM_T_SIZE) != ELEM_T_SIZE) {
-                    errors.emplace_back(NVG_READ_COMMAND_DATA_FAILED, in.tell());
-                    return false;
-                }
+            const float *values = segment.values_;
 
-                direction += fmt::format("{} {} ", result_char_res, to_pos * scale);
+            switch (segment.type_) {
+            case VG_CLOSE_PATH:
+                direction += fmt::format("{} ", result_char_res);
+                break;
+
+            case VG_HLINE_TO:
+            case VG_VLINE_TO:
+                direction += fmt::format("{} {} ", result_char_res, values[0]);
                 break;
-            }
 
             case VG_MOVE_TO:
             case VG_LINE_TO:
-            case VG_SQUAD_TO: {
-                if (in.read(values, ELEM_T_SIZE * 2) != ELEM_T_SIZE * 2) {
-                    errors.emplace_back(NVG_READ_COMMAND_DATA_FAILED, in.tell());
-                    return false;
-                }
-
-                direction += fmt::format("{} {} {} ", result_char_res, values[0] * scale, values[1] * scale);
+            case VG_SQUAD_TO:
+                direction += fmt::format("{} {} {} ", result_char_res, values[0], values[1]);
                 break;
-            }
 
             case VG_SCCWARC_TO:
             case VG_SCWARC_TO:
             case VG_LCCWARC_TO:
             case VG_LCWARC_TO: {
-                const bool is_counterclock_wise = (segment_type == VG_SCCWARC_TO) || (segment_type == VG_LCCWARC_TO);
-                const bool is_small = (segment_type == VG_SCWARC_TO) || (segment_type == VG_SCCWARC_TO);
+                const bool is_counterclock_wise = (segment.type_ == VG_SCCWARC_TO) || (segment.type_ == VG_LCCWARC_TO);
+                const bool is_small = (segment.type_ == VG_SCWARC_TO) || (segment.type_ == VG_SCCWARC_TO);
 
-                if (in.read(values, ELEM_T_SIZE * 5) != ELEM_T_SIZE * 5) {
-                    errors.emplace_back(NVG_READ_COMMAND_DATA_FAILED, in.tell());
-                    return false;
-                }
+                direction += fmt::format("{} {} {}, {}, {} {}, {} {} ", result_char_res, values[0], values[1],
+                    values[2], is_small ? 0 : 1, is_counterclock_wise ? 0 : 1, values[3], values[4]);
 
-                direction += fmt::format("{} {} {}, {}, {} {}, {} {} ", result_char_res, values[0] * scale, values[1] * scale,
-                    values[2], is_small ? 0 : 1, is_counterclock_wise ? 0 : 1, values[3] * scale, values[4] * scale);
+                break;
+            }
+
+            case VG_QUAD_TO:
+            case VG_SCUBIC_TO:
+                direction += fmt::format("{} {} {}, {} {} ", result_char_res, values[0], values[1],
+                    values[2], values[3]);
+
+                break;
+
+            case VG_CUBIC_TO:
+                direction += fmt::format("{} {} {}, {} {}, {} {} ", result_char_res, values[0], values[1],
+                    values[2], values[3], values[4], values[5]);
+
+                break;
 
+            default:
+                assert(false && "Unreachable!");
                 break;
             }
+        }
+
+        return direction;
+    }
+
+    void nvg_build_raster_path(const std::vector<nvg_path_segment> &segments, raster_path &path) {
+        // Smooth curves reflect the last control point of the previous curve of the same kind
+        float last_control_x = 0.0f;
+        float last_control_y = 0.0f;
+
+        std::uint8_t last_type = VG_CLOSE_PATH;
+
+        for (const nvg_path_segment &segment: segments) {
+            const float base_x = segment.relative_ ? path.current_x() : 0.0f;
+            const float base_y = segment.relative_ ? path.current_y() : 0.0f;
+
+            const float *values = segment.values_;
+
+            switch (segment.type_) {
+            case VG_CLOSE_PATH:
+                path.close();
+                break;
+
+            case VG_MOVE_TO:
+                path.move_to(base_x + values[0], base_y + values[1]);
+                break;
+
+            case VG_LINE_TO:
+                path.line_to(base_x + values[0], base_y + values[1]);
+                break;
+
+            case VG_HLINE_TO:
+                path.line_to(base_x + values[0], path.current_y());
+                break;
+
+            case VG_VLINE_TO:
+                path.line_to(path.current_x(), base_y + values[0]);
+                break;
 
             case VG_QUAD_TO:
-            case VG_SCUBIC_TO: {
-                if (in.read(values, ELEM_T_SIZE * 4) != ELEM_T_SIZE * 4) {
-                    errors.emplace_back(NVG_READ_COMMAND_DATA_FAILED, in.tell());
-                    return false;
+            case VG_SQUAD_TO: {
+                float control_x = base_x + values[0];
+                float control_y = base_y + values[1];
+
+                float end_x = base_x + values[2];
+                float end_y = base_y + values[3];
+
+                if (segment.type_ == VG_SQUAD_TO) {
+                    const bool reflect = (last_type == VG_QUAD_TO) || (last_type == VG_SQUAD_TO);
+
+                    control_x = reflect ? (2 * path.current_x() - last_control_x) : path.current_x();
+                    control_y = reflect ? (2 * path.current_y() - last_control_y) : path.current_y();
+
+                    end_x = base_x + values[0];
+                    end_y = base_y + values[1];
                 }
 
-                direction += fmt::format("{} {} {}, {} {} ", result_char_res, values[0] * scale, values[1] * scale,
-                    values[2] * scale, values[3] * scale);
+                path.quad_to(control_x, control_y, end_x, end_y);
+
+                last_control_x = control_x;
+                last_control_y = control_y;
 
                 break;
             }
 
-            case VG_CUBIC_TO: {
-                if (in.read(values, ELEM_T_SIZE * 6) != ELEM_T_SIZE * 6) {
-                    errors.emplace_back(NVG_READ_COMMAND_DATA_FAILED, in.tell());
-                    return false;
+            case VG_CUBIC_TO:
+            case VG_SCUBIC_TO: {
+                float control1_x = base_x + values[0];
+                float control1_y = base_y + values[1];
+
+                float control2_x = base_x + values[2];
+                float control2_y = base_y + values[3];
+
+                float end_x = base_x + values[4];
+                float end_y = base_y + values[5];
+
+                if (segment.type_ == VG_SCUBIC_TO) {
+                    const bool reflect = (last_type == VG_CUBIC_TO) || (last_type == VG_SCUBIC_TO);
+
+                    control1_x = reflect ? (2 * path.current_x() - last_control_x) : path.current_x();
+                    control1_y = reflect ? (2 * path.current_y() - last_control_y) : path.current_y();
+
+                    control2_x = base_x + values[0];
+                    control2_y = base_y + values[1];
+
+                    end_x = base_x + values[2];
+                    end_y = base_y + values[3];
                 }
 
-                direction += fmt::format("{} {} {}, {} {}, {} {} ", result_char_res, values[0] * scale, values[1] * scale,
-                    values[2] * scale, values[3] * scale, values[4] * scale, values[5] * scale);
+                path.cubic_to(control1_x, control1_y, control2_x, control2_y, end_x, end_y);
+
+                last_control_x = control2_x;
+                last_control_y = control2_y;
 
                 break;
             }
 
+            case VG_SCCWARC_TO:
+            case VG_SCWARC_TO:
+            case VG_LCCWARC_TO:
+            case VG_LCWARC_TO: {
+                // Same flags as what is given to SVG
+                const bool is_counterclock_wise = (segment.type_ == VG_SCCWARC_TO) || (segment.type_ == VG_LCCWARC_TO);
+                const bool is_small = (segment.type_ == VG_SCWARC_TO) || (segment.type_ == VG_SCCWARC_TO);
+
+                path.arc_to(values[0], values[1], values[2], !is_small, !is_counterclock_wise, base_x + values[3], base_y + values[4]);
+                break;
+            }
+
             default:
-                assert(false && "Unreachable!");
-                return false;
+                break;
             }
+
+            last_type = segment.type_;
         }
+    }
 
-        direction += "Z";
-        return true;
+    void nvg_brush_to_raster_paint(const nvg_brush &brush, raster_paint &paint) {
+        switch (brush.brush_type_) {
+        case NVG_BRUSH_LINEAR_GRAD:
+        case NVG_BRUSH_RADIAL_GRAD:
+            paint.type_ = (brush.brush_type_ == NVG_BRUSH_LINEAR_GRAD) ? raster_paint_linear_gradient : raster_paint_radial_gradient;
+            std::copy(brush.extra_, brush.extra_ + 5, paint.points_);
+
+            if (brush.has_transform_) {
+                // Same transposition as for SVG
+                paint.gradient_transform_ = raster_matrix(brush.transform_[0], brush.transform_[3], brush.transform_[1], brush.transform_[4],
+                    brush.transform_[2], brush.transform_[5]);
+            }
+
+            for (const nvg_color_ramp_stop_info &info: brush.ramps_) {
+                raster_gradient_stop stop;
+                stop.offset_ = info.offset_;
+                std::copy(info.color_, info.color_ + 4, stop.color_);
+
+                paint.stops_.push_back(stop);
+            }
+
+            break;
+
+        default:
+            paint.type_ = raster_paint_solid;
+            paint.color_[0] = brush.color_[0] / 255.0f;
+            paint.color_[1] = brush.color_[1] / 255.0f;
+            paint.color_[2] = brush.color_[2] / 255.0f;
+            paint.opacity_ = brush.color_[3] / 255.0f;
+
+            break;
+        }
     }
 
-    bool nvg_direct_command_draw_path(nvg_state &state, std::uint32_t command, common::ro_stream &in, common::wo_stream &out, std::vector<nvg_convert_error_description> &errors) {
+    bool nvg_direct_command_draw_path(nvg_state &state, std::uint32_t command, common::ro_stream &in, std::vector<nvg_convert_error_description> &errors) {
         bool do_stroke = command & 0x00010000;
         bool do_fill = command & 0x00020000;
 
@@ -446,14 +643,15 @@ namespace eka2l1::loader {
             return false;
         }
 
-        std::string direction;
+        std::vector<nvg_path_segment> segments;
 
+        // Path data is in signed fixed point
         if (state.path_datatype_ == NVG_PATH_THIRTYTWO_BIT_DECODING) {
             if ((in.tell() % 4) != 0) {
                 in.seek(4 - (in.tell() % 4), common::seek_where::cur);
             }
 
-            if (!nvg_generate_direction<std::uint32_t>(in, direction, errors, segment_types, 1.0f / 65536.0f)) {
+            if (!nvg_decode_path_segments<std::int32_t>(in, errors, segment_types, 1.0f / 65536.0f, segments)) {
                 return false;
             }
         } else {
@@ -467,11 +665,48 @@ namespace eka2l1::loader {
                 scale = 1.0f / 16.0f;
             }
             
-            if (!nvg_generate_direction<std::uint16_t>(in, direction, errors, segment_types, scale)) {
+            if (!nvg_decode_path_segments<std::int16_t>(in, errors, segment_types, scale, segments)) {
                 return false;
             }
         }
 
+        if (state.raster_) {
+            raster_matrix path_transform = state.view_transform_;
+
+            if (!state.no_transform_matrix_) {
+                path_transform = path_transform * raster_matrix(state.transform_matrix_[0], state.transform_matrix_[1], state.transform_matrix_[2],
+                    state.transform_matrix_[3], state.transform_matrix_[4], state.transform_matrix_[5]);
+            }
+
+            raster_path path(path_transform);
+            nvg_build_raster_path(segments, path);
+
+            if (do_fill) {
+                raster_paint paint;
+                nvg_brush_to_raster_paint(state.fill_brush_, paint);
+
+                if (!state.raster_->fill(path, paint)) {
+                    errors.emplace_back(NVG_NON_FINITE_COORDINATES, in.tell());
+                    return false;
+                }
+            }
+
+            if (do_stroke) {
+                raster_paint paint;
+                nvg_brush_to_raster_paint(state.stroke_brush_, paint);
+
+                if (!state.raster_->stroke(path, paint, state.stroke_width_, state.stroke_miter_limit)) {
+                    errors.emplace_back(NVG_NON_FINITE_COORDINATES, in.tell());
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        common::wo_stream &out = *state.out_;
+        const std::string direction = nvg_generate_direction(segments);
+
         static const char *FILL_STYLE_FMT = "fill=\"{}\"";
 
         std::string fill_style;
@@ -553,7 +788,7 @@ namespace eka2l1::loader {
         return true;
     }
 
-    bool nvg_direct_command_set_transformation(nvg_state &state, std::uint32_t command, common::ro_stream &in, common::wo_stream &out, std::vector<nvg_convert_error_description> &errors) {
+    bool nvg_direct_command_set_transformation(nvg_state &state, std::uint32_t command, common::ro_stream &in, std::vector<nvg_convert_error_description> &errors) {
         const std::uint32_t transform_type = (command >> 16) & 0xFF;
         if (transform_type == 1) {
             // Means don't use transform matrix
@@ -616,7 +851,7 @@ namespace eka2l1::loader {
         return true;
     }
 
-    bool nvg_direct_command_set_stroke_width(nvg_state &state, std::uint32_t command, common::ro_stream &in, common::wo_stream &out, std::vector<nvg_convert_error_description> &errors) {
+    bool nvg_direct_command_set_stroke_width(nvg_state &state, std::uint32_t command, common::ro_stream &in, std::vector<nvg_convert_error_description> &errors) {
         if (in.read(&state.stroke_width_, 4) != 4) {
             errors.emplace_back(NVG_READ_COMMAND_DATA_FAILED, in.tell());
             return false;
@@ -625,7 +860,7 @@ namespace eka2l1::loader {
         return true;
     }
 
-    bool nvg_direct_command_set_stroke_miter_limit(nvg_state &state, std::uint32_t command, common::ro_stream &in, common::wo_stream &out, std::vector<nvg_convert_error_description> &errors) {
+    bool nvg_direct_command_set_stroke_miter_limit(nvg_state &state, std::uint32_t command, common::ro_stream &in, std::vector<nvg_convert_error_description> &errors) {
         if (in.read(&state.stroke_miter_limit, 4) != 4) {
             errors.emplace_back(NVG_READ_COMMAND_DATA_FAILED, in.tell());
             return false;
@@ -634,7 +869,7 @@ namespace eka2l1::loader {
         return true;
     }
 
-    static const std::map<nvg_direct_command_opcode, std::pair<std::function<bool(nvg_state &, std::uint32_t, common::ro_stream &, common::wo_stream &, std::vector<nvg_convert_error_description> &)>, bool>>
+    static const std::map<nvg_direct_command_opcode, std::pair<std::function<bool(nvg_state &, std::uint32_t, common::ro_stream &, std::vector<nvg_convert_error_description> &)>, bool>>
         DIRECT_COMMAND_OPCODES_HANLDER = {
             { NVG_DIRECT_COMMAND_SET_FILL_PAINT, { nvg_direct_command_set_fill_paint, true } },
             { NVG_DIRECT_COMMAND_SET_STROKE_PAINT, { nvg_direct_command_set_stroke_paint, true } },
@@ -649,28 +884,35 @@ namespace eka2l1::loader {
     // Offset vector: contains offset of the data for a command. First 2 byte is number of vector, later nvector * 2 bytes are offsets
     // Commands: Each command is 32-bit integer, upper 16-bit is opcode, lower 16-bit contains index of the data offset in the offset vector.
 
-    bool convert_nvg_commands_to_svg(common::ro_stream &in, common::wo_stream &out, std::vector<nvg_convert_error_description> &errors, nvg_options *options) {
+    struct nvg_commands_info {
+        std::uint8_t version_ = 0;
+        std::uint16_t path_type_ = 0;
+
+        float viewport_[4];
+
+        std::uint16_t vector_offset_ = 0;
+        std::uint64_t commands_offset_ = 0;
+    };
+
+    static bool read_nvg_commands_info(common::ro_stream &in, nvg_commands_info &info, std::vector<nvg_convert_error_description> &errors) {
         std::int16_t header_size = 0;
-        std::uint8_t version = 0;
 
         if (in.read(NVG_HEADERSIZE_OFFSET, &header_size, 2) != 2) {
             errors.emplace_back(NVG_END_OF_FILE, NVG_HEADERSIZE_OFFSET);
             return false;
         }
 
-        if (in.read(NVG_VERSION_OFFSET, &version, 1) != 1) {
+        if (in.read(NVG_VERSION_OFFSET, &info.version_, 1) != 1) {
             errors.emplace_back(NVG_END_OF_FILE, NVG_VERSION_OFFSET);
             return false;
         }
 
-        std::uint16_t path_type = 0;
-        if (in.read(NVG_PATH_DATATYPE_OFFSET, &path_type, 2) != 2) {
+        if (in.read(NVG_PATH_DATATYPE_OFFSET, &info.path_type_, 2) != 2) {
             errors.emplace_back(NVG_END_OF_FILE, NVG_PATH_DATATYPE_OFFSET);
             return false;
         }
 
-        float viewport[4];
-        if (in.read(NVG_VIEWPORT_INFO_OFFSET, &viewport, 16) != 16) {
+        if (in.read(NVG_VIEWPORT_INFO_OFFSET, &info.viewport_, 16) != 16) {
             errors.emplace_back(NVG_END_OF_FILE, NVG_VIEWPORT_INFO_OFFSET);
             return false;
         }
@@ -681,52 +923,32 @@ namespace eka2l1::loader {
             return false;
         }
 
-        std::uint16_t vector_offset = header_size + 2;
+        info.vector_offset_ = header_size + 2;
 
         // 2 is the size of the vector count
-        std::uint64_t commands_offset = vector_offset + 2 * vector_count;
-        if (((commands_offset % 4) != 0) && (version >= 2)) {
+        info.commands_offset_ = info.vector_offset_ + 2 * vector_count;
+        if (((info.commands_offset_ % 4) != 0) && (info.version_ >= 2)) {
             // Version 2 or above needs offset aligned
-            commands_offset += 2;
-        }
-
-        std::string aspect_ratio_mode;
-        if (options) {
-            switch (options->aspect_ratio_mode_) {
-            case NVG_NOT_PRESERVE_ASPECT_RATIO:
-                aspect_ratio_mode = " preserveAspectRatio=\"none\"";
-                break;
-            case NVG_PRESERVE_ASPECT_RATIO_AND_REMOVE_UNUSED_SPACE:
-                aspect_ratio_mode = " preserveAspectRatio=\"xMinYMin meet\"";
-                break;
-            case NVG_PRESERVE_ASPECT_RATIO_SLICE:
-                aspect_ratio_mode = "preserveAspectRatio=\"xMidYMid slice\"";
-                break;
-            default:
-                break;
-            }
+            info.commands_offset_ += 2;
         }
 
-        out.write_text(fmt::format("<svg viewBox=\"{} {} {} {}\" xmlns=\"http://www.w3.org/2000/svg\"{}{}{}>\n", viewport[0],
-            viewport[1], viewport[2], viewport[3],
-            (options && (options->width > 0)) ? fmt::format(" width=\"{}\"", options->width) : "",
-            (options && (options->height > 0)) ? fmt::format(" height=\"{}\"", options->height) : "",
-            aspect_ratio_mode));
+        return true;
+    }
 
-        in.seek(commands_offset, common::seek_where::beg);
+    static bool run_nvg_commands(common::ro_stream &in, const nvg_commands_info &info, nvg_state &current_state, std::vector<nvg_convert_error_description> &errors) {
+        in.seek(info.commands_offset_, common::seek_where::beg);
 
         std::uint16_t command_count = 0;
         if (in.read(&command_count, 2) != 2) {
-            errors.emplace_back(NVG_END_OF_FILE, commands_offset);
+            errors.emplace_back(NVG_END_OF_FILE, info.commands_offset_);
             return false;
         }
 
-        if (version >= 2) {
+        if (info.version_ >= 2) {
             in.seek(2, common::seek_where::cur);
         }
 
-        nvg_state current_state;
-        current_state.path_datatype_ = static_cast<nvg_path_data_type>(path_type);
+        current_state.path_datatype_ = static_cast<nvg_path_data_type>(info.path_type_);
 
         for (std::uint16_t i = 0; i < command_count; i++) {
             std::uint32_t command = 0;
@@ -748,7 +970,7 @@ namespace eka2l1::loader {
             }
 
             if (handler->second.second) {
-                if (in.read(vector_offset + data_offset_index_in_vector * 2, &offset, 2) != 2) {
+                if (in.read(info.vector_offset_ + data_offset_index_in_vector * 2, &offset, 2) != 2) {
                     errors.emplace_back(NVG_READ_COMMAND_DATA_FAILED, in.tell());
                     continue;
                 }
@@ -756,21 +978,87 @@ namespace eka2l1::loader {
                 in.seek(offset, common::seek_where::beg);
             }
 
-            handler->second.first(current_state, command, in, out, errors);
+            handler->second.first(current_state, command, in, errors);
 
             if (handler->second.second) {
                 in.seek(current, common::seek_where::beg);
             }
         }
 
+        return true;
+    }
+
+    bool convert_nvg_commands_to_svg(common::ro_stream &in, common::wo_stream &out, std::vector<nvg_convert_error_description> &errors, nvg_options *options) {
+        nvg_commands_info info;
+        if (!read_nvg_commands_info(in, info, errors)) {
+            return false;
+        }
+
+        std::string aspect_ratio_mode;
+        if (options) {
+            switch (options->aspect_ratio_mode_) {
+            case NVG_NOT_PRESERVE_ASPECT_RATIO:
+                aspect_ratio_mode = " preserveAspectRatio=\"none\"";
+                break;
+            case NVG_PRESERVE_ASPECT_RATIO_AND_REMOVE_UNUSED_SPACE:
+                aspect_ratio_mode = " preserveAspectRatio=\"xMinYMin meet\"";
+                break;
+            case NVG_PRESERVE_ASPECT_RATIO_SLICE:
+                aspect_ratio_mode = "preserveAspectRatio=\"xMidYMid slice\"";
+                break;
+            default:
+                break;
+            }
+        }
+
+        out.write_text(fmt::format("<svg viewBox=\"{} {} {} {}\" xmlns=\"http://www.w3.org/2000/svg\"{}{}{}>\n", info.viewport_[0],
+            info.viewport_[1], info.viewport_[2], info.viewport_[3],
+            (options && (options->width > 0)) ? fmt::format(" width=\"{}\"", options->width) : "",
+            (options && (options->height > 0)) ? fmt::format(" height=\"{}\"", options->height) : "",
+            aspect_ratio_mode));
+
+        nvg_state current_state;
+        current_state.out_ = &out;
+
+        if (!run_nvg_commands(in, info, current_state, errors)) {
+            return false;
+        }
+
         out.write_text("</svg>");
         return true;
     }
 
-    bool convert_nvg_to_svg(common::ro_stream &in, common::wo_stream &out, std::vector<nvg_convert_error_description> &errors, nvg_options *options) {
+    // Same placement as the preserveAspectRatio values given in the SVG conversion
+    static raster_matrix calculate_nvg_view_transform(const float *viewport, const int width, const int height, const nvg_aspect_ratio_mode mode) {
+        if ((viewport[2] <= 0.0f) || (viewport[3] <= 0.0f)) {
+            return raster_matrix();
+        }
+
+        const float scale_x = width / viewport[2];
+        const float scale_y = height / viewport[3];
+
+        if (mode == NVG_NOT_PRESERVE_ASPECT_RATIO) {
+            return raster_matrix(scale_x, 0.0f, 0.0f, scale_y, -viewport[0] * scale_x, -viewport[1] * scale_y);
+        }
+
+        const float scale = (mode == NVG_PRESERVE_ASPECT_RATIO_SLICE) ? std::max(scale_x, scale_y) : std::min(scale_x, scale_y);
+
+        float offset_x = -viewport[0] * scale;
+        float offset_y = -viewport[1] * scale;
+
+        if (mode != NVG_PRESERVE_ASPECT_RATIO_AND_REMOVE_UNUSED_SPACE) {
+            // Center
+            offset_x += (width - viewport[2] * scale) / 2.0f;
+            offset_y += (height - viewport[3] * scale) / 2.0f;
+        }
+
+        return raster_matrix(scale, 0.0f, 0.0f, scale, offset_x, offset_y);
+    }
+
+    static bool check_nvg_direct_commands_file(common::ro_stream &in, std::vector<nvg_convert_error_description> &errors) {
         // Read signature
         char signature[3];
-        if (in.read(signature, 3) != 3) {
+        if (in.read(0, signature, 3) != 3) {
             errors.emplace_back(NVG_END_OF_FILE, 0);
             return false;
         }
@@ -786,12 +1074,47 @@ namespace eka2l1::loader {
             return false;
         }
 
-        if ((nvg_type & 3) == 0) {
-            return convert_nvg_commands_to_svg(in, out, errors, options);
-        } else {
+        if ((nvg_type & 3) != 0) {
             errors.emplace_back(NVG_TVL_FORMAT_UNSUPPORTED, 0);
+            return false;
+        }
+
+        return true;
+    }
+
+    bool convert_nvg_to_svg(common::ro_stream &in, common::wo_stream &out, std::vector<nvg_convert_error_description> &errors, nvg_options *options) {
+        if (!check_nvg_direct_commands_file(in, errors)) {
+            return false;
+        }
+
+        return convert_nvg_commands_to_svg(in, out, errors, options);
+    }
+
+    bool rasterize_nvg(common::ro_stream &in, std::uint8_t *dest, const int width, const int height, const int stride,
+        std::vector<nvg_convert_error_description> &errors, nvg_options *options) {
+        if (!check_nvg_direct_commands_file(in, errors)) {
+            return false;
+        }
+
+        nvg_commands_info info;
+        if (!read_nvg_commands_info(in, info, errors)) {
+            return false;
+        }
+
+        vector_raster raster(dest, width, height, stride);
+
+        nvg_state current_state;
+        current_state.raster_ = &raster;
+        current_state.view_transform_ = calculate_nvg_view_transform(info.viewport_, width, height,
+            options ? options->aspect_ratio_mode_ : NVG_PRESERVE_ASPECT_RATIO);
+
+        if (!run_nvg_commands(in, info, current_state, errors)) {
+            return false;
         }
 
-        return false;
+        // Unlike other skipped commands, a path that can't be rasterized leaves the icon incomplete
+        return std::none_of(errors.begin(), errors.end(), [](const nvg_convert_error_description &error) {
+            return error.reason_ == NVG_NON_FINITE_COORDINATES;
+        });
     }
-}
\ No newline at end of file
+}
@@ -0,0 +1,714 @@
+/*
+ * Copyright (c) 2019 EKA2L1 Team.
+ * 
+ * This file is part of EKA2L1 project.
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <loader/vector_raster.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace eka2l1::loader {
+    static constexpr int RASTER_SUBSAMPLE_COUNT = 4;
+    static constexpr int RASTER_GRADIENT_LUT_SIZE = 256;
+    static constexpr int RASTER_MAX_FLATTEN_SEGMENTS = 128;
+
+    static constexpr float RASTER_PI = 3.14159265358979323846f;
+
+    // Length in pixels of each line when flattening a curve
+    static constexpr float RASTER_FLATTEN_STEP = 2.0f;
+
+    // Joins that would fill less than this much of a gap in pixels are skipped
+    static constexpr float RASTER_JOIN_MIN_GAP = 0.1f;
+
+    raster_matrix::raster_matrix(const float a, const float b, const float c, const float d, const float e, const float f) {
+        m_[0] = a;
+        m_[1] = b;
+        m_[2] = c;
+        m_[3] = d;
+        m_[4] = e;
+        m_[5] = f;
+    }
+
+    raster_matrix raster_matrix::operator*(const raster_matrix &rhs) const {
+        return raster_matrix(m_[0] * rhs.m_[0] + m_[2] * rhs.m_[1],
+            m_[1] * rhs.m_[0] + m_[3] * rhs.m_[1],
+            m_[0] * rhs.m_[2] + m_[2] * rhs.m_[3],
+            m_[1] * rhs.m_[2] + m_[3] * rhs.m_[3],
+            m_[0] * rhs.m_[4] + m_[2] * rhs.m_[5] + m_[4],
+            m_[1] * rhs.m_[4] + m_[3] * rhs.m_[5] + m_[5]);
+    }
+
+    bool raster_matrix::invert(raster_matrix &result) const {
+        const float det = m_[0] * m_[3] - m_[1] * m_[2];
+        if (std::fabs(det) < 1e-12f) {
+            return false;
+        }
+
+        const float inv_det = 1.0f / det;
+
+        result = raster_matrix(m_[3] * inv_det, -m_[1] * inv_det, -m_[2] * inv_det, m_[0] * inv_det,
+            (m_[2] * m_[5] - m_[3] * m_[4]) * inv_det, (m_[1] * m_[4] - m_[0] * m_[5]) * inv_det);
+
+        return true;
+    }
+
+    void raster_matrix::map(const float x, const float y, float &rx, float &ry) const {
+        rx = m_[0] * x + m_[2] * y + m_[4];
+        ry = m_[1] * x + m_[3] * y + m_[5];
+    }
+
+    float raster_matrix::scale_factor() const {
+        return std::sqrt(std::fabs(m_[0] * m_[3] - m_[1] * m_[2]));
+    }
+
+    static int flatten_segment_count(const float device_length) {
+        return std::clamp(static_cast<int>(std::ceil(device_length / RASTER_FLATTEN_STEP)), 1, RASTER_MAX_FLATTEN_SEGMENTS);
+    }
+
+    static float point_distance(const raster_point &a, const raster_point &b) {
+        return std::hypot(b.x_ - a.x_, b.y_ - a.y_);
+    }
+
+    raster_path::raster_path(const raster_matrix &transform)
+        : transform_(transform)
+        , start_x_(0.0f)
+        , start_y_(0.0f)
+        , current_x_(0.0f)
+        , current_y_(0.0f)
+        , finite_(true) {
+    }
+
+    void raster_path::ensure_contour() {
+        // Drawing without a move, or after a close, starts a new contour from the current point
+        if (contours_.empty() || closed_.back()) {
+            move_to(current_x_, current_y_);
+        }
+    }
+
+    void raster_path::add_device_point(const float x, const float y) {
+        raster_point point;
+        transform_.map(x, y, point.x_, point.y_);
+
+        if (!std::isfinite(point.x_) || !std::isfinite(point.y_)) {
+            // Keep the point out, the crossings sort requires a strict order
+            finite_ = false;
+            return;
+        }
+
+        contours_.back().push_back(point);
+    }
+
+    void raster_path::move_to(const float x, const float y) {
+        if (!contours_.empty() && (contours_.back().size() <= 1)) {
+            // Nothing was drawn from the last move, reuse it
+            contours_.back().clear();
+            closed_.back() = false;
+        } else {
+            contours_.emplace_back();
+            closed_.push_back(false);
+        }
+
+        start_x_ = current_x_ = x;
+        start_y_ = current_y_ = y;
+
+        add_device_point(x, y);
+    }
+
+    void raster_path::line_to(const float x, const float y) {
+        ensure_contour();
+        add_device_point(x, y);
+
+        current_x_ = x;
+        current_y_ = y;
+    }
+
+    void raster_path::quad_to(const float x1, const float y1, const float x, const float y) {
+        ensure_contour();
+
+        raster_point p[3];
+        transform_.map(current_x_, current_y_, p[0].x_, p[0].y_);
+        transform_.map(x1, y1, p[1].x_, p[1].y_);
+        transform_.map(x, y, p[2].x_, p[2].y_);
+
+        const int count = flatten_segment_count(point_distance(p[0], p[1]) + point_distance(p[1], p[2]));
+
+        for (int i = 1; i <= count; i++) {
+            const float t = static_cast<float>(i) / count;
+            const float mt = 1.0f - t;
+
+            contours_.back().push_back({ mt * mt * p[0].x_ + 2 * mt * t * p[1].x_ + t * t * p[2].x_,
+                mt * mt * p[0].y_ + 2 * mt * t * p[1].y_ + t * t * p[2].y_ });
+        }
+
+        current_x_ = x;
+        current_y_ = y;
+    }
+
+    void raster_path::cubic_to(const float x1, const float y1, const float x2, const float y2, const float x, const float y) {
+        ensure_contour();
+
+        raster_point p[4];
+        transform_.map(current_x_, current_y_, p[0].x_, p[0].y_);
+        transform_.map(x1, y1, p[1].x_, p[1].y_);
+        transform_.map(x2, y2, p[2].x_, p[2].y_);
+        transform_.map(x, y, p[3].x_, p[3].y_);
+
+        const int count = flatten_segment_count(point_distance(p[0], p[1]) + point_distance(p[1], p[2]) + point_distance(p[2], p[3]));
+
+        for (int i = 1; i <= count; i++) {
+            const float t = static_cast<float>(i) / count;
+            const float mt = 1.0f - t;
+
+            const float c0 = mt * mt * mt;
+            const float c1 = 3 * mt * mt * t;
+            const float c2 = 3 * mt * t * t;
+            const float c3 = t * t * t;
+
+            contours_.back().push_back({ c0 * p[0].x_ + c1 * p[1].x_ + c2 * p[2].x_ + c3 * p[3].x_,
+                c0 * p[0].y_ + c1 * p[1].y_ + c2 * p[2].y_ + c3 * p[3].y_ });
+        }
+
+        current_x_ = x;
+        current_y_ = y;
+    }
+
+    void raster_path::arc_to(const float rx, const float ry, const float angle, const bool large_arc, const bool sweep, const float x, const float y) {
+        // Conversion from endpoint to center parameterization, from the SVG implementation notes (F.6.5)
+        float radius_x = std::fabs(rx);
+        float radius_y = std::fabs(ry);
+
+        if ((radius_x == 0.0f) || (radius_y == 0.0f)) {
+            line_to(x, y);
+            return;
+        }
+
+        if ((x == current_x_) && (y == current_y_)) {
+            return;
+        }
+
+        ensure_contour();
+
+        const float phi = angle * RASTER_PI / 180.0f;
+        const float cos_phi = std::cos(phi);
+        const float sin_phi = std::sin(phi);
+
+        const float half_dx = (current_x_ - x) / 2.0f;
+        const float half_dy = (current_y_ - y) / 2.0f;
+
+        const float x1p = cos_phi * half_dx + sin_phi * half_dy;
+        const float y1p = -sin_phi * half_dx + cos_phi * half_dy;
+
+        // Scale up the radius if they can't reach the end point
+        const float lambda = (x1p * x1p) / (radius_x * radius_x) + (y1p * y1p) / (radius_y * radius_y);
+        if (lambda > 1.0f) {
+            radius_x *= std::sqrt(lambda);
+            radius_y *= std::sqrt(lambda);
+        }
+
+        const float rx2 = radius_x * radius_x;
+        const float ry2 = radius_y * radius_y;
+
+        const float numerator = rx2 * ry2 - rx2 * y1p * y1p - ry2 * x1p * x1p;
+        const float denominator = rx2 * y1p * y1p + ry2 * x1p * x1p;
+
+        float coef = (denominator == 0.0f) ? 0.0f : std::sqrt(std::max(0.0f, numerator / denominator));
+        if (large_arc == sweep) {
+            coef = -coef;
+        }
+
+        const float cxp = coef * radius_x * y1p / radius_y;
+        const float cyp = -coef * radius_y * x1p / radius_x;
+
+        const float cx = cos_phi * cxp - sin_phi * cyp + (current_x_ + x) / 2.0f;
+        const float cy = sin_phi * cxp + cos_phi * cyp + (current_y_ + y) / 2.0f;
+
+        const float theta1 = std::atan2((y1p - cyp) / radius_y, (x1p - cxp) / radius_x);
+        float delta_theta = std::atan2((-y1p - cyp) / radius_y, (-x1p - cxp) / radius_x) - theta1;
+
+        if (!sweep && (delta_theta > 0)) {
+            delta_theta -= 2 * RASTER_PI;
+        } else if (sweep && (delta_theta < 0)) {
+            delta_theta += 2 * RASTER_PI;
+        }
+
+        const float device_length = std::fabs(delta_theta) * std::max(radius_x, radius_y) * transform_.scale_factor();
+        const int count = flatten_segment_count(device_length);
+
+        for (int i = 1; i < count; i++) {
+            const float theta = theta1 + delta_theta * i / count;
+
+            const float ex = radius_x * std::cos(theta);
+            const float ey = radius_y * std::sin(theta);
+
+            add_device_point(cx + ex * cos_phi - ey * sin_phi, cy + ex * sin_phi + ey * cos_phi);
+        }
+
+        // Land exactly on the end point
+        add_device_point(x, y);
+
+        current_x_ = x;
+        current_y_ = y;
+    }
+
+    void raster_path::close() {
+        if (!contours_.empty()) {
+            closed_.back() = true;
+        }
+
+        current_x_ = start_x_;
+        current_y_ = start_y_;
+    }
+
+    vector_raster::vector_raster(std::uint8_t *pixels, const int width, const int height, const int stride)
+        : pixels_(pixels)
+        , width_(width)
+        , height_(height)
+        , stride_(stride) {
+        coverage_.resize(std::max(width, 0) + 1);
+    }
+
+    void vector_raster::clear() {
+        for (int y = 0; y < height_; y++) {
+            std::memset(pixels_ + y * stride_, 0, width_ * 4);
+        }
+    }
+
+    struct raster_edge {
+        float x0_;
+        float y0_;
+        float y1_;
+        float dxdy_;
+        int direction_;
+    };
+
+    static void premultiply_color(const float *color, const float opacity, float *result) {
+        const float alpha = std::clamp(color[3] * opacity, 0.0f, 1.0f);
+
+        result[0] = std::clamp(color[0], 0.0f, 1.0f) * alpha;
+        result[1] = std::clamp(color[1], 0.0f, 1.0f) * alpha;
+        result[2] = std::clamp(color[2], 0.0f, 1.0f) * alpha;
+        result[3] = alpha;
+    }
+
+    static void build_gradient_lut(const raster_paint &paint, std::vector<float> &lut) {
+        lut.resize(RASTER_GRADIENT_LUT_SIZE * 4);
+
+        for (int i = 0; i < RASTER_GRADIENT_LUT_SIZE; i++) {
+            const float t = static_cast<float>(i) / (RASTER_GRADIENT_LUT_SIZE - 1);
+            float color[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+
+            if (!paint.stops_.empty()) {
+                if (t <= paint.stops_.front().offset_) {
+                    std::copy(paint.stops_.front().color_, paint.stops_.front().color_ + 4, color);
+                } else if (t >= paint.stops_.back().offset_) {
+                    std::copy(paint.stops_.back().color_, paint.stops_.back().color_ + 4, color);
+                } else {
+                    std::size_t next = 1;
+                    while ((next < paint.stops_.size() - 1) && (paint.stops_[next].offset_ < t)) {
+                        next++;
+                    }
+
+                    const raster_gradient_stop &from = paint.stops_[next - 1];
+                    const raster_gradient_stop &to = paint.stops_[next];
+
+                    const float range = to.offset_ - from.offset_;
+                    const float weight = (range <= 0.0f) ? 1.0f : (t - from.offset_) / range;
+
+                    for (int c = 0; c < 4; c++) {
+                        color[c] = from.color_[c] + (to.color_[c] - from.color_[c]) * weight;
+                    }
+                }
+            }
+
+            premultiply_color(color, paint.opacity_, &lut[i * 4]);
+        }
+    }
+
+    // Get where the given point in gradient space lies on the gradient, from 0 to 1 (pad spread)
+    static float gradient_position(const raster_paint &paint, const float x, const float y) {
+        if (paint.type_ == raster_paint_linear_gradient) {
+            const float dx = paint.points_[2] - paint.points_[0];
+            const float dy = paint.points_[3] - paint.points_[1];
+
+            const float length_squared = dx * dx + dy * dy;
+            if (length_squared <= 0.0f) {
+                return 1.0f;
+            }
+
+            return std::clamp(((x - paint.points_[0]) * dx + (y - paint.points_[1]) * dy) / length_squared, 0.0f, 1.0f);
+        }
+
+        const float cx = paint.points_[0];
+        const float cy = paint.points_[1];
+        const float r = paint.points_[4];
+
+        if (r <= 0.0f) {
+            return 1.0f;
+        }
+
+        float fx = paint.points_[2];
+        float fy = paint.points_[3];
+
+        // Keep the focal point inside the circle
+        const float focal_distance = std::hypot(fx - cx, fy - cy);
+        if (focal_distance > r * 0.99f) {
+            fx = cx + (fx - cx) * (r * 0.99f / focal_distance);
+            fy = cy + (fy - cy) * (r * 0.99f / focal_distance);
+        }
+
+        // Find t, where the point lies on the circle centered at f + t * (c - f) with radius t * r
+        const float cfx = cx - fx;
+        const float cfy = cy - fy;
+        const float dx = x - fx;
+        const float dy = y - fy;
+
+        const float a = cfx * cfx + cfy * cfy - r * r;
+        const float b = dx * cfx + dy * cfy;
+        const float c = dx * dx + dy * dy;
+
+        const float t = (b - std::sqrt(std::max(0.0f, b * b - a * c))) / a;
+        return std::clamp(t, 0.0f, 1.0f);
+    }
+
+    static void blend_pixel(std::uint8_t *dest, const float *premultiplied, const float coverage) {
+        std::uint32_t pixel = 0;
+        std::memcpy(&pixel, dest, sizeof(std::uint32_t));
+
+        const float src_alpha = premultiplied[3] * coverage;
+        const float inv_alpha = 1.0f - src_alpha;
+
+        const float dest_a = static_cast<float>((pixel >> 24) & 0xFF);
+        const float dest_r = static_cast<float>((pixel >> 16) & 0xFF);
+        const float dest_g = static_cast<float>((pixel >> 8) & 0xFF);
+        const float dest_b = static_cast<float>(pixel & 0xFF);
+
+        const auto to_channel = [](const float value) {
+            return static_cast<std::uint32_t>(std::clamp(value + 0.5f, 0.0f, 255.0f));
+        };
+
+        pixel = (to_channel(src_alpha * 255.0f + dest_a * inv_alpha) << 24)
+            | (to_channel(premultiplied[0] * coverage * 255.0f + dest_r * inv_alpha) << 16)
+            | (to_channel(premultiplied[1] * coverage * 255.0f + dest_g * inv_alpha) << 8)
+            | to_channel(premultiplied[2] * coverage * 255.0f + dest_b * inv_alpha);
+
+        std::memcpy(dest, &pixel, sizeof(std::uint32_t));
+    }
+
+    bool vector_raster::fill_polygons(const std::vector<std::vector<raster_point>> &polygons, const raster_paint &paint, const raster_matrix &user_to_device,
+        const raster_fill_rule rule) {
+        if ((width_ <= 0) || (height_ <= 0)) {
+            return true;
+        }
+
+        std::vector<raster_edge> edges;
+        float min_y = static_cast<float>(height_);
+        float max_y = 0.0f;
+
+        for (const auto &polygon : polygons) {
+            for (std::size_t i = 0; i < polygon.size(); i++) {
+                // Polygons are always implicitly closed
+                const raster_point &from = polygon[i];
+                const raster_point &to = polygon[(i + 1) % polygon.size()];
+
+                if (from.y_ == to.y_) {
+                    continue;
+                }
+
+                raster_edge edge;
+                edge.direction_ = (to.y_ > from.y_) ? 1 : -1;
+
+                const raster_point &top = (edge.direction_ > 0) ? from : to;
+                const raster_point &bottom = (edge.direction_ > 0) ? to : from;
+
+                edge.x0_ = top.x_;
+                edge.y0_ = top.y_;
+                edge.y1_ = bottom.y_;
+                edge.dxdy_ = (bottom.x_ - top.x_) / (bottom.y_ - top.y_);
+
+                // Stroke pieces are computed from the path points and may still overflow
+                if (!std::isfinite(edge.x0_) || !std::isfinite(edge.y0_) || !std::isfinite(edge.y1_) || !std::isfinite(edge.dxdy_)) {
+                    return false;
+                }
+
+                min_y = std::min(min_y, edge.y0_);
+                max_y = std::max(max_y, edge.y1_);
+
+                edges.push_back(edge);
+            }
+        }
+
+        if (edges.empty()) {
+            return true;
+        }
+
+        std::sort(edges.begin(), edges.end(), [](const raster_edge &lhs, const raster_edge &rhs) {
+            return lhs.y0_ < rhs.y0_;
+        });
+
+        // Prepare the paint
+        float solid_color[4];
+        std::vector<float> gradient_lut;
+        raster_matrix device_to_gradient;
+
+        if (paint.type_ == raster_paint_solid) {
+            premultiply_color(paint.color_, paint.opacity_, solid_color);
+
+            if (solid_color[3] <= 0.0f) {
+                return true;
+            }
+        } else {
+            if (!(user_to_device * paint.gradient_transform_).invert(device_to_gradient)) {
+                return true;
+            }
+
+            build_gradient_lut(paint, gradient_lut);
+        }
+
+        const int start_row = std::max(0, static_cast<int>(std::floor(min_y)));
+        const int end_row = std::min(height_, static_cast<int>(std::ceil(max_y)));
+
+        std::vector<std::pair<float, int>> crossings;
+
+        const float sample_weight = 1.0f / RASTER_SUBSAMPLE_COUNT;
+        const float width_f = static_cast<float>(width_);
+
+        for (int row = start_row; row < end_row; row++) {
+            int span_start = width_;
+            int span_end = 0;
+
+            const auto add_span = [&](float from, float to) {
+                from = std::clamp(from, 0.0f, width_f);
+                to = std::clamp(to, 0.0f, width_f);
+
+                if (to <= from) {
+                    return;
+                }
+
+                const int from_pixel = static_cast<int>(from);
+                const int to_pixel = static_cast<int>(to);
+
+                if (from_pixel == to_pixel) {
+                    coverage_[from_pixel] += (to - from) * sample_weight;
+                } else {
+                    coverage_[from_pixel] += (from_pixel + 1 - from) * sample_weight;
+
+                    for (int x = from_pixel + 1; x < to_pixel; x++) {
+                        coverage_[x] += sample_weight;
+                    }
+
+                    coverage_[to_pixel] += (to - to_pixel) * sample_weight;
+                }
+
+                span_start = std::min(span_start, from_pixel);
+                span_end = std::max(span_end, std::min(to_pixel + 1, width_));
+            };
+
+            for (int sample = 0; sample < RASTER_SUBSAMPLE_COUNT; sample++) {
+                const float sample_y = row + (sample + 0.5f) * sample_weight;
+                crossings.clear();
+
+                for (const raster_edge &edge : edges) {
+                    if (edge.y0_ > sample_y) {
+                        break;
+                    }
+
+                    if (sample_y < edge.y1_) {
+                        crossings.emplace_back(edge.x0_ + (sample_y - edge.y0_) * edge.dxdy_, edge.direction_);
+                    }
+                }
+
+                std::sort(crossings.begin(), crossings.end());
+
+                int winding = 0;
+                float inside_from = 0.0f;
+
+                for (const auto &crossing : crossings) {
+                    const bool was_inside = (rule == raster_fill_rule_non_zero) ? (winding != 0) : ((winding & 1) != 0);
+                    winding += crossing.second;
+                    const bool is_inside = (rule == raster_fill_rule_non_zero) ? (winding != 0) : ((winding & 1) != 0);
+
+                    if (!was_inside && is_inside) {
+                        inside_from = crossing.first;
+                    } else if (was_inside && !is_inside) {
+                        add_span(inside_from, crossing.first);
+                    }
+                }
+            }
+
+            std::uint8_t *row_pixels = pixels_ + row * stride_;
+
+            for (int x = span_start; x < span_end; x++) {
+                const float coverage = std::min(coverage_[x], 1.0f);
+                coverage_[x] = 0.0f;
+
+                if (coverage <= 0.0f) {
+                    continue;
+                }
+
+                if (paint.type_ == raster_paint_solid) {
+                    blend_pixel(row_pixels + x * 4, solid_color, coverage);
+                } else {
+                    float gx = 0.0f;
+                    float gy = 0.0f;
+
+                    device_to_gradient.map(x + 0.5f, row + 0.5f, gx, gy);
+
+                    const int lut_index = static_cast<int>(gradient_position(paint, gx, gy) * (RASTER_GRADIENT_LUT_SIZE - 1) + 0.5f);
+                    blend_pixel(row_pixels + x * 4, &gradient_lut[lut_index * 4], coverage);
+                }
+            }
+
+            if (span_end < static_cast<int>(coverage_.size())) {
+                coverage_[span_end] = 0.0f;
+            }
+        }
+
+        return true;
+    }
+
+    bool vector_raster::fill(const raster_path &path, const raster_paint &paint, const raster_fill_rule rule) {
+        if (!path.is_finite()) {
+            return false;
+        }
+
+        return fill_polygons(path.contours(), paint, path.transform(), rule);
+    }
+
+    // Orient all stroke pieces the same way, so that they add up under the non-zero rule
+    static void add_oriented_polygon(std::vector<std::vector<raster_point>> &polygons, std::vector<raster_point> &&polygon) {
+        float area = 0.0f;
+
+        for (std::size_t i = 0; i < polygon.size(); i++) {
+            const raster_point &from = polygon[i];
+            const raster_point &to = polygon[(i + 1) % polygon.size()];
+
+            area += from.x_ * to.y_ - to.x_ * from.y_;
+        }
+
+        if (area < 0.0f) {
+            std::reverse(polygon.begin(), polygon.end());
+        }
+
+        polygons.push_back(std::move(polygon));
+    }
+
+    /**
+     * Fill the outer gap of a join, with a miter if it's within the limit, else a bevel.
+     *
+     * The normals are of the incoming and outgoing segments, with the length of half of the stroke width.
+     */
+    static void add_miter_join(std::vector<std::vector<raster_point>> &polygons, const raster_point &center, const raster_point &in_normal,
+        const raster_point &out_normal, const float turn_cross, const float miter_limit) {
+        // The outer side is the one the path turns away from
+        const float side = (turn_cross > 0.0f) ? -1.0f : 1.0f;
+
+        const raster_point outer_in = { center.x_ + side * in_normal.x_, center.y_ + side * in_normal.y_ };
+        const raster_point outer_out = { center.x_ + side * out_normal.x_, center.y_ + side * out_normal.y_ };
+
+        // Cosine of the turn angle, the miter length over the stroke width is 1 / cos(turn / 2)
+        const float half_width_sq = in_normal.x_ * in_normal.x_ + in_normal.y_ * in_normal.y_;
+        const float turn_cos = (in_normal.x_ * out_normal.x_ + in_normal.y_ * out_normal.y_) / half_width_sq;
+        const float half_turn_cos_sq = (1.0f + turn_cos) * 0.5f;
+
+        if ((half_turn_cos_sq > 1e-6f) && (1.0f / half_turn_cos_sq <= miter_limit * miter_limit)) {
+            const float tip_scale = side / (1.0f + turn_cos);
+            const raster_point tip = { center.x_ + (in_normal.x_ + out_normal.x_) * tip_scale, center.y_ + (in_normal.y_ + out_normal.y_) * tip_scale };
+
+            add_oriented_polygon(polygons, { center, outer_in, tip, outer_out });
+            return;
+        }
+
+        add_oriented_polygon(polygons, { center, outer_in, outer_out });
+    }
+
+    bool vector_raster::stroke(const raster_path &path, const raster_paint &paint, const float width, const float miter_limit) {
+        const float half_width = width * path.transform().scale_factor() * 0.5f;
+
+        if (!path.is_finite() || !std::isfinite(half_width)) {
+            return false;
+        }
+
+        if (half_width <= 0.0f) {
+            return true;
+        }
+
+        std::vector<std::vector<raster_point>> pieces;
+        std::vector<raster_point> points;
+
+        for (std::size_t contour_index = 0; contour_index < path.contours().size(); contour_index++) {
+            const auto &contour = path.contours()[contour_index];
+            const bool closed = path.is_closed(contour_index);
+
+            // Drop repeated points, they have no direction
+            points.clear();
+
+            for (const raster_point &point : contour) {
+                if (points.empty() || (point_distance(points.back(), point) > 1e-4f)) {
+                    points.push_back(point);
+                }
+            }
+
+            if (closed && (points.size() > 1) && (point_distance(points.front(), points.back()) <= 1e-4f)) {
+                points.pop_back();
+            }
+
+            if (points.size() < 2) {
+                continue;
+            }
+
+            const std::size_t segment_count = closed ? points.size() : points.size() - 1;
+
+            for (std::size_t i = 0; i < segment_count; i++) {
+                const raster_point &from = points[i];
+                const raster_point &to = points[(i + 1) % points.size()];
+
+                const float length = point_distance(from, to);
+                const float nx = -(to.y_ - from.y_) / length * half_width;
+                const float ny = (to.x_ - from.x_) / length * half_width;
+
+                add_oriented_polygon(pieces, { { from.x_ + nx, from.y_ + ny }, { to.x_ + nx, to.y_ + ny },
+                                                 { to.x_ - nx, to.y_ - ny }, { from.x_ - nx, from.y_ - ny } });
+            }
+
+            // Fill the gaps between segments
+            const std::size_t first_join = closed ? 0 : 1;
+            const std::size_t end_join = closed ? points.size() : points.size() - 1;
+
+            for (std::size_t i = first_join; i < end_join; i++) {
+                const raster_point &prev = points[(i + points.size() - 1) % points.size()];
+                const raster_point &current = points[i];
+                const raster_point &next = points[(i + 1) % points.size()];
+
+                const float in_length = point_distance(prev, current);
+                const float out_length = point_distance(current, next);
+
+                const raster_point in_normal = { -(current.y_ - prev.y_) / in_length * half_width, (current.x_ - prev.x_) / in_length * half_width };
+                const raster_point out_normal = { -(next.y_ - current.y_) / out_length * half_width, (next.x_ - current.x_) / out_length * half_width };
+
+                const float turn_cross = (current.x_ - prev.x_) * (next.y_ - current.y_) - (current.y_ - prev.y_) * (next.x_ - current.x_);
+
+                if (point_distance({ in_normal.x_ - out_normal.x_, in_normal.y_ - out_normal.y_ }, { 0.0f, 0.0f }) >= RASTER_JOIN_MIN_GAP) {
+                    add_miter_join(pieces, current, in_normal, out_normal, turn_cross, miter_limit);
+                }
+            }
+        }
+
+        return fill_polygons(pieces, paint, path.transform(), raster_fill_rule_non_zero);
+    }
+}
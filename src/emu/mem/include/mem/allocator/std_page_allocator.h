@@ -28,10 +28,13 @@ namespace eka2l1::mem {
     /**
      * \brief Basic page table allocator using C++ STD's built-in functions.
      * 
-     * Page table will be automatically free once the allocator is destroyed.
+     * Page table will be automatically free once the allocator is destroyed. Freed tables are
+     * kept in a free list and handed out again by the next creation.
      */
     struct basic_page_table_allocator : public page_table_allocator {
         std::vector<std::unique_ptr<page_table>> page_tabs_;
+        std::vector<std::uint32_t> free_ids_;
+        std::vector<bool> free_flags_;
 
     public:
         ~basic_page_table_allocator() override {}
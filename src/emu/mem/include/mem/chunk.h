@@ -84,6 +84,13 @@ namespace eka2l1::mem {
 
         virtual void *host_base() = 0;
 
+        /**
+         * \brief Get the amount of host memory currently backing this chunk.
+         *
+         * Unlike the committed size, this only counts pages the host really holds.
+         */
+        virtual std::size_t resident();
+
         /**
          * \brief Unmap the committed chunk region from the CPU.
          * 
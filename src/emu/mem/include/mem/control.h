@@ -96,6 +96,13 @@ namespace eka2l1::mem {
             return alloc_->get_page_table_by_id(id);
         }
 
+        /**
+         * \brief Give a page table back to the allocator, so that it can be reused.
+         */
+        void free_page_table(const std::uint32_t id) {
+            alloc_->free_page_table(id);
+        }
+
         /**
          * \brief Get host pointer of a virtual address, in the specified address space.
          */
@@ -53,6 +53,7 @@ namespace eka2l1::mem::flexible {
         const vm_address base(mem_model_process *process) override;
 
         void *host_base() override;
+        std::size_t resident() override;
 
         const std::size_t committed() const override {
             return committed_;
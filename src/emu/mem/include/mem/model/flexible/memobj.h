@@ -58,6 +58,10 @@ namespace eka2l1::mem::flexible {
             return page_occupied_;
         }
 
+        bool is_external() const {
+            return external_;
+        }
+
         /**
          * @brief       Attach new mapping.
          * 
@@ -70,6 +70,11 @@ namespace eka2l1::mem {
             return host_base_;
         }
 
+        std::size_t resident() override {
+            // Memory provided from outside is not ours to account for
+            return is_external_host ? 0 : mem_model_chunk::resident();
+        }
+
         const std::size_t committed() const override {
             return committed_;
         }
@@ -66,6 +66,13 @@ namespace eka2l1::mem {
          */
         asid rollover_fresh_addr_space() override;
 
+        /**
+         * \brief Check if an address lies in a region shared by all address spaces.
+         *
+         * Page tables of such regions only live in the global directory.
+         */
+        bool is_global_address(const vm_address addr) const;
+
         /**
          * \brief Assign page tables at linear base address to page directories.
          */
@@ -32,6 +32,8 @@ namespace eka2l1::mem {
     protected:
         page_directory *cur_dir_;
 
+        page_directory *get_directory_for_addr(const vm_address addr);
+
     public:
         explicit mmu_multiple(control_base *manager, arm::core *cpu, config::state *conf);
         ~mmu_multiple() override {}
@@ -19,22 +19,33 @@
 
 #include <mem/allocator/std_page_allocator.h>
 
+#include <algorithm>
+
 namespace eka2l1::mem {
     page_table *basic_page_table_allocator::create_new(const std::size_t psize) {
-        for (std::size_t i = 0; i < page_tabs_.size(); i++) {
-            if (page_tabs_[i]->idx_ == static_cast<std::uint32_t>(-1)) {
-                return page_tabs_[i].get();
+        if (!free_ids_.empty()) {
+            const std::uint32_t id = free_ids_.back();
+            free_ids_.pop_back();
+            free_flags_[id] = false;
+
+            page_table *recycled = page_tabs_[id].get();
+
+            if (recycled->page_size_ != psize) {
+                *recycled = page_table(id, psize);
             }
+
+            return recycled;
         }
 
         page_tabs_.push_back(std::make_unique<page_table>(static_cast<std::uint32_t>(page_tabs_.size()),
             psize));
+        free_flags_.push_back(false);
 
         return page_tabs_.back().get();
     }
 
     page_table *basic_page_table_allocator::get_page_table_by_id(const std::uint32_t id) {
-        if (page_tabs_.size() < id) {
+        if (page_tabs_.size() <= id) {
             return nullptr;
         }
 
@@ -42,10 +53,16 @@ namespace eka2l1::mem {
     }
 
     void basic_page_table_allocator::free_page_table(const std::uint32_t id) {
-        if (page_tabs_.size() < id || !page_tabs_[id]) {
+        if (page_tabs_.size() <= id || !page_tabs_[id] || free_flags_[id]) {
             return;
         }
 
-        page_tabs_[id]->idx_ = static_cast<std::uint32_t>(-1);
+        page_table *tab = page_tabs_[id].get();
+        tab->idx_ = static_cast<std::uint32_t>(-1);
+
+        std::fill(tab->pages_.begin(), tab->pages_.end(), page_info{});
+
+        free_flags_[id] = true;
+        free_ids_.push_back(id);
     }
 }
@@ -26,6 +26,7 @@
 #include <common/algorithm.h>
 #include <common/allocator.h>
 #include <common/log.h>
+#include <common/virtualmem.h>
 
 namespace eka2l1::mem {
     const vm_address mem_model_chunk::bottom() const {
@@ -36,6 +37,16 @@ namespace eka2l1::mem {
         return top_ << control_->page_size_bits_;
     }
 
+    std::size_t mem_model_chunk::resident() {
+        void *host = host_base();
+
+        if (!host || (committed() == 0)) {
+            return 0;
+        }
+
+        return common::get_resident_size(host, max());
+    }
+
     bool mem_model_chunk::adjust(const vm_address bottom, const vm_address top) {
         const std::size_t top_page_off = ((top + control_->page_size() - 1) >> control_->page_size_bits_);
         const std::size_t bottom_page_off = (bottom >> control_->page_size_bits_);
@@ -183,4 +183,12 @@ namespace eka2l1::mem::flexible {
     void *flexible_mem_model_chunk::host_base() {
         return mem_obj_->ptr();
     }
-}
\ No newline at end of file
+
+    std::size_t flexible_mem_model_chunk::resident() {
+        if (!mem_obj_ || mem_obj_->is_external()) {
+            return 0;
+        }
+
+        return mem_model_chunk::resident();
+    }
+}
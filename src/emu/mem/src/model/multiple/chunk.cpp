@@ -56,10 +56,6 @@ namespace eka2l1::mem {
             int ps_off = (running_offset >> control_->page_index_shift_) & control_->page_index_mask_;
             const auto psize = control_->page_size();
 
-            std::size_t size_just_mapped = 0;
-            vm_address off_start_just_mapped = 0;
-            std::uint8_t *host_start_just_mapped = nullptr;
-
             const auto pt_base = (running_offset >> control_->chunk_shift_) << control_->chunk_shift_;
             std::uint8_t *host_commit_ptr = reinterpret_cast<std::uint8_t *>(host_base_) + (ps_off << control_->page_size_bits_) + pt_base;
             const std::size_t host_commit_size = page_num << control_->page_size_bits_;
@@ -70,11 +66,10 @@ namespace eka2l1::mem {
             }
 
             const vm_address crr_base_addr = base_;
-
             multiple_mem_model_process *mul_process = reinterpret_cast<multiple_mem_model_process *>(own_process_);
-            control_multiple *mul_ctrl = reinterpret_cast<control_multiple *>(control_);
 
-            // Fill the entry
+            // Fill the entry. The cores pick the new pages up through the page table on their next TLB miss,
+            // so nothing has to be pushed to each MMU here.
             for (int poff = ps_off; poff < ps_off + page_num; poff++) {
                 // If the entry has not yet been committed.
                 if (pt->pages_[poff].host_addr == nullptr) {
@@ -83,44 +78,12 @@ namespace eka2l1::mem {
 
                     // Increase committed size.
                     committed_ += psize;
-                    size_just_mapped += psize;
-
-                    if (off_start_just_mapped == 0) {
-                        off_start_just_mapped = (poff << control_->page_size_bits_) + crr_base_addr + pt_base;
-                        host_start_just_mapped = reinterpret_cast<std::uint8_t *>(host_base_) + (poff << control_->page_size_bits_) + pt_base;
-                    }
-                } else {
-                    if (!ignore_committed) {
-                        LOG_TRACE(KERNEL, "Debug");
-                        return static_cast<std::size_t>(-1);
-                    }
-                    // Map those just mapped to the CPU. It will love this
-                    if (size_just_mapped != 0) {
-                        for (auto &mm : mul_ctrl->mmus_) {
-                            if (!own_process_ || mul_process->addr_space_id_ == mm->current_addr_space()) {
-                                mm->map_to_cpu(off_start_just_mapped, size_just_mapped, host_start_just_mapped, permission_);
-                                break;
-                            }
-                        }
-
-                        off_start_just_mapped = 0;
-                        size_just_mapped = 0;
-                        host_start_just_mapped = nullptr;
-                    }
+                } else if (!ignore_committed) {
+                    LOG_TRACE(KERNEL, "Debug");
+                    return static_cast<std::size_t>(-1);
                 }
             }
 
-            // Map the rest
-            if (size_just_mapped != 0) {
-                for (auto &mm : mul_ctrl->mmus_) {
-                    if (!own_process_ || mul_process->addr_space_id_ == mm->current_addr_space()) {
-                        mm->map_to_cpu(off_start_just_mapped, size_just_mapped, host_start_just_mapped, permission_);
-                        break;
-                    }
-                }
-                //LOG_TRACE(MEMORY, "Mapped to CPU: 0x{:X}, size 0x{:X}", off_start_just_mapped, size_just_mapped);
-            }
-
             if (ptid == 0xFFFFFFFF) {
                 // Assign the new page table to the specified address
                 control_->assign_page_table(pt, crr_base_addr + pt_base, !is_local ? MMU_ASSIGN_LOCAL_GLOBAL_REGION : 0,
@@ -392,6 +355,22 @@ namespace eka2l1::mem {
         // Decommit the whole things
         decommit(0, max_size_);
 
+        // Unassign and give back the page tables, so the next chunk can reuse them
+        multiple_mem_model_process *mul_process = reinterpret_cast<multiple_mem_model_process *>(own_process_);
+
+        for (std::size_t i = 0; i < page_tabs_.size(); i++) {
+            if (page_tabs_[i] == 0xFFFFFFFF) {
+                continue;
+            }
+
+            control_->assign_page_table(nullptr, base_ + static_cast<vm_address>(i << control_->chunk_shift_),
+                !is_local ? MMU_ASSIGN_LOCAL_GLOBAL_REGION : 0, is_local ? &mul_process->addr_space_id_ : nullptr,
+                is_local ? 1 : 0);
+
+            control_->free_page_table(page_tabs_[i]);
+            page_tabs_[i] = 0xFFFFFFFF;
+        }
+
         // Free the region that previously allocated from the allocator
         if (!(create_flags_ & MEM_MODEL_CHUNK_INTERNAL_FORCE_FILL)) {
             linear_section *sec = get_section(create_flags_);
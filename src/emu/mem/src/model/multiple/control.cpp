@@ -57,6 +57,8 @@ namespace eka2l1::mem {
 
     asid control_multiple::rollover_fresh_addr_space() {
         // Try to find existing unoccpied page directory
+        // Global tables outside the shared lookup range are kept up to date in every directory, even
+        // unoccupied ones, so a reused directory already has them.
         for (std::size_t i = 0; i < dirs_.size(); i++) {
             if (!dirs_[i]->occupied()) {
                 dirs_[i]->occupied_ = true;
@@ -73,6 +75,12 @@ namespace eka2l1::mem {
         dirs_.push_back(std::make_unique<page_directory>(page_size_bits_, static_cast<asid>(dirs_.size() + 1)));
         dirs_.back()->occupied_ = true;
 
+        for (std::uint32_t i = 0; i < global_dir_.page_tabs_.size(); i++) {
+            if (global_dir_.page_tabs_[i] && !is_global_address(i << page_table_index_shift_)) {
+                dirs_.back()->set_page_table(i, global_dir_.page_tabs_[i]);
+            }
+        }
+
         return static_cast<asid>(dirs_.size());
     }
 
@@ -103,33 +111,28 @@ namespace eka2l1::mem {
             return;
         }
 
-        if (flags & MMU_ASSIGN_LOCAL_GLOBAL_REGION) {
-            // Iterates through all page directories and assign it
+        if (flags & (MMU_ASSIGN_LOCAL_GLOBAL_REGION | MMU_ASSIGN_GLOBAL)) {
+            // Lookups in the global region always go through the global directory, so the table is shared
+            // by every address space without being copied into each of their directories. Global chunks
+            // can still be placed outside that region, those tables are copied to every directory.
             switch_page_table(&global_dir_);
 
-            for (auto &pde : dirs_) {
-                switch_page_table(pde.get());
+            if (!is_global_address(linear_addr)) {
+                for (auto &pde : dirs_) {
+                    switch_page_table(pde.get());
+                }
             }
         } else {
-            if (flags & MMU_ASSIGN_GLOBAL) {
-                // Assign the table to global directory
-                switch_page_table(&global_dir_);
-            } else {
-                LOG_TRACE(MEMORY, "Unreachable!!!");
-            }
+            LOG_TRACE(MEMORY, "Unreachable!!!");
         }
     }
 
-    inline bool should_addr_from_global(const vm_address addr, const bool mem_map_old) {
-        bool should_from_global = false;
-
-        if (mem_map_old) {
-            should_from_global = ((addr >= shared_data_eka1) && (addr <= kern_mapping_eka1_end)) || (addr >= dll_static_data_eka1_end);
-        } else {
-            should_from_global = ((addr >= shared_data) && (addr < dll_static_data_flexible)) || (addr >= rom);
+    bool control_multiple::is_global_address(const vm_address addr) const {
+        if (mem_map_old_) {
+            return ((addr >= shared_data_eka1) && (addr <= kern_mapping_eka1_end)) || (addr >= dll_static_data_eka1_end);
         }
 
-        return should_from_global;
+        return ((addr >= shared_data) && (addr < dll_static_data_flexible)) || (addr >= rom);
     }
 
     void *control_multiple::get_host_pointer(const asid id, const vm_address addr) {
@@ -137,7 +140,7 @@ namespace eka2l1::mem {
             return nullptr;
         }
 
-        if (should_addr_from_global(addr, mem_map_old_)) {
+        if (is_global_address(addr)) {
             return global_dir_.get_pointer(addr);
         }
 
@@ -149,7 +152,7 @@ namespace eka2l1::mem {
             return nullptr;
         }
 
-        if (should_addr_from_global(addr, mem_map_old_)) {
+        if (is_global_address(addr)) {
             return global_dir_.get_page_info(addr);
         }
 
@@ -44,8 +44,13 @@ namespace eka2l1::mem {
         return true;
     }
 
+    page_directory *mmu_multiple::get_directory_for_addr(const vm_address addr) {
+        control_multiple *ctrl_mul = reinterpret_cast<control_multiple *>(manager_);
+        return ctrl_mul->is_global_address(addr) ? &ctrl_mul->global_dir_ : cur_dir_;
+    }
+
     page_table *mmu_multiple::get_page_table_by_addr(const vm_address addr) {
-        return cur_dir_->get_page_table(addr);
+        return get_directory_for_addr(addr)->get_page_table(addr);
     }
 
     const asid mmu_multiple::current_addr_space() const {
@@ -61,7 +66,7 @@ namespace eka2l1::mem {
             return nullptr;
         }
 
-        return cur_dir_->get_pointer(addr);
+        return get_directory_for_addr(addr)->get_pointer(addr);
     }
 
     page_info *mmu_multiple::get_page_info(const vm_address addr) {
@@ -69,6 +74,6 @@ namespace eka2l1::mem {
             return nullptr;
         }
 
-        return cur_dir_->get_page_info(addr);
+        return get_directory_for_addr(addr)->get_page_info(addr);
     }
 }
@@ -29,6 +29,7 @@
 #include <map>
 #include <mutex>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace eka2l1 {
@@ -71,6 +72,10 @@ namespace eka2l1 {
             object_map_type objects_;
             drive_number residing_;
 
+            // Secondary indexes, pointing to objects inside the map above
+            std::unordered_map<epoc::uid, package::object *> sid_index_;
+            std::unordered_map<std::u16string, package::object *> file_index_;
+
             io_system *sys;
             config::state *conf;
 
@@ -78,6 +83,14 @@ namespace eka2l1 {
             void traverse_tree_and_add_packages(loader::sis_registry_tree &tree);
             void install_sis_stubs();
 
+            void add_to_indexes(package::object &obj);
+            void remove_from_indexes(package::object &obj);
+
+            /**
+             * \brief Delete the registry snapshot, so that it's rebuilt from registry files on next load.
+             */
+            void invalidate_registry_snapshot();
+
         public:
             mutable std::mutex lockdown;
 
@@ -85,6 +98,9 @@ namespace eka2l1 {
             loader::choose_lang_func choose_lang;
             loader::var_value_resolver_func var_resolver;
 
+            // Called after files may have been added or removed by an install or uninstall
+            std::function<void()> files_changed;
+
             explicit packages(io_system *sys, config::state *conf, const drive_number residing = drive_c);
             bool installed(const uid pkg_uid);
 
@@ -110,8 +126,28 @@ namespace eka2l1 {
             std::vector<package::object *> dependents(const uid app_uid);
             std::vector<uid> installed_uids() const;
 
+            /**
+             * \brief Get the package that registered an executable with the given SID.
+             * \returns Nullptr if no package owns such executable.
+             */
+            package::object *package_by_sid(const epoc::uid sid);
+
+            /**
+             * \brief Get the package that installed the file at the given virtual path.
+             *
+             * The path comparison is case-insensitive.
+             *
+             * \returns Nullptr if the file is not owned by any package.
+             */
+            package::object *package_by_file(const std::u16string &path);
+
             bool add_package(package::object &pkg, const controller_info *controller_info);
             bool save_package(package::object &pkg);
+            /**
+             * \brief Delete the files of a package and remove its registration.
+             *
+             * Files that the file index says are owned by another package, because it installed over them later, are kept.
+             */
             bool uninstall_package(package::object &pkg);
             bool remove_registeration(package::object &pkg);
 
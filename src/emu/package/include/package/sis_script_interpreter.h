@@ -24,8 +24,12 @@
 
 #include <atomic>
 #include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
 #include <stack>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include <loader/sis_fields.h>
@@ -46,6 +50,7 @@ namespace eka2l1 {
 
     namespace common {
         class ro_stream;
+        class thread_pool;
     }
 
     namespace loader {
@@ -71,15 +76,28 @@ namespace eka2l1 {
                 std::uint16_t data_unit_block_index_;
             };
 
+            enum extract_result {
+                extract_result_skipped = 0,
+                extract_result_done = 1,
+                extract_result_failed = 2
+            };
+
             std::vector<extract_target_info> extract_targets;
+            std::vector<std::shared_future<extract_result>> extract_results; ///< Parallel to extract_targets.
+            std::unordered_map<std::string, std::size_t> extract_last_target_by_path;
+
+            std::unique_ptr<common::thread_pool> extract_pool;
+            std::atomic<bool> extract_cancelled;
+
             std::size_t extract_target_accumulated_size;
-            std::size_t extract_target_decomped_size;
+            std::atomic<std::size_t> extract_target_decomped_size;
 
             progress_changed_callback progress_changed_cb;
             cancel_requested_callback cancel_cb;
 
             drive_number install_drive;
             common::ro_stream *data_stream;
+            std::mutex data_stream_lock; ///< Extraction workers share the SIS stream with the interpreter.
 
             io_system *io;
             manager::packages *mngr;
@@ -130,6 +148,38 @@ namespace eka2l1 {
              */
             bool extract_file(const std::string &path, const uint32_t idx, uint16_t crr_blck_idx);
 
+            /**
+             * \brief Queue a file to be extracted by the extraction pool.
+             *
+             * The interpreter keeps running the install script while the file is inflated and written.
+             * Targets with the same path are written in script order.
+             */
+            void queue_extract_target(const extract_target_info &info);
+
+            /**
+             * \brief Report extraction progress and check if the user asked to cancel.
+             * \returns True if the installation has been cancelled.
+             */
+            bool poll_extract_cancel();
+
+            /**
+             * \brief Wait for one queued extraction, polling cancel on the calling thread meanwhile.
+             */
+            void wait_for_extract_result(const std::shared_future<extract_result> &result);
+
+            /**
+             * \brief Wait for all queued extractions, reporting progress and polling cancel on the calling thread.
+             * \returns False if any extraction failed or was cancelled.
+             */
+            bool wait_for_extract_targets();
+
+            /**
+             * \brief Cancel queued extractions, wait for the running ones and remove every file written.
+             */
+            void abort_extract_targets();
+
+            void report_extract_progress();
+
         public:
             show_text_func show_text; ///< Hook function to display texts.
             choose_lang_func choose_lang; ///< Hook function to choose controller's language.
@@ -137,6 +187,7 @@ namespace eka2l1 {
 
             explicit ss_interpreter(common::ro_stream *stream, io_system *io, manager::packages *mngr,
                 sis_controller *main_controller, sis_data *inst_data, drive_number install_drv);
+            ~ss_interpreter();
 
             std::unique_ptr<sis_registry_tree> interpret(progress_changed_callback cb = nullptr, cancel_requested_callback cancel_cb = nullptr);
 
@@ -34,6 +34,7 @@
 #include <package/sis_v1_installer.h>
 #include <vfs/vfs.h>
 
+#include <algorithm>
 #include <fstream>
 #include <yaml-cpp/yaml.h>
 
@@ -44,6 +45,16 @@ namespace eka2l1 {
     namespace manager {
         static constexpr const char *APP_REGISTRY_FILENAME = "apps_registry.yml";
         static constexpr const char *PACKAGE_FOLDER_PATH = "packages";
+        static constexpr const char *REGISTRY_SNAPSHOT_FILENAME_FORMAT = "cache/package_registry_{}.bin";
+
+        static constexpr std::uint32_t REGISTRY_SNAPSHOT_MAGIC = 0x53474B50; // PKGS
+        static constexpr std::uint32_t REGISTRY_SNAPSHOT_VERSION = 1;
+        static constexpr std::size_t MAXIMUM_REGISTRY_SNAPSHOT_SIZE = common::MB(64);
+
+        struct registry_folder_stamp {
+            std::string name_;
+            std::uint64_t last_write_;
+        };
 
         packages::packages(io_system *io, config::state *conf, const drive_number residing)
             : residing_(residing)
@@ -88,12 +99,208 @@ namespace eka2l1 {
             }
         }
 
+        static std::string get_registry_snapshot_path(config::state *conf, const drive_number residing) {
+            if (!conf) {
+                return "";
+            }
+
+            return add_path(conf->storage, fmt::format(REGISTRY_SNAPSHOT_FILENAME_FORMAT, static_cast<char>(drive_to_char16(residing))));
+        }
+
+        static std::vector<registry_folder_stamp> gather_registry_folder_stamps(io_system *io, const drive_number residing) {
+            std::vector<registry_folder_stamp> stamps;
+
+            const std::u16string parent_folder = get_virtual_registry_parent_folder(residing);
+            std::optional<std::u16string> parent_real_path = io->get_raw_path(parent_folder);
+
+            if (!parent_real_path.has_value()) {
+                return stamps;
+            }
+
+            // The parent folder changes when a package folder is added or removed, and each package folder changes
+            // when one of its registry file is created or deleted.
+            stamps.push_back({ "", common::get_last_modifiy_since_ad(parent_real_path.value()) });
+
+            std::unique_ptr<directory> registry_dir = io->open_dir(parent_folder, {}, io_attrib_include_dir);
+            if (!registry_dir) {
+                stamps.clear();
+                return stamps;
+            }
+
+            while (std::optional<entry_info> registry_folder_ent = registry_dir->get_next_entry()) {
+                if (registry_folder_ent->type != io_component_type::dir) {
+                    continue;
+                }
+
+                std::optional<std::u16string> folder_real_path = io->get_raw_path(common::utf8_to_ucs2(registry_folder_ent->full_path));
+                if (!folder_real_path.has_value()) {
+                    continue;
+                }
+
+                stamps.push_back({ registry_folder_ent->name, common::get_last_modifiy_since_ad(folder_real_path.value()) });
+            }
+
+            std::sort(stamps.begin() + 1, stamps.end(), [](const registry_folder_stamp &lhs, const registry_folder_stamp &rhs) {
+                return lhs.name_ < rhs.name_;
+            });
+
+            return stamps;
+        }
+
+        static void absorb_registry_snapshot_header(common::chunkyseri &seri, std::uint32_t &magic, std::uint32_t &version,
+            std::vector<registry_folder_stamp> &stamps) {
+            seri.absorb(magic);
+            seri.absorb(version);
+
+            std::uint32_t stamp_count = static_cast<std::uint32_t>(stamps.size());
+            seri.absorb(stamp_count);
+
+            if (seri.get_seri_mode() == common::SERI_MODE_READ) {
+                // A stamp takes at least the length of its name and its write time
+                if (!seri.count_fits(stamp_count, sizeof(std::uint32_t) + sizeof(std::uint64_t))) {
+                    stamp_count = 0;
+                }
+
+                stamps.resize(stamp_count);
+            }
+
+            for (registry_folder_stamp &stamp : stamps) {
+                seri.absorb(stamp.name_);
+                seri.absorb(stamp.last_write_);
+            }
+        }
+
+        static bool load_registry_snapshot(const std::string &path, const std::vector<registry_folder_stamp> &stamps,
+            std::vector<package::object> &objects) {
+            if (stamps.empty() || !common::exists(path)) {
+                return false;
+            }
+
+            common::ro_std_file_stream snapshot_stream(path, true);
+            if (!snapshot_stream.valid() || (snapshot_stream.size() > MAXIMUM_REGISTRY_SNAPSHOT_SIZE)) {
+                return false;
+            }
+
+            std::vector<std::uint8_t> snapshot_buffer(snapshot_stream.size());
+            if (snapshot_stream.read(snapshot_buffer.data(), snapshot_buffer.size()) != snapshot_buffer.size()) {
+                return false;
+            }
+
+            common::chunkyseri seri(snapshot_buffer.data(), snapshot_buffer.size(), common::SERI_MODE_READ);
+
+            std::uint32_t magic = 0;
+            std::uint32_t version = 0;
+            std::vector<registry_folder_stamp> snapshot_stamps;
+
+            absorb_registry_snapshot_header(seri, magic, version, snapshot_stamps);
+
+            if ((magic != REGISTRY_SNAPSHOT_MAGIC) || (version != REGISTRY_SNAPSHOT_VERSION) || (snapshot_stamps.size() != stamps.size())) {
+                return false;
+            }
+
+            for (std::size_t i = 0; i < stamps.size(); i++) {
+                if ((snapshot_stamps[i].name_ != stamps[i].name_) || (snapshot_stamps[i].last_write_ != stamps[i].last_write_)) {
+                    return false;
+                }
+            }
+
+            std::uint32_t object_count = 0;
+            seri.absorb(object_count);
+
+            // Every object takes at least as much as an empty one. Check the count before allocating,
+            // so that a corrupted one does not ask for gigabytes
+            package::object empty_object{};
+            common::chunkyseri measure_seri(nullptr, 0, common::SERI_MODE_MEASURE);
+            empty_object.do_state(measure_seri);
+
+            if (!seri.count_fits(object_count, measure_seri.size())) {
+                LOG_WARN(PACKAGE, "Package registry snapshot is corrupted, reloading all registries");
+                return false;
+            }
+
+            objects.resize(object_count);
+
+            for (package::object &obj : objects) {
+                obj.do_state(seri);
+            }
+
+            std::uint32_t end_magic = 0;
+            seri.absorb(end_magic);
+
+            if (end_magic != REGISTRY_SNAPSHOT_MAGIC) {
+                LOG_WARN(PACKAGE, "Package registry snapshot is corrupted, reloading all registries");
+                objects.clear();
+
+                return false;
+            }
+
+            return true;
+        }
+
+        static void write_registry_snapshot(const std::string &path, std::vector<registry_folder_stamp> &stamps, object_map_type &objects) {
+            if (stamps.empty()) {
+                return;
+            }
+
+            std::uint32_t magic = REGISTRY_SNAPSHOT_MAGIC;
+            std::uint32_t version = REGISTRY_SNAPSHOT_VERSION;
+            std::uint32_t object_count = static_cast<std::uint32_t>(objects.size());
+
+            auto do_snapshot = [&](common::chunkyseri &seri) {
+                absorb_registry_snapshot_header(seri, magic, version, stamps);
+                seri.absorb(object_count);
+
+                for (auto &[uid, obj] : objects) {
+                    obj.do_state(seri);
+                }
+
+                seri.absorb(magic);
+            };
+
+            common::chunkyseri seri(nullptr, 0, common::SERI_MODE_MEASURE);
+            do_snapshot(seri);
+
+            std::vector<std::uint8_t> snapshot_buffer(seri.size());
+            seri = common::chunkyseri(snapshot_buffer.data(), snapshot_buffer.size(), common::SERI_MODE_WRITE);
+            do_snapshot(seri);
+
+            common::create_directories(eka2l1::file_directory(path));
+            common::wo_std_file_stream snapshot_stream(path, true);
+
+            if (!snapshot_stream.valid()) {
+                LOG_WARN(PACKAGE, "Unable to write package registry snapshot to {}", path);
+                return;
+            }
+
+            snapshot_stream.write(snapshot_buffer.data(), snapshot_buffer.size());
+        }
+
+        void packages::invalidate_registry_snapshot() {
+            const std::string snapshot_path = get_registry_snapshot_path(conf, residing_);
+
+            if (!snapshot_path.empty() && common::exists(snapshot_path)) {
+                common::remove(snapshot_path);
+            }
+        }
+
         void packages::load_registries() {
             static constexpr const char16_t *STUB_CACHED_PATH_FORMAT = u"{}:\\stubcached";
             const std::u16string stub_cached_path = fmt::format(STUB_CACHED_PATH_FORMAT, drive_to_char16(drive_z));
 
-            std::unique_ptr<directory> registry_dir = sys->open_dir(get_virtual_registry_parent_folder(residing_), {}, io_attrib_include_dir);
-            if (!registry_dir) {
+            const std::string snapshot_path = get_registry_snapshot_path(conf, residing_);
+            std::vector<registry_folder_stamp> stamps = gather_registry_folder_stamps(sys, residing_);
+            std::vector<package::object> snapshot_objects;
+
+            const bool snapshot_valid = !snapshot_path.empty() && load_registry_snapshot(snapshot_path, stamps, snapshot_objects);
+
+            std::unique_ptr<directory> registry_dir = snapshot_valid ? nullptr : sys->open_dir(get_virtual_registry_parent_folder(residing_), {}, io_attrib_include_dir);
+
+            if (snapshot_valid) {
+                for (package::object &obj : snapshot_objects) {
+                    auto obj_ite = objects_.emplace(obj.uid, std::move(obj));
+                    add_to_indexes(obj_ite->second);
+                }
+            } else if (!registry_dir) {
                 LOG_INFO(PACKAGE, "Registry folder is unavailable!");
             } else {
                 while (std::optional<entry_info> registry_folder_ent = registry_dir->get_next_entry()) {
@@ -125,7 +332,8 @@ namespace eka2l1 {
                                     package::object final_obj;
                                     final_obj.do_state(seri);
 
-                                    objects_.emplace(final_obj.uid, std::move(final_obj));
+                                    auto obj_ite = objects_.emplace(final_obj.uid, std::move(final_obj));
+                                    add_to_indexes(obj_ite->second);
                                 }
                             }
                         }
@@ -143,6 +351,12 @@ namespace eka2l1 {
                     fclose(f);
                 }
             }
+
+            if (!snapshot_valid && !snapshot_path.empty()) {
+                // Write down the snapshot, so next time all the registry files do not have to be read again
+                stamps = gather_registry_folder_stamps(sys, residing_);
+                write_registry_snapshot(snapshot_path, stamps, objects_);
+            }
         }
 
         void packages::migrate_legacy_registries() {
@@ -269,8 +483,66 @@ namespace eka2l1 {
             return uniques;
         }
 
+        void packages::add_to_indexes(package::object &obj) {
+            for (const epoc::uid sid : obj.sids) {
+                sid_index_[sid] = &obj;
+            }
+
+            for (const package::file_description &desc : obj.file_descriptions) {
+                if (desc.target.empty()) {
+                    continue;
+                }
+
+                file_index_[common::lowercase_ucs2_string(desc.target)] = &obj;
+
+                // Registries written by older versions only have the SID in the file description
+                if (desc.sid != 0) {
+                    sid_index_[desc.sid] = &obj;
+                }
+            }
+        }
+
+        void packages::remove_from_indexes(package::object &obj) {
+            for (auto ite = sid_index_.begin(); ite != sid_index_.end();) {
+                if (ite->second == &obj) {
+                    ite = sid_index_.erase(ite);
+                } else {
+                    ite++;
+                }
+            }
+
+            for (const package::file_description &desc : obj.file_descriptions) {
+                auto ite = file_index_.find(common::lowercase_ucs2_string(desc.target));
+
+                if ((ite != file_index_.end()) && (ite->second == &obj)) {
+                    file_index_.erase(ite);
+                }
+            }
+        }
+
+        package::object *packages::package_by_sid(const epoc::uid sid) {
+            auto ite = sid_index_.find(sid);
+
+            if (ite == sid_index_.end()) {
+                return nullptr;
+            }
+
+            return ite->second;
+        }
+
+        package::object *packages::package_by_file(const std::u16string &path) {
+            auto ite = file_index_.find(common::lowercase_ucs2_string(path));
+
+            if (ite == file_index_.end()) {
+                return nullptr;
+            }
+
+            return ite->second;
+        }
+
         bool packages::save_package(package::object &pkg) {
             bool result = true;
+            invalidate_registry_snapshot();
 
             std::u16string residing_folder = get_virtual_registry_folder(residing_, pkg.uid);
             sys->create_directories(residing_folder);
@@ -400,6 +672,15 @@ namespace eka2l1 {
                     base_package->file_descriptions.push_back(std::move(new_desc));
                 }
 
+                // An update usually reinstalls the same executables, keep each SID once
+                for (const epoc::uid sid : pkg.sids) {
+                    if (std::find(base_package->sids.begin(), base_package->sids.end(), sid) == base_package->sids.end()) {
+                        base_package->sids.push_back(sid);
+                    }
+                }
+
+                add_to_indexes(*base_package);
+
                 if (!save_package(*base_package)) {
                     LOG_ERROR(PACKAGE, "Unable to write package info for 0x{:X}", base_package->uid);
                 }
@@ -429,8 +710,10 @@ namespace eka2l1 {
                 }
             }
 
-            if (!no_new_package)
-                objects_.emplace(pkg.uid, std::move(pkg));
+            if (!no_new_package) {
+                auto obj_ite = objects_.emplace(pkg.uid, std::move(pkg));
+                add_to_indexes(obj_ite->second);
+            }
 
             return true;
         }
@@ -463,11 +746,16 @@ namespace eka2l1 {
                 sys->delete_entry(ctrl_path);
             }
 
+            // The given package may be the object about to be erased
+            const epoc::uid pkg_uid = pkg.uid;
+
             // Remove the object
+            invalidate_registry_snapshot();
+            remove_from_indexes(pkg_ite->second);
             objects_.erase(pkg_ite);
 
-            if (objects_.find(pkg.uid) == objects_.end()) {
-                std::u16string the_reg_path = get_virtual_registry_folder(residing_, pkg.uid);
+            if (objects_.find(pkg_uid) == objects_.end()) {
+                std::u16string the_reg_path = get_virtual_registry_folder(residing_, pkg_uid);
                 if (std::optional<std::u16string> real_reg_path = sys->get_raw_path(the_reg_path)) {
                     common::delete_folder(common::ucs2_to_utf8(real_reg_path.value()));
                 }
@@ -493,13 +781,25 @@ namespace eka2l1 {
                 return false;
             }
 
-            // Delete files as requested by objects
+            // Delete files as requested by objects. A file that another package installed over since then
+            // belongs to that package now, so it stays
             for (const package::file_description &desc : pkg.file_descriptions) {
                 if ((desc.operation == static_cast<int>(loader::ss_op::install)) || (desc.operation == static_cast<int>(loader::ss_op::null))) {
+                    package::object *owner = package_by_file(desc.target);
+
+                    if (owner && (owner != &pkg_ite->second)) {
+                        LOG_INFO(PACKAGE, "Keeping {}, it is now owned by package 0x{:X}", common::ucs2_to_utf8(desc.target), owner->uid);
+                        continue;
+                    }
+
                     sys->delete_entry(desc.target);
                 }
             }
 
+            if (files_changed) {
+                files_changed();
+            }
+
             return remove_registeration(pkg);
         }
 
@@ -559,6 +859,11 @@ namespace eka2l1 {
 
                 std::unique_ptr<loader::sis_registry_tree> new_infos = interpreter.interpret(progress_cb, cancel_cb);
 
+                // Even an aborted installation may have left some files behind
+                if (files_changed) {
+                    files_changed();
+                }
+
                 if (new_infos) {
                     traverse_tree_and_add_packages(*new_infos);
 
@@ -573,7 +878,13 @@ namespace eka2l1 {
                 final_obj.file_major_version = 5;
                 final_obj.file_minor_version = 4;
 
-                if (!loader::install_sis_old(path, sys, drive, final_obj, choose_lang, var_resolver, progress_cb, cancel_cb)) {
+                const bool install_ok = loader::install_sis_old(path, sys, drive, final_obj, choose_lang, var_resolver, progress_cb, cancel_cb);
+
+                if (files_changed) {
+                    files_changed();
+                }
+
+                if (!install_ok) {
                     return package::installation_result_invalid;
                 }
 
@@ -22,7 +22,46 @@
 
 #include <utils/des.h>
 
+#include <type_traits>
+#include <vector>
+
 namespace eka2l1::package {
+    /**
+     * \brief Get the least number of bytes an element takes when serialized, which is the size of an empty one.
+     */
+    template <typename T>
+    static std::size_t min_serialized_size() {
+        if constexpr (std::is_integral_v<T>) {
+            return sizeof(T);
+        } else {
+            T empty{};
+            common::chunkyseri seri(nullptr, 0, common::SERI_MODE_MEASURE);
+            empty.do_state(seri);
+
+            return seri.size();
+        }
+    }
+
+    /**
+     * \brief Resize a container to the count that was just read.
+     *
+     * A count too big for the data left can only come from a corrupted registry. The container is
+     * left empty in that case, instead of allocating memory for it.
+     */
+    template <typename T>
+    static void resize_for_read(common::chunkyseri &seri, std::vector<T> &container, std::uint32_t &count,
+        const std::size_t min_element_size = min_serialized_size<T>()) {
+        if (seri.get_seri_mode() != common::SERI_MODE_READ) {
+            return;
+        }
+
+        if (!seri.count_fits(count, min_element_size)) {
+            count = 0;
+        }
+
+        container.resize(count);
+    }
+
     void package::do_state(common::chunkyseri &seri) {
         seri.absorb(uid);
         epoc::absorb_des_string(package_name, seri, true);
@@ -93,9 +132,7 @@ namespace eka2l1::package {
         count = static_cast<std::uint32_t>(sids.size());
         seri.absorb(count);
 
-        if (seri.get_seri_mode() == common::SERI_MODE_READ) {
-            sids.resize(count);
-        }
+        resize_for_read(seri, sids, count);
 
         for (uint32_t i = 0; i < count; i++) {
             seri.absorb(sids[i]);
@@ -105,9 +142,7 @@ namespace eka2l1::package {
         count = static_cast<std::uint32_t>(controller_infos.size());
         seri.absorb(count);
 
-        if (seri.get_seri_mode() == common::SERI_MODE_READ) {
-            controller_infos.resize(count);
-        }
+        resize_for_read(seri, controller_infos, count);
 
         for (uint32_t i = 0; i < count; i++) {
             controller_infos[i].do_state(seri);
@@ -154,9 +189,7 @@ namespace eka2l1::package {
         count = static_cast<std::uint32_t>(dependencies.size());
         seri.absorb(count);
 
-        if (seri.get_seri_mode() == common::SERI_MODE_READ) {
-            dependencies.resize(count);
-        }
+        resize_for_read(seri, dependencies, count);
 
         for (size_t i = 0; i < count; i++) {
             dependencies[i].do_state(seri);
@@ -166,9 +199,7 @@ namespace eka2l1::package {
         count = static_cast<std::uint32_t>(embedded_packages.size());
         seri.absorb(count);
 
-        if (seri.get_seri_mode() == common::SERI_MODE_READ) {
-            embedded_packages.resize(count);
-        }
+        resize_for_read(seri, embedded_packages, count);
         for (size_t i = 0; i < count; i++) {
             embedded_packages[i].do_state(seri);
         }
@@ -177,9 +208,7 @@ namespace eka2l1::package {
         count = static_cast<std::uint32_t>(properties.size());
         seri.absorb(count);
 
-        if (seri.get_seri_mode() == common::SERI_MODE_READ) {
-            properties.resize(count);
-        }
+        resize_for_read(seri, properties, count);
         for (size_t i = 0; i < count; i++) {
             properties[i].do_state(seri);
         }
@@ -188,9 +217,7 @@ namespace eka2l1::package {
         count = static_cast<std::uint32_t>(file_descriptions.size());
         seri.absorb(count);
 
-        if (seri.get_seri_mode() == common::SERI_MODE_READ) {
-            file_descriptions.resize(count);
-        }
+        resize_for_read(seri, file_descriptions, count);
 
         for (size_t i = 0; i < count; i++) {
             file_descriptions[i].do_state(seri);
@@ -202,9 +229,7 @@ namespace eka2l1::package {
         count = static_cast<std::uint32_t>(install_chain_indices.size());
         seri.absorb(count);
 
-        if (seri.get_seri_mode() == common::SERI_MODE_READ) {
-            install_chain_indices.resize(count);
-        }
+        resize_for_read(seri, install_chain_indices, count);
         for (size_t i = 0; i < count; i++) {
             seri.absorb(install_chain_indices[i]);
         }
@@ -216,9 +241,7 @@ namespace eka2l1::package {
             count = static_cast<std::uint32_t>(supported_language_ids.size());
             seri.absorb(count);
 
-            if (seri.get_seri_mode() == common::SERI_MODE_READ) {
-                supported_language_ids.resize(count);
-            }
+            resize_for_read(seri, supported_language_ids, count);
 
             for (std::uint32_t i = 0; i < count; i++) {
                 seri.absorb(supported_language_ids[i]);
@@ -227,9 +250,7 @@ namespace eka2l1::package {
             count = static_cast<std::uint32_t>(localized_package_names.size());
             seri.absorb(count);
 
-            if (seri.get_seri_mode() == common::SERI_MODE_READ) {
-                localized_package_names.resize(count);
-            }
+            resize_for_read(seri, localized_package_names, count, 1);
 
             for (std::uint32_t i = 0; i < count; i++) {
                 epoc::absorb_des_string(localized_package_names[i], seri, true);
@@ -238,9 +259,7 @@ namespace eka2l1::package {
             count = static_cast<std::uint32_t>(localized_vendor_names.size());
             seri.absorb(count);
 
-            if (seri.get_seri_mode() == common::SERI_MODE_READ) {
-                localized_vendor_names.resize(count);
-            }
+            resize_for_read(seri, localized_vendor_names, count, 1);
 
             for (std::uint32_t i = 0; i < count; i++) {
                 epoc::absorb_des_string(localized_vendor_names[i], seri, true);
@@ -28,6 +28,7 @@
 #include <common/time.h>
 #include <common/types.h>
 #include <common/platform.h>
+#include <common/thread_pool.h>
 
 #include <config/config.h>
 #include <vfs/vfs.h>
@@ -40,8 +41,13 @@
 
 #include <miniz.h>
 
+#include <algorithm>
+#include <chrono>
+
 namespace eka2l1 {
     namespace loader {
+        static constexpr std::uint32_t EXTRACT_PROGRESS_POLL_INTERVAL_MS = 30;
+
         std::string get_install_path(const std::u16string &pseudo_path, drive_number drv) {
             std::u16string raw_path = pseudo_path;
 
@@ -73,6 +79,7 @@ namespace eka2l1 {
             : main_controller(main_controller)
             , install_data(inst_data)
             , conf(nullptr)
+            , extract_cancelled(false)
             , extract_target_accumulated_size(0)
             , extract_target_decomped_size(0)
             , progress_changed_cb(nullptr)
@@ -82,6 +89,12 @@ namespace eka2l1 {
             , mngr(mngr) {
         }
 
+        ss_interpreter::~ss_interpreter() {
+            if (extract_pool) {
+                abort_extract_targets();
+            }
+        }
+
         std::vector<uint8_t> ss_interpreter::get_small_file_buf(uint32_t data_idx, uint16_t crr_blck_idx) {
             sis_file_data *data = reinterpret_cast<sis_file_data *>(
                 reinterpret_cast<sis_data_unit *>(install_data->data_units.fields[crr_blck_idx].get())->data_unit.fields[data_idx].get());
@@ -91,8 +104,12 @@ namespace eka2l1 {
 
             compressed.compressed_data.resize(us);
 
-            data_stream->seek(compressed.offset, common::seek_where::beg);
-            data_stream->read(&compressed.compressed_data[0], us);
+            {
+                const std::lock_guard<std::mutex> guard(data_stream_lock);
+
+                data_stream->seek(compressed.offset, common::seek_where::beg);
+                data_stream->read(&compressed.compressed_data[0], us);
+            }
 
             if (compressed.algorithm == sis_compressed_algorithm::none) {
                 return compressed.compressed_data;
@@ -129,16 +146,7 @@ namespace eka2l1 {
         }
 
         bool ss_interpreter::extract_file(const std::string &path, const uint32_t idx, uint16_t crr_blck_idx) {
-            std::string rp = eka2l1::file_directory(path);
-            common::create_directories(rp);
-
-            // Delete the file, starts over
-            if (common::is_system_case_insensitive() && common::exists(path)) {
-                if (!common::remove(path)) {
-                    LOG_WARN(PACKAGE, "Unable to remove {} to extract new file", path);
-                }
-            }
-
+            // Runs on an extraction worker. Directories were already made by the interpreter thread
             sis_data_unit *data_unit = reinterpret_cast<sis_data_unit *>(install_data->data_units.fields[crr_blck_idx].get());
 
             if (data_unit->data_unit.fields.empty()) {
@@ -148,58 +156,72 @@ namespace eka2l1 {
 
             sis_file_data *data = reinterpret_cast<sis_file_data *>(data_unit->data_unit.fields[idx].get());
 
-            sis_compressed compressed = data->raw_data;
+            const sis_compressed &compressed = data->raw_data;
 
             std::uint64_t left = ((compressed.len_low) | (static_cast<std::uint64_t>(compressed.len_high) << 32)) - 12;
-            data_stream->seek(compressed.offset, common::seek_where::beg);
+            std::uint64_t read_offset = compressed.offset;
 
             std::vector<unsigned char> temp_chunk;
             temp_chunk.resize(CHUNK_SIZE);
 
             std::vector<unsigned char> temp_inflated_chunk;
-            temp_inflated_chunk.resize(CHUNK_MAX_INFLATED_SIZE);
 
             mz_stream stream;
 
             stream.zalloc = nullptr;
             stream.zfree = nullptr;
 
-            if (compressed.algorithm == sis_compressed_algorithm::deflated) {
+            const bool deflated = (compressed.algorithm == sis_compressed_algorithm::deflated);
+
+            if (deflated) {
+                temp_inflated_chunk.resize(CHUNK_MAX_INFLATED_SIZE);
+
                 if (inflateInit(&stream) != MZ_OK) {
                     LOG_ERROR(PACKAGE, "Can not intialize inflate stream");
+                    return false;
                 }
             }
 
             std::uint32_t total_inflated_size = 0;
             bool cancel_requested = false;
+            bool failed = false;
 
             {
                 common::wo_std_file_stream std_fstream(path, true);
 
                 while (left > 0) {
-                    if (cancel_cb && cancel_cb()) {
+                    if (extract_cancelled) {
                         cancel_requested = true;
                         break;
                     }
 
-                    std::fill(temp_chunk.begin(), temp_chunk.end(), 0);
                     int grab = static_cast<int>(left < CHUNK_SIZE ? left : CHUNK_SIZE);
 
-                    data_stream->read(&temp_chunk[0], grab);
+                    {
+                        // Other workers move the cursor between our reads, so always seek
+                        const std::lock_guard<std::mutex> guard(data_stream_lock);
 
-                    if (!data_stream->valid()) {
-                        LOG_ERROR(PACKAGE, "Stream fail, skipping this file, should report to developers.");
-                        return false;
+                        data_stream->seek(read_offset, common::seek_where::beg);
+                        data_stream->read(&temp_chunk[0], grab);
+
+                        if (!data_stream->valid()) {
+                            LOG_ERROR(PACKAGE, "Stream fail, skipping this file, should report to developers.");
+                            failed = true;
+                            break;
+                        }
                     }
 
-                    if (compressed.algorithm == sis_compressed_algorithm::deflated) {
+                    read_offset += grab;
+
+                    if (deflated) {
                         uint32_t inflated_size = 0;
 
                         auto res = flate::inflate_data(&stream, temp_chunk.data(), temp_inflated_chunk.data(), grab, &inflated_size);
 
                         if (!res) {
                             LOG_ERROR(PACKAGE, "Decompress failed! Report to developers");
-                            return false;
+                            failed = true;
+                            break;
                         }
 
                         std_fstream.write(temp_inflated_chunk.data(), inflated_size);
@@ -212,18 +234,10 @@ namespace eka2l1 {
                     }
 
                     left -= grab;
-
-                    if (progress_changed_cb) {
-                        if (extract_target_accumulated_size != 0) {
-                            progress_changed_cb(extract_target_decomped_size, extract_target_accumulated_size);
-                        } else {
-                            progress_changed_cb(100, 100);
-                        }
-                    }
                 }
 
-                if (compressed.algorithm == sis_compressed_algorithm::deflated) {
-                    if (!cancel_requested && (total_inflated_size != compressed.uncompressed_size)) {
+                if (deflated) {
+                    if (!cancel_requested && !failed && (total_inflated_size != compressed.uncompressed_size)) {
                         LOG_ERROR(PACKAGE, "Sanity check failed: Total inflated size not equal to specified uncompress size "
                                            "in SISCompressed ({} vs {})!",
                             total_inflated_size, compressed.uncompressed_size);
@@ -233,7 +247,7 @@ namespace eka2l1 {
                 }
             }
 
-            if (cancel_requested) {
+            if (cancel_requested || failed) {
                 common::remove(path);
                 return false;
             }
@@ -241,6 +255,110 @@ namespace eka2l1 {
             return true;
         }
 
+        void ss_interpreter::queue_extract_target(const extract_target_info &info) {
+            if (!extract_pool) {
+                extract_pool = std::make_unique<common::thread_pool>("SIS extractor");
+            }
+
+            // Workers only write, so prepare the destination here. Creating the same directories
+            // from several threads at once is not safe
+            common::create_directories(eka2l1::file_directory(info.file_path_));
+
+            // Paths that only differ in case are the same file on case-insensitive hosts
+            const std::string path_key = common::lowercase_string(info.file_path_);
+
+            std::shared_future<extract_result> previous;
+            auto previous_ite = extract_last_target_by_path.find(path_key);
+
+            if (previous_ite != extract_last_target_by_path.end()) {
+                // The same file is installed again later in the script. Let the last write win, like before
+                previous = extract_results[previous_ite->second];
+            } else if (common::is_system_case_insensitive() && common::exists(info.file_path_)) {
+                // Delete the file, starts over
+                if (!common::remove(info.file_path_)) {
+                    LOG_WARN(PACKAGE, "Unable to remove {} to extract new file", info.file_path_);
+                }
+            }
+
+            extract_last_target_by_path[path_key] = extract_targets.size();
+            extract_targets.push_back(info);
+
+            auto extract_task = [this, info, previous]() {
+                if (previous.valid()) {
+                    previous.wait();
+                }
+
+                if (extract_cancelled) {
+                    return extract_result_skipped;
+                }
+
+                return extract_file(info.file_path_, info.data_unit_block_index_, info.data_unit_index_)
+                    ? extract_result_done
+                    : extract_result_failed;
+            };
+
+            extract_results.push_back(extract_pool->submit(extract_task).share());
+        }
+
+        void ss_interpreter::report_extract_progress() {
+            if (!progress_changed_cb) {
+                return;
+            }
+
+            if (extract_target_accumulated_size != 0) {
+                progress_changed_cb(extract_target_decomped_size, extract_target_accumulated_size);
+            } else {
+                progress_changed_cb(100, 100);
+            }
+        }
+
+        bool ss_interpreter::poll_extract_cancel() {
+            report_extract_progress();
+
+            if (!extract_cancelled && cancel_cb && cancel_cb()) {
+                extract_cancelled = true;
+            }
+
+            return extract_cancelled;
+        }
+
+        void ss_interpreter::wait_for_extract_result(const std::shared_future<extract_result> &result) {
+            while (result.wait_for(std::chrono::milliseconds(EXTRACT_PROGRESS_POLL_INTERVAL_MS)) != std::future_status::ready) {
+                poll_extract_cancel();
+            }
+        }
+
+        bool ss_interpreter::wait_for_extract_targets() {
+            bool succeed = true;
+
+            for (auto &result : extract_results) {
+                wait_for_extract_result(result);
+
+                if (result.get() != extract_result_done) {
+                    // Stop the rest early, but still wait for them, they reference us
+                    extract_cancelled = true;
+                    succeed = false;
+                }
+            }
+
+            report_extract_progress();
+            return succeed;
+        }
+
+        void ss_interpreter::abort_extract_targets() {
+            extract_cancelled = true;
+
+            for (std::size_t i = 0; i < extract_results.size(); i++) {
+                if (extract_results[i].get() == extract_result_done) {
+                    common::remove(extract_targets[i].file_path_);
+                }
+            }
+
+            extract_pool.reset();
+            extract_results.clear();
+            extract_last_target_by_path.clear();
+        }
+
         int ss_interpreter::gasp_true_form_of_integral_expression(const sis_expression &expr) {
             switch (expr.op) {
             case ss_expr_op::EPrimTypeVariable: {
@@ -461,6 +579,10 @@ namespace eka2l1 {
                                 uncomp_size, ver_used)
                             == 0) {
                             desc.sid = extended_header.info.secure_id;
+
+                            if ((desc.sid != 0) && (std::find(parent.sids.begin(), parent.sids.end(), desc.sid) == parent.sids.end())) {
+                                parent.sids.push_back(desc.sid);
+                            }
                         }
                     }
                 }
@@ -538,6 +660,11 @@ namespace eka2l1 {
         bool ss_interpreter::interpret(sis_install_block &install_block, sis_registry_tree &parent_tree, std::uint16_t crr_blck_idx) {
             // Process file
             for (auto &wrap_file : install_block.files.fields) {
+                // Extraction runs in the background, so a cancel has to be noticed while the script runs too
+                if (poll_extract_cancel()) {
+                    return false;
+                }
+
                 sis_file_des *file = reinterpret_cast<sis_file_des *>(wrap_file.get());
                 std::string raw_path = "";
                 std::string install_path = "";
@@ -600,6 +727,13 @@ namespace eka2l1 {
                             break;
                         }
 
+                        if (!install_path.empty()) {
+                            package::object *owner = mngr->package_by_file(common::utf8_to_ucs2(install_path));
+                            if (owner && (owner->uid != main_controller->info.uid.uid)) {
+                                LOG_WARN(PACKAGE, "File {} is owned by package 0x{:X}, it will be overwritten and owned by this package", install_path, owner->uid);
+                            }
+                        }
+
                         bool lowered = false;
 
                         if (common::is_platform_case_sensitive()) {
@@ -613,8 +747,8 @@ namespace eka2l1 {
                             info.data_unit_block_index_ = file->idx;
                             info.data_unit_index_ = crr_blck_idx;
 
-                            extract_targets.push_back(info);
                             extract_target_accumulated_size += file->uncompressed_len;
+                            queue_extract_target(info);
                         }
 
                         if (!lowered) {
@@ -622,6 +756,15 @@ namespace eka2l1 {
                         }
 
                         if (FOUND_STR(raw_path.find(".sis")) || FOUND_STR(raw_path.find(".sisx"))) {
+                            if (!install_data->data_units.fields.empty()) {
+                                // The identification reads the extracted file, so it has to be written by now
+                                wait_for_extract_result(extract_results.back());
+
+                                if (extract_cancelled) {
+                                    return false;
+                                }
+                            }
+
                             if (!install_data->data_units.fields.empty() && (loader::identify_sis_type(raw_path).has_value())) {
                                 LOG_INFO(PACKAGE, "Detected an SmartInstaller SIS, path at: {}", raw_path);
                                 gathered_sis_paths.push_back(common::utf8_to_ucs2(raw_path));
@@ -696,14 +839,19 @@ namespace eka2l1 {
 
             gathered_sis_paths.clear();
             extract_targets.clear();
+            extract_results.clear();
+            extract_last_target_by_path.clear();
 
+            extract_cancelled = false;
             extract_target_accumulated_size = 0;
             extract_target_decomped_size = 0;
 
             progress_changed_cb = cb;
             cancel_cb = ccb;
 
+            // Files are extracted in the background as soon as the script reaches them
             if (!interpret(main_controller, *trees, 0)) {
+                abort_extract_targets();
                 return nullptr;
             }
 
@@ -711,24 +859,12 @@ namespace eka2l1 {
                 if (cb)
                     cb(1, 1);
             } else {
-                std::size_t n = 0;
-                bool cancel_requested = false;
-
-                for (; n < extract_targets.size(); n++) {
-                    extract_target_info &target = extract_targets[n];
-                    if (!extract_file(target.file_path_, target.data_unit_block_index_, target.data_unit_index_)) {
-                        cancel_requested = true;
-                        break;
-                    }
-                }
-
-                if (cancel_requested) {
-                    for (std::size_t i = 0; i < n; i++) {
-                        common::remove(extract_targets[i].file_path_);
-                    }
-
+                if (!wait_for_extract_targets()) {
+                    abort_extract_targets();
                     return nullptr;
                 }
+
+                extract_pool.reset();
             }
 
             fill_embeds_to_package_info(*trees);
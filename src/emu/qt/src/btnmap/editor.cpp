@@ -86,6 +86,11 @@ namespace eka2l1::qt::btnmap {
     }
 
     void editor::draw(drivers::graphics_driver *driver, drivers::graphics_command_builder &builder, const eka2l1::vec2f &scale) {
+        if (atlas_) {
+            // The builder of the last frame has been submitted by now
+            atlas_->mark_draws_submitted();
+        }
+
         // Draw a gray overlay
         builder.set_feature(eka2l1::drivers::graphics_feature::blend, true);
         builder.blend_formula(drivers::blend_equation::add, drivers::blend_equation::add,
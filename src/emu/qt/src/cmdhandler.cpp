@@ -308,7 +308,9 @@ bool mount_card_option_handler(eka2l1::common::arg_parser *parser, void *userdat
     } else {
         std::cout << "Mounting in progress. Please wait..." << std::endl;
 
-        eka2l1::zip_mount_error error = emu->symsys->mount_game_zip(drive_e, drive_media::physical, path, (writable_sd ? 0 : io_attrib_write_protected));
+        const std::string card_folder = eka2l1::add_path(emu->conf.storage, "cards/" + eka2l1::replace_extension(eka2l1::filename(path), "") + "/");
+        eka2l1::zip_mount_error error = emu->symsys->mount_game_zip(drive_e, drive_media::physical, path, (writable_sd ? 0 : io_attrib_write_protected),
+            nullptr, nullptr, card_folder);
         if (error != eka2l1::zip_mount_error_none) {
             switch (error) {
             case eka2l1::zip_mount_error_corrupt:
@@ -817,9 +817,13 @@ void main_window::mount_game_card_dump(QString mount_path) {
         current_progress_dialog_->setAttribute(Qt::WA_DeleteOnClose, true);
         current_progress_dialog_->show();
 
-        QFuture<eka2l1::zip_mount_error> extract_future = QtConcurrent::run([this, mount_path]() -> eka2l1::zip_mount_error {
+        // Stream the dump into a folder kept for it, rather than staging it in the temporary cache
+        const std::string card_folder = eka2l1::add_path(emulator_state_.conf.storage, "cards/" + eka2l1::replace_extension(eka2l1::filename(mount_path.toStdString()), "") + "/");
+
+        QFuture<eka2l1::zip_mount_error> extract_future = QtConcurrent::run([this, mount_path, card_folder]() -> eka2l1::zip_mount_error {
             return emulator_state_.symsys->mount_game_zip(
-                drive_e, drive_media::physical, mount_path.toStdString(), 0, [this](const std::size_t done, const std::size_t total) { emit progress_dialog_change(done, total); }, [this] { return current_progress_dialog_->wasCanceled(); });
+                drive_e, drive_media::physical, mount_path.toStdString(), 0, [this](const std::size_t done, const std::size_t total) { emit progress_dialog_change(done, total); }, [this] { return current_progress_dialog_->wasCanceled(); },
+                card_folder);
         });
 
         while (!extract_future.isFinished()) {
@@ -30,6 +30,7 @@
 #include <services/fbs/font.h>
 #include <services/fbs/font_atlas.h>
 #include <services/fbs/font_store.h>
+#include <services/fbs/mbm_cache.h>
 #include <services/framework.h>
 #include <services/window/common.h>
 
@@ -356,6 +357,7 @@ namespace eka2l1 {
         std::u16string default_system_font;
 
         std::unordered_map<fbsbitmap_cache_info, fbsbitmap *> shared_bitmaps;
+        epoc::mbm_cache bitmap_file_cache;
 
         std::unique_ptr<epoc::chunk_allocator> shared_chunk_allocator;
         std::unique_ptr<epoc::chunk_allocator> large_chunk_allocator;
@@ -484,10 +486,14 @@ namespace eka2l1 {
          * \param idx_          Index of the bitmap in MBM. Index base is 0.
          * \param size_         Reference variable to assign the new size in case the data is decompressed.
          * \param err_code      Pointer to integer which will holds error code. Must not be null.
+         * \param modify_time   Last modification time of the MBM file, used to key the decompressed data cache.
+         *                      The cache is not used if this is 0.
+         * \param path          Path of the MBM file, used to key the decompressed data cache.
          * 
          * \return Pointer to the data.
          */
-        void *load_data_to_rom(loader::mbm_file &mbmf_, const std::size_t idx_, std::size_t &size_decomp, int *err_code);
+        void *load_data_to_rom(loader::mbm_file &mbmf_, const std::size_t idx_, std::size_t &size_decomp, int *err_code,
+            const std::uint64_t modify_time = 0, const std::u16string &path = u"");
 
         /*! \brief Use to Allocate structure from server side.
          *
@@ -22,10 +22,11 @@
 #include <services/fbs/adapter/font_adapter.h>
 #include <services/window/common.h>
 
-#include <deque>
-#include <map>
+#include <list>
 #include <memory>
+#include <optional>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace eka2l1::drivers {
@@ -36,25 +37,96 @@ namespace eka2l1::drivers {
 namespace eka2l1::epoc {
 #define ESTIMATE_MAX_CHAR_IN_ATLAS_WIDTH 50
 
+    /**
+     * \brief Packs rectangles into horizontal shelves of a fixed size area.
+     *
+     * Each shelf is as tall as the first rectangle opened it, and keeps a list of free horizontal spans,
+     * so that freed rectangles can be reused by others of similar height.
+     */
+    class atlas_shelf_packer {
+        struct shelf {
+            int y_;
+            int height_;
+
+            std::vector<eka2l1::vec2> free_spans_; ///< Sorted by x. Each is (x, width).
+        };
+
+        eka2l1::vec2 size_;
+        int next_shelf_y_;
+
+        std::vector<shelf> shelves_;
+
+        std::optional<eka2l1::vec2> allocate_in_shelf(const std::size_t shelf_index, const int width);
+
+    public:
+        explicit atlas_shelf_packer(const eka2l1::vec2 size = { 0, 0 });
+
+        void reset(const eka2l1::vec2 size);
+
+        /**
+         * \brief Allocate a rectangle.
+         *
+         * \param size             Size of the rectangle.
+         * \param shelf_index      On success, contains the index of the shelf the rectangle is in.
+         *
+         * \returns Top-left position of the rectangle, or nothing if there is no space left.
+         */
+        std::optional<eka2l1::vec2> allocate(const eka2l1::vec2 size, std::size_t &shelf_index);
+
+        /**
+         * \brief Give back a rectangle allocated before.
+         */
+        void free(const std::size_t shelf_index, const int x, const int width);
+
+        std::size_t shelf_count() const {
+            return shelves_.size();
+        }
+    };
+
     /**
      * \brief Font atlas is a texture contains glyph bitmaps.
      * 
      * The atlas dimension is a square, and height is equals to font_size *
      * estimate_max_char_in_atlas.
+     *
+     * Glyphs are rasterized one by one, placed with a shelf packer, and only their rectangle is uploaded
+     * to the texture. When the atlas is full, least recently used glyphs are evicted.
+     *
+     * Glyph uploads are submitted right away, while the draws stay in the caller's builder. Glyphs used by
+     * draws made after the last call to mark_draws_submitted are never evicted, so their slots can't be
+     * overwritten before those draws run.
      */
     struct font_atlas {
-        std::map<char16_t, adapter::character_info> characters_;
+        struct glyph_entry {
+            adapter::character_info info_;
+            std::list<char16_t>::iterator last_use_pos_;
+
+            std::size_t shelf_index_;
+            bool has_slot_;
+
+            std::uint32_t draw_serial_; ///< Serial of the last draw using this glyph.
+        };
+
+        std::unordered_map<char16_t, glyph_entry> characters_;
         drivers::handle atlas_handle_;
         adapter::font_file_adapter_base *adapter_;
         int size_;
 
-        std::vector<int> last_use_;
+        std::list<char16_t> last_use_; ///< Most recently used glyph first.
 
         std::pair<char16_t, char16_t> initial_range_;
-        std::unique_ptr<std::uint8_t[]> atlas_data_;
+        atlas_shelf_packer packer_;
+        std::vector<std::uint8_t> scratch_;
 
         std::size_t typeface_idx_;
-        std::int32_t pack_handle_;
+        std::uint32_t draw_serial_;
+        std::uint32_t submitted_serial_; ///< Serial of the last draw known to be submitted to the driver.
+
+        /**
+         * \brief Rasterize a glyph, place it in the atlas and queue the upload of its rectangle.
+         */
+        bool add_glyph(const char16_t code, drivers::graphics_command_builder &upload_builder);
+        bool evict_least_used();
 
     public:
         explicit font_atlas();
@@ -80,5 +152,14 @@ namespace eka2l1::epoc {
         int get_char_size() const {
             return size_;
         }
+
+        /**
+         * \brief Tell the atlas that the builders of all draws made so far have been submitted.
+         *
+         * Until then, glyphs used by those draws are kept in the atlas.
+         */
+        void mark_draws_submitted() {
+            submitted_serial_ = draw_serial_;
+        }
     };
 }
\ No newline at end of file
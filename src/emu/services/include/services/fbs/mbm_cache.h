@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2019 EKA2L1 Team.
+ * 
+ * This file is part of EKA2L1 project.
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <loader/mbm.h>
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace eka2l1::common {
+    class ro_stream;
+}
+
+namespace eka2l1::epoc {
+    /**
+     * \brief Caches parsed MBM headers and decompressed bitmap payloads.
+     *
+     * Applications usually load bitmaps from the same few MBM files over and over (icons, skins...).
+     * Without a cache, each load re-opens the file, re-reads the trailer and the headers, and runs
+     * the RLE decompression again.
+     *
+     * Both caches are keyed by the file's path and last modification time, so a file that got
+     * rewritten is never served from the stale data.
+     */
+    class mbm_cache {
+        struct header_entry {
+            std::uint64_t modify_time_;
+            std::uint64_t file_size_;
+
+            std::unique_ptr<loader::mbm_file> file_;
+        };
+
+        struct payload_key {
+            std::u16string path_;
+            std::size_t index_;
+            std::uint64_t modify_time_;
+
+            bool operator==(const payload_key &rhs) const {
+                return (index_ == rhs.index_) && (modify_time_ == rhs.modify_time_) && (path_ == rhs.path_);
+            }
+        };
+
+        struct payload_key_hash {
+            std::size_t operator()(const payload_key &key) const noexcept;
+        };
+
+        struct payload_entry {
+            payload_key key_;
+            std::vector<std::uint8_t> data_;
+        };
+
+        std::unordered_map<std::u16string, header_entry> headers_;
+
+        std::list<payload_entry> payloads_;
+        std::unordered_map<payload_key, std::list<payload_entry>::iterator, payload_key_hash> payload_lookup_;
+
+        std::size_t payload_size_;
+        std::size_t max_payload_size_;
+
+    public:
+        explicit mbm_cache(const std::size_t max_payload_size);
+
+        /**
+         * \brief Get the MBM file with all of its headers read.
+         *
+         * On a miss, all headers in the file are read from the given stream and indexed. The returned
+         * file is bound to the given stream, and must not be used after the stream is gone.
+         *
+         * \param path          Path of the file containing the MBM.
+         * \param modify_time   Last modification time of the file.
+         * \param file_size     Size of the file.
+         * \param stream        Stream to read the MBM from.
+         *
+         * \returns Nullptr if the headers can't be read.
+         */
+        loader::mbm_file *get_headers(const std::u16string &path, const std::uint64_t modify_time,
+            const std::uint64_t file_size, common::ro_stream *stream);
+
+        /**
+         * \brief Look for the decompressed data of a bitmap, and mark it as most recently used.
+         *
+         * \returns Nullptr if the data is not cached.
+         */
+        const std::vector<std::uint8_t> *get_payload(const std::u16string &path, const std::size_t index,
+            const std::uint64_t modify_time);
+
+        /**
+         * \brief Store the decompressed data of a bitmap.
+         *
+         * Least recently used payloads are evicted until the total size fits the limit. Data larger
+         * than the limit itself is not cached.
+         */
+        void add_payload(const std::u16string &path, const std::size_t index, const std::uint64_t modify_time,
+            const std::uint8_t *data, const std::size_t size);
+
+        void clear();
+
+        std::size_t payload_size() const {
+            return payload_size_;
+        }
+
+        std::size_t payload_count() const {
+            return payloads_.size();
+        }
+    };
+}
@@ -27,11 +27,18 @@
 #include <utils/version.h>
 
 #include <algorithm>
+#include <condition_variable>
 #include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <memory>
 #include <mutex>
 #include <unordered_map>
+#include <vector>
+
+namespace eka2l1 {
+    class ntimer;
+}
 
 namespace eka2l1::service {
     using uid = std::uint32_t;
@@ -88,6 +95,57 @@ namespace eka2l1::service {
     class typical_session;
     using typical_session_ptr = std::unique_ptr<typical_session>;
 
+    /**
+     * \brief Runs the blocking host part of HLE requests on host worker threads.
+     *
+     * The work function runs on a worker, without the kernel lock. It must only do host work (such as reading
+     * a host file into a host buffer), and must not touch guest memory or kernel objects. Once it is done,
+     * the finish function is posted back through a timer event, and run with the kernel lock held.
+     * If the queue is stopped first, the finish function is still called, with cancelled set.
+     */
+    class host_work_queue {
+    public:
+        using work_func = std::function<void()>;
+        using finish_func = std::function<void(const bool cancelled)>;
+
+    private:
+        struct state {
+            std::mutex lock_;
+            std::condition_variable idle_cond_;
+
+            std::size_t running_ = 0;
+            bool completing_ = false;
+            bool stopped_ = false;
+
+            std::vector<finish_func> finished_;
+        };
+
+        kernel_system *kern_;
+        ntimer *timing_;
+        std::shared_ptr<state> state_;
+        int finish_evt_;
+
+    public:
+        explicit host_work_queue(kernel_system *kern, ntimer *timing, const std::string &name);
+        ~host_work_queue();
+
+        /**
+         * \brief Queue host work, and the function finishing it under the kernel lock.
+         *
+         * The finish function is called and destroyed with the kernel lock held.
+         */
+        void queue(work_func work, finish_func finish);
+
+        /**
+         * \brief Wait for running work to end, and cancel the finish functions that have not run yet.
+         *
+         * Must be called with the kernel lock held, or while the kernel is not running, since the cancelled
+         * finish functions run on the calling thread. Workers never take the kernel lock, so waiting for them
+         * with it held does not deadlock.
+         */
+        void stop();
+    };
+
     class typical_server : public server {
     protected:
         friend class typical_session;
@@ -97,6 +155,8 @@ namespace eka2l1::service {
 
         std::optional<epoc::version> get_version(service::ipc_context *ctx);
 
+        std::unique_ptr<host_work_queue> host_work_;
+
     public:
         ~typical_server() override;
 
@@ -165,7 +225,26 @@ namespace eka2l1::service {
         void disconnect(service::ipc_context &ctx) override;
         void disconnect_impl(service::session *ss);
 
+        /**
+         * \brief Run the blocking host part of a request on a host worker, and complete it asynchronously.
+         *
+         * The context is taken over. Its handler should gather everything from the guest first, then return
+         * right after this call.
+         *
+         * \param ctx     The context of the request.
+         * \param work    Host work to do on the worker. See host_work_queue for what it may touch.
+         * \param finish  Called with the kernel lock held once the work is done, to write results and complete
+         *                the request. If the server is destroyed first, the request is completed with
+         *                epoc::error_cancel instead.
+         */
+        void defer_host_work(service::ipc_context *ctx, host_work_queue::work_func work,
+            std::function<void(service::ipc_context &)> finish);
+
         int destroy() override {
+            if (host_work_) {
+                host_work_->stop();
+            }
+
             clear_all_sessions();
             return server::destroy();
         }
@@ -29,7 +29,9 @@
 
 #include <atomic>
 #include <clocale>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
 #include <regex>
 #include <unordered_map>
 
@@ -87,6 +89,20 @@ namespace eka2l1 {
 
         kernel::uid process{ 0 };
 
+        std::mutex host_io_lock;
+        std::condition_variable host_io_cond;
+        bool host_io_pending = false; ///< A host worker is reading the file of this node.
+
+        void begin_host_io();
+        void end_host_io();
+
+        /**
+         * \brief Wait until no host worker uses the file of this node.
+         *
+         * Workers never take the kernel lock, so this can be called with it held.
+         */
+        void wait_host_io();
+
         void deref() override;
         ~fs_node() override;
     };
@@ -106,7 +122,14 @@ namespace eka2l1 {
         std::u16string ss_path;
 
         fs_node *get_file_node(const int handle) {
-            return obj_table_.get<fs_node>(handle);
+            fs_node *node = obj_table_.get<fs_node>(handle);
+
+            // Requests on the same file are handled in order
+            if (node) {
+                node->wait_host_io();
+            }
+
+            return node;
         }
 
         explicit fs_server_client(service::typical_server *srv, kernel::uid suid, epoc::version client_version, kernel::thread *own_thr);
@@ -327,6 +350,12 @@ namespace eka2l1 {
 
         void init();
 
+        /**
+         * \brief Called after a client created, renamed or deleted an entry.
+         * \param path Absolute path of the entry.
+         */
+        void entry_changed(const std::u16string &path);
+
     public:
         explicit fs_server(system *sys);
         ~fs_server() override;
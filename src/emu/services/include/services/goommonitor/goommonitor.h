@@ -22,6 +22,10 @@
 #include <kernel/server.h>
 #include <services/framework.h>
 
+#include <cstddef>
+#include <string>
+#include <vector>
+
 namespace eka2l1 {
     enum goom_monitor_opcode {
         goom_monitor_request_free_memory = 0,
@@ -31,11 +35,45 @@ namespace eka2l1 {
         goom_monitor_request_optional_ram = 4
     };
 
+    struct goom_process_memory_usage {
+        kernel::uid process_id_;
+        std::string process_name_;
+
+        std::size_t committed_ = 0;      ///< Memory committed by the guest.
+        std::size_t resident_ = 0;       ///< Host memory really backing the committed memory.
+    };
+
+    struct goom_memory_report {
+        std::size_t host_resident_ = 0;      ///< Resident size of the whole emulator process.
+        std::vector<goom_process_memory_usage> processes_;
+    };
+
+    /**
+     * \brief Check if a request for free memory can be granted without going over the host memory budget.
+     *
+     * \param host_resident     Resident size of the emulator process, in bytes.
+     * \param host_budget       Resident size the emulator should stay under, in bytes. 0 means there is no budget.
+     * \param bytes_requested   Amount of free memory the application asks for.
+     */
+    bool goom_host_memory_fits(const std::size_t host_resident, const std::size_t host_budget, const std::size_t bytes_requested);
+
     class goom_monitor_server : public service::typical_server {
     public:
         explicit goom_monitor_server(eka2l1::system *sys);
 
         void connect(service::ipc_context &context) override;
+
+        /**
+         * \brief Collect the memory usage of every guest process, from the chunks they own.
+         *
+         * Processes are sorted by resident size, largest first.
+         */
+        goom_memory_report collect_memory_report();
+
+        /**
+         * \brief Get the host resident size free memory requests must stay under, in bytes. 0 means there is no budget.
+         */
+        std::size_t host_memory_budget();
     };
 
     struct goom_monitor_session : public service::typical_session {
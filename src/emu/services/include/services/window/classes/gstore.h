@@ -27,11 +27,16 @@
 
 #include <cstdint>
 #include <memory>
+#include <vector>
 
 namespace eka2l1::drivers {
     class graphics_driver;
 }
 
+namespace eka2l1 {
+    struct fbsfont;
+}
+
 namespace eka2l1::epoc {
     class bitmap_cache;
     struct window;
@@ -210,10 +215,16 @@ namespace eka2l1::epoc {
         eka2l1::vec2 position_;
         common::region clip_;
         drivers::filter_option texture_filter_;
+        std::vector<fbsfont *> *text_fonts_;
 
     public:
+        /**
+         * \param text_fonts       Fonts used to draw text are added here, with a reference held on each. Once the
+         *                         builder is submitted, they must be given to mark_text_fonts_submitted.
+         */
         explicit gdi_command_builder(drivers::graphics_driver *drv, drivers::graphics_command_builder &builder, bitmap_cache &bcache,
-            drivers::filter_option texture_filter, const eka2l1::vec2 &position, float scale_factor, const common::region &clip);
+            drivers::filter_option texture_filter, const eka2l1::vec2 &position, float scale_factor, const common::region &clip,
+            std::vector<fbsfont *> &text_fonts);
 
         void set_position(const eka2l1::vec2 &pos) {
             position_ = pos;
@@ -240,4 +251,10 @@ namespace eka2l1::epoc {
         void build_command_disable_clip();
         void build_command_update_texture(const gdi_store_command_update_texture_data &cmd);
     };
+
+    /**
+     * \brief Tell the atlases of fonts collected by a gdi_command_builder that its draws have been submitted,
+     *        then drop the references held on the fonts.
+     */
+    void mark_text_fonts_submitted(std::vector<fbsfont *> &text_fonts);
 }
\ No newline at end of file
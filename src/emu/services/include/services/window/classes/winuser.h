@@ -26,6 +26,7 @@
 
 #include <common/linked.h>
 #include <common/region.h>
+#include <drivers/graphics/readback.h>
 
 #include <functional>
 #include <memory>
@@ -228,7 +229,11 @@ namespace eka2l1::epoc {
 
         fbsbitmap *bitmap_;
 
+        drivers::bitmap_readback_pipeline readback_;
+        bool async_readback_;
+
         void create_backed_bitmap();
+        void sync_to_bitmap();
 
         void on_activate() override;
         void handle_extent_changed(const eka2l1::vec2 &new_size, const eka2l1::vec2 &new_pos) override;
@@ -245,6 +250,14 @@ namespace eka2l1::epoc {
         bool scroll(eka2l1::rect clip_space, const eka2l1::vec2 offset, eka2l1::rect source_rect) override;
 
         void sync_from_bitmap(std::optional<common::region> region = std::nullopt);
+
+        /**
+         * \brief Let updates read the window content back to the bitmap without stalling on the driver.
+         *
+         * The bitmap then trails the window content by about a frame. This suits continuous renderers such as
+         * EGL surfaces. Disabling it waits for the pending reads, so the bitmap is up-to-date again.
+         */
+        void set_async_readback(const bool enable);
         bool draw(drivers::graphics_command_builder &builder) override;
 
         void add_draw_command(gdi_store_command &command) override;
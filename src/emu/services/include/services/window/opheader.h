@@ -27,6 +27,9 @@
 #include <common/uid.h>
 #include <common/vecx.h>
 
+#include <cstdint>
+#include <cstring>
+
 namespace eka2l1 {
     struct ws_cmd_header {
         uint16_t op;
@@ -40,6 +43,61 @@ namespace eka2l1 {
         void *data_ptr;
     };
 
+    /**
+     * \brief Walk through a window server command buffer without copying it.
+     *
+     * An object handle is only present when the command's opcode has bit 15 set. Otherwise, the command
+     * targets the same object as the previous one.
+     */
+    struct ws_cmd_walker {
+        std::uint8_t *beg_;
+        std::uint8_t *end_;
+
+        std::uint32_t last_handle_;
+
+        explicit ws_cmd_walker(std::uint8_t *beg, std::uint8_t *end, const std::uint32_t initial_handle = 0)
+            : beg_(beg)
+            , end_(end)
+            , last_handle_(initial_handle) {
+        }
+
+        /**
+         * \brief Decode the next command in the buffer.
+         *
+         * \param cmd      The command to fill. Its data pointer points into the walked buffer.
+         * \returns False if the buffer is exhausted, or the next command is truncated.
+         */
+        bool next(ws_cmd &cmd) {
+            if (beg_ + sizeof(ws_cmd_header) > end_) {
+                return false;
+            }
+
+            std::memcpy(&cmd.header, beg_, sizeof(ws_cmd_header));
+            std::uint8_t *data = beg_ + sizeof(ws_cmd_header);
+
+            if (cmd.header.op & 0x8000) {
+                if (data + sizeof(std::uint32_t) > end_) {
+                    return false;
+                }
+
+                cmd.header.op &= ~0x8000;
+                std::memcpy(&last_handle_, data, sizeof(std::uint32_t));
+
+                data += sizeof(std::uint32_t);
+            }
+
+            if (data + cmd.header.cmd_len > end_) {
+                return false;
+            }
+
+            cmd.obj_handle = last_handle_;
+            cmd.data_ptr = data;
+
+            beg_ = data + cmd.header.cmd_len;
+            return true;
+        }
+    };
+
     struct ws_cmd_screen_device_header {
         int num_screen;
         uint32_t screen_dvc_ptr;
@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2022 EKA2L1 Team.
+ *
+ * This file is part of EKA2L1 project.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace eka2l1::epoc {
+    static constexpr std::uint32_t WS_COMMAND_RECORD_MAGIC = 0x52435357; // WSCR
+    static constexpr std::uint32_t WS_COMMAND_RECORD_VERSION = 1;
+
+    struct ws_command_record {
+        std::uint64_t session_uid_;
+        std::uint32_t function_;
+        std::vector<std::uint8_t> buffer_;
+    };
+
+    /**
+     * \brief Append every command buffer sent to the window server to a file.
+     *
+     * The stream consists of a header (magic and version), followed by records of session UID (8 bytes),
+     * IPC function (4 bytes), buffer size (4 bytes) and the raw buffer, all in little-endian.
+     */
+    class ws_command_recorder {
+        std::ofstream stream_;
+        std::mutex lock_;
+
+    public:
+        explicit ws_command_recorder(const std::string &path);
+
+        bool is_open() const {
+            return stream_.is_open();
+        }
+
+        void record(const std::uint64_t session_uid, const std::uint32_t function, const std::uint8_t *buffer,
+            const std::uint32_t size);
+    };
+
+    /**
+     * \brief Read back a stream produced by ws_command_recorder.
+     */
+    class ws_command_playback {
+        std::ifstream stream_;
+        bool valid_;
+
+    public:
+        explicit ws_command_playback(const std::string &path);
+
+        bool is_valid() const {
+            return valid_;
+        }
+
+        /**
+         * \brief Read the next record from the stream.
+         * \returns False on end of stream, or if the record is truncated.
+         */
+        bool next(ws_command_record &record);
+    };
+}
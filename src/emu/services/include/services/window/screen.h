@@ -44,6 +44,8 @@ namespace eka2l1 {
 
     class window_server;
     class ntimer;
+
+    struct fbsfont;
 }
 
 namespace eka2l1::drivers {
@@ -114,6 +116,8 @@ namespace eka2l1::epoc {
 
         bool sync_screen_buffer = false;
 
+        std::vector<fbsfont *> pending_text_fonts; ///< Referenced fonts used by text draws of a redraw that is not submitted yet.
+
         enum {
             FLAG_NEED_RECALC_VISIBLE = 1 << 0,
             FLAG_ORIENTATION_LOCK = 1 << 1,
@@ -227,6 +231,11 @@ namespace eka2l1::epoc {
          */
         void redraw(drivers::graphics_driver *driver);
 
+        /**
+         * \brief Let fonts used by the last redraw know that its command list has been submitted, and release them.
+         */
+        void mark_text_draws_submitted();
+
         /**
          * \brief Update the window group focus.
          */
@@ -43,6 +43,7 @@
 #include <services/window/fifo.h>
 #include <services/window/io.h>
 #include <services/window/opheader.h>
+#include <services/window/recorder.h>
 #include <services/window/scheduler.h>
 #include <services/window/screen.h>
 
@@ -247,7 +248,7 @@ namespace eka2l1::epoc {
         void get_ready(service::ipc_context &ctx, ws_cmd *cmd, const event_listener_type type);
 
         void execute_command(service::ipc_context &ctx, ws_cmd cmd);
-        void execute_commands(service::ipc_context &ctx, std::vector<ws_cmd> cmds);
+        void execute_commands(service::ipc_context &ctx, std::uint8_t *beg, std::uint8_t *end);
         void parse_command_buffer(service::ipc_context &ctx);
 
         std::uint32_t add_object(window_client_obj_ptr &obj);
@@ -390,6 +391,8 @@ namespace eka2l1 {
 
         std::uint32_t config_flags;
 
+        std::unique_ptr<epoc::ws_command_recorder> cmd_recorder_;
+
         void init(service::ipc_context &ctx);
         void send_to_command_buffer(service::ipc_context &ctx);
 
@@ -428,6 +431,10 @@ namespace eka2l1 {
             return &anim_sched;
         }
 
+        epoc::ws_command_recorder *get_command_recorder() {
+            return cmd_recorder_.get();
+        }
+
         epoc::pointer_cursor_mode &cursor_mode() {
             return cursor_mode_;
         }
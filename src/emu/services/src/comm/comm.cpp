@@ -37,9 +37,7 @@ namespace eka2l1 {
     comm_server::comm_server(eka2l1::system *sys)
         : service::typical_server(sys, get_comm_server_name_by_epocver(sys->get_symbian_version_use()))
         , c32start_prop_(nullptr) {
-        c32start_prop_ = kern->create<service::property>();
-        c32start_prop_->first = C32START_FIRST_UID;
-        c32start_prop_->second = 1;
+        c32start_prop_ = kern->create_prop(C32START_FIRST_UID, 1);
 
         // On S60v2 it will keep spin loop until this value reach larger then 9. Not sure what it is...
         c32start_prop_->define(service::property_type::int_data, 4);
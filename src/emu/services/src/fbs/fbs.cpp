@@ -29,6 +29,7 @@
 #include <services/fbs/fbs.h>
 #include <services/fs/std.h>
 
+#include <common/algorithm.h>
 #include <common/cvt.h>
 #include <common/log.h>
 #include <common/thread.h>
@@ -311,6 +312,7 @@ namespace eka2l1 {
         , large_chunk(nullptr)
         , fntstr_seg(nullptr)
         , bmp_font_vtab(0)
+        , bitmap_file_cache(common::MB(16))
         , session_cache_list(nullptr) {
     }
 
@@ -21,11 +21,149 @@
 #include <common/algorithm.h>
 #include <common/time.h>
 
+#include <algorithm>
+
 namespace eka2l1::epoc {
+    // Space left between glyphs, so that sampling never bleeds into the neighbour
+    static constexpr int ATLAS_GLYPH_PADDING = 1;
+
+    // Shelf heights are rounded up to this, so that glyphs of close heights can share one
+    static constexpr int ATLAS_SHELF_HEIGHT_ALIGN = 4;
+
+    atlas_shelf_packer::atlas_shelf_packer(const eka2l1::vec2 size) {
+        reset(size);
+    }
+
+    void atlas_shelf_packer::reset(const eka2l1::vec2 size) {
+        size_ = size;
+        next_shelf_y_ = 0;
+
+        shelves_.clear();
+    }
+
+    std::optional<eka2l1::vec2> atlas_shelf_packer::allocate_in_shelf(const std::size_t shelf_index, const int width) {
+        shelf &target = shelves_[shelf_index];
+
+        for (std::size_t i = 0; i < target.free_spans_.size(); i++) {
+            eka2l1::vec2 &span = target.free_spans_[i];
+
+            if (span.y >= width) {
+                const eka2l1::vec2 pos(span.x, target.y_);
+
+                span.x += width;
+                span.y -= width;
+
+                if (span.y == 0) {
+                    target.free_spans_.erase(target.free_spans_.begin() + i);
+                }
+
+                return pos;
+            }
+        }
+
+        return std::nullopt;
+    }
+
+    std::optional<eka2l1::vec2> atlas_shelf_packer::allocate(const eka2l1::vec2 size, std::size_t &shelf_index) {
+        if ((size.x <= 0) || (size.y <= 0) || (size.x > size_.x) || (size.y > size_.y)) {
+            return std::nullopt;
+        }
+
+        // Prefer the shortest shelf that has space, and is not more than twice as tall as the rectangle
+        std::size_t best_shelf = shelves_.size();
+
+        for (std::size_t i = 0; i < shelves_.size(); i++) {
+            const shelf &candidate = shelves_[i];
+
+            if ((candidate.height_ < size.y) || (candidate.height_ > size.y * 2)) {
+                continue;
+            }
+
+            if ((best_shelf != shelves_.size()) && (candidate.height_ >= shelves_[best_shelf].height_)) {
+                continue;
+            }
+
+            for (const eka2l1::vec2 &span : candidate.free_spans_) {
+                if (span.y >= size.x) {
+                    best_shelf = i;
+                    break;
+                }
+            }
+        }
+
+        if (best_shelf != shelves_.size()) {
+            shelf_index = best_shelf;
+            return allocate_in_shelf(best_shelf, size.x);
+        }
+
+        const int shelf_height = common::min(common::align(size.y, ATLAS_SHELF_HEIGHT_ALIGN), size_.y - next_shelf_y_);
+
+        if (shelf_height >= size.y) {
+            shelf new_shelf;
+            new_shelf.y_ = next_shelf_y_;
+            new_shelf.height_ = shelf_height;
+            new_shelf.free_spans_.push_back(eka2l1::vec2(0, size_.x));
+
+            next_shelf_y_ += shelf_height;
+
+            shelves_.push_back(std::move(new_shelf));
+            shelf_index = shelves_.size() - 1;
+
+            return allocate_in_shelf(shelf_index, size.x);
+        }
+
+        // Out of space for new shelves, take any shelf that is tall enough
+        for (std::size_t i = 0; i < shelves_.size(); i++) {
+            if (shelves_[i].height_ >= size.y) {
+                std::optional<eka2l1::vec2> pos = allocate_in_shelf(i, size.x);
+
+                if (pos.has_value()) {
+                    shelf_index = i;
+                    return pos;
+                }
+            }
+        }
+
+        return std::nullopt;
+    }
+
+    void atlas_shelf_packer::free(const std::size_t shelf_index, const int x, const int width) {
+        if (shelf_index >= shelves_.size()) {
+            return;
+        }
+
+        std::vector<eka2l1::vec2> &spans = shelves_[shelf_index].free_spans_;
+        auto ite = std::lower_bound(spans.begin(), spans.end(), x, [](const eka2l1::vec2 &span, const int x) {
+            return span.x < x;
+        });
+
+        ite = spans.insert(ite, eka2l1::vec2(x, width));
+
+        // Merge with the next span, then the previous one
+        if (((ite + 1) != spans.end()) && (ite->x + ite->y == (ite + 1)->x)) {
+            ite->y += (ite + 1)->y;
+            spans.erase(ite + 1);
+        }
+
+        if ((ite != spans.begin()) && ((ite - 1)->x + (ite - 1)->y == ite->x)) {
+            (ite - 1)->y += ite->y;
+            spans.erase(ite);
+        }
+
+        // Drop empty shelves on the top, so their space can be used for different heights
+        while (!shelves_.empty() && (shelves_.back().free_spans_.size() == 1) && (shelves_.back().free_spans_[0].y == size_.x)) {
+            next_shelf_y_ = shelves_.back().y_;
+            shelves_.pop_back();
+        }
+    }
+
     font_atlas::font_atlas()
         : atlas_handle_(0)
-        , atlas_data_(nullptr)
-        , pack_handle_(0) {
+        , adapter_(nullptr)
+        , size_(0)
+        , typeface_idx_(0)
+        , draw_serial_(0)
+        , submitted_serial_(0) {
     }
 
     font_atlas::font_atlas(adapter::font_file_adapter_base *adapter, const std::size_t typeface_idx, const char16_t initial_start,
@@ -35,8 +173,8 @@ namespace eka2l1::epoc {
         , size_(font_size)
         , initial_range_(initial_start, initial_char_count)
         , typeface_idx_(typeface_idx)
-        , atlas_data_(nullptr)
-        , pack_handle_(0) {
+        , draw_serial_(0)
+        , submitted_serial_(0) {
     }
 
     void font_atlas::init(adapter::font_file_adapter_base *adapter, const std::size_t typeface_idx, const char16_t initial_start,
@@ -46,9 +184,8 @@ namespace eka2l1::epoc {
         size_ = font_size;
         initial_range_ = { initial_start, initial_char_count };
         typeface_idx_ = typeface_idx;
-        pack_handle_ = 0;
-
-        atlas_data_.reset();
+        draw_serial_ = 0;
+        submitted_serial_ = 0;
     }
 
     void font_atlas::destroy(drivers::graphics_driver *driver) {
@@ -60,105 +197,159 @@ namespace eka2l1::epoc {
             driver->submit_command_list(retrieved);
 
             atlas_handle_ = 0;
-            atlas_data_.reset();
-        }
-
-        if (pack_handle_) {
-            adapter_->end_get_atlas(pack_handle_);
         }
 
         last_use_.clear();
         characters_.clear();
+        scratch_.clear();
+
+        packer_.reset({ 0, 0 });
     }
 
     int font_atlas::get_atlas_width() const {
         return common::align(ESTIMATE_MAX_CHAR_IN_ATLAS_WIDTH * size_, 1024);
     }
 
-    bool font_atlas::draw_text(const std::u16string &text, const eka2l1::rect &text_box, const epoc::text_alignment alignment, drivers::graphics_driver *driver, drivers::graphics_command_builder &builder, const eka2l1::vec2f scale_vector) {
-        const int width = get_atlas_width();
-        drivers::graphics_command_builder upload_builder;
-
-        if (!atlas_data_) {
-            atlas_data_ = std::make_unique<std::uint8_t[]>(width * width);
-            auto cinfos = std::make_unique<adapter::character_info[]>(initial_range_.second);
+    bool font_atlas::evict_least_used() {
+        if (last_use_.empty()) {
+            return false;
+        }
 
-            pack_handle_ = adapter_->begin_get_atlas(atlas_data_.get(), { width, width });
+        auto ite = characters_.find(last_use_.back());
 
-            if (pack_handle_ == -1) {
+        if (ite != characters_.end()) {
+            // Draws are moved to the front of the list in order, so if the last glyph is still used by
+            // a pending draw, every other one is too
+            if (ite->second.draw_serial_ > submitted_serial_) {
                 return false;
             }
 
-            if (!adapter_->get_glyph_atlas(pack_handle_, typeface_idx_, initial_range_.first, nullptr, initial_range_.second,
-                    size_, cinfos.get())) {
-                return false;
+            const adapter::character_info &info = ite->second.info_;
+
+            if (ite->second.has_slot_) {
+                packer_.free(ite->second.shelf_index_, info.x0, info.x1 - info.x0 + ATLAS_GLYPH_PADDING);
             }
 
-            // initialize the last used list and character map
-            for (char16_t i = 0; i < initial_range_.second; i++) {
-                last_use_.push_back(initial_range_.first + i);
-                characters_.emplace(initial_range_.first + i, cinfos[i]);
+            characters_.erase(ite);
+        }
+
+        last_use_.pop_back();
+        return true;
+    }
+
+    bool font_atlas::add_glyph(const char16_t code, drivers::graphics_command_builder &upload_builder) {
+        adapter::character_info info{};
+        int code_point = code;
+
+        // Rasterize the glyph alone, the adapter packs it somewhere in the scratch area. The size should fit
+        // any glyph even with oversampling, but try again with a bigger one just in case.
+        int scratch_width = size_ * 2 + 8;
+        bool rasterized = false;
+
+        for (int attempt = 0; (attempt < 2) && !rasterized; attempt++) {
+            if (attempt != 0) {
+                scratch_width *= 2;
             }
 
-            // Submit the bitmap through another queue, in case the command list above never got submitted
-            atlas_handle_ = drivers::create_bitmap(driver, { width, width }, 8);
+            scratch_.assign(scratch_width * scratch_width, 0);
+            const std::int32_t handle = adapter_->begin_get_atlas(scratch_.data(), { scratch_width, scratch_width });
 
-            upload_builder.update_bitmap(atlas_handle_, reinterpret_cast<const char *>(atlas_data_.get()),
-                width * width, { 0, 0 }, { width, width });
-            upload_builder.set_texture_filter(atlas_handle_, false, drivers::filter_option::nearest);
+            if (handle == -1) {
+                return false;
+            }
+
+            rasterized = adapter_->get_glyph_atlas(handle, typeface_idx_, 0, &code_point, 1, size_, &info);
+            adapter_->end_get_atlas(handle);
         }
 
-        std::vector<int> to_rast;
-        std::vector<char16_t> unique_char;
+        if (!rasterized) {
+            return false;
+        }
 
-        // Iterate through characters, and filter out characters which is not available in the atlas.
-        // Add character to last used, too.
-        for (auto &chr : text) {
-            if (characters_.find(chr) == characters_.end()) {
-                if (!std::binary_search(to_rast.begin(), to_rast.end(), chr)) {
-                    to_rast.push_back(chr);
-                    std::sort(to_rast.begin(), to_rast.end());
+        glyph_entry entry;
+        entry.has_slot_ = false;
+        entry.shelf_index_ = 0;
+        entry.draw_serial_ = draw_serial_;
+
+        const eka2l1::vec2 glyph_size(common::min<int>(info.x1, scratch_width) - info.x0, common::min<int>(info.y1, scratch_width) - info.y0);
+
+        if ((glyph_size.x > 0) && (glyph_size.y > 0)) {
+            std::optional<eka2l1::vec2> pos;
+
+            while (!(pos = packer_.allocate(glyph_size + eka2l1::vec2(ATLAS_GLYPH_PADDING, ATLAS_GLYPH_PADDING), entry.shelf_index_)).has_value()) {
+                if (!evict_least_used()) {
+                    // Everything left is needed by draws that have not run yet
+                    return false;
                 }
             }
 
-            if (std::find(unique_char.begin(), unique_char.end(), chr) == unique_char.end()) {
-                last_use_.insert(last_use_.begin(), chr);
-                unique_char.push_back(chr);
+            // Copy the glyph out of the scratch area, with rows aligned to 4 bytes for the upload
+            const int upload_stride = common::align(glyph_size.x, 4);
+            std::vector<std::uint8_t> upload_data(upload_stride * glyph_size.y);
+
+            for (int y = 0; y < glyph_size.y; y++) {
+                std::copy(scratch_.begin() + (info.y0 + y) * scratch_width + info.x0,
+                    scratch_.begin() + (info.y0 + y) * scratch_width + info.x0 + glyph_size.x,
+                    upload_data.begin() + y * upload_stride);
             }
+
+            upload_builder.update_bitmap(atlas_handle_, reinterpret_cast<const char *>(upload_data.data()), upload_data.size(),
+                pos.value(), glyph_size, upload_stride);
+
+            info.x0 = static_cast<std::uint16_t>(pos->x);
+            info.y0 = static_cast<std::uint16_t>(pos->y);
+            info.x1 = static_cast<std::uint16_t>(pos->x + glyph_size.x);
+            info.y1 = static_cast<std::uint16_t>(pos->y + glyph_size.y);
+
+            entry.has_slot_ = true;
         }
 
-        last_use_.erase(last_use_.end() - unique_char.size(), last_use_.end());
+        entry.info_ = info;
+
+        last_use_.push_front(code);
+        entry.last_use_pos_ = last_use_.begin();
+
+        characters_[code] = entry;
+        return true;
+    }
 
-        if (!to_rast.empty()) {
-            // Try to rasterize these
-            auto cinfos = std::make_unique<adapter::character_info[]>(to_rast.size());
+    bool font_atlas::draw_text(const std::u16string &text, const eka2l1::rect &text_box, const epoc::text_alignment alignment, drivers::graphics_driver *driver, drivers::graphics_command_builder &builder, const eka2l1::vec2f scale_vector) {
+        const int width = get_atlas_width();
+        drivers::graphics_command_builder upload_builder;
 
-            if (!adapter_->get_glyph_atlas(pack_handle_, typeface_idx_, 0, to_rast.data(), static_cast<char16_t>(to_rast.size()), size_,
-                    cinfos.get())) {
-                // Try to redo the atlas, getting latest use characters.
-                adapter_->end_get_atlas(pack_handle_);
-                pack_handle_ = adapter_->begin_get_atlas(atlas_data_.get(), { width, width });
+        if (!atlas_handle_) {
+            packer_.reset({ width, width });
 
-                if (pack_handle_ == -1) {
-                    return false;
-                }
+            // Submit the bitmap through another queue, in case the command list above never got submitted
+            atlas_handle_ = drivers::create_bitmap(driver, { width, width }, 8);
 
-                if (!adapter_->get_glyph_atlas(pack_handle_, typeface_idx_, 0, &last_use_[0], static_cast<char16_t>(characters_.size() - 5),
-                        size_, cinfos.get())) {
-                    return false;
-                }
+            // Clear it once, glyphs are uploaded one by one afterwards
+            std::vector<std::uint8_t> empty_data(width * width, 0);
 
-                for (std::size_t i = 0; i < characters_.size() - 5; i++) {
-                    characters_[last_use_[i]] = cinfos[i];
-                }
-            } else {
-                // Update the characters
-                for (char16_t i = 0; i < static_cast<char16_t>(to_rast.size()); i++) {
-                    characters_.emplace(to_rast[i], cinfos[i]);
-                }
+            upload_builder.update_bitmap(atlas_handle_, reinterpret_cast<const char *>(empty_data.data()),
+                empty_data.size(), { 0, 0 }, { width, width });
+            upload_builder.set_texture_filter(atlas_handle_, false, drivers::filter_option::nearest);
+
+            for (char16_t i = 0; i < initial_range_.second; i++) {
+                add_glyph(initial_range_.first + i, upload_builder);
+            }
+        }
+
+        draw_serial_++;
+
+        // Move characters of this text to the front of the last used list, and rasterize the missing ones.
+        // Those used by this text are never evicted while adding the others.
+        for (auto &chr : text) {
+            auto ite = characters_.find(chr);
+
+            if (ite == characters_.end()) {
+                add_glyph(chr, upload_builder);
+                continue;
+            }
 
-                upload_builder.update_bitmap(atlas_handle_, reinterpret_cast<const char *>(atlas_data_.get()),
-                    width * width, { 0, 0 }, { width, width });
+            if (ite->second.draw_serial_ != draw_serial_) {
+                last_use_.splice(last_use_.begin(), last_use_, ite->second.last_use_pos_);
+                ite->second.draw_serial_ = draw_serial_;
             }
         }
 
@@ -170,7 +361,11 @@ namespace eka2l1::epoc {
             float size_length = 0;
 
             for (auto &chr : text) {
-                size_length += static_cast<int>(characters_[chr].xadv * scale_vector[0]);
+                auto ite = characters_.find(chr);
+
+                if (ite != characters_.end()) {
+                    size_length += static_cast<int>(ite->second.info_.xadv * scale_vector[0]);
+                }
             }
 
             if (alignment == epoc::text_alignment::right) {
@@ -193,9 +388,14 @@ namespace eka2l1::epoc {
                 continue;
             }
 
-            eka2l1::rect source_rect;
-            adapter::character_info &info = characters_[chr];
+            auto ite = characters_.find(chr);
 
+            if (ite == characters_.end()) {
+                continue;
+            }
+
+            eka2l1::rect source_rect;
+            adapter::character_info &info = ite->second.info_;
             source_rect.top = { info.x0, info.y0 };
             source_rect.size = eka2l1::object_size(info.x1 - info.x0, info.y1 - info.y0);
 
@@ -416,7 +416,8 @@ namespace eka2l1 {
         return start;
     }
 
-    void *fbs_server::load_data_to_rom(loader::mbm_file &mbmf_, const std::size_t idx_, std::size_t &size_decomp, int *err_code) {
+    void *fbs_server::load_data_to_rom(loader::mbm_file &mbmf_, const std::size_t idx_, std::size_t &size_decomp, int *err_code,
+        const std::uint64_t modify_time, const std::u16string &path) {
         *err_code = fbs_load_data_err_none;
         size_decomp = 0;
 
@@ -429,7 +430,14 @@ namespace eka2l1 {
                                                mbmf_.sbm_headers[idx_].bit_per_pixels)
             * mbmf_.sbm_headers[idx_].size_pixels.y;
 
-        if (!mbmf_.read_single_bitmap(idx_, nullptr, size_when_compressed)) {
+        // Only compressed data is worth caching, uncompressed one is just a plain read
+        const bool use_cache = (modify_time != 0) && (mbmf_.sbm_headers[idx_].compression != 0);
+        const std::vector<std::uint8_t> *cached_data = use_cache ? bitmap_file_cache.get_payload(path, idx_, modify_time) : nullptr;
+
+        if (cached_data) {
+            size_when_compressed = cached_data->size();
+            size_decomp = size_when_compressed;
+        } else if (!mbmf_.read_single_bitmap(idx_, nullptr, size_when_compressed)) {
             *err_code = fbs_load_data_err_read_decomp_fail;
             return nullptr;
         } else {
@@ -454,6 +462,11 @@ namespace eka2l1 {
             return nullptr;
         }
 
+        if (cached_data) {
+            std::copy(cached_data->begin(), cached_data->end(), reinterpret_cast<std::uint8_t *>(data));
+            return data;
+        }
+
         // Yay, we manage to alloc memory to load the data in
         // So let's get to work
         bool result_read = mbmf_.read_single_bitmap(idx_, reinterpret_cast<std::uint8_t *>(data), avail_dest_size);
@@ -463,6 +476,11 @@ namespace eka2l1 {
             return nullptr;
         }
 
+        if (use_cache) {
+            bitmap_file_cache.add_payload(path, idx_, modify_time, reinterpret_cast<std::uint8_t *>(data),
+                common::min(avail_dest_size, size_when_compressed));
+        }
+
         return data;
     }
 
@@ -648,14 +666,31 @@ namespace eka2l1 {
                 stream_for_mbm_read->seek(0, common::seek_where::beg);
             }
 
-            loader::mbm_file mbmf_(stream_for_mbm_read);
-            mbmf_.index_to_loads.push_back(load_options->bitmap_id);
+            const std::u16string source_path = source->file_name();
+            const std::uint64_t source_modify_time = source->last_modify_since_0ad();
 
-            if (!mbmf_.do_read_headers()) {
-                ctx->complete(epoc::error_corrupt);
-                return;
+            // Headers of the whole file are indexed the first time it's seen. If some of them are broken,
+            // fallback to only read the one requested.
+            std::optional<loader::mbm_file> uncached_mbmf;
+            loader::mbm_file *mbmf = fbss->bitmap_file_cache.get_headers(source_path, source_modify_time, source->size(),
+                stream_for_mbm_read);
+
+            if (!mbmf) {
+                stream_for_mbm_read->seek(0, common::seek_where::beg);
+
+                uncached_mbmf.emplace(stream_for_mbm_read);
+                uncached_mbmf->index_to_loads.push_back(load_options->bitmap_id);
+
+                if (!uncached_mbmf->do_read_headers()) {
+                    ctx->complete(epoc::error_corrupt);
+                    return;
+                }
+
+                mbmf = &uncached_mbmf.value();
             }
 
+            loader::mbm_file &mbmf_ = *mbmf;
+
             // Let's do an insanity check. Is the bitmap index client given us is not valid ?
             if (!mbmf_.is_header_loaded(load_options->bitmap_id)) {
                 ctx->complete(epoc::error_not_found);
@@ -670,7 +705,8 @@ namespace eka2l1 {
             int err_code = fbs_load_data_err_none;
             std::size_t size_when_decomp = 0;
 
-            auto bmp_data = fbss->load_data_to_rom(mbmf_, load_options->bitmap_id, size_when_decomp, &err_code);
+            auto bmp_data = fbss->load_data_to_rom(mbmf_, load_options->bitmap_id, size_when_decomp, &err_code,
+                source_modify_time, source_path);
             std::uint8_t *bmp_data_base = fbss->get_large_chunk_base();
 
             switch (err_code) {
@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2019 EKA2L1 Team.
+ * 
+ * This file is part of EKA2L1 project.
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <services/fbs/mbm_cache.h>
+
+#include <common/algorithm.h>
+#include <common/buffer.h>
+#include <common/hash.h>
+
+namespace eka2l1::epoc {
+    std::size_t mbm_cache::payload_key_hash::operator()(const payload_key &key) const noexcept {
+        std::size_t seed = 0x151A5151;
+
+        common::hash_combine(seed, key.path_);
+        common::hash_combine(seed, key.index_);
+        common::hash_combine(seed, key.modify_time_);
+
+        return seed;
+    }
+
+    mbm_cache::mbm_cache(const std::size_t max_payload_size)
+        : payload_size_(0)
+        , max_payload_size_(max_payload_size) {
+    }
+
+    loader::mbm_file *mbm_cache::get_headers(const std::u16string &path, const std::uint64_t modify_time,
+        const std::uint64_t file_size, common::ro_stream *stream) {
+        const std::u16string path_lower = common::lowercase_ucs2_string(path);
+        auto ite = headers_.find(path_lower);
+
+        if (ite != headers_.end()) {
+            if ((ite->second.modify_time_ == modify_time) && (ite->second.file_size_ == file_size)) {
+                ite->second.file_->stream = stream;
+                return ite->second.file_.get();
+            }
+
+            headers_.erase(ite);
+        }
+
+        // Leave the index list empty so that all headers are read
+        auto file = std::make_unique<loader::mbm_file>(stream);
+
+        if (!file->do_read_headers()) {
+            return nullptr;
+        }
+
+        header_entry &entry = headers_[path_lower];
+
+        entry.modify_time_ = modify_time;
+        entry.file_size_ = file_size;
+        entry.file_ = std::move(file);
+
+        return entry.file_.get();
+    }
+
+    const std::vector<std::uint8_t> *mbm_cache::get_payload(const std::u16string &path, const std::size_t index,
+        const std::uint64_t modify_time) {
+        auto ite = payload_lookup_.find(payload_key{ common::lowercase_ucs2_string(path), index, modify_time });
+
+        if (ite == payload_lookup_.end()) {
+            return nullptr;
+        }
+
+        payloads_.splice(payloads_.begin(), payloads_, ite->second);
+        return &ite->second->data_;
+    }
+
+    void mbm_cache::add_payload(const std::u16string &path, const std::size_t index, const std::uint64_t modify_time,
+        const std::uint8_t *data, const std::size_t size) {
+        if (size > max_payload_size_) {
+            return;
+        }
+
+        payload_key key{ common::lowercase_ucs2_string(path), index, modify_time };
+        auto ite = payload_lookup_.find(key);
+
+        if (ite != payload_lookup_.end()) {
+            payload_size_ -= ite->second->data_.size();
+            payloads_.erase(ite->second);
+            payload_lookup_.erase(ite);
+        }
+
+        while (!payloads_.empty() && (payload_size_ + size > max_payload_size_)) {
+            payload_size_ -= payloads_.back().data_.size();
+            payload_lookup_.erase(payloads_.back().key_);
+            payloads_.pop_back();
+        }
+
+        payloads_.push_front(payload_entry{ key, std::vector<std::uint8_t>(data, data + size) });
+        payload_lookup_.emplace(std::move(key), payloads_.begin());
+
+        payload_size_ += size;
+    }
+
+    void mbm_cache::clear() {
+        headers_.clear();
+        payloads_.clear();
+        payload_lookup_.clear();
+
+        payload_size_ = 0;
+    }
+}
@@ -18,8 +18,11 @@
  */
 
 #include <common/log.h>
+#include <common/thread_pool.h>
 #include <config/config.h>
+#include <kernel/timing.h>
 #include <system/epoc.h>
+#include <utils/err.h>
 
 #include <services/framework.h>
 #include <services/utils.h>
@@ -60,10 +63,137 @@ namespace eka2l1::service {
         : server(sys->get_kernel_system(), sys, nullptr, name, true, false) {
     }
 
+    static common::thread_pool &get_host_work_pool() {
+        static common::thread_pool pool("HLE host worker");
+        return pool;
+    }
+
+    host_work_queue::host_work_queue(kernel_system *kern, ntimer *timing, const std::string &name)
+        : kern_(kern)
+        , timing_(timing)
+        , state_(std::make_shared<state>()) {
+        // The callback outlives neither the kernel nor the timer, but may outlive this queue
+        std::shared_ptr<state> shared_state = state_;
+
+        finish_evt_ = timing_->register_event(name + " host work", [kern, shared_state](std::uint64_t, int) {
+            kernel_lock guard(kern);
+            std::vector<finish_func> to_finish;
+
+            {
+                const std::lock_guard<std::mutex> state_guard(shared_state->lock_);
+
+                if (shared_state->stopped_ || shared_state->finished_.empty()) {
+                    return;
+                }
+
+                to_finish.swap(shared_state->finished_);
+                shared_state->completing_ = true;
+            }
+
+            for (finish_func &finish : to_finish) {
+                finish(false);
+            }
+
+            to_finish.clear();
+
+            const std::lock_guard<std::mutex> state_guard(shared_state->lock_);
+            shared_state->completing_ = false;
+            shared_state->idle_cond_.notify_all();
+        });
+    }
+
+    host_work_queue::~host_work_queue() {
+        stop();
+    }
+
+    void host_work_queue::queue(work_func work, finish_func finish) {
+        {
+            const std::lock_guard<std::mutex> guard(state_->lock_);
+
+            if (state_->stopped_) {
+                return;
+            }
+
+            state_->running_++;
+        }
+
+        std::shared_ptr<state> shared_state = state_;
+        ntimer *timing = timing_;
+        const int finish_evt = finish_evt_;
+
+        get_host_work_pool().enqueue([shared_state, timing, finish_evt, work = std::move(work), finish = std::move(finish)]() mutable {
+            work();
+
+            const std::lock_guard<std::mutex> guard(shared_state->lock_);
+
+            // Even when stopped, the finish function is handed back, so that stop() can cancel it
+            shared_state->finished_.push_back(std::move(finish));
+
+            if (!shared_state->stopped_) {
+                timing->schedule_event(0, finish_evt, 0);
+            }
+
+            shared_state->running_--;
+            shared_state->idle_cond_.notify_all();
+        });
+    }
+
+    void host_work_queue::stop() {
+        std::vector<finish_func> dropped;
+
+        {
+            std::unique_lock<std::mutex> ulock(state_->lock_);
+
+            if (!state_->stopped_) {
+                state_->stopped_ = true;
+                state_->idle_cond_.wait(ulock, [this]() { return (state_->running_ == 0) && !state_->completing_; });
+
+                dropped.swap(state_->finished_);
+            }
+        }
+
+        // Their requests would otherwise never complete, and the client would wait on them forever
+        for (finish_func &finish : dropped) {
+            finish(true);
+        }
+
+        dropped.clear();
+
+        if (finish_evt_ >= 0) {
+            while (timing_->unschedule_event(finish_evt_, 0)) {
+            }
+
+            timing_->remove_event(finish_evt_);
+            finish_evt_ = -1;
+        }
+    }
+
     typical_server::~typical_server() {
+        if (host_work_) {
+            host_work_->stop();
+        }
+
         sessions.clear();
     }
 
+    void typical_server::defer_host_work(service::ipc_context *ctx, host_work_queue::work_func work,
+        std::function<void(service::ipc_context &)> finish) {
+        if (!host_work_) {
+            host_work_ = std::make_unique<host_work_queue>(kern, kern->get_ntimer(), raw_name());
+        }
+
+        std::shared_ptr<ipc_context> deferred_ctx(ctx->move_to_new());
+
+        host_work_->queue(std::move(work), [deferred_ctx, finish = std::move(finish)](const bool cancelled) {
+            if (cancelled) {
+                deferred_ctx->complete(epoc::error_cancel);
+                return;
+            }
+
+            finish(*deferred_ctx);
+        });
+    }
+
     void typical_server::disconnect_impl(service::session *ss) {
         if (!ss) {
             return;
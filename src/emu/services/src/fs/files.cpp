@@ -35,6 +35,9 @@
 #include <services/fs/sec.h>
 
 namespace eka2l1 {
+    // Reads at least this big are done on a host worker, so that the guest keeps running meanwhile
+    static constexpr std::uint32_t FS_HOST_WORKER_READ_MIN_SIZE = 0x10000;
+
     bool file_attrib::claim_exclusive(const kernel::uid pr_uid) {
         if (owner == pr_uid) {
             flags |= static_cast<std::uint32_t>(fs_file_attrib_flag::exclusive);
@@ -72,7 +75,26 @@ namespace eka2l1 {
         }
     }
 
+    void fs_node::begin_host_io() {
+        const std::lock_guard<std::mutex> guard(host_io_lock);
+        host_io_pending = true;
+    }
+
+    void fs_node::end_host_io() {
+        const std::lock_guard<std::mutex> guard(host_io_lock);
+        host_io_pending = false;
+
+        host_io_cond.notify_all();
+    }
+
+    void fs_node::wait_host_io() {
+        std::unique_lock<std::mutex> ulock(host_io_lock);
+        host_io_cond.wait(ulock, [this]() { return !host_io_pending; });
+    }
+
     fs_node::~fs_node() {
+        wait_host_io();
+
         if (temporary) {
             io_system *io = serv->get_system()->get_io_system();
 
@@ -425,13 +447,17 @@ namespace eka2l1 {
             return;
         }
 
-        bool res = ctx->sys->get_io_system()->rename(vfs_file->file_name(), new_path_abs);
+        const std::u16string old_path_abs = vfs_file->file_name();
+        bool res = ctx->sys->get_io_system()->rename(old_path_abs, new_path_abs);
 
         if (!res) {
             ctx->complete(epoc::error_general);
             return;
         }
 
+        server<fs_server>()->entry_changed(old_path_abs);
+        server<fs_server>()->entry_changed(new_path_abs);
+
         // Save state of file and reopening it
         size_t last_pos = vfs_file->tell();
         int last_mode = vfs_file->file_mode();
@@ -547,19 +573,45 @@ namespace eka2l1 {
             }
         }
 
-        vfs_file->seek(read_pos, file_seek_mode::beg);
-
-        uint64_t size = vfs_file->size();
+        const std::uint64_t size = vfs_file->size();
 
-        if (size - read_pos < read_len) {
+        if (read_pos >= size) {
+            read_len = 0;
+        } else if (size - read_pos < static_cast<std::uint64_t>(read_len)) {
             read_len = static_cast<int>(size - read_pos);
         }
 
-        std::vector<char> read_data;
-        read_data.resize(read_len);
+        if (static_cast<std::uint32_t>(read_len) >= FS_HOST_WORKER_READ_MIN_SIZE) {
+            std::shared_ptr<std::vector<std::uint8_t>> read_data = std::make_shared<std::vector<std::uint8_t>>(read_len);
+            node->begin_host_io();
 
-        size_t read_finish_len = vfs_file->read_file(read_data.data(), 1, read_len);
-        ctx->write_data_to_descriptor_argument(0, reinterpret_cast<uint8_t *>(read_data.data()), static_cast<std::uint32_t>(read_finish_len));
+            server<fs_server>()->defer_host_work(ctx, [node, vfs_file, read_pos, read_data]() {
+                const std::size_t read_finish_len = vfs_file->read_file_at(read_pos, read_data->data(), static_cast<std::uint32_t>(read_data->size()));
+                read_data->resize(read_finish_len);
+
+                node->end_host_io();
+            }, [read_data](service::ipc_context &deferred_ctx) {
+                deferred_ctx.write_data_to_descriptor_argument(0, read_data->data(), static_cast<std::uint32_t>(read_data->size()));
+                deferred_ctx.complete(epoc::error_none);
+            });
+
+            return;
+        }
+
+        const bool is_des16 = (static_cast<int>(ctx->msg->args.get_arg_type(0)) & static_cast<int>(ipc_arg_type::flag_16b));
+        std::uint8_t *dest_ptr = is_des16 ? nullptr : ctx->get_descriptor_argument_ptr(0);
+
+        if (dest_ptr && (static_cast<std::size_t>(read_len) <= ctx->get_argument_max_data_size(0))) {
+            // Read straight into the client's descriptor
+            const std::size_t read_finish_len = vfs_file->read_file_at(read_pos, dest_ptr, static_cast<std::uint32_t>(read_len));
+            ctx->set_descriptor_argument_length(0, static_cast<std::uint32_t>(read_finish_len));
+        } else {
+            std::vector<char> read_data;
+            read_data.resize(read_len);
+
+            const std::size_t read_finish_len = vfs_file->read_file_at(read_pos, read_data.data(), static_cast<std::uint32_t>(read_len));
+            ctx->write_data_to_descriptor_argument(0, reinterpret_cast<uint8_t *>(read_data.data()), static_cast<std::uint32_t>(read_finish_len));
+        }
 
         //LOG_TRACE(SERVICE_EFSRV, "Readed {} from {} to address 0x{:x}", read_finish_len, read_pos, ctx->msg->args.args[0]);
         ctx->complete(epoc::error_none);
@@ -620,6 +672,7 @@ namespace eka2l1 {
         full_path = temp_file->file_name();
 
         temp_file->close();
+        server<fs_server>()->entry_changed(full_path);
 
         LOG_INFO(SERVICE_EFSRV, "Opening temp file: {}", common::ucs2_to_utf8(full_path));
         int handle = new_node(ctx->sys->get_io_system(), ctx->msg->own_thr, full_path,
@@ -858,6 +911,10 @@ namespace eka2l1 {
 
         LOG_TRACE(SERVICE_EFSRV, "Handle opened: {}", handle);
 
+        if (!is_it_avail) {
+            server<fs_server>()->entry_changed(*name_res);
+        }
+
         ctx->write_data_to_descriptor_argument<int>(3, handle);
         ctx->complete(epoc::error_none);
     }
@@ -37,6 +37,7 @@
 #include <common/wildcard.h>
 
 #include <kernel/kernel.h>
+#include <kernel/libmanager.h>
 #include <system/epoc.h>
 #include <vfs/vfs.h>
 
@@ -169,12 +170,10 @@ namespace eka2l1 {
         // Create property references to system drive
         // TODO (pent0): Not hardcode the drive. Maybe dangerous, who knows.
         default_sys_path = u"C:\\";
-        system_drive_prop = &(*sys->get_kernel_system()->create<service::property>());
+        system_drive_prop = sys->get_kernel_system()->create_prop(static_cast<int>(FS_UID), static_cast<int>(SYSTEM_DRIVE_KEY));
         system_drive_prop->define(service::property_type::int_data, 0);
         system_drive_prop->set_int(drive_c);
 
-        system_drive_prop->first = static_cast<int>(FS_UID);
-        system_drive_prop->second = static_cast<int>(SYSTEM_DRIVE_KEY);
     }
 
     fs_server::~fs_server() {
@@ -360,6 +359,9 @@ namespace eka2l1 {
             return;
         }
 
+        server<fs_server>()->entry_changed(target);
+        server<fs_server>()->entry_changed(dest);
+
         // A new app list may be created
         ctx->complete(epoc::error_none);
     }
@@ -401,6 +403,9 @@ namespace eka2l1 {
             return;
         }
 
+        server<fs_server>()->entry_changed(target);
+        server<fs_server>()->entry_changed(dest);
+
         // A new app list may be created
         ctx->complete(epoc::error_none);
     }
@@ -428,9 +433,17 @@ namespace eka2l1 {
             return;
         }
 
+        server<fs_server>()->entry_changed(path);
         ctx->complete(epoc::error_none);
     }
 
+    void fs_server::entry_changed(const std::u16string &path) {
+        // Library lookups are served from cached directory listings
+        if (hle::lib_manager *mngr = sys->get_kernel_system()->get_lib_manager()) {
+            mngr->invalidate_dll_index(path);
+        }
+    }
+
     void fs_server::synchronize_driver(service::ipc_context *ctx) {
         ctx->complete(epoc::error_none);
     }
@@ -22,7 +22,25 @@
 #include <system/epoc.h>
 #include <utils/err.h>
 
+#include <kernel/chunk.h>
+#include <kernel/kernel.h>
+#include <kernel/process.h>
+
+#include <common/virtualmem.h>
+#include <config/config.h>
+
+#include <algorithm>
+#include <map>
+
 namespace eka2l1 {
+    bool goom_host_memory_fits(const std::size_t host_resident, const std::size_t host_budget, const std::size_t bytes_requested) {
+        if (host_budget == 0) {
+            return true;
+        }
+
+        return (host_resident <= host_budget) && (bytes_requested <= host_budget - host_resident);
+    }
+
     goom_monitor_server::goom_monitor_server(eka2l1::system *sys)
         : service::typical_server(sys, "GOomMonitorServer") {
     }
@@ -32,6 +50,43 @@ namespace eka2l1 {
         context.complete(epoc::error_none);
     }
 
+    goom_memory_report goom_monitor_server::collect_memory_report() {
+        goom_memory_report report;
+        report.host_resident_ = common::get_host_resident_size();
+
+        std::map<kernel::uid, goom_process_memory_usage> usages;
+
+        for (auto &obj : kern->get_chunk_list()) {
+            kernel::chunk *target_chunk = reinterpret_cast<kernel::chunk *>(obj.get());
+            kernel::process *owner = target_chunk ? target_chunk->get_own_process() : nullptr;
+
+            if (!owner) {
+                continue;
+            }
+
+            goom_process_memory_usage &usage = usages[owner->unique_id()];
+
+            usage.process_id_ = owner->unique_id();
+            usage.process_name_ = owner->name();
+            usage.committed_ += target_chunk->committed();
+            usage.resident_ += target_chunk->resident();
+        }
+
+        for (auto &[id, usage] : usages) {
+            report.processes_.push_back(std::move(usage));
+        }
+
+        std::sort(report.processes_.begin(), report.processes_.end(), [](const goom_process_memory_usage &lhs, const goom_process_memory_usage &rhs) {
+            return lhs.resident_ > rhs.resident_;
+        });
+
+        return report;
+    }
+
+    std::size_t goom_monitor_server::host_memory_budget() {
+        return static_cast<std::size_t>(sys->get_config()->goom_host_memory_budget_mb) * 1024 * 1024;
+    }
+
     goom_monitor_session::goom_monitor_session(service::typical_server *serv, const kernel::uid ss_id,
         epoc::version client_version)
         : service::typical_session(serv, ss_id, client_version) {
@@ -41,6 +96,25 @@ namespace eka2l1 {
         std::optional<std::uint32_t> bytes_requested = ctx->get_argument_value<std::uint32_t>(0);
         if (bytes_requested.has_value()) {
             LOG_TRACE(SERVICE_GOOMMONITOR, "Application requested to have {}B of free memory!", bytes_requested.value());
+
+            goom_monitor_server *serv = server<goom_monitor_server>();
+            goom_memory_report report = serv->collect_memory_report();
+            LOG_TRACE(SERVICE_GOOMMONITOR, "Host resident size: {}KB", report.host_resident_ / 1024);
+
+            for (const auto &usage : report.processes_) {
+                LOG_TRACE(SERVICE_GOOMMONITOR, "- {}: committed {}KB, resident {}KB", usage.process_name_, usage.committed_ / 1024,
+                    usage.resident_ / 1024);
+            }
+
+            const std::size_t host_budget = serv->host_memory_budget();
+
+            if (!goom_host_memory_fits(report.host_resident_, host_budget, bytes_requested.value())) {
+                LOG_WARN(SERVICE_GOOMMONITOR, "Not enough host memory to free {}B (resident {}KB, budget {}KB)", bytes_requested.value(),
+                    report.host_resident_ / 1024, host_budget / 1024);
+
+                ctx->complete(epoc::error_no_memory);
+                return;
+            }
         }
 
         ctx->complete(epoc::error_none);
@@ -49,14 +123,14 @@ namespace eka2l1 {
     void goom_monitor_session::fetch(service::ipc_context *ctx) {
         switch (ctx->msg->function) {
         case goom_monitor_request_free_memory:
+            // Completes with its own status
             request_free_memory(ctx);
             break;
 
         default:
             LOG_ERROR(SERVICE_GOOMMONITOR, "Unimplemented opcode for Global OOM Monitor server 0x{:X}", ctx->msg->function);
+            ctx->complete(epoc::error_none);
             break;
         }
-
-        ctx->complete(epoc::error_none);
     }
 }
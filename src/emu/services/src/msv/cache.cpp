@@ -19,6 +19,8 @@
 
 #include <services/msv/cache.h>
 
+#include <algorithm>
+
 namespace eka2l1::epoc::msv {
     entry_range_table::entry_range_table()
         : min_(0)
@@ -26,19 +28,22 @@ namespace eka2l1::epoc::msv {
         , flags_(0) {
     }
 
+    static bool entry_id_less(const entry &lhs, const entry &rhs) {
+        return lhs.id_ < rhs.id_;
+    }
+
     entry *entry_range_table::add(entry &ent, const bool extend_range) {
-        if (get(ent.id_)) {
+        if (!extend_range && ((ent.id_ < min_) || (ent.id_ > max_))) {
             return nullptr;
         }
 
-        if (!extend_range && ((ent.id_ < min_) || (ent.id_ > max_))) {
+        auto ite = std::lower_bound(entries_.begin(), entries_.end(), ent, entry_id_less);
+
+        if ((ite != entries_.end()) && (ite->id_ == ent.id_)) {
             return nullptr;
         }
 
-        entries_.push_back(ent);
-        std::sort(entries_.begin(), entries_.end(), [](const entry &lhs, const entry &rhs) {
-            return lhs.id_ < rhs.id_;
-        });
+        ite = entries_.insert(ite, ent);
 
         if (ent.id_ < min_) {
             min_ = ent.id_;
@@ -48,10 +53,6 @@ namespace eka2l1::epoc::msv {
             max_ = ent.id_;
         }
 
-        auto ite = std::lower_bound(entries_.begin(), entries_.end(), ent, [](const entry &lhs, const entry &rhs) {
-            return lhs.id_ < rhs.id_;
-        });
-
         return &(*ite);
     }
 
@@ -79,28 +80,37 @@ namespace eka2l1::epoc::msv {
             return true;
         }
 
-        if ((ents.size() == 1) || (end_index - start_index == 0)) {
-            return add(ents[0], true);
+        if (end_index == start_index) {
+            return add(ents[start_index], true);
         }
 
-        bool no_need_look_too_much = entries_.empty();
+        auto ents_begin = ents.begin() + start_index;
+        auto ents_end = ents.begin() + end_index + 1;
+
+        if (entries_.empty() || (entries_.back().id_ < ents_begin->id_)) {
+            // Fast path: all the new entries come after ours, which is the case when a folder is loaded.
+            entries_.insert(entries_.end(), ents_begin, ents_end);
+        } else {
+            // Merge both sorted lists in one pass. Entries that already exist are kept.
+            std::vector<entry> merged;
+            merged.reserve(entries_.size() + (end_index - start_index + 1));
+
+            auto ours = entries_.begin();
 
-        if (!no_need_look_too_much) {
-            for (std::size_t i = start_index; i <= end_index; i++) {
-                if (!std::binary_search(entries_.begin(), entries_.end(), ents[i], [](const entry &lhs, const entry &rhs) {
-                    return lhs.id_ < rhs.id_;
-                })) {
-                    // Continue with our lifes
-                    entries_.push_back(ents[i]);
+            while ((ours != entries_.end()) || (ents_begin != ents_end)) {
+                if ((ents_begin == ents_end) || ((ours != entries_.end()) && (ours->id_ <= ents_begin->id_))) {
+                    if ((ents_begin != ents_end) && (ours->id_ == ents_begin->id_)) {
+                        ents_begin++;
+                    }
+
+                    merged.push_back(std::move(*ours++));
+                } else {
+                    merged.push_back(*ents_begin++);
                 }
             }
-        } else {
-            entries_.insert(entries_.begin(), ents.begin() + start_index, ents.begin() + end_index + 1);
+
+            entries_ = std::move(merged);
         }
-        
-        std::sort(entries_.begin(), entries_.end(), [](const entry &lhs, const entry &rhs) {
-            return lhs.id_ < rhs.id_;
-        });
 
         min_ = entries_.front().id_;
         max_ = entries_.back().id_;
@@ -312,19 +322,26 @@ namespace eka2l1::epoc::msv {
         auto make_tables_and_add = [&](const std::size_t starting_index, const std::size_t size) {
             for (std::size_t i = 0; i < (size + CACHE_THRESHOLD - 1) / CACHE_THRESHOLD; i++) {    
                 entry_range_table *table = new entry_range_table;
-                table->add_tons(entries, starting_index + i * CACHE_THRESHOLD, common::min<std::size_t>(entries.size() - 1, starting_index + (i + 1) * CACHE_THRESHOLD - 1));
+                const std::size_t table_start = starting_index + i * CACHE_THRESHOLD;
+                const std::size_t table_end = common::min<std::size_t>(entries.size() - 1, table_start + CACHE_THRESHOLD - 1);
 
-                if (entries[i * CACHE_THRESHOLD].parent_id_ != myid_) {
-                    table->grand_child_present(true);
+                table->add_tons(entries, table_start, table_end);
+
+                for (std::size_t j = table_start; j <= table_end; j++) {
+                    if (entries[j].parent_id_ != myid_) {
+                        table->grand_child_present(true);
+                        break;
+                    }
                 }
 
                 tables_.push(&table->folder_link_);
             }
         };
 
-        std::sort(entries.begin(), entries.end(), [](const entry &lhs, const entry &rhs) {
-            return lhs.id_ < rhs.id_;
-        });
+        // Entries loaded from the database already come in order
+        if (!std::is_sorted(entries.begin(), entries.end(), entry_id_less)) {
+            std::sort(entries.begin(), entries.end(), entry_id_less);
+        }
 
         if (tables_.empty()) {
             // Add some new tables
@@ -349,20 +366,20 @@ namespace eka2l1::epoc::msv {
 
             bool grand_child_incoming = false;
 
-            while (the_table && (entries[skipped].id_ < the_table->max_range())) {
-                skipped++;
-
+            while ((skipped < entries.size()) && (entries[skipped].id_ <= the_table->max_range())) {
                 if (entries[skipped].parent_id_ != myid_) {
                     grand_child_incoming = true;
                 }
+
+                skipped++;
             }
 
             if (grand_child_incoming) {
                 the_table->grand_child_present(true);
             }
 
-            if (skipped)
-                the_table->add_tons(entries, last_skip, skipped);
+            if (skipped > last_skip)
+                the_table->add_tons(entries, last_skip, skipped - 1);
 
             if (the_table->splitable()) {
                 the_table->do_split(myid_);
@@ -376,7 +393,14 @@ namespace eka2l1::epoc::msv {
                     const std::size_t to_take = common::min<std::size_t>(more_to, entries.size() - skipped);
 
                     if (to_take > 0) {
-                        the_table->add_tons(entries, skipped, to_take);
+                        for (std::size_t i = skipped; i < skipped + to_take; i++) {
+                            if (entries[i].parent_id_ != myid_) {
+                                the_table->grand_child_present(true);
+                                break;
+                            }
+                        }
+
+                        the_table->add_tons(entries, skipped, skipped + to_take - 1);
                         skipped += to_take;
                     }
 
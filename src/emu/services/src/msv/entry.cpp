@@ -548,6 +548,7 @@ namespace eka2l1::epoc::msv {
         , find_entry_stmt_(nullptr)
         , query_child_entries_stmt_(nullptr)
         , query_child_ids_stmt_(nullptr)
+        , query_folder_entries_stmt_(nullptr)
         , id_counter_(MSV_FIRST_FREE_ENTRY_ID - 1) {
         bool newly_created = false;
 
@@ -588,6 +589,10 @@ namespace eka2l1::epoc::msv {
             sqlite3_finalize(query_child_ids_stmt_);
         }
 
+        if (query_folder_entries_stmt_) {
+            sqlite3_finalize(query_folder_entries_stmt_);
+        }
+
         if (database_) {
             sqlite3_close(database_);
         }
@@ -652,6 +657,13 @@ namespace eka2l1::epoc::msv {
             LOG_WARN(SERVICE_MSV, "Fail to create index entry's parent indexing!");
         }
 
+        // Whole visible folders are loaded at once into the cache, index that too
+        const char *INDEX_ENTRY_CREATE_VISIBLE_PARENT_INDEX_STM = "CREATE INDEX IF NOT EXISTS IndexEntry_VisibleParentIndex ON IndexEntry(visibleParent);";
+
+        if (sqlite3_exec(database_, INDEX_ENTRY_CREATE_VISIBLE_PARENT_INDEX_STM, nullptr, nullptr, nullptr) != SQLITE_OK) {
+            LOG_WARN(SERVICE_MSV, "Fail to create index entry's visible parent indexing!");
+        }
+
         // Create version table
         const char *VERSION_TABLE_CREATE_STM = "CREATE TABLE IF NOT EXISTS VersionTable(version INTEGER PRIMARY KEY);";
 
@@ -1032,6 +1044,67 @@ namespace eka2l1::epoc::msv {
         return false;
     }
 
+    bool sql_entry_indexer::collect_visible_folder_entries(const msv_id visible_folder_id, std::vector<entry> &entries) {
+        if (!query_folder_entries_stmt_) {
+            static const char *QUERY_FOLDER_ENTRIES_STM_STR = "SELECT parentId, serviceId, mtmId, type, date, data, size, error, mtmData1,"
+                    "mtmData2, mtmData3, relatedId, bioType, pcSyncCount, reserved, visibleParent,"
+                    "description, details, id from IndexEntry WHERE visibleParent=:visibleParent AND id<>:visibleParent ORDER BY id";
+
+            if (sqlite3_prepare(database_, QUERY_FOLDER_ENTRIES_STM_STR, -1, &query_folder_entries_stmt_, nullptr) != SQLITE_OK) {
+                LOG_ERROR(SERVICE_MSV, "Can't prepare collect visible folder entries statement!");
+                return false;
+            }
+        }
+
+        sqlite3_reset(query_folder_entries_stmt_);
+        if (sqlite3_bind_int(query_folder_entries_stmt_, 1, visible_folder_id) != SQLITE_OK) {
+            LOG_ERROR(SERVICE_MSV, "Can't bind visible folder id to query folder entries statement!");
+            return false;
+        }
+
+        const std::size_t first_new = entries.size();
+
+        do {
+            int result = sqlite3_step(query_folder_entries_stmt_);
+            if (result == SQLITE_DONE) {
+                break;
+            }
+
+            if (result != SQLITE_ROW) {
+                LOG_ERROR(SERVICE_MSV, "Error {} while querying visible folder entries from SQL database", result);
+                return false;
+            }
+
+            entry an_entry;
+            fill_entry_information(an_entry, query_folder_entries_stmt_, true);
+
+            entries.push_back(std::move(an_entry));
+        } while (true);
+
+        // Every child of an entry that is not a visible folder lives in the same visible folder. So the children
+        // list of those entries can be built from this result, without querying each of them later.
+        auto new_begin = entries.begin() + first_new;
+
+        for (auto ite = new_begin; ite != entries.end(); ite++) {
+            if (!ite->visible_folder()) {
+                ite->children_looked_up(true);
+            }
+        }
+
+        for (auto ite = new_begin; ite != entries.end(); ite++) {
+            auto parent_ite = std::lower_bound(new_begin, entries.end(), ite->parent_id_, [](const entry &lhs, const msv_id rhs) {
+                return lhs.id_ < rhs;
+            });
+
+            if ((parent_ite != entries.end()) && (parent_ite->id_ == ite->parent_id_) && !parent_ite->visible_folder()) {
+                // Query is ordered by ID, so the children list stays sorted
+                parent_ite->children_ids_.push_back(ite->id_);
+            }
+        }
+
+        return true;
+    }
+
     std::vector<entry *> sql_entry_indexer::get_entries_by_parent(const std::uint32_t parent_id) {
         visible_folder_children_query_error error = visible_folder_children_query_ok;
         std::vector<entry*> entries;
@@ -1044,7 +1117,7 @@ namespace eka2l1::epoc::msv {
 
         auto gather_visible_folder_entries = [&](visible_folder *ff) -> bool {
             std::vector<entry> queries;
-            if (!collect_children_entries(visible_folder_id, queries)) {
+            if (!collect_visible_folder_entries(visible_folder_id, queries)) {
                 LOG_ERROR(SERVICE_MSV, "Unable to query visible folder children entries from database!");
                 return false;
             }
@@ -1088,7 +1161,9 @@ namespace eka2l1::epoc::msv {
                 entries = ff->get_children_by_parent(parent_id, &error);
                 if (error == visible_folder_children_incomplete) {
                     // Query all entries and then do transformation
-                    gather_visible_folder_entries(ff);
+                    if (gather_visible_folder_entries(ff)) {
+                        entries = ff->get_children_by_parent(parent_id, &error);
+                    }
                 }
 
                 if ((parent_id != visible_folder_id) && (error != visible_folder_children_query_ok)) {
@@ -1114,13 +1189,14 @@ namespace eka2l1::epoc::msv {
         visible_folder *new_folder = new visible_folder(visible_folder_id);
         gather_visible_folder_entries(new_folder);
 
-        if (parent_id != visible_folder_id) {
-            gather_target_parent_entries(new_folder);
-        }
-
         folders_.push(&new_folder->indexer_link_);
         entries = new_folder->get_children_by_parent(parent_id, &error);
 
+        if ((parent_id != visible_folder_id) && (error != visible_folder_children_query_ok)) {
+            gather_target_parent_entries(new_folder);
+            entries = new_folder->get_children_by_parent(parent_id, &error);
+        }
+
         if (error != visible_folder_children_query_ok) {
             LOG_ERROR(SERVICE_MSV, "An error occured that made it unable to retrieve children entries");
         }
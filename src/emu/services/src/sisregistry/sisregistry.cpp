@@ -666,34 +666,33 @@ namespace eka2l1 {
         }
 
         manager::packages *mngr = ctx->sys->get_packages();
+        package::object *obj = mngr->package_by_sid(package_sid.value());
 
-        for (auto &[uid, obj] : *mngr) {
-            if (std::find(obj.sids.begin(), obj.sids.end(), package_sid.value()) != obj.sids.end()) {
-                package::package target_pkg = static_cast<package::package &>(obj);
+        if (!obj) {
+            LOG_TRACE(SERVICE_SISREGISTRY, "SidToPackage for 0x{:X} can't be found", package_sid.value());
+            ctx->complete(epoc::error_not_found);
+            return;
+        }
 
-                common::chunkyseri seri(nullptr, 0, common::SERI_MODE_MEASURE);
-                target_pkg.do_state(seri);
+        package::package target_pkg = static_cast<package::package &>(*obj);
 
-                if (seri.size() > target_max_length) {
-                    std::uint32_t target_length = static_cast<std::uint32_t>(seri.size());
+        common::chunkyseri seri(nullptr, 0, common::SERI_MODE_MEASURE);
+        target_pkg.do_state(seri);
 
-                    ctx->write_data_to_descriptor_argument(1, target_length);
-                    ctx->complete(epoc::error_overflow);
-                    return;
-                }
+        if (seri.size() > target_max_length) {
+            std::uint32_t target_length = static_cast<std::uint32_t>(seri.size());
 
-                ctx->set_descriptor_argument_length(1, static_cast<std::uint32_t>(seri.size()));
+            ctx->write_data_to_descriptor_argument(1, target_length);
+            ctx->complete(epoc::error_overflow);
+            return;
+        }
 
-                seri = common::chunkyseri(target_buffer, target_max_length, common::SERI_MODE_WRITE);
-                target_pkg.do_state(seri);
+        ctx->set_descriptor_argument_length(1, static_cast<std::uint32_t>(seri.size()));
 
-                ctx->complete(epoc::error_none);
-                return;
-            }
-        }
+        seri = common::chunkyseri(target_buffer, target_max_length, common::SERI_MODE_WRITE);
+        target_pkg.do_state(seri);
 
-        LOG_TRACE(SERVICE_SISREGISTRY, "SidToPackage for 0x{:X} can't be found", package_sid.value());
-        ctx->complete(epoc::error_not_found);
+        ctx->complete(epoc::error_none);
     }
 
     void sisregistry_client_session::get_entry(eka2l1::service::ipc_context *ctx) {
@@ -39,16 +39,15 @@
 #include <algorithm>
 
 #include <common/buffer.h>
+#include <common/fileutils.h>
 #include <common/log.h>
+#include <common/path.h>
 #include <common/runlen.h>
 #include <common/time.h>
 
 #define XXH_INLINE_ALL
 #include <xxhash.h>
 
-// LunaSVG
-#include <lunasvg.h>
-
 namespace eka2l1::epoc {
     bitmap_cache::bitmap_cache(kernel_system *kern_)
         : fbss_(nullptr)
@@ -222,6 +221,80 @@ namespace eka2l1::epoc {
         return hash;
     }
 
+    static constexpr const char *ICON_RASTER_CACHE_FILENAME_FORMAT = "cache/icons/{:016X}.bin";
+    static constexpr std::uint32_t ICON_RASTER_CACHE_MAGIC = 0x4E524349; // ICRN
+
+    // Bump this when the rasterizer output changes, so that icons cached by older versions are redrawn
+    static constexpr std::uint32_t ICON_RASTER_CACHE_VERSION = 2;
+
+    struct icon_raster_cache_header {
+        std::uint32_t magic_;
+        std::uint32_t width_;
+        std::uint32_t height_;
+        std::uint32_t version_;
+    };
+
+    struct icon_raster_cache_key {
+        std::uint32_t version_;
+        std::uint32_t reserved_;
+        std::uint64_t source_hash_;
+        std::int32_t width_;
+        std::int32_t height_;
+        std::int32_t color_;
+        std::int32_t aspect_ratio_;
+    };
+
+    static std::uint64_t get_icon_raster_cache_key(const std::uint8_t *source, const std::size_t source_size, const eka2l1::object_size &size,
+        const utils::akn_icon_header *header) {
+        icon_raster_cache_key key;
+        key.version_ = ICON_RASTER_CACHE_VERSION;
+        key.reserved_ = 0;
+        key.source_hash_ = XXH64(source, source_size, 0);
+        key.width_ = size.x;
+        key.height_ = size.y;
+        key.color_ = header->icon_color_;
+        key.aspect_ratio_ = header->aspect_ratio_;
+
+        return XXH64(&key, sizeof(key), 0);
+    }
+
+    static bool load_cached_icon_raster(const std::uint64_t key, const eka2l1::object_size &size, char *dest) {
+        const std::string path = fmt::format(ICON_RASTER_CACHE_FILENAME_FORMAT, key);
+        const std::size_t pixmap_size = size.x * size.y * 4;
+
+        common::ro_std_file_stream stream(path, true);
+        if (!stream.valid() || (stream.size() != sizeof(icon_raster_cache_header) + pixmap_size)) {
+            return false;
+        }
+
+        icon_raster_cache_header header;
+        if (stream.read(&header, sizeof(header)) != sizeof(header)) {
+            return false;
+        }
+
+        if ((header.magic_ != ICON_RASTER_CACHE_MAGIC) || (header.version_ != ICON_RASTER_CACHE_VERSION) || (header.width_ != static_cast<std::uint32_t>(size.x)) || (header.height_ != static_cast<std::uint32_t>(size.y))) {
+            return false;
+        }
+
+        return stream.read(dest, pixmap_size) == pixmap_size;
+    }
+
+    static void save_cached_icon_raster(const std::uint64_t key, const eka2l1::object_size &size, const char *pixels) {
+        const std::string path = fmt::format(ICON_RASTER_CACHE_FILENAME_FORMAT, key);
+
+        icon_raster_cache_header header;
+        header.magic_ = ICON_RASTER_CACHE_MAGIC;
+        header.width_ = static_cast<std::uint32_t>(size.x);
+        header.height_ = static_cast<std::uint32_t>(size.y);
+        header.version_ = ICON_RASTER_CACHE_VERSION;
+
+        common::create_directories(eka2l1::file_directory(path));
+        common::wo_std_file_stream stream(path, true);
+
+        stream.write(&header, sizeof(header));
+        stream.write(pixels, size.x * size.y * 4);
+    }
+
     std::int64_t bitmap_cache::get_suitable_bitmap_index() {
         // First time, will scans through the bitmap array to find empty box
         // Sometimes, app might purges a lot of bitmaps at same time
@@ -335,40 +408,29 @@ namespace eka2l1::epoc {
                     std::fill(reinterpret_cast<std::uint32_t *>(data_pointer), reinterpret_cast<std::uint32_t *>(data_pointer + pixmap_size),
                         ((header_icon->icon_color_ & 0xFFFFFF) << 8) | 0xFF);
                 } else {
-                    common::ro_buf_stream nvg_in_stream(reinterpret_cast<std::uint8_t *>(data_pointer), compressed_size);
-                    common::wo_growable_buf_stream svg_out_stream;
+                    std::uint8_t *nvg_data = reinterpret_cast<std::uint8_t *>(data_pointer);
+                    const std::size_t nvg_size = (compressed_size > header_icon->header_size_) ? (compressed_size - header_icon->header_size_) : 0;
 
-                    std::vector<loader::nvg_convert_error_description> errors;
+                    data_pointer = new char[pixmap_size];
 
-                    loader::nvg_options cvt_options;
-                    cvt_options.width = bmp->header_.size_pixels.x;
-                    cvt_options.height = bmp->header_.size_pixels.y;
-                    cvt_options.aspect_ratio_mode_ = static_cast<loader::nvg_aspect_ratio_mode>(header_icon->aspect_ratio_);
+                    // Rendered icons are kept on disk, most of them are the same from boot to boot
+                    const std::uint64_t raster_key = get_icon_raster_cache_key(nvg_data, nvg_size, bmp->header_.size_pixels, header_icon);
 
-                    if (!loader::convert_nvg_to_svg(nvg_in_stream, svg_out_stream, errors, &cvt_options)) {
-                        data_pointer = new char[pixmap_size];
+                    if (!load_cached_icon_raster(raster_key, bmp->header_.size_pixels, data_pointer)) {
                         std::memset(data_pointer, 0, pixmap_size);
 
-                        LOG_ERROR(SERVICE_WINDOW, "Failed to convert NVG bitmap to SVG for rendering!");
-                    } else {
-                        data_pointer = new char[pixmap_size];
+                        common::ro_buf_stream nvg_in_stream(nvg_data, nvg_size);
+                        std::vector<loader::nvg_convert_error_description> errors;
 
-                        // Render in-memory using lunasvg
-                        // Hope the performance is good! The icon/bitmap seems very small
-                        std::memset(data_pointer, 0, pixmap_size);
+                        loader::nvg_options raster_options;
+                        raster_options.aspect_ratio_mode_ = static_cast<loader::nvg_aspect_ratio_mode>(header_icon->aspect_ratio_);
 
-                        const std::string svg_out_content = svg_out_stream.content();
-                        //LOG_DEBUG(SERVICE_WINDOW, "{}", svg_out_content);
-
-                        auto nvg_doc = lunasvg::Document::loadFromData(svg_out_content);
-                        if (!nvg_doc) {
-                            LOG_ERROR(SERVICE_WINDOW, "Error loading SVG in-memory, SVG content: {}", svg_out_content);
+                        if (!loader::rasterize_nvg(nvg_in_stream, reinterpret_cast<std::uint8_t *>(data_pointer), bmp->header_.size_pixels.x,
+                                bmp->header_.size_pixels.y, bmp->header_.size_pixels.x * 4, errors, &raster_options)) {
+                            std::memset(data_pointer, 0, pixmap_size);
+                            LOG_ERROR(SERVICE_WINDOW, "Failed to render NVG bitmap!");
                         } else {
-                            auto bitmap = lunasvg::Bitmap(reinterpret_cast<std::uint8_t *>(data_pointer), bmp->header_.size_pixels.x,
-                                bmp->header_.size_pixels.y, bmp->header_.size_pixels.x * 4);
-
-                            lunasvg::Matrix matrix{ 1, 0, 0, 1, 0, 0 };
-                            nvg_doc->render(bitmap, matrix);
+                            save_cached_icon_raster(raster_key, bmp->header_.size_pixels, data_pointer);
                         }
                     }
                 }
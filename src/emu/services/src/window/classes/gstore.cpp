@@ -28,6 +28,8 @@
 #include <common/time.h>
 #include <common/algorithm.h>
 
+#include <algorithm>
+
 namespace eka2l1::epoc {
     // NOTE: Must store objects then free ref with local font atlas.
     gdi_store_command_segment::~gdi_store_command_segment() {
@@ -190,14 +192,16 @@ namespace eka2l1::epoc {
     }
 
     gdi_command_builder::gdi_command_builder(drivers::graphics_driver *drv, drivers::graphics_command_builder &builder, bitmap_cache &bcache,
-        drivers::filter_option texture_filter, const eka2l1::vec2 &position, float scale_factor, const common::region &clip)
+        drivers::filter_option texture_filter, const eka2l1::vec2 &position, float scale_factor, const common::region &clip,
+        std::vector<fbsfont *> &text_fonts)
         : driver_(drv)
         , builder_(builder)
         , bcache_(bcache)
         , scale_factor_(scale_factor)
         , position_(position)
         , clip_(clip)
-        , texture_filter_(texture_filter) {
+        , texture_filter_(texture_filter)
+        , text_fonts_(&text_fonts) {
     }
 
     void gdi_command_builder::build_segment(const gdi_store_command_segment &segment) {
@@ -330,6 +334,12 @@ namespace eka2l1::epoc {
 
         text_font->atlas.draw_text(cmd.string_, scaled_text_box, static_cast<epoc::text_alignment>(cmd.alignment_),
             driver_, builder_, scale_to_pass);
+
+        // The segment holding the font may be freed before the builder is submitted
+        if (std::find(text_fonts_->begin(), text_fonts_->end(), text_font) == text_fonts_->end()) {
+            text_fonts_->push_back(text_font);
+            text_font->ref();
+        }
     }
 
     void gdi_command_builder::build_command_draw_raw_texture(const gdi_store_command_draw_raw_texture_data &cmd) {
@@ -504,4 +514,13 @@ namespace eka2l1::epoc {
             builder_.set_swizzle(cmd.handle_, cmd.swizz_[0], cmd.swizz_[1], cmd.swizz_[2], cmd.swizz_[3]);
         }
     }
+
+    void mark_text_fonts_submitted(std::vector<fbsfont *> &text_fonts) {
+        for (fbsfont *font : text_fonts) {
+            font->atlas.mark_draws_submitted();
+            font->deref();
+        }
+
+        text_fonts.clear();
+    }
 }
\ No newline at end of file
@@ -1212,7 +1212,7 @@ namespace eka2l1::epoc {
 
                 gdi_command_builder gdi_builder(client->get_ws().get_graphics_driver(), builder,
                     *client->get_ws().get_bitmap_cache(), filter, abs_rect.top, scr->display_scale_factor,
-                    visible_region);
+                    visible_region, scr->pending_text_fonts);
 
                 for (std::size_t i = 0; i < segments.size(); i++) {
                     if (segments[i]->type_ != gdi_store_command_segment_pending_redraw) {
@@ -1229,7 +1229,7 @@ namespace eka2l1::epoc {
 
                 gdi_command_builder gdi_builder(client->get_ws().get_graphics_driver(), builder,
                     *client->get_ws().get_bitmap_cache(), filter, abs_rect.top, scr->display_scale_factor,
-                    visible_region);
+                    visible_region, scr->pending_text_fonts);
 
                 gdi_builder.build_segment(*pending_segment_);
                 pending_segment_.reset();
@@ -1312,6 +1312,7 @@ namespace eka2l1::epoc {
         const epoc::display_mode dmode, const std::uint32_t client_handle)
         : canvas_base(client, scr, parent, window_type::backed_up, dmode, client_handle)
         , bitmap_(nullptr)
+        , async_readback_(false)
         , driver_win_id(0)
         , ping_pong_driver_win_id(0) {
         resize_needed = true;
@@ -1417,10 +1418,12 @@ namespace eka2l1::epoc {
             return 0;
         }
 
+        std::vector<fbsfont *> text_fonts;
+
         if (pending_segment_) {
             gdi_command_builder gdi_builder(client->get_ws().get_graphics_driver(), driver_builder_,
                 *client->get_ws().get_bitmap_cache(), drivers::filter_option::linear, eka2l1::vec2(0, 0),
-                1.0f, common::region{});
+                1.0f, common::region{}, text_fonts);
 
             gdi_builder.build_segment(*pending_segment_);
             pending_segment_.reset();
@@ -1429,30 +1432,63 @@ namespace eka2l1::epoc {
         drivers::command_list list = driver_builder_.retrieve_command_list();
         drv->submit_command_list(list);
 
+        mark_text_fonts_submitted(text_fonts);
+
         driver_builder_.bind_bitmap(driver_win_id);
 
         // Sync back to the bitmap
-        if (bitmap_) {
-            if (bitmap_->bitmap_->compression_type() != epoc::bitmap_file_no_compression) {
-                LOG_ERROR(SERVICE_WINDOW, "Try to sync data back to backed bitmap canvas but compression is required on the bitmap!");
-            } else {
-                fbs_server *serv = client->get_ws().get_fbs_server();
+        sync_to_bitmap();
 
-                bool support_current_display_mode = true;
-                bool support_dirty_bitmap = true;
+        return canvas_base::try_update(drawer);
+    }
 
-                query_fbs_feature_support(serv, support_current_display_mode, support_dirty_bitmap);
+    void bitmap_backed_canvas::sync_to_bitmap() {
+        if (!bitmap_) {
+            return;
+        }
 
-                eka2l1::vec2 to_sync_size(common::min<int>(bitmap_->bitmap_->header_.size_pixels.x, size().x),
-                    common::min<int>(bitmap_->bitmap_->header_.size_pixels.y, size().y));
+        if (bitmap_->bitmap_->compression_type() != epoc::bitmap_file_no_compression) {
+            LOG_ERROR(SERVICE_WINDOW, "Try to sync data back to backed bitmap canvas but compression is required on the bitmap!");
+            return;
+        }
 
-                drivers::read_bitmap(drv, driver_win_id, eka2l1::point(0, 0), to_sync_size, get_bpp_from_display_mode(
-                    support_current_display_mode ? bitmap_->bitmap_->settings_.current_display_mode() : bitmap_->bitmap_->settings_.initial_display_mode()),
-                    bitmap_->bitmap_->data_pointer(serv));
-            }
+        drivers::graphics_driver *drv = client->get_ws().get_graphics_driver();
+        fbs_server *serv = client->get_ws().get_fbs_server();
+
+        bool support_current_display_mode = true;
+        bool support_dirty_bitmap = true;
+
+        query_fbs_feature_support(serv, support_current_display_mode, support_dirty_bitmap);
+
+        eka2l1::vec2 to_sync_size(common::min<int>(bitmap_->bitmap_->header_.size_pixels.x, size().x),
+            common::min<int>(bitmap_->bitmap_->header_.size_pixels.y, size().y));
+
+        const std::uint32_t bpp = get_bpp_from_display_mode(support_current_display_mode ? bitmap_->bitmap_->settings_.current_display_mode() : bitmap_->bitmap_->settings_.initial_display_mode());
+
+        if (!async_readback_) {
+            drivers::read_bitmap(drv, driver_win_id, eka2l1::point(0, 0), to_sync_size, bpp, bitmap_->bitmap_->data_pointer(serv));
+            return;
         }
 
-        return canvas_base::try_update(drawer);
+        const std::size_t data_size = static_cast<std::size_t>(bitmap_->bitmap_->byte_width_) * to_sync_size.y;
+
+        readback_.queue(drv, driver_win_id, to_sync_size, bpp, data_size);
+        readback_.resolve(bitmap_->bitmap_->data_pointer(serv), data_size);
+    }
+
+    void bitmap_backed_canvas::set_async_readback(const bool enable) {
+        if (async_readback_ == enable) {
+            return;
+        }
+
+        async_readback_ = enable;
+
+        if (!enable && bitmap_) {
+            fbs_server *serv = client->get_ws().get_fbs_server();
+            const std::size_t data_size = static_cast<std::size_t>(bitmap_->bitmap_->byte_width_) * common::min<int>(bitmap_->bitmap_->header_.size_pixels.y, size().y);
+
+            readback_.resolve(bitmap_->bitmap_->data_pointer(serv), data_size, true);
+        }
     }
 
     void bitmap_backed_canvas::add_draw_command(gdi_store_command &command) {
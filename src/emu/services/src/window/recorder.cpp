@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2022 EKA2L1 Team.
+ *
+ * This file is part of EKA2L1 project.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <services/window/recorder.h>
+
+namespace eka2l1::epoc {
+    ws_command_recorder::ws_command_recorder(const std::string &path)
+        : stream_(path, std::ios_base::binary | std::ios_base::out | std::ios_base::trunc) {
+        if (stream_.is_open()) {
+            stream_.write(reinterpret_cast<const char *>(&WS_COMMAND_RECORD_MAGIC), sizeof(WS_COMMAND_RECORD_MAGIC));
+            stream_.write(reinterpret_cast<const char *>(&WS_COMMAND_RECORD_VERSION), sizeof(WS_COMMAND_RECORD_VERSION));
+        }
+    }
+
+    void ws_command_recorder::record(const std::uint64_t session_uid, const std::uint32_t function, const std::uint8_t *buffer,
+        const std::uint32_t size) {
+        if (!stream_.is_open()) {
+            return;
+        }
+
+        const std::lock_guard<std::mutex> guard(lock_);
+
+        stream_.write(reinterpret_cast<const char *>(&session_uid), sizeof(session_uid));
+        stream_.write(reinterpret_cast<const char *>(&function), sizeof(function));
+        stream_.write(reinterpret_cast<const char *>(&size), sizeof(size));
+        stream_.write(reinterpret_cast<const char *>(buffer), size);
+    }
+
+    ws_command_playback::ws_command_playback(const std::string &path)
+        : stream_(path, std::ios_base::binary | std::ios_base::in)
+        , valid_(false) {
+        std::uint32_t magic = 0;
+        std::uint32_t version = 0;
+
+        if (!stream_.read(reinterpret_cast<char *>(&magic), sizeof(magic)) || !stream_.read(reinterpret_cast<char *>(&version), sizeof(version))) {
+            return;
+        }
+
+        valid_ = (magic == WS_COMMAND_RECORD_MAGIC) && (version == WS_COMMAND_RECORD_VERSION);
+    }
+
+    bool ws_command_playback::next(ws_command_record &record) {
+        if (!valid_) {
+            return false;
+        }
+
+        std::uint32_t size = 0;
+
+        if (!stream_.read(reinterpret_cast<char *>(&record.session_uid_), sizeof(record.session_uid_)) || !stream_.read(reinterpret_cast<char *>(&record.function_), sizeof(record.function_)) || !stream_.read(reinterpret_cast<char *>(&size), sizeof(size))) {
+            return false;
+        }
+
+        record.buffer_.resize(size);
+        return static_cast<bool>(stream_.read(reinterpret_cast<char *>(record.buffer_.data()), size));
+    }
+}
@@ -18,6 +18,7 @@
  */
 
 #include <services/window/classes/dsa.h>
+#include <services/window/classes/gstore.h>
 #include <services/window/classes/winbase.h>
 #include <services/window/classes/wingroup.h>
 #include <services/window/classes/winuser.h>
@@ -215,6 +216,8 @@ namespace eka2l1::epoc {
         eka2l1::drivers::command_list retrieved = builder.retrieve_command_list();
         driver->submit_command_list(retrieved);
 
+        mark_text_draws_submitted();
+
         if (performed && sync_screen_buffer && (display_scale_factor == 1.0f)) {
             sync_screen_buffer_data(driver);
         }
@@ -222,6 +225,10 @@ namespace eka2l1::epoc {
         fire_screen_redraw_callbacks(false);
     }
 
+    void screen::mark_text_draws_submitted() {
+        mark_text_fonts_submitted(pending_text_fonts);
+    }
+
     void screen::deinit(drivers::graphics_driver *driver) {
         // Make command list first, and bind our screen bitmap
         if (driver) {
@@ -271,6 +278,8 @@ namespace eka2l1::epoc {
         eka2l1::drivers::command_list retrieved = builder.retrieve_command_list();
         driver->submit_command_list(retrieved);
 
+        mark_text_draws_submitted();
+
         if (performed && sync_screen_buffer) {
             sync_screen_buffer_data(driver);
         }
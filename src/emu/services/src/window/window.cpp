@@ -60,6 +60,8 @@
 
 #include <loader/rom.h>
 
+#include <chrono>
+#include <ctime>
 #include <optional>
 #include <string>
 
@@ -128,38 +130,29 @@ namespace eka2l1::epoc {
     }
 
     void window_server_client::parse_command_buffer(service::ipc_context &ctx) {
-        std::optional<std::string> dat = ctx.get_argument_value<std::string>(cmd_slot);
+        std::uint8_t *beg = ctx.get_descriptor_argument_ptr(cmd_slot);
+        const std::size_t size = ctx.get_argument_data_size(cmd_slot);
 
-        if (!dat) {
-            return;
-        }
-
-        char *beg = dat->data();
-        char *end = dat->data() + dat->size();
-
-        std::vector<ws_cmd> cmds;
-
-        while (beg < end) {
-            ws_cmd cmd;
+        std::optional<std::string> copied;
 
-            cmd.header = *reinterpret_cast<ws_cmd_header *>(beg);
+        if (!beg) {
+            // The descriptor is not directly addressable, take the slow path
+            copied = ctx.get_argument_value<std::string>(cmd_slot);
 
-            if (cmd.header.op & 0x8000) {
-                cmd.header.op &= ~0x8000;
-                cmd.obj_handle = *reinterpret_cast<std::uint32_t *>(beg + sizeof(ws_cmd_header));
-
-                beg += sizeof(ws_cmd_header) + sizeof(cmd.obj_handle);
-            } else {
-                beg += sizeof(ws_cmd_header);
+            if (!copied) {
+                return;
             }
 
-            cmd.data_ptr = reinterpret_cast<void *>(beg);
-            beg += cmd.header.cmd_len;
+            beg = reinterpret_cast<std::uint8_t *>(copied->data());
+        }
+
+        const std::size_t buffer_size = copied ? copied->size() : size;
 
-            cmds.push_back(std::move(cmd));
+        if (epoc::ws_command_recorder *recorder = get_ws().get_command_recorder()) {
+            recorder->record(guest_session->unique_id(), ctx.msg->function, beg, static_cast<std::uint32_t>(buffer_size));
         }
 
-        execute_commands(ctx, std::move(cmds));
+        execute_commands(ctx, beg, beg + buffer_size);
     }
 
     window_server_client::window_server_client(service::session *guest_session, kernel::thread *own_thread, epoc::version ver)
@@ -171,8 +164,11 @@ namespace eka2l1::epoc {
         , uid_counter(0) {
     }
 
-    void window_server_client::execute_commands(service::ipc_context &ctx, std::vector<ws_cmd> cmds) {
-        for (auto &cmd : cmds) {
+    void window_server_client::execute_commands(service::ipc_context &ctx, std::uint8_t *beg, std::uint8_t *end) {
+        ws_cmd_walker walker(beg, end);
+        ws_cmd cmd;
+
+        while (walker.next(cmd)) {
             if (cmd.obj_handle == guest_session->unique_id()) {
                 if (last_obj) {
                     last_obj->on_command_batch_done(ctx);
@@ -1556,6 +1552,23 @@ namespace eka2l1 {
 
         // For addition mappings before actual game launches
         init_key_mappings();
+
+        if (kern->get_config()->record_ws_commands) {
+            auto start = std::chrono::system_clock::now();
+            std::time_t end_time = std::chrono::system_clock::to_time_t(start);
+
+            tm local_tm = *std::localtime(&end_time);
+
+            const std::string filename = fmt::format("wscmd_{}_{}_{}_{}_{}_{}.rec", local_tm.tm_year + 1900, local_tm.tm_mon + 1,
+                local_tm.tm_mday, local_tm.tm_hour, local_tm.tm_min, local_tm.tm_sec);
+
+            cmd_recorder_ = std::make_unique<epoc::ws_command_recorder>(filename);
+
+            if (!cmd_recorder_->is_open()) {
+                LOG_ERROR(SERVICE_WINDOW, "Unable to open {} for recording window server commands", filename);
+                cmd_recorder_.reset();
+            }
+        }
     }
 
     window_server::~window_server() {
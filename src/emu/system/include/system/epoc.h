@@ -172,8 +172,19 @@ namespace eka2l1 {
         void set_config(config::state *conf);
 
         void mount(drive_number drv, const drive_media media, std::string path, const std::uint32_t attrib = io_attrib_none);
+
+        /**
+         * \brief Extract a game card dump archive, and mount it as a drive.
+         *
+         * Entries are extracted concurrently. By default the archive is staged in a temporary folder,
+         * which is cleared on each mount. On failure or cancel, the partial output is removed.
+         *
+         * \param target_folder  If not empty, the folder to mount the archive from. It is extracted into a sibling
+         *                       staging folder first, then replaces the target only once complete. The target is
+         *                       left alone if it was already extracted from the same archive.
+         */
         zip_mount_error mount_game_zip(drive_number drv, const drive_media media, const std::string &zip_path, const std::uint32_t base_attrib = io_attrib_none,
-            progress_changed_callback progress_cb = nullptr, cancel_requested_callback cancel_cb = nullptr);
+            progress_changed_callback progress_cb = nullptr, cancel_requested_callback cancel_cb = nullptr, const std::string &target_folder = "");
 
         ngage_game_card_install_error install_ngage_game_card(const std::string &folder_path, std::function<void(std::string)> game_name_found_cb, progress_changed_callback progress_cb = nullptr);
         bool get_ngage_game_info_mounted(apa_app_registry &result);
@@ -29,6 +29,7 @@
 #include <common/path.h>
 #include <common/platform.h>
 #include <common/random.h>
+#include <common/thread_pool.h>
 
 #include <disasm/disasm.h>
 
@@ -44,9 +45,12 @@
 
 #include <services/applist/applist.h>
 
+#include <algorithm>
 #include <atomic>
+#include <chrono>
 #include <fstream>
 #include <string>
+#include <unordered_set>
 
 #include <disasm/disasm.h>
 #include <drivers/itc.h>
@@ -227,6 +231,12 @@ namespace eka2l1 {
                 return 0;
             };
 
+            packages_->files_changed = [&]() {
+                if (hle::lib_manager *mngr = kern_->get_lib_manager()) {
+                    mngr->invalidate_dll_index();
+                }
+            };
+
             packages_->choose_lang = [&](const int *langs, const int count) {
                 device *dvc = get_device_manager()->get_current();
                 if (!dvc) {
@@ -550,7 +560,8 @@ namespace eka2l1 {
         }
 
         void mount(drive_number drv, const drive_media media, std::string path, const std::uint32_t attrib = io_attrib_none);
-        zip_mount_error mount_game_zip(drive_number drv, const drive_media media, const std::string &zip_path, const std::uint32_t attrib = io_attrib_none, progress_changed_callback progress_cb = nullptr, cancel_requested_callback cancel_cb = nullptr);
+        zip_mount_error mount_game_zip(drive_number drv, const drive_media media, const std::string &zip_path, const std::uint32_t attrib = io_attrib_none, progress_changed_callback progress_cb = nullptr, cancel_requested_callback cancel_cb = nullptr,
+            const std::string &target_folder = "");
         ngage_game_card_install_error install_ngage_game_card(const std::string &folder_path, std::function<void(std::string)> game_name_found_cb, progress_changed_callback progress_cb = nullptr);
         ngage_game_card_install_error find_singular_ngage_game(const std::string &system_apps_folder_path, apa_app_registry &result, std::string *app_folder_name_1 = nullptr, std::string *app_folder_name_2 = nullptr);
         bool get_ngage_game_info_mounted(apa_app_registry &result);
@@ -788,7 +799,132 @@ namespace eka2l1 {
         io_->mount_physical_path(drv, media, attrib, common::utf8_to_ucs2(path));
     }
 
-    zip_mount_error system_impl::mount_game_zip(drive_number drv, const drive_media media, const std::string &zip_path, const std::uint32_t base_attrib, progress_changed_callback progress_cb, cancel_requested_callback cancel_cb) {
+    static constexpr std::uint32_t ZIP_EXTRACT_PROGRESS_POLL_INTERVAL_MS = 30;
+
+    struct zip_extract_entry {
+        mz_uint index_;
+        std::string path_;
+        mz_uint64 uncomp_size_;
+    };
+
+    struct zip_extract_worker_context {
+        std::ofstream *file_stream_;
+        std::atomic<std::size_t> *size_uncomped_so_far_;
+        std::atomic<bool> *cancelled_;
+    };
+
+    /**
+     * \brief Extract zip entries, picking the next one from a shared counter until all are done.
+     *
+     * Each worker opens its own reader, since a miniz archive can't be read from multiple threads.
+     */
+    static bool extract_zip_entries(const std::string &zip_path, const std::vector<zip_extract_entry> &entries, std::atomic<std::size_t> &next_entry,
+        std::atomic<std::size_t> &size_uncomped_so_far, std::atomic<bool> &cancelled) {
+        std::unique_ptr<mz_zip_archive> archive = std::make_unique<mz_zip_archive>();
+        if (!mz_zip_reader_init_file(archive.get(), zip_path.c_str(), 0)) {
+            // No point for other workers to continue
+            cancelled = true;
+            return false;
+        }
+
+        zip_extract_worker_context context;
+        context.size_uncomped_so_far_ = &size_uncomped_so_far;
+        context.cancelled_ = &cancelled;
+
+        bool succeed = true;
+
+        while (!cancelled) {
+            const std::size_t current = next_entry++;
+            if (current >= entries.size()) {
+                break;
+            }
+
+            std::ofstream file_stream(entries[current].path_, std::ios::binary);
+            if (!file_stream) {
+                LOG_ERROR(SYSTEM, "Unable to create extracted file {}", entries[current].path_);
+                succeed = false;
+                break;
+            }
+
+            context.file_stream_ = &file_stream;
+
+            if (!mz_zip_reader_extract_to_callback(
+                    archive.get(), entries[current].index_, [](void *userdata, mz_uint64 offset, const void *buf, std::size_t n) -> std::size_t {
+                        zip_extract_worker_context *data_ptr = reinterpret_cast<zip_extract_worker_context *>(userdata);
+
+                        if (*data_ptr->cancelled_) {
+                            return 0;
+                        }
+
+                        data_ptr->file_stream_->write(reinterpret_cast<const char *>(buf), n);
+                        if (!data_ptr->file_stream_->good()) {
+                            return 0;
+                        }
+
+                        *data_ptr->size_uncomped_so_far_ += n;
+                        return n;
+                    },
+                    &context, 0)) {
+                succeed = false;
+                break;
+            }
+        }
+
+        mz_zip_reader_end(archive.get());
+
+        if (!succeed) {
+            // No point for other workers to continue
+            cancelled = true;
+        }
+
+        return succeed;
+    }
+
+    static constexpr const char *ZIP_MOUNT_STAMP_FILE_NAME = "eka2l1_zip_stamp.txt";
+
+    /**
+     * \brief Describe the archive a target folder was extracted from, so that an unchanged archive is not extracted again.
+     */
+    static std::string make_zip_mount_stamp(const std::string &zip_path) {
+        return fmt::format("{} {}", common::file_size(zip_path), common::get_last_modifiy_since_ad(common::utf8_to_ucs2(zip_path)));
+    }
+
+    static std::string read_zip_mount_stamp(const std::string &folder) {
+        std::ifstream stamp_stream(eka2l1::add_path(folder, ZIP_MOUNT_STAMP_FILE_NAME));
+        std::string stamp;
+
+        std::getline(stamp_stream, stamp);
+        return stamp;
+    }
+
+    // Swap a fully extracted staging folder in place of the target. The old target is only deleted once the new one is in
+    static bool replace_zip_mount_folder(const std::string &staging_folder, const std::string &target_folder) {
+        const std::string old_folder = target_folder + ".old";
+        const bool target_existed = common::exists(target_folder);
+
+        common::delete_folder(old_folder);
+
+        if (target_existed && !common::move_file(target_folder, old_folder)) {
+            return false;
+        }
+
+        if (!common::move_file(staging_folder, target_folder)) {
+            if (target_existed) {
+                common::move_file(old_folder, target_folder);
+            }
+
+            return false;
+        }
+
+        if (target_existed) {
+            common::delete_folder(old_folder);
+        }
+
+        return true;
+    }
+
+    zip_mount_error system_impl::mount_game_zip(drive_number drv, const drive_media media, const std::string &zip_path, const std::uint32_t base_attrib, progress_changed_callback progress_cb, cancel_requested_callback cancel_cb,
+        const std::string &target_folder) {
         std::unique_ptr<mz_zip_archive> archive = std::make_unique<mz_zip_archive>();
         if (!mz_zip_reader_init_file(archive.get(), zip_path.c_str(), 0)) {
             return zip_mount_error_not_zip;
@@ -798,22 +934,10 @@ namespace eka2l1 {
         const std::uint32_t num_files = mz_zip_reader_get_num_files(archive.get());
         bool system_found = false;
 
-        std::vector<std::string> list_files;
+        std::vector<zip_extract_entry> entries;
+        std::vector<std::string> directories;
 
-        struct extract_zip_callback_data {
-            progress_changed_callback progress_cb_;
-            cancel_requested_callback cancel_cb_;
-            std::size_t total_uncomp_size_;
-            std::size_t size_uncomped_so_far_;
-            std::unique_ptr<std::ofstream> file_stream_;
-            bool was_canceled_;
-        } callback_data;
-
-        callback_data.progress_cb_ = progress_cb;
-        callback_data.cancel_cb_ = cancel_cb;
-        callback_data.total_uncomp_size_ = 0;
-        callback_data.size_uncomped_so_far_ = 0;
-        callback_data.was_canceled_ = false;
+        std::size_t total_uncomp_size = 0;
 
         for (std::uint32_t i = 0; i < num_files; i++) {
             mz_zip_archive_file_stat file_stat;
@@ -824,71 +948,139 @@ namespace eka2l1 {
                     system_found = true;
                 }
 
-                list_files.push_back(file_stat.m_filename);
-                callback_data.total_uncomp_size_ += file_stat.m_uncomp_size;
+                if (file_stat.m_is_directory) {
+                    directories.push_back(file_stat.m_filename);
+                } else {
+                    entries.push_back({ static_cast<mz_uint>(i), file_stat.m_filename, file_stat.m_uncomp_size });
+                    total_uncomp_size += file_stat.m_uncomp_size;
+                }
             } else {
                 mz_zip_reader_end(archive.get());
                 return zip_mount_error_corrupt;
             }
         }
 
+        // Workers open their own readers, the central directory has been read by now
+        mz_zip_reader_end(archive.get());
+
         if (!system_found) {
-            mz_zip_reader_end(archive.get());
             return zip_mount_error_no_system_folder;
         }
 
         std::string current_dir;
         common::get_current_directory(current_dir);
 
-        const std::string temp_folder = eka2l1::absolute_path("cache/temp/", current_dir);
+        // With a target folder, the dump is extracted next to it and swapped in once complete, so that a failed or
+        // cancelled mount leaves the previous content alone. Else it goes to a temporary folder, wiped on every mount
+        const bool use_temp_folder = target_folder.empty();
+        std::string mount_folder = eka2l1::absolute_path(use_temp_folder ? "cache/temp" : target_folder, current_dir);
 
-        eka2l1::common::delete_folder(temp_folder);
-        eka2l1::common::create_directories(temp_folder);
+        while (!mount_folder.empty() && eka2l1::is_separator(mount_folder.back())) {
+            mount_folder.pop_back();
+        }
 
-        std::uint32_t extracted = 0;
+        std::string zip_stamp;
 
-        for (std::size_t extracted = 0; extracted < list_files.size(); extracted++) {
-            const std::string path_to_file = eka2l1::add_path(temp_folder, list_files[extracted]);
-            common::create_directories(eka2l1::file_directory(path_to_file));
-            callback_data.file_stream_ = std::make_unique<std::ofstream>(path_to_file, std::ios::binary);
+        if (!use_temp_folder) {
+            zip_stamp = make_zip_mount_stamp(zip_path);
 
-            if (!mz_zip_reader_extract_to_callback(
-                    archive.get(), static_cast<mz_uint>(extracted), [](void *userdata, mz_uint64 offset, const void *buf, std::size_t n) -> std::size_t {
-                        extract_zip_callback_data *data_ptr = reinterpret_cast<extract_zip_callback_data *>(userdata);
+            if (read_zip_mount_stamp(mount_folder) == zip_stamp) {
+                if (progress_cb) {
+                    progress_cb(total_uncomp_size, total_uncomp_size);
+                }
 
-                        if (data_ptr->cancel_cb_ && data_ptr->cancel_cb_()) {
-                            data_ptr->was_canceled_ = true;
-                            return 0;
-                        }
+                mount(drv, media, eka2l1::add_path(mount_folder, "/"), base_attrib | io_attrib_removeable);
+                return zip_mount_error_none;
+            }
+        }
 
-                        std::size_t written = data_ptr->file_stream_->tellp();
-                        data_ptr->file_stream_->write(reinterpret_cast<const char *>(buf), n);
+        const std::string extract_folder = eka2l1::add_path(use_temp_folder ? mount_folder : mount_folder + ".partial", "/");
 
-                        std::size_t current_pos = data_ptr->file_stream_->tellp();
-                        written = current_pos - written;
+        eka2l1::common::delete_folder(extract_folder);
+        eka2l1::common::create_directories(extract_folder);
 
-                        if (written == n) {
-                            data_ptr->size_uncomped_so_far_ += written;
+        // Make the folder tree beforehand, so that workers only have to write files
+        std::unordered_set<std::string> created_dirs;
 
-                            if (data_ptr->progress_cb_) {
-                                data_ptr->progress_cb_(data_ptr->size_uncomped_so_far_, data_ptr->total_uncomp_size_);
-                            }
-                        }
+        for (const std::string &directory : directories) {
+            const std::string dir_path = eka2l1::add_path(extract_folder, directory);
+            if (created_dirs.insert(dir_path).second) {
+                common::create_directories(dir_path);
+            }
+        }
 
-                        return static_cast<std::size_t>(written);
-                    },
-                    &callback_data, 0)) {
-                callback_data.file_stream_.reset();
-                eka2l1::common::delete_folder(temp_folder);
+        for (zip_extract_entry &entry : entries) {
+            entry.path_ = eka2l1::add_path(extract_folder, entry.path_);
 
-                mz_zip_reader_end(archive.get());
-                return zip_mount_error_corrupt;
+            const std::string dir_path = eka2l1::file_directory(entry.path_);
+            if (created_dirs.insert(dir_path).second) {
+                common::create_directories(dir_path);
             }
         }
 
-        mz_zip_reader_end(archive.get());
-        mount(drv, media, temp_folder, base_attrib | io_attrib_removeable);
+        // Largest first, so that a big file doesn't end up being the tail every worker waits on
+        std::sort(entries.begin(), entries.end(), [](const zip_extract_entry &lhs, const zip_extract_entry &rhs) {
+            return lhs.uncomp_size_ > rhs.uncomp_size_;
+        });
+
+        std::atomic<std::size_t> next_entry(0);
+        std::atomic<std::size_t> size_uncomped_so_far(0);
+        std::atomic<bool> cancelled(false);
+
+        bool succeed = true;
+
+        if (!entries.empty()) {
+            const std::size_t worker_count = std::min<std::size_t>(entries.size(), std::max<std::uint32_t>(std::thread::hardware_concurrency(), 1));
+
+            common::thread_pool extract_pool("Zip extractor", worker_count);
+            std::vector<std::future<bool>> results;
+
+            for (std::size_t i = 0; i < worker_count; i++) {
+                results.push_back(extract_pool.submit([&]() {
+                    return extract_zip_entries(zip_path, entries, next_entry, size_uncomped_so_far, cancelled);
+                }));
+            }
+
+            // Callbacks are only called from this thread
+            for (auto &result : results) {
+                while (result.wait_for(std::chrono::milliseconds(ZIP_EXTRACT_PROGRESS_POLL_INTERVAL_MS)) != std::future_status::ready) {
+                    if (progress_cb) {
+                        progress_cb(size_uncomped_so_far, total_uncomp_size);
+                    }
+
+                    if (!cancelled && cancel_cb && cancel_cb()) {
+                        cancelled = true;
+                    }
+                }
+
+                if (!result.get()) {
+                    succeed = false;
+                }
+            }
+
+            if (cancelled) {
+                succeed = false;
+            }
+        }
+
+        if (succeed && !use_temp_folder) {
+            std::ofstream stamp_stream(eka2l1::add_path(extract_folder, ZIP_MOUNT_STAMP_FILE_NAME));
+            stamp_stream << zip_stamp;
+            stamp_stream.close();
+
+            succeed = stamp_stream.good() && replace_zip_mount_folder(mount_folder + ".partial", mount_folder);
+        }
+
+        if (!succeed) {
+            eka2l1::common::delete_folder(extract_folder);
+            return zip_mount_error_corrupt;
+        }
+
+        if (progress_cb) {
+            progress_cb(total_uncomp_size, total_uncomp_size);
+        }
 
+        mount(drv, media, eka2l1::add_path(mount_folder, "/"), base_attrib | io_attrib_removeable);
         return zip_mount_error_none;
     }
 
@@ -1394,8 +1586,9 @@ namespace eka2l1 {
         return impl->mount(drv, media, path, attrib);
     }
 
-    zip_mount_error system::mount_game_zip(drive_number drv, const drive_media media, const std::string &zip_path, const std::uint32_t base_attrib, progress_changed_callback progress_cb, cancel_requested_callback cancel_cb) {
-        return impl->mount_game_zip(drv, media, zip_path, base_attrib, progress_cb, cancel_cb);
+    zip_mount_error system::mount_game_zip(drive_number drv, const drive_media media, const std::string &zip_path, const std::uint32_t base_attrib, progress_changed_callback progress_cb, cancel_requested_callback cancel_cb,
+        const std::string &target_folder) {
+        return impl->mount_game_zip(drv, media, zip_path, base_attrib, progress_cb, cancel_cb, target_folder);
     }
 
     ngage_game_card_install_error system::install_ngage_game_card(const std::string &folder_path, std::function<void(std::string)> game_name_found_cb, progress_changed_callback progress_cb) {
@@ -299,6 +299,12 @@ namespace eka2l1::epoc {
             }
 
             len >>= 1;
+
+            // Every character takes at least a byte, a longer string can only come from corrupted data
+            if (len > seri.left()) {
+                len = 0;
+            }
+
             str.resize(len);
 
             if (unicode) {
@@ -177,6 +177,19 @@ namespace eka2l1 {
 
         virtual std::uint64_t last_modify_since_0ad() = 0;
 
+        /*! \brief Read from the given offset.
+         *
+         * The seek cursor is left right after the last byte read. Backends can override this
+         * to avoid a separate seek, and to serve small consecutive reads from a readahead window.
+         *
+         * \param offset Offset to read from.
+         * \param data   Pointer to the destination.
+         * \param size   Total bytes to read.
+         *
+         * \returns Total bytes read.
+         */
+        virtual std::size_t read_file_at(const std::uint64_t offset, void *data, const std::uint32_t size);
+
         std::size_t read_file(const std::uint64_t offset, void *buf, std::uint32_t size,
             std::uint32_t count);
     };
@@ -32,16 +32,25 @@
 #include <vfs/vfs.h>
 
 #include <array>
+#include <atomic>
+#include <cstring>
 #include <cwctype>
 #include <iostream>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <regex>
 #include <stack>
 #include <thread>
+#include <vector>
 
 #include <string.h>
 
+#if EKA2L1_PLATFORM(POSIX)
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 namespace eka2l1 {
     file::file(const std::uint32_t attrib)
         : io_component(io_component_type::file, attrib) {
@@ -59,6 +68,11 @@ namespace eka2l1 {
         return true;
     }
 
+    std::size_t file::read_file_at(const std::uint64_t offset, void *data, const std::uint32_t size) {
+        seek(offset, file_seek_mode::beg);
+        return read_file(data, 1, size);
+    }
+
     std::size_t file::read_file(const std::uint64_t offset, void *buf, std::uint32_t size,
         std::uint32_t count) {
         const std::uint64_t last_offset = tell();
@@ -188,6 +202,38 @@ namespace eka2l1 {
         }
     };
 
+    /**
+     * \brief State shared by every physical file handle opened on the same host path.
+     */
+    struct physical_file_share {
+        std::atomic<std::uint64_t> write_generation{ 0 };
+    };
+
+    static std::mutex physical_file_shares_lock;
+    static std::map<std::u16string, std::weak_ptr<physical_file_share>> physical_file_shares;
+
+    static std::shared_ptr<physical_file_share> acquire_physical_file_share(const std::u16string &path) {
+        const std::lock_guard<std::mutex> guard(physical_file_shares_lock);
+
+        for (auto ite = physical_file_shares.begin(); ite != physical_file_shares.end();) {
+            if (ite->second.expired()) {
+                ite = physical_file_shares.erase(ite);
+            } else {
+                ite++;
+            }
+        }
+
+        std::weak_ptr<physical_file_share> &entry = physical_file_shares[path];
+        std::shared_ptr<physical_file_share> share = entry.lock();
+
+        if (!share) {
+            share = std::make_shared<physical_file_share>();
+            entry = share;
+        }
+
+        return share;
+    }
+
     struct physical_file : public file {
         FILE *file;
 
@@ -198,6 +244,23 @@ namespace eka2l1 {
 
         bool closed;
 
+        // Positioned reads leave the stdio cursor untouched. The real cursor is stored here, and
+        // only applied back to the stdio stream when it's needed by other operations.
+        std::optional<std::uint64_t> pending_pos;
+        bool write_dirty;
+
+        static constexpr std::uint32_t READAHEAD_WINDOW_SIZE = 0x4000;
+
+        // Writes through any handle of the same host file bump the shared generation, which
+        // drops the readahead window of every other handle. Changes made outside of the emulator
+        // are not tracked.
+        std::shared_ptr<physical_file_share> share;
+
+        std::vector<std::uint8_t> readahead_buf;
+        std::uint64_t readahead_offset;
+        std::uint32_t readahead_size;
+        std::uint64_t readahead_generation;
+
         const char *translate_mode(int mode, const bool reopen = false) {
             if (mode & READ_MODE) {
                 if (mode & BIN_MODE) {
@@ -330,6 +393,10 @@ namespace eka2l1 {
         void init(const utf16_str &vfs_path, const utf16_str &real_path, const int mode) {
             // Disable directory check here
             closed = false;
+            write_dirty = false;
+            readahead_offset = 0;
+            readahead_size = 0;
+            readahead_generation = 0;
             file = common::open_c_file(common::ucs2_to_utf8(real_path).c_str(), translate_mode(mode));
 
             physical_path = real_path;
@@ -343,29 +410,133 @@ namespace eka2l1 {
 
             input_name = vfs_path;
             fmode = mode;
+            share = acquire_physical_file_share(real_path);
         }
 
         void shutdown() {
             if (file && !closed) {
                 fclose(file);
             }
+
+            share.reset();
+        }
+
+        void notify_write() {
+            readahead_size = 0;
+
+            if (share) {
+                share->write_generation++;
+            }
+        }
+
+        void apply_pending_pos() {
+            if (pending_pos.has_value()) {
+                fseek(file, static_cast<long>(pending_pos.value()), SEEK_SET);
+                pending_pos.reset();
+            }
+        }
+
+        void flush_pending_write() {
+            if (write_dirty) {
+                fflush(file);
+                write_dirty = false;
+            }
         }
 
         size_t write_file(const void *data, uint32_t size, uint32_t count) override {
             WARN_CLOSE
 
-            return fwrite(data, size, count, file) * size;
+            apply_pending_pos();
+
+            const std::size_t written = fwrite(data, size, count, file) * size;
+
+            if (share && (share.use_count() > 1)) {
+                // Other handles read the host file directly, they must see this data
+                fflush(file);
+            } else {
+                write_dirty = true;
+            }
+
+            notify_write();
+            return written;
         }
 
         size_t read_file(void *data, uint32_t size, uint32_t count) override {
             WARN_CLOSE
 
+            apply_pending_pos();
             return fread(data, size, count, file) * size;
         }
 
+#if EKA2L1_PLATFORM(POSIX)
+        std::size_t read_host_at(const std::uint64_t offset, void *data, const std::uint32_t size) {
+            const ssize_t result = pread(fileno(file), data, size, static_cast<off_t>(offset));
+            return (result < 0) ? 0 : static_cast<std::size_t>(result);
+        }
+
+        std::size_t read_file_at(const std::uint64_t offset, void *data, const std::uint32_t size) override {
+            WARN_CLOSE
+
+            // Data written through stdio may still be in its buffer
+            flush_pending_write();
+
+            std::size_t total_read = 0;
+
+            if (share && (readahead_generation != share->write_generation.load())) {
+                readahead_size = 0;
+            }
+
+            if ((offset >= readahead_offset) && (offset < readahead_offset + readahead_size)) {
+                const std::uint32_t in_window = static_cast<std::uint32_t>(common::min<std::uint64_t>(
+                    readahead_offset + readahead_size - offset, size));
+
+                std::memcpy(data, readahead_buf.data() + (offset - readahead_offset), in_window);
+                total_read = in_window;
+            }
+
+            if (total_read < size) {
+                const std::uint64_t left_offset = offset + total_read;
+                const std::uint32_t left_size = static_cast<std::uint32_t>(size - total_read);
+
+                std::uint8_t *left_dest = reinterpret_cast<std::uint8_t *>(data) + total_read;
+
+                if (left_size >= READAHEAD_WINDOW_SIZE) {
+                    // Big reads go straight to the destination
+                    total_read += read_host_at(left_offset, left_dest, left_size);
+                } else {
+                    readahead_buf.resize(READAHEAD_WINDOW_SIZE);
+
+                    readahead_offset = left_offset;
+                    readahead_generation = share ? share->write_generation.load() : 0;
+                    readahead_size = static_cast<std::uint32_t>(read_host_at(left_offset, readahead_buf.data(),
+                        READAHEAD_WINDOW_SIZE));
+
+                    const std::uint32_t to_copy = common::min<std::uint32_t>(left_size, readahead_size);
+                    std::memcpy(left_dest, readahead_buf.data(), to_copy);
+
+                    total_read += to_copy;
+                }
+            }
+
+            pending_pos = offset + total_read;
+            return total_read;
+        }
+#endif
+
         std::uint64_t size() const override {
             WARN_CLOSE
 
+#if EKA2L1_PLATFORM(POSIX)
+            if (write_dirty) {
+                fflush(file);
+            }
+
+            struct stat file_stat;
+            if (fstat(fileno(file), &file_stat) == 0) {
+                return static_cast<std::uint64_t>(file_stat.st_size);
+            }
+#endif
+
             auto crr_pos = ftell(file);
             fseek(file, 0, SEEK_END);
 
@@ -380,6 +551,7 @@ namespace eka2l1 {
 
             fclose(file);
             closed = true;
+            share.reset();
 
             return true;
         }
@@ -387,6 +559,10 @@ namespace eka2l1 {
         uint64_t tell() override {
             WARN_CLOSE
 
+            if (pending_pos.has_value()) {
+                return pending_pos.value();
+            }
+
             return ftell(file);
         }
 
@@ -397,6 +573,8 @@ namespace eka2l1 {
                 return 0xFFFFFFFFFFFFFFFF;
             }
 
+            apply_pending_pos();
+
             if (where == file_seek_mode::beg) {
                 if (seek_off < 0) {
                     LOG_ERROR(VFS, "Attempting to seek set with negative offset ({})", seek_off);
@@ -429,6 +607,7 @@ namespace eka2l1 {
                 return true;
             }
 
+            write_dirty = false;
             return (fflush(file) == 0);
         }
 
@@ -441,7 +620,11 @@ namespace eka2l1 {
             const std::uint64_t saved_pos = tell();
             fclose(file);
 
+            pending_pos.reset();
+            write_dirty = false;
+
             int err_code = common::resize(common::ucs2_to_utf8(physical_path), new_size);
+            notify_write();
 
             // Reopen the file again...
 #if EKA2L1_PLATFORM(WIN32)
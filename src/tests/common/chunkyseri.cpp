@@ -121,3 +121,29 @@ TEST_CASE("do_read_with_section", "chunkyseri") {
     REQUIRE(t2 == 7);
     REQUIRE(t3 == "HIPEOPL");
 }
+
+TEST_CASE("do_read_corrupted_count", "chunkyseri") {
+    // Counts far bigger than the data that follows them
+    const std::uint8_t test_data[] = { 0xFF, 0xFF, 0xFF, 0x7F, 1, 0, 0, 0, 2, 0, 0, 0 };
+    std::vector<std::uint8_t> test_data_vec(test_data, test_data + sizeof(test_data));
+
+    common::chunkyseri seri(test_data_vec.data(), test_data_vec.size(), common::SERI_MODE_READ);
+
+    REQUIRE(seri.count_fits(3, sizeof(std::uint32_t)));
+    REQUIRE_FALSE(seri.count_fits(4, sizeof(std::uint32_t)));
+
+    std::vector<std::uint32_t> numbers;
+    seri.absorb_container(numbers);
+
+    REQUIRE(numbers.empty());
+
+    common::chunkyseri string_seri(test_data_vec.data(), test_data_vec.size(), common::SERI_MODE_READ);
+    std::u16string str = u"LOOL";
+    string_seri.absorb(str);
+
+    REQUIRE(str.empty());
+
+    // Nothing is bounded when not reading
+    common::chunkyseri measure_seri(nullptr, 0, common::SERI_MODE_MEASURE);
+    REQUIRE(measure_seri.count_fits(0xFFFFFFFF, 4));
+}
@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2019 EKA2L1 Team.
+ * 
+ * This file is part of EKA2L1 project.
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <catch2/catch.hpp>
+#include <common/cvt.h>
+
+using namespace eka2l1;
+
+TEST_CASE("ucs2_utf8_ascii_round_trip", "cvt") {
+    const std::string ascii = "C:\\system\\apps\\longappnamethatcrossesseveralchunks\\app.aif";
+    const std::u16string ucs2 = common::utf8_to_ucs2(ascii);
+
+    REQUIRE(ucs2 == u"C:\\system\\apps\\longappnamethatcrossesseveralchunks\\app.aif");
+    REQUIRE(common::ucs2_to_utf8(ucs2) == ascii);
+
+    REQUIRE(common::utf8_to_ucs2("").empty());
+    REQUIRE(common::ucs2_to_utf8(u"").empty());
+}
+
+TEST_CASE("ucs2_utf8_multibyte_round_trip", "cvt") {
+    // ASCII prefix long enough to leave the fast path mid-string, followed by 2, 3 and 4 byte sequences
+    const std::u16string ucs2 = u"abcdefghij\u00e9\u4e2d\u6587 \U0001F600 end";
+    const std::string utf8 = "abcdefghij\xc3\xa9\xe4\xb8\xad\xe6\x96\x87 \xf0\x9f\x98\x80 end";
+
+    REQUIRE(common::ucs2_to_utf8(ucs2) == utf8);
+    REQUIRE(common::utf8_to_ucs2(utf8) == ucs2);
+}
+
+TEST_CASE("ucs2_lone_surrogate_survives_round_trip", "cvt") {
+    const std::u16string ucs2 = { u'a', static_cast<char16_t>(0xD800), u'b', static_cast<char16_t>(0xDC01) };
+    const std::string utf8 = common::ucs2_to_utf8(ucs2);
+
+    REQUIRE(utf8 == "a\xed\xa0\x80" "b\xed\xb0\x81");
+    REQUIRE(common::utf8_to_ucs2(utf8) == ucs2);
+}
+
+TEST_CASE("utf8_invalid_sequence_is_replaced", "cvt") {
+    // Stray continuation byte, overlong encoding, and a truncated sequence at the end
+    const std::string utf8 = "a\x80" "b\xc0\xaf" "c\xe4\xb8";
+    const std::u16string expected = u"a\ufffdb\ufffd\ufffdc\ufffd\ufffd";
+
+    REQUIRE(common::utf8_to_ucs2(utf8) == expected);
+}
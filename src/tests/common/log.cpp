@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) 2019 EKA2L1 Team.
+ * 
+ * This file is part of EKA2L1 project.
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <catch2/catch.hpp>
+#include <common/log.h>
+
+#include <spdlog/sinks/base_sink.h>
+#include <fmt/format.h>
+
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace eka2l1;
+
+class capture_log_sink : public spdlog::sinks::base_sink<std::mutex> {
+public:
+    std::vector<std::string> messages_;
+
+protected:
+    void sink_it_(const spdlog::details::log_msg &msg) override {
+        messages_.emplace_back(msg.payload.data(), msg.payload.size());
+    }
+
+    void flush_() override {
+    }
+};
+
+TEST_CASE("async_log_formats_after_arguments_are_gone", "log") {
+    auto sink = std::make_shared<capture_log_sink>();
+    log::spd_logger->sinks().push_back(sink);
+
+    log::set_async_logging(true);
+
+    for (int i = 0; i < 2000; i++) {
+        // The string is gone before the writer gets to format it
+        std::string transient = "value" + std::to_string(i);
+        LOG_INFO(COMMON, "Message {} {}", i, transient.c_str());
+    }
+
+    std::thread other_thread([]() {
+        LOG_WARN(COMMON, "From another thread");
+    });
+
+    other_thread.join();
+
+    // Pending messages are written before returning
+    log::set_async_logging(false);
+    log::spd_logger->sinks().pop_back();
+
+    REQUIRE(sink->messages_.size() == 2001);
+
+    int next_index = 0;
+    bool found_other = false;
+
+    for (const std::string &message: sink->messages_) {
+        if (message.find("From another thread") != std::string::npos) {
+            found_other = true;
+            continue;
+        }
+
+        const std::string expected = "Message " + std::to_string(next_index) + " value" + std::to_string(next_index);
+        REQUIRE(message.find(expected) != std::string::npos);
+        REQUIRE(message.find("[Common]") != std::string::npos);
+
+        next_index++;
+    }
+
+    REQUIRE(found_other);
+}
+
+TEST_CASE("async_log_disable_keeps_racing_messages", "log") {
+    auto sink = std::make_shared<capture_log_sink>();
+    log::spd_logger->sinks().push_back(sink);
+
+    log::set_async_logging(true);
+
+    std::vector<std::thread> threads;
+
+    for (int i = 0; i < 4; i++) {
+        threads.emplace_back([]() {
+            // Enough to fill the ring, while logging gets switched off under it
+            for (int j = 0; j < 3000; j++) {
+                LOG_INFO(COMMON, "Racing {}", j);
+            }
+        });
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    log::set_async_logging(false);
+
+    for (std::thread &thread: threads) {
+        thread.join();
+    }
+
+    log::spd_logger->sinks().pop_back();
+
+    // Nothing is left stranded in a ring, and nothing spins forever waiting for a stopped writer
+    REQUIRE(sink->messages_.size() == 4 * 3000);
+}
+
+TEST_CASE("async_log_formats_views_right_away", "log") {
+    auto sink = std::make_shared<capture_log_sink>();
+    log::spd_logger->sinks().push_back(sink);
+
+    log::set_async_logging(true);
+
+    {
+        // The join result only refers to the vector, which is gone before the writer runs
+        std::vector<int> values = { 1, 2, 3 };
+        LOG_INFO(COMMON, "Values {}", fmt::join(values, ", "));
+    }
+
+    log::set_async_logging(false);
+    log::spd_logger->sinks().pop_back();
+
+    REQUIRE(sink->messages_.size() == 1);
+    REQUIRE(sink->messages_[0].find("Values 1, 2, 3") != std::string::npos);
+}
+
+struct async_log_counted_arg {
+    static inline int alive_count = 0;
+
+    async_log_counted_arg() {
+        alive_count++;
+    }
+
+    async_log_counted_arg(const async_log_counted_arg &) {
+        alive_count++;
+    }
+
+    ~async_log_counted_arg() {
+        alive_count--;
+    }
+};
+
+template <>
+struct fmt::formatter<async_log_counted_arg> {
+    constexpr auto parse(format_parse_context &ctx) {
+        return ctx.begin();
+    }
+
+    template <typename FormatContext>
+    auto format(const async_log_counted_arg &, FormatContext &ctx) const {
+        return fmt::format_to(ctx.out(), "counted");
+    }
+};
+
+TEST_CASE("async_log_args_destroyed_when_format_fails", "log") {
+    using args_tuple = std::tuple<std::string, async_log_counted_arg>;
+
+    alignas(args_tuple) std::uint8_t storage[sizeof(args_tuple)];
+    new (storage) args_tuple("text", async_log_counted_arg{});
+
+    REQUIRE(async_log_counted_arg::alive_count == 1);
+
+    // A string can't be formatted as an integer
+    std::string message;
+    REQUIRE_THROWS(log::format_and_destroy_async_log_args<args_tuple>(storage, "{:d} {}", message));
+
+    REQUIRE(async_log_counted_arg::alive_count == 0);
+}
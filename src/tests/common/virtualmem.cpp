@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2022 EKA2L1 Team.
+ *
+ * This file is part of EKA2L1 project.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <catch2/catch.hpp>
+#include <common/virtualmem.h>
+
+#include <cstring>
+
+using namespace eka2l1;
+
+TEST_CASE("decommit_releases_host_pages", "virtualmem") {
+    const std::size_t page_size = static_cast<std::size_t>(common::get_host_page_size());
+    const std::size_t region_size = page_size * 16;
+
+    std::uint8_t *region = reinterpret_cast<std::uint8_t *>(common::map_memory(region_size));
+    REQUIRE(region);
+
+    REQUIRE(common::commit(region, region_size, prot_read_write));
+    std::memset(region, 0xAB, region_size);
+
+    REQUIRE(common::get_resident_size(region, region_size) == region_size);
+
+    // Release the second half only
+    REQUIRE(common::decommit(region + region_size / 2, region_size / 2));
+    REQUIRE(common::get_resident_size(region, region_size) == region_size / 2);
+
+    // Recommitted memory reads as zero
+    REQUIRE(common::commit(region + region_size / 2, region_size / 2, prot_read_write));
+    REQUIRE(region[region_size / 2] == 0);
+    REQUIRE(region[0] == 0xAB);
+
+    REQUIRE(common::unmap_memory(region, region_size));
+}
+
+TEST_CASE("host_resident_size_is_known", "virtualmem") {
+    REQUIRE(common::get_host_resident_size() > 0);
+}
@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2022 EKA2L1 Team.
+ *
+ * This file is part of EKA2L1 project.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <catch2/catch.hpp>
+#include <common/platform.h>
+#include <cpu/arm_lockstep.h>
+
+using namespace eka2l1;
+
+static constexpr std::uint32_t LOCKSTEP_TEST_MEM_SIZE = 0x4000;
+static constexpr std::uint32_t LOCKSTEP_TEST_DATA_ADDR = 0x2000;
+
+static const std::uint32_t LOCKSTEP_TEST_CODE[] = {
+    0xe3a00001, // mov r0, #1
+    0xe2801002, // add r1, r0, #2
+    0xe5821000, // str r1, [r2]
+    0xe0813000, // add r3, r1, r0
+    0xe5823004, // str r3, [r2, #4]
+    0xe2522000, // subs r2, r2, #0
+    0xeafffffe // b +#0 (infinite loop)
+};
+
+// Atomically increment the word at r2, r4 times
+static const std::uint32_t LOCKSTEP_TEST_EXCLUSIVE_CODE[] = {
+    0xe1921f9f, // ldrex r1, [r2]
+    0xe2811001, // add r1, r1, #1
+    0xe1823f91, // strex r3, r1, [r2]
+    0xe3530000, // cmp r3, #0
+    0x1afffffa, // bne #0
+    0xe2544001, // subs r4, r4, #1
+    0x1afffff8, // bne #0
+    0xeafffffe // b +#0 (infinite loop)
+};
+
+static constexpr std::uint32_t LOCKSTEP_TEST_EXCLUSIVE_COUNT = 3;
+
+static void prepare_lockstep_runner(arm::lockstep_runner &runner, const std::uint32_t *code = LOCKSTEP_TEST_CODE,
+    const std::uint32_t code_size = sizeof(LOCKSTEP_TEST_CODE)) {
+    runner.write_memory(0, code, code_size);
+
+    arm::core::thread_context ctx{};
+    ctx.cpsr = 0x10;
+    ctx.cpu_registers[2] = LOCKSTEP_TEST_DATA_ADDR;
+    ctx.cpu_registers[4] = LOCKSTEP_TEST_EXCLUSIVE_COUNT;
+    ctx.set_sp(LOCKSTEP_TEST_MEM_SIZE);
+    ctx.set_pc(0);
+
+    runner.load_context(ctx);
+}
+
+TEST_CASE("same_backend_never_diverges", "lockstep") {
+    arm::lockstep_runner runner(arm_emulator_type::dyncom, arm_emulator_type::dyncom, LOCKSTEP_TEST_MEM_SIZE);
+    REQUIRE(runner.is_valid());
+
+    prepare_lockstep_runner(runner);
+
+    REQUIRE(!runner.run(100, 2).has_value());
+    REQUIRE(runner.block_count() >= 6);
+    REQUIRE(runner.subject_core()->get_reg(3) == 4);
+}
+
+TEST_CASE("tampered_register_is_reported", "lockstep") {
+    arm::lockstep_runner runner(arm_emulator_type::dyncom, arm_emulator_type::dyncom, LOCKSTEP_TEST_MEM_SIZE);
+    REQUIRE(runner.is_valid());
+
+    prepare_lockstep_runner(runner);
+
+    REQUIRE(runner.step_block(2));
+
+    // Simulate a miscompiled instruction in the subject
+    runner.subject_core()->set_reg(1, 5);
+
+    REQUIRE(!runner.step_block(1));
+
+    auto divergence = runner.first_divergence();
+
+    REQUIRE(divergence.has_value());
+    REQUIRE(divergence->kind_ == arm::lockstep_divergence_gpr);
+    REQUIRE(divergence->location_ == 1);
+    REQUIRE(divergence->block_index_ == 1);
+    REQUIRE(divergence->reference_value_ == 3);
+    REQUIRE(divergence->subject_value_ == 5);
+}
+
+TEST_CASE("exclusive_loop_never_diverges", "lockstep") {
+    arm::lockstep_runner runner(arm_emulator_type::dyncom, arm_emulator_type::dyncom, LOCKSTEP_TEST_MEM_SIZE);
+    REQUIRE(runner.is_valid());
+
+    prepare_lockstep_runner(runner, LOCKSTEP_TEST_EXCLUSIVE_CODE, sizeof(LOCKSTEP_TEST_EXCLUSIVE_CODE));
+
+    REQUIRE(!runner.run(100, 3).has_value());
+    REQUIRE(runner.subject_core()->get_reg(1) == LOCKSTEP_TEST_EXCLUSIVE_COUNT);
+    REQUIRE(runner.subject_core()->get_reg(3) == 0);
+    REQUIRE(runner.subject_core()->get_reg(4) == 0);
+}
+
+#if !EKA2L1_ARCH(ARM)
+TEST_CASE("dynarmic_matches_dyncom_on_exclusive_loop", "lockstep") {
+    arm::lockstep_runner runner(arm_emulator_type::dyncom, arm_emulator_type::dynarmic, LOCKSTEP_TEST_MEM_SIZE);
+    REQUIRE(runner.is_valid());
+
+    prepare_lockstep_runner(runner, LOCKSTEP_TEST_EXCLUSIVE_CODE, sizeof(LOCKSTEP_TEST_EXCLUSIVE_CODE));
+
+    auto divergence = runner.run(100);
+    INFO((divergence.has_value() ? divergence->to_string() : "No divergence"));
+
+    REQUIRE(!divergence.has_value());
+    REQUIRE(runner.reference_core()->get_reg(1) == LOCKSTEP_TEST_EXCLUSIVE_COUNT);
+}
+
+TEST_CASE("dynarmic_matches_dyncom", "lockstep") {
+    arm::lockstep_runner runner(arm_emulator_type::dyncom, arm_emulator_type::dynarmic, LOCKSTEP_TEST_MEM_SIZE);
+    REQUIRE(runner.is_valid());
+
+    prepare_lockstep_runner(runner);
+
+    auto divergence = runner.run(100);
+    INFO((divergence.has_value() ? divergence->to_string() : "No divergence"));
+
+    REQUIRE(!divergence.has_value());
+}
+#endif
@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2022 EKA2L1 Team.
+ *
+ * This file is part of EKA2L1 project.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <catch2/catch.hpp>
+#include <drivers/graphics/backend/graphics_driver_shared.h>
+#include <drivers/graphics/graphics.h>
+
+using namespace eka2l1;
+
+/**
+ * \brief Shared driver with no backend, so that no object can actually be created.
+ */
+class null_shared_driver : public drivers::shared_graphics_driver {
+public:
+    explicit null_shared_driver()
+        : drivers::shared_graphics_driver(drivers::graphic_api::opengl) {
+    }
+
+    void submit_command_list(drivers::command_list &cmd_list) override {
+        for (std::size_t i = 0; i < cmd_list.size_; i++) {
+            dispatch(cmd_list.base_[i]);
+        }
+
+        delete[] cmd_list.base_;
+    }
+
+    void run() override {}
+    void abort() override {}
+    void bind_swapchain_framebuf() override {}
+    void update_surface(void *surface) override {}
+    void set_upscale_shader(const std::string &name) override {}
+    std::string get_active_upscale_shader() const override {
+        return "";
+    }
+    bool support_extension(const drivers::graphics_driver_extension ext) override {
+        return false;
+    }
+    bool query_extension_value(const drivers::graphics_driver_extension_query query, void *data_ptr) override {
+        return false;
+    }
+};
+
+TEST_CASE("reserve_reuses_released_handles", "graphics_handle_pool") {
+    drivers::graphics_handle_pool pool;
+
+    REQUIRE(pool.reserve() == 1);
+    REQUIRE(pool.reserve() == 2);
+    REQUIRE(pool.reserve() == 3);
+
+    pool.release(2);
+    REQUIRE(pool.reserve() == 2);
+
+    // Next number is only handed out once everything released is taken
+    REQUIRE(pool.reserve() == 4);
+}
+
+TEST_CASE("release_ignores_unreserved_handles", "graphics_handle_pool") {
+    drivers::graphics_handle_pool pool;
+
+    REQUIRE(pool.reserve() == 1);
+
+    pool.release(0);
+    pool.release(5);
+
+    pool.release(1);
+    pool.release(1);
+
+    // Released twice, but must only be handed out once
+    REQUIRE(pool.reserve() == 1);
+    REQUIRE(pool.reserve() == 2);
+}
+
+TEST_CASE("destroy_gives_back_handle_of_failed_creation", "graphics_handle_pool") {
+    null_shared_driver driver;
+
+    // Creation of these never reached the driver, so no slot exists for them
+    const drivers::handle object_handle = driver.reserve_object_handle();
+    const drivers::handle bitmap_handle = driver.reserve_bitmap_handle();
+
+    drivers::graphics_command_builder builder;
+    builder.destroy(object_handle);
+    builder.destroy_bitmap(bitmap_handle);
+
+    drivers::command_list retrieved = builder.retrieve_command_list();
+    driver.submit_command_list(retrieved);
+
+    REQUIRE(driver.reserve_object_handle() == object_handle);
+    REQUIRE(driver.reserve_bitmap_handle() == bitmap_handle);
+}
@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2022 EKA2L1 Team.
+ *
+ * This file is part of EKA2L1 project.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <catch2/catch.hpp>
+#include <drivers/graphics/graphics.h>
+#include <drivers/graphics/readback.h>
+
+#include <cstring>
+#include <thread>
+#include <vector>
+
+using namespace eka2l1;
+
+/**
+ * \brief Software driver that only serves bitmap reads, filling the buffer with the current frame number.
+ *
+ * Commands are held until process() is called, to simulate a busy GPU.
+ */
+class software_readback_driver : public drivers::graphics_driver {
+    std::vector<drivers::command> pending_;
+    std::mutex pending_lock_;
+
+public:
+    std::uint8_t frame_ = 0;
+
+    explicit software_readback_driver()
+        : drivers::graphics_driver(drivers::graphic_api::opengl) {
+    }
+
+    void process() {
+        const std::lock_guard<std::mutex> guard(pending_lock_);
+
+        for (drivers::command &cmd : pending_) {
+            if (cmd.opcode_ == drivers::graphics_driver_read_bitmap) {
+                const std::uint32_t width = static_cast<std::uint32_t>(cmd.data_[2]);
+                const std::uint32_t height = static_cast<std::uint32_t>(cmd.data_[2] >> 32);
+                const std::uint32_t bpp = static_cast<std::uint32_t>(cmd.data_[3]);
+
+                std::memset(reinterpret_cast<std::uint8_t *>(cmd.data_[4]), frame_, width * height * bpp / 8);
+            }
+
+            finish(cmd.status_, 1);
+        }
+
+        pending_.clear();
+    }
+
+    void submit_command_list(drivers::command_list &cmd_list) override {
+        const std::lock_guard<std::mutex> guard(pending_lock_);
+
+        for (std::size_t i = 0; i < cmd_list.size_; i++) {
+            pending_.push_back(cmd_list.base_[i]);
+        }
+
+        delete[] cmd_list.base_;
+    }
+
+    void run() override {}
+    void abort() override {}
+    void update_bitmap(drivers::handle h, const std::size_t size, const eka2l1::vec2 &offset, const eka2l1::vec2 &dim,
+        const void *data, const std::size_t pixels_per_line = 0) override {}
+    void set_viewport(const eka2l1::rect &viewport) override {}
+    void update_surface(void *surface) override {}
+    void set_upscale_shader(const std::string &name) override {}
+    std::string get_active_upscale_shader() const override {
+        return "";
+    }
+    bool support_extension(const drivers::graphics_driver_extension ext) override {
+        return false;
+    }
+    bool query_extension_value(const drivers::graphics_driver_extension_query query, void *data_ptr) override {
+        return false;
+    }
+};
+
+static constexpr std::size_t READBACK_TEST_SIZE = 4 * 4 * 4;
+
+TEST_CASE("readback_does_not_wait_for_driver", "readback") {
+    software_readback_driver driver;
+    drivers::bitmap_readback_pipeline pipeline;
+
+    std::vector<std::uint8_t> dest(READBACK_TEST_SIZE, 0xFF);
+
+    driver.frame_ = 1;
+    pipeline.queue(&driver, 1, eka2l1::object_size(4, 4), 32, READBACK_TEST_SIZE);
+
+    // Nothing has been processed yet, the destination must be left alone
+    REQUIRE(!pipeline.resolve(dest.data(), dest.size()));
+    REQUIRE(dest[0] == 0xFF);
+
+    driver.process();
+
+    REQUIRE(pipeline.resolve(dest.data(), dest.size()));
+    REQUIRE(dest[0] == 1);
+
+    // Already resolved
+    REQUIRE(!pipeline.resolve(dest.data(), dest.size()));
+}
+
+TEST_CASE("readback_takes_newest_completed_frame", "readback") {
+    software_readback_driver driver;
+    drivers::bitmap_readback_pipeline pipeline;
+
+    std::vector<std::uint8_t> dest(READBACK_TEST_SIZE, 0);
+
+    driver.frame_ = 2;
+    pipeline.queue(&driver, 1, eka2l1::object_size(4, 4), 32, READBACK_TEST_SIZE);
+    pipeline.queue(&driver, 1, eka2l1::object_size(4, 4), 32, READBACK_TEST_SIZE);
+    driver.process();
+
+    driver.frame_ = 3;
+
+    // Both staging buffers are done. A third frame reuses the oldest one without waiting.
+    pipeline.queue(&driver, 1, eka2l1::object_size(4, 4), 32, READBACK_TEST_SIZE);
+
+    REQUIRE(pipeline.resolve(dest.data(), dest.size()));
+    REQUIRE(dest[0] == 2);
+
+    std::thread completer([&]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        driver.process();
+    });
+
+    REQUIRE(pipeline.resolve(dest.data(), dest.size(), true));
+    REQUIRE(dest[0] == 3);
+
+    completer.join();
+}
+
+TEST_CASE("readback_discards_mismatched_size", "readback") {
+    software_readback_driver driver;
+    drivers::bitmap_readback_pipeline pipeline;
+
+    std::vector<std::uint8_t> dest(READBACK_TEST_SIZE * 2, 0);
+
+    driver.frame_ = 4;
+    pipeline.queue(&driver, 1, eka2l1::object_size(4, 4), 32, READBACK_TEST_SIZE);
+    driver.process();
+
+    REQUIRE(!pipeline.resolve(dest.data(), dest.size()));
+    REQUIRE(dest[0] == 0);
+}
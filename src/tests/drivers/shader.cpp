@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2022 EKA2L1 Team.
+ *
+ * This file is part of EKA2L1 project.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <catch2/catch.hpp>
+#include <drivers/graphics/shader.h>
+
+#include <string>
+
+using namespace eka2l1;
+
+static std::string strip_precision(const std::string &source) {
+    std::string result;
+    drivers::append_glsl_without_precision_qualifiers(result, source);
+
+    return result;
+}
+
+TEST_CASE("glsl_strip_precision_statements_and_qualifiers", "shader") {
+    REQUIRE(strip_precision("precision mediump float;\nuniform highp vec4 color;\n") == "\nuniform  vec4 color;\n");
+    REQUIRE(strip_precision("varying lowp vec2 uv;") == "varying  vec2 uv;");
+
+    // Identifiers that only contain a qualifier are kept
+    REQUIRE(strip_precision("float highpass;") == "float highpass;");
+}
+
+TEST_CASE("glsl_strip_precision_leaves_comments_alone", "shader") {
+    REQUIRE(strip_precision("// precision mediump float\nuniform vec4 color;\n") == "// precision mediump float\nuniform vec4 color;\n");
+    REQUIRE(strip_precision("/* precision highp float */ varying vec2 uv;\n") == "/* precision highp float */ varying vec2 uv;\n");
+}
+
+TEST_CASE("glsl_strip_precision_leaves_preprocessor_lines_alone", "shader") {
+    const std::string source = "#ifdef GL_FRAGMENT_PRECISION_HIGH\n#extension GL_OES_standard_derivatives : enable\n#endif\n";
+    REQUIRE(strip_precision(source) == source);
+}
+
+TEST_CASE("glsl_strip_precision_inside_define_bodies", "shader") {
+    REQUIRE(strip_precision("#ifdef GL_ES\n#define P mediump \\\n  highp\n#endif\nvarying P vec2 uv;\n")
+        == "#ifdef GL_ES\n#define P  \\\n  \n#endif\nvarying P vec2 uv;\n");
+    REQUIRE(strip_precision("#define TEX(s, uv) texture2D(s, uv) /* lowp */ * lowp vec4(1.0)\n")
+        == "#define TEX(s, uv) texture2D(s, uv) /* lowp */ *  vec4(1.0)\n");
+
+    // Desktop shims that define the qualifiers away keep their macro names
+    REQUIRE(strip_precision("#define highp\n#define lowp // empty\n") == "#define highp\n#define lowp // empty\n");
+}
+
+TEST_CASE("shader_var_type_size_keeps_uniform_batch_aligned", "shader") {
+    REQUIRE(drivers::get_shader_var_type_size(drivers::shader_var_type::real) == 4);
+    REQUIRE(drivers::get_shader_var_type_size(drivers::shader_var_type::boolean) == 4);
+    REQUIRE(drivers::get_shader_var_type_size(drivers::shader_var_type::sampler2d) == 4);
+    REQUIRE(drivers::get_shader_var_type_size(drivers::shader_var_type::ivec3) == 12);
+    REQUIRE(drivers::get_shader_var_type_size(drivers::shader_var_type::mat2) == 16);
+    REQUIRE(drivers::get_shader_var_type_size(drivers::shader_var_type::mat3) == 36);
+    REQUIRE(drivers::get_shader_var_type_size(drivers::shader_var_type::mat4) == 64);
+    REQUIRE(drivers::get_shader_var_type_size(drivers::shader_var_type::none) == 0);
+
+    // Data follows each header, so the next header is only aligned if both are multiples of 4 bytes
+    REQUIRE(sizeof(drivers::uniform_batch_entry) % 4 == 0);
+
+    for (int type = static_cast<int>(drivers::shader_var_type::none); type <= static_cast<int>(drivers::shader_var_type::mat4); type++) {
+        REQUIRE(drivers::get_shader_var_type_size(static_cast<drivers::shader_var_type>(type)) % 4 == 0);
+    }
+}
@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2022 EKA2L1 Team.
+ *
+ * This file is part of EKA2L1 project.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <catch2/catch.hpp>
+#include <drivers/graphics/uniform_arena.h>
+
+#include <cstring>
+#include <vector>
+
+using namespace eka2l1;
+
+static drivers::uniform_batch_entry read_batch_entry(const std::vector<std::uint8_t> &batch, const std::size_t offset) {
+    drivers::uniform_batch_entry entry;
+    std::memcpy(&entry, batch.data() + offset, sizeof(drivers::uniform_batch_entry));
+
+    return entry;
+}
+
+TEST_CASE("uniform_arena_lays_out_variables_in_order", "uniform_arena") {
+    drivers::uniform_arena arena;
+    arena.add_variable(3, drivers::shader_var_type::vec4, 1);
+    arena.add_variable(0, drivers::shader_var_type::mat4, 2);
+    arena.add_variable(-1, drivers::shader_var_type::vec2, 1);
+    arena.add_variable(5, drivers::shader_var_type::real, 0);
+
+    REQUIRE(arena.size() == 16 + 128 + 4);
+
+    const drivers::uniform_arena_variable *color = arena.get_variable(3);
+    REQUIRE(color);
+    REQUIRE(color->offset_ == 0);
+    REQUIRE(color->capacity_ == 16);
+
+    const drivers::uniform_arena_variable *bones = arena.get_variable(0);
+    REQUIRE(bones);
+    REQUIRE(bones->offset_ == 16);
+    REQUIRE(bones->capacity_ == 128);
+    REQUIRE(bones->array_size_ == 2);
+
+    // An array size of 0 still holds one value
+    const drivers::uniform_arena_variable *scale = arena.get_variable(5);
+    REQUIRE(scale);
+    REQUIRE(scale->offset_ == 144);
+    REQUIRE(scale->array_size_ == 1);
+
+    REQUIRE(!arena.get_variable(-1));
+    REQUIRE(!arena.get_variable(1));
+    REQUIRE(!arena.get_variable(6));
+
+    arena.clear();
+
+    REQUIRE(arena.size() == 0);
+    REQUIRE(!arena.get_variable(3));
+}
+
+TEST_CASE("uniform_arena_packs_only_dirty_variables", "uniform_arena") {
+    drivers::uniform_arena arena;
+    arena.add_variable(2, drivers::shader_var_type::vec2, 1);
+    arena.add_variable(7, drivers::shader_var_type::mat2, 1);
+    arena.add_variable(4, drivers::shader_var_type::real, 1);
+
+    std::vector<std::uint8_t> batch = { 0xCD };
+    REQUIRE(!arena.pack_dirty(batch));
+    REQUIRE(batch.size() == 1);
+
+    const float matrix[4] = { 1.0f, 2.0f, 3.0f, 4.0f };
+    const float position[2] = { 5.0f, 6.0f };
+
+    REQUIRE(arena.write(7, reinterpret_cast<const std::uint8_t *>(matrix), sizeof(matrix), drivers::shader_var_type::mat2,
+        drivers::uniform_batch_entry_flag_transpose));
+    REQUIRE(arena.write(2, reinterpret_cast<const std::uint8_t *>(position), sizeof(position), drivers::shader_var_type::vec2, 0));
+    REQUIRE(!arena.write(3, reinterpret_cast<const std::uint8_t *>(position), sizeof(position), drivers::shader_var_type::vec2, 0));
+    REQUIRE(arena.any_dirty());
+
+    REQUIRE(arena.pack_dirty(batch));
+    REQUIRE(batch.size() == (sizeof(drivers::uniform_batch_entry) * 2 + sizeof(position) + sizeof(matrix)));
+
+    // Variables come in the order they were added, not the order they were set
+    const drivers::uniform_batch_entry first = read_batch_entry(batch, 0);
+    REQUIRE(first.binding_ == 2);
+    REQUIRE(first.var_type_ == static_cast<std::uint16_t>(drivers::shader_var_type::vec2));
+    REQUIRE(first.flags_ == 0);
+    REQUIRE(first.size_ == sizeof(position));
+    REQUIRE(std::memcmp(batch.data() + sizeof(drivers::uniform_batch_entry), position, sizeof(position)) == 0);
+
+    const std::size_t second_offset = sizeof(drivers::uniform_batch_entry) + sizeof(position);
+    const drivers::uniform_batch_entry second = read_batch_entry(batch, second_offset);
+    REQUIRE(second.binding_ == 7);
+    REQUIRE(second.var_type_ == static_cast<std::uint16_t>(drivers::shader_var_type::mat2));
+    REQUIRE(second.flags_ == drivers::uniform_batch_entry_flag_transpose);
+    REQUIRE(second.size_ == sizeof(matrix));
+    REQUIRE(std::memcmp(batch.data() + second_offset + sizeof(drivers::uniform_batch_entry), matrix, sizeof(matrix)) == 0);
+
+    REQUIRE(!arena.any_dirty());
+    REQUIRE(!arena.pack_dirty(batch));
+}
+
+TEST_CASE("uniform_arena_clamps_writes_to_capacity", "uniform_arena") {
+    drivers::uniform_arena arena;
+    arena.add_variable(0, drivers::shader_var_type::vec3, 2);
+    arena.add_variable(1, drivers::shader_var_type::real, 1);
+
+    const float values[9] = { 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f, 9.0f };
+    REQUIRE(arena.write(0, reinterpret_cast<const std::uint8_t *>(values), sizeof(values), drivers::shader_var_type::vec3, 0));
+
+    std::vector<std::uint8_t> batch;
+    REQUIRE(arena.pack_dirty(batch));
+
+    // Values past the end of the array don't spill into the next variable
+    REQUIRE(read_batch_entry(batch, 0).size_ == 24);
+    REQUIRE(batch.size() == sizeof(drivers::uniform_batch_entry) + 24);
+    REQUIRE(std::memcmp(batch.data() + sizeof(drivers::uniform_batch_entry), values, 24) == 0);
+}
+
+TEST_CASE("uniform_arena_tracks_dirty_bits_past_one_word", "uniform_arena") {
+    drivers::uniform_arena arena;
+
+    for (std::int32_t i = 0; i < 70; i++) {
+        arena.add_variable(i, drivers::shader_var_type::integer, 1);
+    }
+
+    const std::int32_t value = 42;
+    REQUIRE(arena.write(66, reinterpret_cast<const std::uint8_t *>(&value), sizeof(value), drivers::shader_var_type::integer, 0));
+    REQUIRE(arena.write(1, reinterpret_cast<const std::uint8_t *>(&value), sizeof(value), drivers::shader_var_type::integer, 0));
+
+    std::vector<std::uint8_t> batch;
+    REQUIRE(arena.pack_dirty(batch));
+    REQUIRE(batch.size() == (sizeof(drivers::uniform_batch_entry) + sizeof(value)) * 2);
+
+    REQUIRE(read_batch_entry(batch, 0).binding_ == 1);
+    REQUIRE(read_batch_entry(batch, sizeof(drivers::uniform_batch_entry) + sizeof(value)).binding_ == 66);
+}
@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2022 EKA2L1 Team.
+ *
+ * This file is part of EKA2L1 project.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <catch2/catch.hpp>
+#include <drivers/graphics/yuv.h>
+
+#include <vector>
+
+using namespace eka2l1;
+
+TEST_CASE("yuv420p_buffer_size_rounds_chroma_up", "yuv") {
+    REQUIRE(drivers::get_yuv420p_buffer_size(eka2l1::vec2(4, 2)) == 8 + 2 * 2);
+    REQUIRE(drivers::get_yuv420p_buffer_size(eka2l1::vec2(3, 3)) == 9 + 2 * 4);
+}
+
+TEST_CASE("yuv420p_to_rgba_limited_range", "yuv") {
+    const eka2l1::vec2 size(3, 3);
+    std::vector<std::uint8_t> source(drivers::get_yuv420p_buffer_size(size), 128);
+
+    // Black and white, then a pixel that will be tinted blue
+    source[0] = 16;
+    source[1] = 235;
+    source[2] = 81;
+
+    // Second row: luma below and above the limited range
+    source[3] = 0;
+    source[4] = 255;
+
+    // Second chroma column has maximum blue difference
+    source[9 + 1] = 240;
+
+    std::vector<std::uint8_t> dest(size.x * size.y * 4);
+    drivers::convert_yuv420p_to_rgba(dest.data(), source.data(), size);
+
+    REQUIRE(dest[0] == 0);
+    REQUIRE(dest[1] == 0);
+    REQUIRE(dest[2] == 0);
+    REQUIRE(dest[3] == 255);
+
+    REQUIRE(dest[4] == 255);
+    REQUIRE(dest[5] == 255);
+    REQUIRE(dest[6] == 255);
+
+    // Third pixel uses the second chroma sample, blue saturates
+    REQUIRE(dest[8] == 76);
+    REQUIRE(dest[9] == 32);
+    REQUIRE(dest[10] == 255);
+
+    // Row 1 shares chroma row 0, and values are clamped
+    REQUIRE(dest[3 * 4] == 0);
+    REQUIRE(dest[4 * 4] == 255);
+    REQUIRE(dest[4 * 4 + 2] == 255);
+}
@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2022 EKA2L1 Team.
+ *
+ * This file is part of EKA2L1 project.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <catch2/catch.hpp>
+#include <common/algorithm.h>
+#include <common/cvt.h>
+#include <common/fileutils.h>
+#include <config/config.h>
+#include <cpu/arm_factory.h>
+#include <kernel/kernel.h>
+#include <kernel/libmanager.h>
+#include <kernel/timing.h>
+#include <vfs/vfs.h>
+
+#include <fstream>
+
+using namespace eka2l1;
+
+static constexpr const char16_t *LIBMANAGER_TEST_DRIVE_PATH = u"libmanager_test_drive_c";
+
+/**
+ * \brief Library manager over an IO with only drive C mounted to an empty folder.
+ */
+struct libmanager_test_env {
+    io_system io_;
+    config::state conf_;
+    ntimer timing_;
+    arm::exclusive_monitor_instance monitor_;
+    arm::core_instance cpu_;
+    std::unique_ptr<kernel_system> kern_;
+    std::unique_ptr<hle::lib_manager> mngr_;
+
+    explicit libmanager_test_env()
+        : timing_(DEFAULT_EMULATED_CPU_HZ)
+        , monitor_(arm::create_exclusive_monitor(arm_emulator_type::dyncom, 1))
+        , cpu_(arm::create_core(monitor_.get(), arm_emulator_type::dyncom)) {
+        common::delete_folder(common::ucs2_to_utf8(LIBMANAGER_TEST_DRIVE_PATH));
+        common::create_directories(common::ucs2_to_utf8(LIBMANAGER_TEST_DRIVE_PATH) + "/sys/bin");
+        common::create_directories(common::ucs2_to_utf8(LIBMANAGER_TEST_DRIVE_PATH) + "/data");
+
+        file_system_inst physical_fs = create_physical_filesystem(epocver::epoc94, "");
+        io_.add_filesystem(physical_fs);
+        io_.mount_physical_path(drive_c, drive_media::physical, io_attrib_internal, LIBMANAGER_TEST_DRIVE_PATH);
+
+        kern_ = std::make_unique<kernel_system>(nullptr, &timing_, &io_, &conf_, nullptr, nullptr, cpu_.get(), nullptr);
+        mngr_ = std::make_unique<hle::lib_manager>(kern_.get(), &io_, nullptr);
+    }
+
+    ~libmanager_test_env() {
+        mngr_.reset();
+        kern_.reset();
+
+        common::delete_folder(common::ucs2_to_utf8(LIBMANAGER_TEST_DRIVE_PATH));
+    }
+
+    void create_host_file(const char *relative_path) {
+        std::ofstream stream(common::ucs2_to_utf8(LIBMANAGER_TEST_DRIVE_PATH) + "/" + relative_path);
+        stream << "dll";
+    }
+};
+
+TEST_CASE("dll_index_invalidated_by_changed_path", "libmanager") {
+    libmanager_test_env env;
+    hle::lib_manager *mngr = env.mngr_.get();
+
+    // The miss is cached as well
+    REQUIRE(mngr->find_library_candidates(u"euser.dll").empty());
+    env.create_host_file("sys/bin/euser.dll");
+    REQUIRE(mngr->find_library_candidates(u"euser.dll").empty());
+
+    // Changes elsewhere keep the listing
+    mngr->invalidate_dll_index(u"C:\\Data\\notes.txt");
+    REQUIRE(mngr->find_library_candidates(u"euser.dll").empty());
+
+    mngr->invalidate_dll_index(u"C:\\Sys\\Bin\\EUSER.DLL");
+    const std::vector<std::u16string> candidates = mngr->find_library_candidates(u"euser.dll");
+
+    REQUIRE(candidates.size() == 1);
+    REQUIRE(common::compare_ignore_case(candidates[0], u"C:\\Sys\\Bin\\euser.dll") == 0);
+}
+
+TEST_CASE("dll_index_invalidated_by_changed_parent_directory", "libmanager") {
+    libmanager_test_env env;
+    hle::lib_manager *mngr = env.mngr_.get();
+
+    REQUIRE(mngr->find_library_candidates(u"estor.dll").empty());
+    env.create_host_file("sys/bin/estor.dll");
+
+    // Renaming or deleting a parent directory changes everything under it
+    mngr->invalidate_dll_index(u"C:\\Sys");
+    REQUIRE(mngr->find_library_candidates(u"estor.dll").size() == 1);
+}
+
+TEST_CASE("dll_index_full_invalidation", "libmanager") {
+    libmanager_test_env env;
+    hle::lib_manager *mngr = env.mngr_.get();
+
+    REQUIRE(mngr->find_library_candidates(u"efsrv.dll").empty());
+    env.create_host_file("sys/bin/efsrv.dll");
+
+    mngr->invalidate_dll_index();
+    REQUIRE(mngr->find_library_candidates(u"efsrv.dll").size() == 1);
+}
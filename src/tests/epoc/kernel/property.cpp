@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2022 EKA2L1 Team.
+ *
+ * This file is part of EKA2L1 project.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <catch2/catch.hpp>
+#include <config/config.h>
+#include <cpu/arm_factory.h>
+#include <kernel/kernel.h>
+#include <kernel/property.h>
+#include <kernel/timing.h>
+
+using namespace eka2l1;
+
+/**
+ * \brief Kernel with only a timer, a config and an interpreter CPU, enough to create and destroy objects.
+ */
+struct property_test_kernel {
+    config::state conf_;
+    ntimer timing_;
+    arm::exclusive_monitor_instance monitor_;
+    arm::core_instance cpu_;
+    std::unique_ptr<kernel_system> kern_;
+
+    explicit property_test_kernel()
+        : timing_(DEFAULT_EMULATED_CPU_HZ)
+        , monitor_(arm::create_exclusive_monitor(arm_emulator_type::dyncom, 1))
+        , cpu_(arm::create_core(monitor_.get(), arm_emulator_type::dyncom)) {
+        kern_ = std::make_unique<kernel_system>(nullptr, &timing_, nullptr, &conf_, nullptr, nullptr, cpu_.get(), nullptr);
+    }
+};
+
+TEST_CASE("property_lookup_by_category_and_key", "property") {
+    property_test_kernel test_kern;
+    kernel_system *kern = test_kern.kern_.get();
+
+    property_ptr first = kern->create_prop(0x101F75B6, 1);
+    property_ptr second = kern->create_prop(0x101F75B6, 2);
+    property_ptr other_category = kern->create_prop(0x1000A82B, 1);
+
+    REQUIRE(kern->get_prop(0x101F75B6, 1) == first);
+    REQUIRE(kern->get_prop(0x101F75B6, 2) == second);
+    REQUIRE(kern->get_prop(0x1000A82B, 1) == other_category);
+    REQUIRE(kern->get_prop(0x101F75B6, 3) == nullptr);
+
+    // Negative categories and keys don't collide with others
+    property_ptr negative = kern->create_prop(-1, -1);
+    REQUIRE(kern->get_prop(-1, -1) == negative);
+    REQUIRE(kern->get_prop(-1, 1) == nullptr);
+
+    REQUIRE(kern->delete_prop(0x101F75B6, 1));
+    REQUIRE(kern->get_prop(0x101F75B6, 1) == nullptr);
+    REQUIRE_FALSE(kern->delete_prop(0x101F75B6, 1));
+    REQUIRE(kern->get_prop(0x101F75B6, 2) == second);
+}
+
+TEST_CASE("property_duplicate_first_created_wins", "property") {
+    property_test_kernel test_kern;
+    kernel_system *kern = test_kern.kern_.get();
+
+    property_ptr first = kern->create_prop(0x10205054, 7);
+    property_ptr second = kern->create_prop(0x10205054, 7);
+    property_ptr third = kern->create_prop(0x10205054, 7);
+
+    REQUIRE(first != second);
+    REQUIRE(kern->get_prop(0x10205054, 7) == first);
+
+    // Destroying a duplicate that is not looked up keeps the first one
+    REQUIRE(kern->destroy(second));
+    REQUIRE(kern->get_prop(0x10205054, 7) == first);
+
+    // The next one in creation order takes over
+    REQUIRE(kern->delete_prop(0x10205054, 7));
+    REQUIRE(kern->get_prop(0x10205054, 7) == third);
+
+    REQUIRE(kern->delete_prop(0x10205054, 7));
+    REQUIRE(kern->get_prop(0x10205054, 7) == nullptr);
+}
+
+TEST_CASE("property_small_binary_value_inline", "property") {
+    property_test_kernel test_kern;
+    kernel_system *kern = test_kern.kern_.get();
+
+    property_ptr prop = kern->create_prop(0x10205054, 8);
+    prop->define(service::property_type::bin_data, 0);
+
+    std::uint8_t small_data[] = { 1, 2, 3, 4 };
+    REQUIRE(prop->set(small_data, sizeof(small_data)));
+    REQUIRE(prop->get_bin() == std::vector<std::uint8_t>(small_data, small_data + sizeof(small_data)));
+
+    // Growing past the inline buffer keeps the value intact
+    std::vector<std::uint8_t> large_data(service::property::INLINE_DATA_SIZE * 4);
+
+    for (std::size_t i = 0; i < large_data.size(); i++) {
+        large_data[i] = static_cast<std::uint8_t>(i);
+    }
+
+    REQUIRE(prop->set(large_data.data(), static_cast<std::uint32_t>(large_data.size())));
+    REQUIRE(prop->get_bin() == large_data);
+    REQUIRE(std::equal(large_data.begin(), large_data.end(), prop->get_bin_ptr()));
+
+    REQUIRE(prop->set(small_data, sizeof(small_data)));
+    REQUIRE(prop->get_bin() == std::vector<std::uint8_t>(small_data, small_data + sizeof(small_data)));
+}
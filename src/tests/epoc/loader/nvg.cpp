@@ -0,0 +1,266 @@
+/*
+ * Copyright (c) 2019 EKA2L1 Team.
+ * 
+ * This file is part of EKA2L1 project.
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <catch2/catch.hpp>
+#include <loader/nvg.h>
+#include <loader/vector_raster.h>
+
+#include <common/buffer.h>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+using namespace eka2l1;
+
+static std::uint32_t get_raster_pixel(const std::vector<std::uint32_t> &pixels, const int width, const int x, const int y) {
+    return pixels[y * width + x];
+}
+
+TEST_CASE("fill_rectangle_solid", "vector_raster") {
+    std::vector<std::uint32_t> pixels(16 * 16, 0);
+    loader::vector_raster raster(reinterpret_cast<std::uint8_t *>(pixels.data()), 16, 16, 16 * 4);
+
+    loader::raster_path path;
+    path.move_to(2.0f, 2.0f);
+    path.line_to(10.0f, 2.0f);
+    path.line_to(10.0f, 10.0f);
+    path.line_to(2.0f, 10.0f);
+    path.close();
+
+    loader::raster_paint paint;
+    paint.color_[0] = 1.0f;
+
+    raster.fill(path, paint);
+
+    REQUIRE(get_raster_pixel(pixels, 16, 5, 5) == 0xFFFF0000);
+    REQUIRE(get_raster_pixel(pixels, 16, 2, 9) == 0xFFFF0000);
+    REQUIRE(get_raster_pixel(pixels, 16, 1, 5) == 0);
+    REQUIRE(get_raster_pixel(pixels, 16, 10, 5) == 0);
+    REQUIRE(get_raster_pixel(pixels, 16, 12, 12) == 0);
+}
+
+TEST_CASE("fill_half_covered_pixel_and_even_odd", "vector_raster") {
+    std::vector<std::uint32_t> pixels(16 * 16, 0);
+    loader::vector_raster raster(reinterpret_cast<std::uint8_t *>(pixels.data()), 16, 16, 16 * 4);
+
+    // Two squares inside each other, same direction
+    loader::raster_path path;
+    path.move_to(0.0f, 0.0f);
+    path.line_to(12.5f, 0.0f);
+    path.line_to(12.5f, 12.0f);
+    path.line_to(0.0f, 12.0f);
+    path.close();
+    path.move_to(4.0f, 4.0f);
+    path.line_to(8.0f, 4.0f);
+    path.line_to(8.0f, 8.0f);
+    path.line_to(4.0f, 8.0f);
+    path.close();
+
+    loader::raster_paint paint;
+    paint.color_[2] = 1.0f;
+
+    raster.fill(path, paint, loader::raster_fill_rule_even_odd);
+
+    REQUIRE(get_raster_pixel(pixels, 16, 1, 1) == 0xFF0000FF);
+    REQUIRE(get_raster_pixel(pixels, 16, 6, 6) == 0);
+
+    // Half of the pixel is covered, premultiplied
+    const std::uint32_t edge = get_raster_pixel(pixels, 16, 12, 1);
+    REQUIRE(((edge >> 24) & 0xFF) >= 0x7E);
+    REQUIRE(((edge >> 24) & 0xFF) <= 0x81);
+    REQUIRE((edge & 0xFF) == ((edge >> 24) & 0xFF));
+}
+
+TEST_CASE("linear_gradient_and_stroke", "vector_raster") {
+    std::vector<std::uint32_t> pixels(32 * 8, 0);
+    loader::vector_raster raster(reinterpret_cast<std::uint8_t *>(pixels.data()), 32, 8, 32 * 4);
+
+    loader::raster_path path;
+    path.move_to(0.0f, 0.0f);
+    path.line_to(32.0f, 0.0f);
+    path.line_to(32.0f, 4.0f);
+    path.line_to(0.0f, 4.0f);
+    path.close();
+
+    loader::raster_paint gradient;
+    gradient.type_ = loader::raster_paint_linear_gradient;
+    gradient.points_[0] = 0.0f;
+    gradient.points_[2] = 32.0f;
+    gradient.stops_.push_back({ 0.0f, { 0.0f, 0.0f, 0.0f, 1.0f } });
+    gradient.stops_.push_back({ 1.0f, { 1.0f, 1.0f, 1.0f, 1.0f } });
+
+    raster.fill(path, gradient);
+
+    const std::uint32_t left = get_raster_pixel(pixels, 32, 0, 1) & 0xFF;
+    const std::uint32_t middle = get_raster_pixel(pixels, 32, 16, 1) & 0xFF;
+    const std::uint32_t right = get_raster_pixel(pixels, 32, 31, 1) & 0xFF;
+
+    REQUIRE(left < 0x10);
+    REQUIRE(middle > 0x70);
+    REQUIRE(middle < 0x90);
+    REQUIRE(right > 0xF0);
+
+    // 2 pixels wide horizontal line, centered on y = 6
+    loader::raster_path line;
+    line.move_to(4.0f, 6.0f);
+    line.line_to(28.0f, 6.0f);
+
+    loader::raster_paint stroke_paint;
+    stroke_paint.color_[1] = 1.0f;
+
+    raster.stroke(line, stroke_paint, 2.0f);
+
+    REQUIRE(get_raster_pixel(pixels, 32, 10, 5) == 0xFF00FF00);
+    REQUIRE(get_raster_pixel(pixels, 32, 10, 6) == 0xFF00FF00);
+    REQUIRE(get_raster_pixel(pixels, 32, 10, 7) == 0);
+    REQUIRE(get_raster_pixel(pixels, 32, 2, 6) == 0);
+}
+
+TEST_CASE("stroke_miter_join_and_limit", "vector_raster") {
+    std::vector<std::uint32_t> pixels(32 * 32, 0);
+    loader::vector_raster raster(reinterpret_cast<std::uint8_t *>(pixels.data()), 32, 32, 32 * 4);
+
+    // Right angle corner at (20, 10), 4 pixels wide. The miter fills up the outer corner
+    loader::raster_path corner;
+    corner.move_to(4.0f, 10.0f);
+    corner.line_to(20.0f, 10.0f);
+    corner.line_to(20.0f, 28.0f);
+
+    loader::raster_paint paint;
+    paint.color_[0] = 1.0f;
+
+    raster.stroke(corner, paint, 4.0f);
+
+    REQUIRE(get_raster_pixel(pixels, 32, 21, 8) == 0xFFFF0000);
+    REQUIRE(get_raster_pixel(pixels, 32, 23, 23) == 0);
+
+    // With a limit below sqrt(2), the same corner is beveled
+    raster.clear();
+    raster.stroke(corner, paint, 4.0f, 1.0f);
+
+    REQUIRE(get_raster_pixel(pixels, 32, 21, 8) == 0);
+    REQUIRE(get_raster_pixel(pixels, 32, 19, 9) == 0xFFFF0000);
+}
+
+template <typename T>
+static void write_nvg_value(std::vector<std::uint8_t> &data, const std::size_t offset, const T value) {
+    std::memcpy(data.data() + offset, &value, sizeof(T));
+}
+
+TEST_CASE("reject_non_finite_points", "vector_raster") {
+    std::vector<std::uint32_t> pixels(16 * 16, 0);
+    loader::vector_raster raster(reinterpret_cast<std::uint8_t *>(pixels.data()), 16, 16, 16 * 4);
+
+    loader::raster_path path;
+    path.move_to(2.0f, 2.0f);
+    path.line_to(std::numeric_limits<float>::quiet_NaN(), 2.0f);
+    path.line_to(10.0f, 10.0f);
+    path.line_to(2.0f, 10.0f);
+    path.close();
+
+    REQUIRE_FALSE(path.is_finite());
+
+    loader::raster_paint paint;
+    REQUIRE_FALSE(raster.fill(path, paint));
+    REQUIRE_FALSE(raster.stroke(path, paint, 1.0f));
+
+    // Finite points with an infinite stroke width fail too
+    loader::raster_path square;
+    square.move_to(2.0f, 2.0f);
+    square.line_to(10.0f, 2.0f);
+    square.line_to(10.0f, 10.0f);
+    square.close();
+
+    REQUIRE(square.is_finite());
+    REQUIRE_FALSE(raster.stroke(square, paint, std::numeric_limits<float>::infinity()));
+
+    REQUIRE(std::all_of(pixels.begin(), pixels.end(), [](const std::uint32_t pixel) { return pixel == 0; }));
+}
+
+// Fill a red square on the top left quarter of the viewport
+static std::vector<std::uint8_t> make_nvg_square_file(const float *viewport) {
+    std::vector<std::uint8_t> data(100, 0);
+
+    // Header
+    data[0] = 'n';
+    data[1] = 'v';
+    data[2] = 'g';
+    data[3] = 1;
+    write_nvg_value<std::int16_t>(data, 4, 52);
+    write_nvg_value<std::uint16_t>(data, 26, 2);
+
+    std::memcpy(data.data() + 36, viewport, 4 * sizeof(float));
+
+    // Offset vector
+    write_nvg_value<std::uint16_t>(data, 52, 2);
+    write_nvg_value<std::uint16_t>(data, 54, 68);
+    write_nvg_value<std::uint16_t>(data, 56, 76);
+
+    // Commands: set fill paint with full alpha, then fill the path
+    write_nvg_value<std::uint16_t>(data, 58, 2);
+    write_nvg_value<std::uint32_t>(data, 60, (4 << 24) | (0xFF << 16) | 0);
+    write_nvg_value<std::uint32_t>(data, 64, (7 << 24) | 0x20000 | 1);
+
+    // Flat red color
+    write_nvg_value<std::uint32_t>(data, 68, 1);
+    write_nvg_value<std::uint32_t>(data, 72, 0xFF0000FF);
+
+    // Square on the top left quarter, coordinates are in 1/16
+    write_nvg_value<std::uint16_t>(data, 76, 5);
+
+    const std::uint8_t segments[5] = { 2, 4, 4, 4, 0 };
+    std::memcpy(data.data() + 78, segments, sizeof(segments));
+
+    const std::int16_t coords[8] = { 0, 0, 128, 0, 128, 128, 0, 128 };
+    std::memcpy(data.data() + 84, coords, sizeof(coords));
+
+    return data;
+}
+
+TEST_CASE("rasterize_nvg_direct_commands", "nvg") {
+    const float viewport[4] = { 0.0f, 0.0f, 16.0f, 16.0f };
+    std::vector<std::uint8_t> data = make_nvg_square_file(viewport);
+
+    std::vector<std::uint32_t> pixels(32 * 32, 0);
+    std::vector<loader::nvg_convert_error_description> errors;
+
+    common::ro_buf_stream stream(data.data(), data.size());
+    REQUIRE(loader::rasterize_nvg(stream, reinterpret_cast<std::uint8_t *>(pixels.data()), 32, 32, 32 * 4, errors));
+    REQUIRE(errors.empty());
+
+    // Scaled from 16x16 to 32x32
+    REQUIRE(get_raster_pixel(pixels, 32, 2, 2) == 0xFFFF0000);
+    REQUIRE(get_raster_pixel(pixels, 32, 15, 15) == 0xFFFF0000);
+    REQUIRE(get_raster_pixel(pixels, 32, 16, 15) == 0);
+    REQUIRE(get_raster_pixel(pixels, 32, 20, 20) == 0);
+}
+
+TEST_CASE("rasterize_nvg_non_finite_viewport_fails", "nvg") {
+    const float viewport[4] = { 0.0f, 0.0f, std::numeric_limits<float>::quiet_NaN(), 16.0f };
+    std::vector<std::uint8_t> data = make_nvg_square_file(viewport);
+
+    std::vector<std::uint32_t> pixels(32 * 32, 0);
+    std::vector<loader::nvg_convert_error_description> errors;
+
+    common::ro_buf_stream stream(data.data(), data.size());
+    REQUIRE_FALSE(loader::rasterize_nvg(stream, reinterpret_cast<std::uint8_t *>(pixels.data()), 32, 32, 32 * 4, errors));
+    REQUIRE(!errors.empty());
+    REQUIRE(errors.back().reason_ == loader::NVG_NON_FINITE_COORDINATES);
+}
@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2019 EKA2L1 Team.
+ * 
+ * This file is part of EKA2L1 project.
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <catch2/catch.hpp>
+#include <mem/allocator/std_page_allocator.h>
+#include <mem/model/multiple/control.h>
+
+using namespace eka2l1;
+
+TEST_CASE("page_table_allocator_reuses_freed_tables", "mem") {
+    mem::basic_page_table_allocator allocator;
+
+    mem::page_table *first = allocator.create_new(12);
+    mem::page_table *second = allocator.create_new(12);
+
+    REQUIRE(first->id() == 0);
+    REQUIRE(second->id() == 1);
+
+    first->idx_ = 5;
+    first->pages_[3].host_addr = first;
+
+    allocator.free_page_table(first->id());
+    allocator.free_page_table(first->id());
+
+    mem::page_table *recycled = allocator.create_new(12);
+
+    REQUIRE(recycled == first);
+    REQUIRE(recycled->idx_ == 0xFFFFFFFF);
+    REQUIRE(!recycled->pages_[3].occupied());
+
+    // The double free above must not hand out the same table twice
+    REQUIRE(allocator.create_new(12)->id() == 2);
+    REQUIRE(allocator.get_page_table_by_id(3) == nullptr);
+}
+
+TEST_CASE("multiple_model_global_table_outside_shared_range", "mem") {
+    mem::basic_page_table_allocator allocator;
+    mem::control_multiple control(nullptr, &allocator, nullptr, 12, false);
+
+    const mem::asid before = control.rollover_fresh_addr_space();
+
+    // High in the user global section, but outside the range looked up through the global directory
+    const mem::vm_address addr = mem::dll_static_data_flexible + 0x100000;
+    REQUIRE(!control.is_global_address(addr));
+
+    std::uint32_t backing = 0;
+
+    mem::page_table *table = control.create_new_page_table();
+    table->pages_[0].host_addr = &backing;
+
+    control.assign_page_table(table, addr, mem::MMU_ASSIGN_LOCAL_GLOBAL_REGION);
+
+    const mem::asid after = control.rollover_fresh_addr_space();
+
+    REQUIRE(control.get_host_pointer(before, addr) == &backing);
+    REQUIRE(control.get_host_pointer(after, addr) == &backing);
+    REQUIRE(control.get_host_pointer(0, addr) == &backing);
+
+    // Unassigning must drop the table from every address space
+    control.assign_page_table(nullptr, addr, mem::MMU_ASSIGN_LOCAL_GLOBAL_REGION);
+
+    REQUIRE(control.get_page_info(before, addr) == nullptr);
+    REQUIRE(control.get_page_info(after, addr) == nullptr);
+}
@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) 2022 EKA2L1 Team.
+ *
+ * This file is part of EKA2L1 project.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <catch2/catch.hpp>
+#include <common/fileutils.h>
+#include <common/path.h>
+#include <config/config.h>
+#include <package/manager.h>
+#include <vfs/vfs.h>
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+using namespace eka2l1;
+
+static constexpr const char16_t *PACKAGE_TEST_DRIVE_PATH = u"package_test_drive_c";
+static constexpr const char *PACKAGE_TEST_STORAGE_PATH = "package_test_storage";
+
+/**
+ * \brief IO with only drive C mounted to an empty folder, plus a config storing cache there.
+ */
+struct package_test_env {
+    io_system io_;
+    config::state conf_;
+
+    explicit package_test_env() {
+        common::delete_folder(common::ucs2_to_utf8(PACKAGE_TEST_DRIVE_PATH));
+        common::delete_folder(PACKAGE_TEST_STORAGE_PATH);
+
+        common::create_directories(common::ucs2_to_utf8(PACKAGE_TEST_DRIVE_PATH));
+
+        file_system_inst physical_fs = create_physical_filesystem(epocver::epoc94, "");
+        io_.add_filesystem(physical_fs);
+        io_.mount_physical_path(drive_c, drive_media::physical, io_attrib_internal, PACKAGE_TEST_DRIVE_PATH);
+
+        conf_.storage = PACKAGE_TEST_STORAGE_PATH;
+    }
+
+    ~package_test_env() {
+        common::delete_folder(common::ucs2_to_utf8(PACKAGE_TEST_DRIVE_PATH));
+        common::delete_folder(PACKAGE_TEST_STORAGE_PATH);
+    }
+};
+
+static package::object make_test_package(const epoc::uid uid, const package::install_type_value type, const std::vector<epoc::uid> &sids,
+    const std::vector<std::u16string> &files) {
+    package::object obj{};
+    obj.uid = uid;
+    obj.install_type = type;
+    obj.sids = sids;
+
+    for (const std::u16string &file : files) {
+        package::file_description desc{};
+        desc.target = file;
+
+        obj.file_descriptions.push_back(std::move(desc));
+    }
+
+    return obj;
+}
+
+TEST_CASE("package_partial_update_keeps_sids_unique", "package") {
+    package_test_env env;
+    manager::packages pkgs(&env.io_, &env.conf_, drive_c);
+
+    static constexpr epoc::uid TEST_PACKAGE_UID = 0xE0001234;
+
+    package::object base = make_test_package(TEST_PACKAGE_UID, package::install_type_normal_install, { 0xE0001000, 0xE0001001 },
+        { u"C:\\sys\\bin\\first.exe", u"C:\\sys\\bin\\second.exe" });
+    REQUIRE(pkgs.add_package(base, nullptr));
+
+    // The update reinstalls the second executable and adds a third one
+    package::object update = make_test_package(TEST_PACKAGE_UID, package::install_type_partial_update, { 0xE0001001, 0xE0001002 },
+        { u"C:\\sys\\bin\\second.exe", u"C:\\sys\\bin\\third.exe" });
+    REQUIRE(pkgs.add_package(update, nullptr));
+
+    package::object *installed = pkgs.package(TEST_PACKAGE_UID);
+    REQUIRE(installed);
+    REQUIRE(installed->sids == std::vector<epoc::uid>{ 0xE0001000, 0xE0001001, 0xE0001002 });
+
+    REQUIRE(pkgs.package_by_sid(0xE0001000) == installed);
+    REQUIRE(pkgs.package_by_sid(0xE0001002) == installed);
+    REQUIRE(pkgs.package_by_sid(0xE0001003) == nullptr);
+
+    // File lookups ignore case
+    REQUIRE(pkgs.package_by_file(u"c:\\SYS\\BIN\\THIRD.EXE") == installed);
+    REQUIRE(pkgs.package_by_file(u"C:\\sys\\bin\\fourth.exe") == nullptr);
+
+    REQUIRE(pkgs.uninstall_package(*installed));
+    REQUIRE(pkgs.package_by_sid(0xE0001001) == nullptr);
+    REQUIRE(pkgs.package_by_file(u"C:\\sys\\bin\\first.exe") == nullptr);
+}
+
+TEST_CASE("package_snapshot_with_corrupted_count_falls_back", "package") {
+    package_test_env env;
+    static constexpr epoc::uid TEST_PACKAGE_UID = 0xE0004321;
+
+    {
+        manager::packages pkgs(&env.io_, &env.conf_, drive_c);
+        package::object base = make_test_package(TEST_PACKAGE_UID, package::install_type_normal_install, { 0xE0004000 },
+            { u"C:\\sys\\bin\\snapshot.exe" });
+
+        REQUIRE(pkgs.add_package(base, nullptr));
+    }
+
+    // The first load reads the registry files and writes the snapshot down
+    {
+        manager::packages pkgs(&env.io_, &env.conf_, drive_c);
+        pkgs.load_registries();
+
+        REQUIRE(pkgs.package_by_sid(0xE0004000));
+    }
+
+    const std::string snapshot_path = add_path(PACKAGE_TEST_STORAGE_PATH, "cache/package_registry_C.bin");
+    REQUIRE(common::exists(snapshot_path));
+
+    std::vector<std::uint8_t> snapshot_data;
+
+    {
+        std::ifstream snapshot_stream(snapshot_path, std::ios::binary);
+        snapshot_data.assign(std::istreambuf_iterator<char>(snapshot_stream), std::istreambuf_iterator<char>());
+    }
+
+    // Skip the magic, the version and the folder stamps, to get to the object count
+    std::size_t offset = sizeof(std::uint32_t) * 2;
+    std::uint32_t stamp_count = 0;
+
+    std::memcpy(&stamp_count, snapshot_data.data() + offset, sizeof(std::uint32_t));
+    offset += sizeof(std::uint32_t);
+
+    for (std::uint32_t i = 0; i < stamp_count; i++) {
+        std::uint32_t name_length = 0;
+        std::memcpy(&name_length, snapshot_data.data() + offset, sizeof(std::uint32_t));
+
+        offset += sizeof(std::uint32_t) + name_length + sizeof(std::uint64_t);
+    }
+
+    std::uint32_t object_count = 0;
+    std::memcpy(&object_count, snapshot_data.data() + offset, sizeof(std::uint32_t));
+    REQUIRE(object_count == 1);
+
+    object_count = 0x7FFFFFFF;
+    std::memcpy(snapshot_data.data() + offset, &object_count, sizeof(std::uint32_t));
+
+    {
+        std::ofstream snapshot_stream(snapshot_path, std::ios::binary | std::ios::trunc);
+        snapshot_stream.write(reinterpret_cast<const char *>(snapshot_data.data()), snapshot_data.size());
+    }
+
+    // The corrupted snapshot is ignored, registries are read again
+    manager::packages pkgs(&env.io_, &env.conf_, drive_c);
+    pkgs.load_registries();
+
+    REQUIRE(pkgs.package_count() == 1);
+    REQUIRE(pkgs.package_by_sid(0xE0004000));
+}
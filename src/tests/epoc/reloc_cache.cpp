@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2019 EKA2L1 Team.
+ * 
+ * This file is part of EKA2L1 project.
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <catch2/catch.hpp>
+#include <kernel/reloc_cache.h>
+
+using namespace eka2l1;
+
+static kernel::relocated_image make_test_image(const std::size_t code_size, const std::uint8_t fill) {
+    kernel::relocated_image image;
+    image.code_.resize(code_size, fill);
+    image.data_.resize(16, fill);
+
+    return image;
+}
+
+TEST_CASE("relocated_image_cache_hit_needs_same_addresses", "reloc_cache") {
+    kernel::relocated_image_cache cache(0x1000);
+
+    kernel::relocated_image_key key{ 0x1234, 0x70000000, 0x400000 };
+    cache.add(key, make_test_image(0x100, 0xAB));
+
+    const kernel::relocated_image *image = cache.find(key);
+    REQUIRE(image);
+    REQUIRE(image->code_.size() == 0x100);
+    REQUIRE(image->code_[0] == 0xAB);
+
+    kernel::relocated_image_key other_base = key;
+    other_base.code_run_addr_ = 0x70010000;
+
+    REQUIRE(cache.find(other_base) == nullptr);
+}
+
+TEST_CASE("relocated_image_cache_evicts_least_recently_used", "reloc_cache") {
+    kernel::relocated_image_cache cache(0x300);
+
+    kernel::relocated_image_key key1{ 1, 0x70000000, 0x400000 };
+    kernel::relocated_image_key key2{ 2, 0x70000000, 0x400000 };
+    kernel::relocated_image_key key3{ 3, 0x70000000, 0x400000 };
+
+    cache.add(key1, make_test_image(0x170, 1));
+    cache.add(key2, make_test_image(0x170, 2));
+
+    // Touch the first one, so the second one is the oldest
+    REQUIRE(cache.find(key1));
+
+    cache.add(key3, make_test_image(0x170, 3));
+
+    REQUIRE(cache.count() == 2);
+    REQUIRE(cache.total_size() <= 0x300);
+    REQUIRE(cache.find(key1));
+    REQUIRE(cache.find(key2) == nullptr);
+    REQUIRE(cache.find(key3));
+
+    // Too big to ever fit
+    kernel::relocated_image_key key4{ 4, 0x70000000, 0x400000 };
+    cache.add(key4, make_test_image(0x400, 4));
+
+    REQUIRE(cache.find(key4) == nullptr);
+    REQUIRE(cache.count() == 2);
+}
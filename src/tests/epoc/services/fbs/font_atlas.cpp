@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2022 EKA2L1 Team.
+ *
+ * This file is part of EKA2L1 project.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <catch2/catch.hpp>
+#include <services/fbs/font_atlas.h>
+
+using namespace eka2l1;
+
+TEST_CASE("shelf_packer_reuses_shelf_of_similar_height", "font_atlas") {
+    epoc::atlas_shelf_packer packer({ 64, 64 });
+    std::size_t shelf_a = 0;
+    std::size_t shelf_b = 0;
+
+    auto pos_a = packer.allocate({ 20, 10 }, shelf_a);
+    auto pos_b = packer.allocate({ 20, 9 }, shelf_b);
+
+    REQUIRE(pos_a.has_value());
+    REQUIRE(pos_b.has_value());
+    REQUIRE(shelf_a == shelf_b);
+    REQUIRE(pos_a->y == 0);
+    REQUIRE(pos_b->y == 0);
+    REQUIRE(pos_b->x == 20);
+
+    // Much shorter rectangle opens a new shelf
+    std::size_t shelf_c = 0;
+    auto pos_c = packer.allocate({ 20, 3 }, shelf_c);
+
+    REQUIRE(pos_c.has_value());
+    REQUIRE(shelf_c != shelf_a);
+    REQUIRE(pos_c->y == 12);
+    REQUIRE(packer.shelf_count() == 2);
+}
+
+TEST_CASE("shelf_packer_reuses_freed_space", "font_atlas") {
+    epoc::atlas_shelf_packer packer({ 32, 16 });
+    std::size_t shelf_index = 0;
+
+    // Fill the whole area
+    std::vector<eka2l1::vec2> positions;
+
+    for (int i = 0; i < 8; i++) {
+        auto pos = packer.allocate({ 8, 8 }, shelf_index);
+        REQUIRE(pos.has_value());
+
+        positions.push_back(pos.value());
+    }
+
+    REQUIRE(!packer.allocate({ 8, 8 }, shelf_index).has_value());
+
+    // Free two neighbours, a rectangle twice as wide must fit in there
+    packer.free(0, positions[1].x, 8);
+    packer.free(0, positions[2].x, 8);
+
+    auto merged_pos = packer.allocate({ 16, 8 }, shelf_index);
+
+    REQUIRE(merged_pos.has_value());
+    REQUIRE(shelf_index == 0);
+    REQUIRE(merged_pos->x == positions[1].x);
+
+    // Emptying the top shelf gives its space back to rectangles of any height
+    for (int i = 4; i < 8; i++) {
+        packer.free(1, positions[i].x, 8);
+    }
+
+    REQUIRE(packer.shelf_count() == 1);
+
+    auto tall_pos = packer.allocate({ 4, 8 }, shelf_index);
+
+    REQUIRE(tall_pos.has_value());
+    REQUIRE(tall_pos->y == 8);
+    REQUIRE(!packer.allocate({ 4, 9 }, shelf_index).has_value());
+}
@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2022 EKA2L1 Team.
+ *
+ * This file is part of EKA2L1 project.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <catch2/catch.hpp>
+#include <services/fbs/mbm_cache.h>
+
+#include <common/buffer.h>
+
+#include <fstream>
+#include <vector>
+
+using namespace eka2l1;
+
+static std::vector<std::uint8_t> read_test_mbm() {
+    std::ifstream fi("loaderassets/face.mbm", std::ios::binary);
+    return std::vector<std::uint8_t>(std::istreambuf_iterator<char>(fi), std::istreambuf_iterator<char>());
+}
+
+TEST_CASE("headers_are_indexed_until_file_changes", "mbm_cache") {
+    std::vector<std::uint8_t> data = read_test_mbm();
+    REQUIRE(!data.empty());
+
+    common::ro_buf_stream stream(data.data(), data.size());
+    epoc::mbm_cache cache(0x1000);
+
+    loader::mbm_file *file = cache.get_headers(u"Z:\\Resource\\Face.mbm", 100, data.size(), &stream);
+
+    REQUIRE(file);
+    REQUIRE(file->trailer.count == 1);
+    REQUIRE(file->is_header_loaded(0));
+    REQUIRE(file->sbm_headers[0].bit_per_pixels == 24);
+
+    // Path is not case sensitive
+    REQUIRE(cache.get_headers(u"z:\\resource\\face.mbm", 100, data.size(), &stream) == file);
+
+    // Modified file must be read again
+    loader::mbm_file *new_file = cache.get_headers(u"z:\\resource\\face.mbm", 101, data.size(), &stream);
+
+    REQUIRE(new_file);
+    REQUIRE(new_file->trailer.count == 1);
+
+    // Garbage can't be indexed
+    std::vector<std::uint8_t> garbage(64, 0);
+    common::ro_buf_stream garbage_stream(garbage.data(), garbage.size());
+
+    REQUIRE(!cache.get_headers(u"z:\\resource\\garbage.mbm", 100, garbage.size(), &garbage_stream));
+}
+
+TEST_CASE("payloads_evicted_least_recently_used_first", "mbm_cache") {
+    epoc::mbm_cache cache(0x300);
+
+    const std::vector<std::uint8_t> payload(0x100, 0x5A);
+
+    cache.add_payload(u"z:\\a.mbm", 0, 1, payload.data(), payload.size());
+    cache.add_payload(u"z:\\a.mbm", 1, 1, payload.data(), payload.size());
+    cache.add_payload(u"z:\\a.mbm", 2, 1, payload.data(), payload.size());
+
+    REQUIRE(cache.payload_size() == 0x300);
+
+    // Touch the first one, so the second becomes the oldest
+    const std::vector<std::uint8_t> *first = cache.get_payload(u"Z:\\A.MBM", 0, 1);
+    REQUIRE(first);
+    REQUIRE(*first == payload);
+
+    cache.add_payload(u"z:\\a.mbm", 3, 1, payload.data(), payload.size());
+
+    REQUIRE(cache.payload_count() == 3);
+    REQUIRE(cache.payload_size() == 0x300);
+    REQUIRE(cache.get_payload(u"z:\\a.mbm", 0, 1));
+    REQUIRE(!cache.get_payload(u"z:\\a.mbm", 1, 1));
+    REQUIRE(cache.get_payload(u"z:\\a.mbm", 2, 1));
+
+    // Different modification time is a different payload
+    REQUIRE(!cache.get_payload(u"z:\\a.mbm", 3, 2));
+
+    // Too large to ever fit
+    const std::vector<std::uint8_t> big_payload(0x400, 0);
+    cache.add_payload(u"z:\\b.mbm", 0, 1, big_payload.data(), big_payload.size());
+
+    REQUIRE(!cache.get_payload(u"z:\\b.mbm", 0, 1));
+    REQUIRE(cache.payload_size() == 0x300);
+}
@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2022 EKA2L1 Team.
+ *
+ * This file is part of EKA2L1 project.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <catch2/catch.hpp>
+#include <config/config.h>
+#include <cpu/arm_factory.h>
+#include <kernel/kernel.h>
+#include <kernel/timing.h>
+#include <services/framework.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using namespace eka2l1;
+
+/**
+ * \brief Kernel with only a timer, a config and an interpreter CPU. The timer thread is not started,
+ *        so posted completions only run when the test advances the timer.
+ */
+struct host_work_test_kernel {
+    config::state conf_;
+    ntimer timing_;
+    arm::exclusive_monitor_instance monitor_;
+    arm::core_instance cpu_;
+    std::unique_ptr<kernel_system> kern_;
+
+    explicit host_work_test_kernel()
+        : timing_(DEFAULT_EMULATED_CPU_HZ)
+        , monitor_(arm::create_exclusive_monitor(arm_emulator_type::dyncom, 1))
+        , cpu_(arm::create_core(monitor_.get(), arm_emulator_type::dyncom)) {
+        kern_ = std::make_unique<kernel_system>(nullptr, &timing_, nullptr, &conf_, nullptr, nullptr, cpu_.get(), nullptr);
+    }
+};
+
+TEST_CASE("host_work_finishes_on_timer_thread", "host_work") {
+    host_work_test_kernel test_kern;
+    service::host_work_queue queue(test_kern.kern_.get(), &test_kern.timing_, "Test");
+
+    std::atomic<bool> work_done = false;
+    std::thread::id work_thread;
+
+    bool finished = false;
+    std::thread::id finish_thread;
+
+    queue.queue([&]() {
+        work_thread = std::this_thread::get_id();
+        work_done = true;
+    }, [&](const bool cancelled) {
+        // The work is done before the finish is posted
+        REQUIRE(work_done);
+        REQUIRE_FALSE(cancelled);
+
+        finish_thread = std::this_thread::get_id();
+        finished = true;
+    });
+
+    for (int i = 0; (i < 500) && !finished; i++) {
+        test_kern.timing_.advance();
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+
+    REQUIRE(finished);
+    REQUIRE(work_thread != std::this_thread::get_id());
+    REQUIRE(finish_thread == std::this_thread::get_id());
+}
+
+TEST_CASE("host_work_stop_waits_and_cancels_finish", "host_work") {
+    host_work_test_kernel test_kern;
+    service::host_work_queue queue(test_kern.kern_.get(), &test_kern.timing_, "Test");
+
+    std::atomic<bool> work_done = false;
+    int finish_count = 0;
+    bool finish_cancelled = false;
+
+    queue.queue([&]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        work_done = true;
+    }, [&](const bool cancelled) {
+        finish_count++;
+        finish_cancelled = cancelled;
+    });
+
+    // Stopping with the kernel lock held must not deadlock
+    test_kern.kern_->lock();
+    queue.stop();
+    test_kern.kern_->unlock();
+
+    REQUIRE(work_done);
+
+    // The finish still runs once, so that its request can be completed
+    REQUIRE(finish_count == 1);
+    REQUIRE(finish_cancelled);
+
+    test_kern.timing_.advance();
+    REQUIRE(finish_count == 1);
+
+    // Nothing is queued once stopped
+    bool late_work_run = false;
+    queue.queue([&]() { late_work_run = true; }, [](const bool) {});
+
+    REQUIRE_FALSE(late_work_run);
+}
@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2022 EKA2L1 Team.
+ *
+ * This file is part of EKA2L1 project.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <catch2/catch.hpp>
+#include <common/virtualmem.h>
+#include <services/goommonitor/goommonitor.h>
+
+using namespace eka2l1;
+
+TEST_CASE("goom_host_memory_fits_without_budget", "goommonitor") {
+    REQUIRE(goom_host_memory_fits(0, 0, 0x100000));
+    REQUIRE(goom_host_memory_fits(static_cast<std::size_t>(-1), 0, 0xFFFFFFFF));
+}
+
+TEST_CASE("goom_host_memory_fits_checks_resident_against_budget", "goommonitor") {
+    const std::size_t budget = 64 * 1024 * 1024;
+
+    REQUIRE(goom_host_memory_fits(32 * 1024 * 1024, budget, 32 * 1024 * 1024));
+    REQUIRE_FALSE(goom_host_memory_fits(32 * 1024 * 1024, budget, 32 * 1024 * 1024 + 1));
+
+    // Already over the budget, even asking for nothing fails
+    REQUIRE(goom_host_memory_fits(budget, budget, 0));
+    REQUIRE_FALSE(goom_host_memory_fits(budget + 1, budget, 0));
+}
+
+TEST_CASE("goom_host_memory_fits_uses_sampled_resident_size", "goommonitor") {
+    const std::size_t host_resident = common::get_host_resident_size();
+
+    if (host_resident == 0) {
+        // Not available on this host
+        return;
+    }
+
+    REQUIRE(goom_host_memory_fits(host_resident, host_resident * 2, host_resident));
+    REQUIRE_FALSE(goom_host_memory_fits(host_resident, host_resident / 2, 0));
+}
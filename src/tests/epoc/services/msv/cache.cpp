@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2022 EKA2L1 Team.
+ *
+ * This file is part of EKA2L1 project.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <catch2/catch.hpp>
+#include <services/msv/cache.h>
+
+#include <vector>
+
+using namespace eka2l1;
+
+static epoc::msv::entry make_msv_entry(const std::uint32_t id, const std::int32_t parent_id) {
+    epoc::msv::entry ent;
+    ent.id_ = id;
+    ent.parent_id_ = parent_id;
+
+    return ent;
+}
+
+TEST_CASE("range_table_add_keeps_order", "msv_cache") {
+    epoc::msv::entry_range_table table;
+    const std::uint32_t ids[] = { 50, 10, 30, 20, 40 };
+
+    for (const std::uint32_t id : ids) {
+        epoc::msv::entry ent = make_msv_entry(id, 1);
+        epoc::msv::entry *added = table.add(ent, true);
+
+        REQUIRE(added);
+        REQUIRE(added->id_ == id);
+    }
+
+    epoc::msv::entry duplicate = make_msv_entry(30, 2);
+    REQUIRE(!table.add(duplicate, true));
+
+    REQUIRE(table.max_range() == 50);
+
+    for (const std::uint32_t id : ids) {
+        REQUIRE(table.get(id));
+        REQUIRE(table.get(id)->parent_id_ == 1);
+    }
+
+    REQUIRE(!table.get(35));
+}
+
+TEST_CASE("range_table_add_tons_merges", "msv_cache") {
+    epoc::msv::entry_range_table table;
+
+    epoc::msv::entry first = make_msv_entry(20, 1);
+    epoc::msv::entry second = make_msv_entry(40, 1);
+
+    table.add(first, true);
+    table.add(second, true);
+
+    std::vector<epoc::msv::entry> incoming;
+    incoming.push_back(make_msv_entry(10, 2));
+    incoming.push_back(make_msv_entry(20, 2));
+    incoming.push_back(make_msv_entry(30, 2));
+    incoming.push_back(make_msv_entry(50, 2));
+
+    REQUIRE(table.add_tons(incoming, 0, incoming.size() - 1));
+
+    REQUIRE(table.min_range() == 10);
+    REQUIRE(table.max_range() == 50);
+
+    // The entry that was already there is kept
+    REQUIRE(table.get(20)->parent_id_ == 1);
+    REQUIRE(table.get(30)->parent_id_ == 2);
+    REQUIRE(table.get(40)->parent_id_ == 1);
+}
+
+TEST_CASE("visible_folder_bulk_load", "msv_cache") {
+    static constexpr std::uint32_t FOLDER_ID = 0x1000;
+    static constexpr std::uint32_t ENTRY_COUNT = epoc::msv::CACHE_THRESHOLD * 3 + 7;
+
+    epoc::msv::visible_folder folder(FOLDER_ID);
+    std::vector<epoc::msv::entry> entries;
+
+    for (std::uint32_t i = 0; i < ENTRY_COUNT; i++) {
+        entries.push_back(make_msv_entry(0x2000 + i * 2, FOLDER_ID));
+    }
+
+    REQUIRE(folder.add_entry_list(entries, true));
+
+    // Merge some more into the existing tables
+    std::vector<epoc::msv::entry> more_entries;
+    for (std::uint32_t i = 0; i < ENTRY_COUNT; i++) {
+        more_entries.push_back(make_msv_entry(0x2001 + i * 2, FOLDER_ID));
+    }
+
+    REQUIRE(folder.add_entry_list(more_entries, true));
+
+    epoc::msv::visible_folder_children_query_error error = epoc::msv::visible_folder_children_query_ok;
+    std::vector<epoc::msv::entry *> children = folder.get_children_by_parent(FOLDER_ID, &error);
+
+    REQUIRE(error == epoc::msv::visible_folder_children_query_ok);
+    REQUIRE(children.size() == ENTRY_COUNT * 2);
+
+    for (std::uint32_t i = 0; i < ENTRY_COUNT * 2; i++) {
+        REQUIRE(folder.get_entry(0x2000 + i));
+    }
+}
@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2022 EKA2L1 Team.
+ *
+ * This file is part of EKA2L1 project.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <catch2/catch.hpp>
+#include <services/window/opheader.h>
+
+#include <cstring>
+#include <vector>
+
+using namespace eka2l1;
+
+static void append_command(std::vector<std::uint8_t> &buf, std::uint16_t op, const std::uint32_t *handle,
+    const std::uint32_t payload_size) {
+    if (handle) {
+        op |= 0x8000;
+    }
+
+    const ws_cmd_header header{ op, static_cast<std::uint16_t>(payload_size) };
+    const std::size_t offset = buf.size();
+
+    buf.resize(offset + sizeof(header) + (handle ? sizeof(std::uint32_t) : 0) + payload_size, 0xCD);
+    std::memcpy(buf.data() + offset, &header, sizeof(header));
+
+    if (handle) {
+        std::memcpy(buf.data() + offset + sizeof(header), handle, sizeof(std::uint32_t));
+    }
+}
+
+TEST_CASE("walker_reuses_previous_handle", "window") {
+    std::vector<std::uint8_t> buf;
+
+    const std::uint32_t first_handle = 0x10001;
+    const std::uint32_t second_handle = 0x20002;
+
+    append_command(buf, 5, &first_handle, 8);
+    append_command(buf, 6, nullptr, 4);
+    append_command(buf, 7, &second_handle, 0);
+    append_command(buf, 8, nullptr, 12);
+
+    ws_cmd_walker walker(buf.data(), buf.data() + buf.size());
+    ws_cmd cmd;
+
+    const std::uint16_t expected_ops[] = { 5, 6, 7, 8 };
+    const std::uint32_t expected_handles[] = { first_handle, first_handle, second_handle, second_handle };
+
+    for (std::size_t i = 0; i < 4; i++) {
+        REQUIRE(walker.next(cmd));
+        REQUIRE(cmd.header.op == expected_ops[i]);
+        REQUIRE(cmd.obj_handle == expected_handles[i]);
+        REQUIRE(reinterpret_cast<std::uint8_t *>(cmd.data_ptr) >= buf.data());
+    }
+
+    REQUIRE(!walker.next(cmd));
+}
+
+TEST_CASE("walker_stops_on_truncated_command", "window") {
+    std::vector<std::uint8_t> buf;
+    const std::uint32_t handle = 0x10001;
+
+    append_command(buf, 5, &handle, 8);
+    append_command(buf, 6, nullptr, 16);
+
+    // Cut the payload of the second command
+    buf.resize(buf.size() - 4);
+
+    ws_cmd_walker walker(buf.data(), buf.data() + buf.size());
+    ws_cmd cmd;
+
+    REQUIRE(walker.next(cmd));
+    REQUIRE(cmd.header.op == 5);
+    REQUIRE(!walker.next(cmd));
+}
@@ -1,5 +1,6 @@
 #include <catch2/catch.hpp>
 #include <common/algorithm.h>
+#include <common/fileutils.h>
 #include <common/path.h>
 #include <common/types.h>
 #include <vfs/vfs.h>
@@ -37,3 +38,94 @@ TEST_CASE("get_physical", "vfs") {
 
     REQUIRE(eka2l1::common::compare_ignore_case(*actual_path_b, std::u16string(u"drive_b") + static_cast<char16_t>(eka2l1::get_separator()) + u"despacito3leak") == 0);
 }
+
+TEST_CASE("physical_read_at_moves_cursor", "vfs") {
+    static constexpr std::uint32_t TEST_FILE_SIZE = 0x10000;
+    const std::string test_path = "vfs_read_at_test.bin";
+
+    std::vector<std::uint8_t> pattern(TEST_FILE_SIZE);
+    for (std::uint32_t i = 0; i < TEST_FILE_SIZE; i++) {
+        pattern[i] = static_cast<std::uint8_t>(i * 7);
+    }
+
+    {
+        eka2l1::symfile writer = eka2l1::physical_file_proxy(test_path, WRITE_MODE | BIN_MODE);
+        REQUIRE(writer);
+        REQUIRE(writer->write_file(pattern.data(), 1, TEST_FILE_SIZE) == TEST_FILE_SIZE);
+    }
+
+    eka2l1::symfile f = eka2l1::physical_file_proxy(test_path, READ_MODE | WRITE_MODE | BIN_MODE);
+    REQUIRE(f);
+
+    std::uint8_t buf[64];
+
+    // Small read, gets served from the readahead window afterwards
+    REQUIRE(f->read_file_at(100, buf, 32) == 32);
+    REQUIRE(std::equal(buf, buf + 32, pattern.begin() + 100));
+    REQUIRE(f->tell() == 132);
+
+    REQUIRE(f->read_file_at(132, buf, 64) == 64);
+    REQUIRE(std::equal(buf, buf + 64, pattern.begin() + 132));
+    REQUIRE(f->tell() == 196);
+
+    // Normal read continues from where the positioned read stopped
+    REQUIRE(f->read_file(buf, 1, 4) == 4);
+    REQUIRE(std::equal(buf, buf + 4, pattern.begin() + 196));
+
+    // A write must not be hidden by the readahead window
+    const std::uint8_t new_data[4] = { 0xDE, 0xAD, 0xBE, 0xEF };
+    f->seek(150, eka2l1::file_seek_mode::beg);
+    REQUIRE(f->write_file(new_data, 1, 4) == 4);
+
+    REQUIRE(f->read_file_at(148, buf, 8) == 8);
+    REQUIRE(std::equal(buf + 2, buf + 6, new_data));
+
+    // Reading past the end is truncated
+    REQUIRE(f->read_file_at(TEST_FILE_SIZE - 10, buf, 64) == 10);
+    REQUIRE(f->tell() == TEST_FILE_SIZE);
+
+    f->close();
+    f.reset();
+
+    eka2l1::common::remove(test_path);
+}
+
+TEST_CASE("physical_read_at_sees_writes_from_other_handles", "vfs") {
+    static constexpr std::uint32_t TEST_FILE_SIZE = 0x1000;
+    const std::string test_path = "vfs_read_at_shared_test.bin";
+
+    std::vector<std::uint8_t> pattern(TEST_FILE_SIZE, 0x11);
+
+    {
+        eka2l1::symfile writer = eka2l1::physical_file_proxy(test_path, WRITE_MODE | BIN_MODE);
+        REQUIRE(writer);
+        REQUIRE(writer->write_file(pattern.data(), 1, TEST_FILE_SIZE) == TEST_FILE_SIZE);
+    }
+
+    eka2l1::symfile reader = eka2l1::physical_file_proxy(test_path, READ_MODE | BIN_MODE);
+    eka2l1::symfile writer = eka2l1::physical_file_proxy(test_path, READ_MODE | WRITE_MODE | BIN_MODE);
+
+    REQUIRE(reader);
+    REQUIRE(writer);
+
+    std::uint8_t buf[8];
+
+    // Fill the readahead window of the reader
+    REQUIRE(reader->read_file_at(0, buf, 8) == 8);
+    REQUIRE(buf[4] == 0x11);
+
+    const std::uint8_t new_data[4] = { 0xDE, 0xAD, 0xBE, 0xEF };
+    writer->seek(4, eka2l1::file_seek_mode::beg);
+    REQUIRE(writer->write_file(new_data, 1, 4) == 4);
+
+    REQUIRE(reader->read_file_at(0, buf, 8) == 8);
+    REQUIRE(std::equal(buf + 4, buf + 8, new_data));
+
+    reader->close();
+    writer->close();
+
+    reader.reset();
+    writer.reset();
+
+    eka2l1::common::remove(test_path);
+}
@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2022 EKA2L1 Team.
+ *
+ * This file is part of EKA2L1 project.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <services/window/opheader.h>
+#include <services/window/recorder.h>
+
+#include <common/log.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <unordered_map>
+#include <vector>
+
+// Decode a window server command recording, walking every buffer like the server does, and report the throughput.
+// This is a decoder benchmark only: commands are never executed, so it says nothing about the cost of running them.
+int main(int argc, char **argv) {
+    eka2l1::log::setup_log(nullptr);
+
+    if (argc <= 1) {
+        LOG_ERROR(eka2l1::SYSTEM, "No recording provided!");
+        LOG_INFO(eka2l1::SYSTEM, "Usage: wsdecodebench [recording] [iterations].");
+
+        return -1;
+    }
+
+    eka2l1::epoc::ws_command_playback playback(argv[1]);
+
+    if (!playback.is_valid()) {
+        LOG_ERROR(eka2l1::SYSTEM, "{} is not a window server command recording!", argv[1]);
+        return -2;
+    }
+
+    const int iterations = (argc > 2) ? std::max(1, std::atoi(argv[2])) : 100;
+
+    std::vector<eka2l1::epoc::ws_command_record> records;
+    eka2l1::epoc::ws_command_record record;
+
+    std::uint64_t total_bytes = 0;
+
+    while (playback.next(record)) {
+        total_bytes += record.buffer_.size();
+        records.push_back(std::move(record));
+    }
+
+    std::unordered_map<std::uint32_t, std::uint64_t> opcode_counts;
+    std::uint64_t command_count = 0;
+
+    const auto start = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < iterations; i++) {
+        for (auto &rec : records) {
+            eka2l1::ws_cmd_walker walker(rec.buffer_.data(), rec.buffer_.data() + rec.buffer_.size());
+            eka2l1::ws_cmd cmd;
+
+            while (walker.next(cmd)) {
+                opcode_counts[(cmd.obj_handle == rec.session_uid_) ? cmd.header.op : (cmd.header.op | 0x10000)]++;
+                command_count++;
+            }
+        }
+    }
+
+    const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+    LOG_INFO(eka2l1::SYSTEM, "Buffers: {}, bytes: {}, iterations: {}", records.size(), total_bytes, iterations);
+    LOG_INFO(eka2l1::SYSTEM, "Commands decoded: {} in {} us ({:.2f} commands/us)", command_count, elapsed,
+        (elapsed == 0) ? 0.0 : static_cast<double>(command_count) / static_cast<double>(elapsed));
+
+    std::vector<std::pair<std::uint32_t, std::uint64_t>> sorted_counts(opcode_counts.begin(), opcode_counts.end());
+    std::sort(sorted_counts.begin(), sorted_counts.end(), [](const auto &lhs, const auto &rhs) {
+        return lhs.second > rhs.second;
+    });
+
+    LOG_INFO(eka2l1::SYSTEM, "Most frequent opcodes (per iteration):");
+
+    for (std::size_t i = 0; i < std::min<std::size_t>(sorted_counts.size(), 20); i++) {
+        LOG_INFO(eka2l1::SYSTEM, "\t{} 0x{:X}: {}", (sorted_counts[i].first & 0x10000) ? "Object" : "Client",
+            sorted_counts[i].first & 0xFFFF, sorted_counts[i].second / iterations);
+    }
+
+    return 0;
+}